@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef PULSEEXEC_VERSION
+#define PULSEEXEC_VERSION "unknown"
+#endif
+
+namespace pulseexec {
+namespace bench {
+
+inline int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Percentile (0-100) of a sample set; sorts the samples in place
+inline int64_t percentile(std::vector<int64_t>& samples, double pct) {
+  if (samples.empty()) {
+    return 0;
+  }
+  std::sort(samples.begin(), samples.end());
+  size_t idx = static_cast<size_t>(pct / 100.0 * static_cast<double>(samples.size() - 1));
+  return samples[idx];
+}
+
+// Machine-readable results alongside the console output. Each case records its
+// parameters and metrics; when PULSEEXEC_BENCH_JSON_DIR is set the report is
+// written to <dir>/<benchmark>.json on destruction, so runs from different
+// releases can be diffed case by case.
+class JsonReport {
+public:
+  explicit JsonReport(std::string benchmark) : benchmark_(std::move(benchmark)) {}
+  ~JsonReport() { write(); }
+
+  JsonReport(const JsonReport&) = delete;
+  JsonReport& operator=(const JsonReport&) = delete;
+
+  void add(const std::string& name, nlohmann::json params, nlohmann::json metrics) {
+    results_.push_back(
+        {{"case", name}, {"params", std::move(params)}, {"metrics", std::move(metrics)}});
+  }
+
+  nlohmann::json to_json() const {
+    char timestamp[32] = {};
+    std::time_t now = std::time(nullptr);
+    std::tm utc{};
+    gmtime_r(&now, &utc);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+    return {{"benchmark", benchmark_},
+            {"version", PULSEEXEC_VERSION},
+            {"timestamp", timestamp},
+            {"results", results_}};
+  }
+
+  // No-op without PULSEEXEC_BENCH_JSON_DIR; false if the file cannot be written
+  bool write() {
+    const char* dir = std::getenv("PULSEEXEC_BENCH_JSON_DIR");
+    if (written_ || dir == nullptr || *dir == '\0') {
+      return true;
+    }
+    written_ = true;
+
+    std::string path = std::string(dir) + "/" + benchmark_ + ".json";
+    std::ofstream out(path);
+    if (!out) {
+      std::cerr << "Cannot write benchmark report " << path << "\n";
+      return false;
+    }
+    out << to_json().dump(2) << "\n";
+    return static_cast<bool>(out);
+  }
+
+private:
+  std::string benchmark_;
+  nlohmann::json results_ = nlohmann::json::array();
+  bool written_ = false;
+};
+
+} // namespace bench
+} // namespace pulseexec
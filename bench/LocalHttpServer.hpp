@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <boost/asio.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pulseexec {
+namespace bench {
+
+// Minimal loopback HTTP/1.1 server used as a stand-in for the exchange REST API.
+// Connections are kept alive unless the client asks otherwise, so benchmarks can
+// observe how many TCP connections a client actually opens.
+class LocalHttpServer {
+public:
+  struct Reply {
+    int status = 200;
+    std::string body;
+  };
+
+  using Handler = std::function<Reply(const std::string& method, const std::string& target,
+                                      const std::string& body)>;
+
+  explicit LocalHttpServer(Handler handler)
+      : handler_(std::move(handler)),
+        acceptor_(io_, boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"),
+                                                      0)) {}
+
+  ~LocalHttpServer() { stop(); }
+
+  void start() {
+    running_ = true;
+    accept_thread_ = std::thread([this] { accept_loop(); });
+  }
+
+  void stop() {
+    if (!running_.exchange(false)) {
+      return;
+    }
+
+    // A blocking accept() is not interrupted by close(); wake it with a dummy connection
+    boost::system::error_code ec;
+    {
+      boost::asio::ip::tcp::socket waker(io_);
+      waker.connect(acceptor_.local_endpoint(), ec);
+    }
+    if (accept_thread_.joinable()) {
+      accept_thread_.join();
+    }
+    acceptor_.close(ec);
+
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    for (auto& socket : sockets_) {
+      socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+      socket->close(ec);
+    }
+    for (auto& thread : session_threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+  std::string base_url() const {
+    return "http://127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port());
+  }
+
+  uint64_t connections_accepted() const { return connections_accepted_.load(); }
+  uint64_t requests_served() const { return requests_served_.load(); }
+
+private:
+  void accept_loop() {
+    while (running_) {
+      auto socket = std::make_shared<boost::asio::ip::tcp::socket>(io_);
+      boost::system::error_code ec;
+      acceptor_.accept(*socket, ec);
+      if (ec || !running_) {
+        break;
+      }
+
+      socket->set_option(boost::asio::ip::tcp::no_delay(true), ec);
+      connections_accepted_.fetch_add(1);
+
+      std::lock_guard<std::mutex> lock(sessions_mutex_);
+      sockets_.push_back(socket);
+      session_threads_.emplace_back([this, socket] { serve(*socket); });
+    }
+  }
+
+  void serve(boost::asio::ip::tcp::socket& socket) {
+    boost::asio::streambuf buffer;
+    boost::system::error_code ec;
+
+    while (running_) {
+      size_t header_len = boost::asio::read_until(socket, buffer, "\r\n\r\n", ec);
+      if (ec) {
+        return;
+      }
+
+      std::string headers(boost::asio::buffers_begin(buffer.data()),
+                          boost::asio::buffers_begin(buffer.data()) + header_len);
+      buffer.consume(header_len);
+
+      size_t content_length = 0;
+      auto cl_pos = find_header(headers, "content-length:");
+      if (cl_pos != std::string::npos) {
+        content_length = std::stoul(headers.substr(cl_pos + 15));
+      }
+      bool close_after = find_header(headers, "connection: close") != std::string::npos;
+
+      if (buffer.size() < content_length) {
+        boost::asio::read(socket, buffer,
+                          boost::asio::transfer_exactly(content_length - buffer.size()), ec);
+        if (ec) {
+          return;
+        }
+      }
+
+      std::string body(boost::asio::buffers_begin(buffer.data()),
+                       boost::asio::buffers_begin(buffer.data()) + content_length);
+      buffer.consume(content_length);
+
+      std::string method = headers.substr(0, headers.find(' '));
+      size_t target_start = method.size() + 1;
+      std::string target =
+          headers.substr(target_start, headers.find(' ', target_start) - target_start);
+
+      Reply reply = handler_(method, target, body);
+      requests_served_.fetch_add(1);
+
+      std::string response = "HTTP/1.1 " + std::to_string(reply.status) + " OK\r\n" +
+                             "Content-Type: application/json\r\n" +
+                             "Content-Length: " + std::to_string(reply.body.size()) + "\r\n" +
+                             (close_after ? "Connection: close\r\n" : "Connection: keep-alive\r\n");
+      response += "\r\n" + reply.body;
+      boost::asio::write(socket, boost::asio::buffer(response), ec);
+      if (ec || close_after) {
+        return;
+      }
+    }
+  }
+
+  static size_t find_header(const std::string& headers, const std::string& needle) {
+    std::string lowered = headers;
+    for (auto& c : lowered) {
+      c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return lowered.find(needle);
+  }
+
+  Handler handler_;
+  boost::asio::io_context io_;
+  boost::asio::ip::tcp::acceptor acceptor_;
+  std::atomic<bool> running_{false};
+  std::thread accept_thread_;
+
+  std::mutex sessions_mutex_;
+  std::vector<std::shared_ptr<boost::asio::ip::tcp::socket>> sockets_;
+  std::vector<std::thread> session_threads_;
+
+  std::atomic<uint64_t> connections_accepted_{0};
+  std::atomic<uint64_t> requests_served_{0};
+};
+
+} // namespace bench
+} // namespace pulseexec
@@ -0,0 +1,126 @@
+// ExecutionGateway order submission throughput: blocking place_order vs the
+// curl_multi-driven place_order_async path.
+//
+// The loopback stand-in adds a fixed service delay per request to mimic an
+// exchange round trip, so throughput is bounded by how many orders a client
+// keeps in flight rather than by local CPU.
+
+#include "BenchUtil.hpp"
+#include "LocalHttpServer.hpp"
+#include "pulseexec/ExecutionGateway.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+constexpr size_t kConnections = 16;
+
+LocalHttpServer::Handler delayed_reply(int latency_us) {
+  return [latency_us](const std::string&, const std::string&, const std::string&) {
+    std::this_thread::sleep_for(std::chrono::microseconds(latency_us));
+    return LocalHttpServer::Reply{
+        200, R"({"jsonrpc":"2.0","id":1,"result":{"access_token":"bench_token",)"
+             R"("expires_in":3600,"order":{"order_id":"BENCH-1","order_state":"open"}}})"};
+  };
+}
+
+void report(JsonReport& results, const std::string& label, int orders, int64_t elapsed_ns,
+            size_t peak_in_flight, int failures) {
+  double seconds = static_cast<double>(elapsed_ns) / 1e9;
+  int64_t orders_per_sec = static_cast<int64_t>(orders / seconds);
+  std::cout << label << "\n";
+  std::cout << "  orders:          " << orders << "\n";
+  std::cout << "  failures:        " << failures << "\n";
+  std::cout << "  peak_in_flight:  " << peak_in_flight << "\n";
+  std::cout << "  orders_per_sec:  " << orders_per_sec << "\n\n";
+  results.add(label, {{"orders", orders}},
+           {{"failures", failures},
+            {"peak_in_flight", peak_in_flight},
+            {"orders_per_sec", orders_per_sec}});
+}
+
+void run_blocking(JsonReport& results, int orders, int latency_us) {
+  LocalHttpServer server(delayed_reply(latency_us));
+  server.start();
+
+  ExecutionGateway gateway("bench_key", "bench_secret", server.base_url(), nullptr, kConnections);
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT, "bench");
+  gateway.place_order(req); // Warm-up, caches the access token
+
+  int failures = 0;
+  int64_t start = now_ns();
+  for (int i = 0; i < orders; ++i) {
+    if (!gateway.place_order(req).success) {
+      ++failures;
+    }
+  }
+  report(results, "blocking place_order (1 thread)", orders, now_ns() - start, 1, failures);
+}
+
+void run_async(JsonReport& results, int orders, int latency_us, size_t window) {
+  LocalHttpServer server(delayed_reply(latency_us));
+  server.start();
+
+  ExecutionGateway gateway("bench_key", "bench_secret", server.base_url(), nullptr, kConnections);
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT, "bench");
+  gateway.place_order(req); // Warm-up, caches the access token
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t in_flight = 0;
+  size_t peak_in_flight = 0;
+  int completed = 0;
+  std::atomic<int> failures{0};
+
+  int64_t start = now_ns();
+  for (int i = 0; i < orders; ++i) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&] { return in_flight < window; });
+      peak_in_flight = std::max(peak_in_flight, ++in_flight);
+    }
+
+    gateway.place_order_async(req, [&](const ExecutionResult& result) {
+      if (!result.success) {
+        failures++;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      --in_flight;
+      ++completed;
+      cv.notify_all();
+    });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return completed == orders; });
+  }
+
+  report(results, "place_order_async (window=" + std::to_string(window) + ")", orders,
+         now_ns() - start, peak_in_flight, failures.load());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int orders = argc > 1 ? std::atoi(argv[1]) : 2000;
+  int latency_us = argc > 2 ? std::atoi(argv[2]) : 500;
+  JsonReport results("bench_async_gateway");
+
+  std::cout << "simulated exchange latency: " << latency_us << "us, connections: " << kConnections
+            << "\n\n";
+
+  run_blocking(results, orders, latency_us);
+  for (size_t window : {16, 64, 256}) {
+    run_async(results, orders, latency_us, window);
+  }
+
+  return 0;
+}
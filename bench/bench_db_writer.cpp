@@ -0,0 +1,135 @@
+// DBWriter persistence rate at different transaction batch sizes.
+//
+// Every write is an INSERT OR REPLACE of a distinct order into an on-disk WAL
+// database; the clock stops once stop() has drained and committed the queue.
+//
+// The fill burst case replays the write pattern of a busy book instead: orders
+// are worked 16 at a time, and each goes pending -> open -> partial -> partial
+// -> filled with the updates of the 16 interleaved, as fills arrive. It is run
+// with and without write coalescing; write_amplification is SQLite statements
+// per order (5.0 means every update was written).
+
+#include "BenchUtil.hpp"
+#include "pulseexec/DBWriter.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <memory>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+void remove_db(const std::string& path) {
+  std::remove(path.c_str());
+  std::remove((path + "-wal").c_str());
+  std::remove((path + "-shm").c_str());
+}
+
+void run_case(JsonReport& report, const std::string& db_path, size_t batch_size, int writes) {
+  remove_db(db_path);
+
+  DBWriter writer(db_path, nullptr, writes, batch_size, std::chrono::microseconds(1000));
+  writer.start();
+
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT);
+  std::vector<Order> orders;
+  orders.reserve(writes);
+  for (int i = 0; i < writes; ++i) {
+    orders.emplace_back("BENCH_" + std::to_string(i), req, i);
+  }
+
+  int64_t start = now_ns();
+  for (const auto& order : orders) {
+    writer.write_order(order);
+  }
+  writer.stop();
+  int64_t elapsed_ns = now_ns() - start;
+
+  double seconds = static_cast<double>(elapsed_ns) / 1e9;
+  int64_t writes_per_sec = static_cast<int64_t>(writer.get_written_count() / seconds);
+  std::cout << "batch_size=" << batch_size << "\n";
+  std::cout << "  writes:          " << writer.get_written_count() << "\n";
+  std::cout << "  dropped:         " << writer.get_dropped_count() << "\n";
+  std::cout << "  writes_per_sec:  " << writes_per_sec << "\n\n";
+  report.add("write_order", {{"batch_size", batch_size}, {"writes", writes}},
+             {{"written", writer.get_written_count()},
+              {"dropped", writer.get_dropped_count()},
+              {"writes_per_sec", writes_per_sec}});
+
+  remove_db(db_path);
+}
+
+void run_fill_burst(JsonReport& report, const std::string& db_path, bool coalesce, int orders) {
+  remove_db(db_path);
+
+  constexpr int kWorking = 16;
+  const std::pair<OrderState, double> lifecycle[] = {
+      {OrderState::PENDING, 0.0}, {OrderState::OPEN, 0.0},    {OrderState::PARTIAL, 2.5},
+      {OrderState::PARTIAL, 7.5}, {OrderState::FILLED, 10.0},
+  };
+  const int updates = orders * static_cast<int>(std::size(lifecycle));
+
+  DBWriter writer(db_path, nullptr, updates, 256, std::chrono::microseconds(1000));
+  writer.set_write_coalescing(coalesce);
+  writer.start();
+
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT);
+  std::vector<Order> working;
+  working.reserve(kWorking);
+
+  int64_t start = now_ns();
+  for (int first = 0; first < orders; first += kWorking) {
+    working.clear();
+    for (int i = first; i < std::min(first + kWorking, orders); ++i) {
+      working.emplace_back("BURST_" + std::to_string(i), req, i);
+    }
+    for (const auto& [state, filled] : lifecycle) {
+      for (auto& order : working) {
+        order.state = state;
+        order.filled_amount = Qty(filled);
+        writer.write_order(order);
+      }
+    }
+  }
+  writer.stop();
+  int64_t elapsed_ns = now_ns() - start;
+
+  double seconds = static_cast<double>(elapsed_ns) / 1e9;
+  int64_t updates_per_sec = static_cast<int64_t>(updates / seconds);
+  double amplification = static_cast<double>(writer.get_written_count()) / orders;
+  std::cout << "fill burst, coalescing " << (coalesce ? "on" : "off") << "\n";
+  std::cout << "  updates:             " << updates << "\n";
+  std::cout << "  statements:          " << writer.get_written_count() << "\n";
+  std::cout << "  coalesced:           " << writer.get_coalesced_count() << "\n";
+  std::cout << "  write_amplification: " << amplification << "\n";
+  std::cout << "  updates_per_sec:     " << updates_per_sec << "\n\n";
+  report.add("fill_burst", {{"coalescing", coalesce}, {"orders", orders}, {"updates", updates}},
+             {{"statements", writer.get_written_count()},
+              {"coalesced", writer.get_coalesced_count()},
+              {"dropped", writer.get_dropped_count()},
+              {"write_amplification", amplification},
+              {"updates_per_sec", updates_per_sec}});
+
+  remove_db(db_path);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int writes = argc > 1 ? std::atoi(argv[1]) : 20000;
+  std::string db_path = argc > 2 ? argv[2] : "./bench_db_writer.db";
+  JsonReport report("bench_db_writer");
+
+  for (size_t batch_size : {1, 64, 1024}) {
+    run_case(report, db_path, batch_size, writes);
+  }
+  for (bool coalesce : {false, true}) {
+    run_fill_burst(report, db_path, coalesce, writes);
+  }
+
+  return 0;
+}
@@ -0,0 +1,249 @@
+// Exchange simulator throughput, from the matching engine alone up to the
+// whole client stack against it over loopback HTTP.
+//
+// The order flow is the same in every case: limit orders on both sides
+// scattered a few ticks around a fixed mid, so roughly a third of them cross
+// and trade, and every fourth order is canceled again if it rested. It runs
+//   1. straight into a MatchingEngine,
+//   2. through ExchangeSimulator::handle() as JSON-RPC bodies built by
+//      DeribitCodec, on one thread and on one thread per instrument,
+//   3. end to end: OrderManager, ExecutionGateway::place_order_async and a
+//      LocalHttpServer fronting the simulator, with the simulator's book
+//      notifications applied to a MarketDataFeed.
+
+#include "BenchUtil.hpp"
+#include "LocalHttpServer.hpp"
+#include "pulseexec/DeribitCodec.hpp"
+#include "pulseexec/ExchangeSimulator.hpp"
+#include "pulseexec/ExecutionGateway.hpp"
+#include "pulseexec/MarketDataFeed.hpp"
+#include "pulseexec/MatchingEngine.hpp"
+#include "pulseexec/OrderManager.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+const InstrumentScale kScale{1, 0, Price(0.5, 1), Qty(10.0, 0)};
+constexpr double kMid = 50000.0;
+constexpr int kCancelEvery = 4;
+constexpr size_t kConnections = 16;
+
+struct FlowOrder {
+  Side side;
+  double price;
+  double amount;
+};
+
+// Prices within +-10 ticks of the mid, biased so each side mostly rests on
+// its own half of the book and sometimes crosses
+std::vector<FlowOrder> generate_flow(int orders, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<int> offset(-4, 10);
+  std::uniform_int_distribution<int> lots(1, 10);
+  std::vector<FlowOrder> flow;
+  flow.reserve(orders);
+  for (int i = 0; i < orders; ++i) {
+    Side side = i % 2 == 0 ? Side::BUY : Side::SELL;
+    double ticks = offset(rng) * 0.5;
+    double price = side == Side::BUY ? kMid - ticks : kMid + 0.5 + ticks;
+    flow.push_back(FlowOrder{side, price, lots(rng) * 10.0});
+  }
+  return flow;
+}
+
+void report(JsonReport& results, const std::string& label, int orders, int64_t elapsed_ns,
+            nlohmann::json extra = nlohmann::json::object()) {
+  double seconds = static_cast<double>(elapsed_ns) / 1e9;
+  int64_t orders_per_sec = static_cast<int64_t>(orders / seconds);
+  std::cout << label << "\n";
+  std::cout << "  orders:          " << orders << "\n";
+  for (auto it = extra.begin(); it != extra.end(); ++it) {
+    std::cout << "  " << it.key() << ": " << std::string(15 - it.key().size(), ' ') << it.value()
+              << "\n";
+  }
+  std::cout << "  elapsed_ms:      " << elapsed_ns / 1e6 << "\n";
+  std::cout << "  orders_per_sec:  " << orders_per_sec << "\n\n";
+  extra["elapsed_ns"] = elapsed_ns;
+  extra["orders_per_sec"] = orders_per_sec;
+  results.add(label, {{"orders", orders}}, std::move(extra));
+}
+
+void run_engine(JsonReport& results, const std::vector<FlowOrder>& flow) {
+  MatchingEngine engine("BTC-PERPETUAL", kScale);
+  int64_t now_ms = 0;
+
+  int64_t start = now_ns();
+  for (size_t i = 0; i < flow.size(); ++i) {
+    const FlowOrder& o = flow[i];
+    const MatchingOrder* order = engine.submit(i + 1, o.side, OrderType::LIMIT,
+                                               kScale.price(o.price), kScale.qty(o.amount), "",
+                                               now_ms);
+    if (i % kCancelEvery == 0 && order->state == OrderState::OPEN) {
+      engine.cancel(order->id, now_ms);
+    }
+  }
+  int64_t elapsed = now_ns() - start;
+
+  report(results, "matching engine", static_cast<int>(flow.size()), elapsed,
+         {{"trades", engine.trade_count()},
+          {"bid_levels", engine.bid_depth()},
+          {"ask_levels", engine.ask_depth()}});
+}
+
+std::vector<std::string> build_bodies(const std::string& instrument,
+                                      const std::vector<FlowOrder>& flow) {
+  std::vector<std::string> bodies;
+  bodies.reserve(flow.size());
+  for (const auto& o : flow) {
+    OrderRequest req(instrument, o.side, o.price, o.amount, OrderType::LIMIT, "bench");
+    bodies.push_back(deribit::build_place_order_body(req));
+  }
+  return bodies;
+}
+
+// Places every order through handle(), canceling every fourth one that rests.
+// Replies are only scanned for the ID and state, so the client side costs
+// next to nothing.
+void drive_simulator(ExchangeSimulator& sim, const std::vector<FlowOrder>& flow,
+                     const std::vector<std::string>& bodies) {
+  const std::string id_key = R"("order_id":")";
+  for (size_t i = 0; i < flow.size(); ++i) {
+    auto reply = sim.handle("POST",
+                            flow[i].side == Side::BUY ? "/api/v2/private/buy"
+                                                      : "/api/v2/private/sell",
+                            bodies[i]);
+    if (i % kCancelEvery != 0 || reply.body.find(R"("order_state":"open")") == std::string::npos) {
+      continue;
+    }
+    size_t start = reply.body.find(id_key) + id_key.size();
+    std::string order_id = reply.body.substr(start, reply.body.find('"', start) - start);
+    sim.handle("POST", "/api/v2/private/cancel", R"({"order_id":")" + order_id + "\"}");
+  }
+}
+
+void run_simulator(JsonReport& results, const std::vector<FlowOrder>& flow, int threads) {
+  ExchangeSimulator sim(nullptr, kScale);
+  std::vector<std::vector<std::string>> bodies;
+  for (int t = 0; t < threads; ++t) {
+    bodies.push_back(build_bodies("BENCH-" + std::to_string(t), flow));
+  }
+
+  std::vector<std::thread> workers;
+  int64_t start = now_ns();
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] { drive_simulator(sim, flow, bodies[t]); });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  int64_t elapsed = now_ns() - start;
+
+  report(results,
+         "simulator handle() (" + std::to_string(threads) + " thread" + (threads > 1 ? "s" : "") +
+             ", 1 instrument each)",
+         static_cast<int>(flow.size()) * threads, elapsed,
+         {{"requests_failed", sim.requests_failed()}});
+}
+
+void run_end_to_end(JsonReport& results, const std::vector<FlowOrder>& flow, size_t window) {
+  ExchangeSimulator sim(nullptr, kScale);
+  sim.add_instrument("BTC-PERPETUAL", kScale);
+
+  auto feed = std::make_shared<MarketDataFeed>("ws://127.0.0.1:1/ws/api/v2", nullptr);
+  feed->subscribe("BTC-PERPETUAL", kScale);
+  feed->process_message(sim.snapshot_notification("BTC-PERPETUAL"));
+  std::atomic<uint64_t> notifications{0};
+  sim.set_book_listener([&](const std::string& notification) {
+    notifications.fetch_add(1, std::memory_order_relaxed);
+    feed->process_message(notification);
+  });
+
+  LocalHttpServer server([&sim](const std::string& method, const std::string& target,
+                                const std::string& body) {
+    ExchangeSimulator::Reply reply = sim.handle(method, target, body);
+    return LocalHttpServer::Reply{reply.status, std::move(reply.body)};
+  });
+  server.start();
+
+  auto manager = std::make_shared<OrderManager>(nullptr, nullptr);
+  ExecutionGateway gateway("bench_key", "bench_secret", server.base_url(), nullptr, kConnections);
+  OrderRequest warmup("BTC-PERPETUAL", Side::BUY, 1.0, 10.0, OrderType::LIMIT, "WARMUP");
+  gateway.place_order(warmup); // Caches the access token
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t in_flight = 0;
+  size_t completed = 0;
+  std::atomic<int> failures{0};
+
+  int64_t start = now_ns();
+  for (size_t i = 0; i < flow.size(); ++i) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&] { return in_flight < window; });
+      ++in_flight;
+    }
+
+    const FlowOrder& o = flow[i];
+    OrderRequest req("BTC-PERPETUAL", o.side, o.price, o.amount, OrderType::LIMIT,
+                     "E2E_" + std::to_string(i));
+    OrderHandle handle = manager->create_order(req);
+    gateway.place_order_async(req, [&, handle](const ExecutionResult& result) {
+      if (result.success) {
+        manager->update_order(handle, OrderState::OPEN, result.exchange_order_id);
+      } else {
+        manager->update_order(handle, OrderState::REJECTED, "", Qty(), result.error_message);
+        failures++;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      --in_flight;
+      ++completed;
+      cv.notify_all();
+    });
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return completed == flow.size(); });
+  }
+  int64_t elapsed = now_ns() - start;
+  server.stop();
+
+  OrderBook book;
+  feed->get_book("BTC-PERPETUAL", book);
+  report(results, "end to end (window=" + std::to_string(window) + ")",
+         static_cast<int>(flow.size()), elapsed,
+         {{"failures", failures.load()},
+          {"book_updates", notifications.load()},
+          {"feed_change_id", book.sequence}});
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int orders = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  int e2e_orders = argc > 2 ? std::atoi(argv[2]) : 20000;
+  JsonReport results("bench_exchange_simulator");
+
+  std::vector<FlowOrder> flow = generate_flow(orders, 42);
+  run_engine(results, flow);
+  run_simulator(results, flow, 1);
+  unsigned threads = std::max(2u, std::min(4u, std::thread::hardware_concurrency()));
+  run_simulator(results, flow, static_cast<int>(threads));
+
+  std::vector<FlowOrder> e2e_flow = generate_flow(e2e_orders, 7);
+  for (size_t window : {16, 256}) {
+    run_end_to_end(results, e2e_flow, window);
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+// ExecutionGateway REST latency: fresh CURL handle per call vs pooled keep-alive handles.
+//
+// Runs place_order round trips against a loopback HTTP stand-in so the numbers
+// reflect connection setup cost rather than exchange or network latency.
+
+#include "BenchUtil.hpp"
+#include "LocalHttpServer.hpp"
+#include "pulseexec/ExecutionGateway.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+// Answers both public/auth and private/buy|sell with one JSON-RPC result
+LocalHttpServer::Reply canned_reply(const std::string&, const std::string&, const std::string&) {
+  return {200, R"({"jsonrpc":"2.0","id":1,"result":{"access_token":"bench_token",)"
+               R"("expires_in":3600,"order":{"order_id":"BENCH-1","order_state":"open"}}})"};
+}
+
+void run_case(JsonReport& report, const std::string& label, size_t pool_size, int iterations) {
+  LocalHttpServer server(canned_reply);
+  server.start();
+
+  ExecutionGateway gateway("bench_key", "bench_secret", server.base_url(), nullptr, pool_size);
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT, "bench");
+
+  // Warm-up (also caches the access token)
+  for (int i = 0; i < 50; ++i) {
+    gateway.place_order(req);
+  }
+
+  uint64_t connections_before = server.connections_accepted();
+  std::vector<int64_t> samples;
+  samples.reserve(iterations);
+
+  for (int i = 0; i < iterations; ++i) {
+    int64_t start = now_ns();
+    ExecutionResult result = gateway.place_order(req);
+    samples.push_back(now_ns() - start);
+    if (!result.success) {
+      std::cerr << label << ": request failed: " << result.error_message << "\n";
+      return;
+    }
+  }
+
+  uint64_t connections = server.connections_accepted() - connections_before;
+  int64_t total = 0;
+  for (int64_t s : samples) {
+    total += s;
+  }
+
+  std::cout << label << " (pool_size=" << pool_size << ")\n";
+  std::cout << "  requests:     " << iterations << "\n";
+  std::cout << "  connections:  " << connections << "\n";
+  std::cout << "  mean_us:      " << (total / iterations) / 1000.0 << "\n";
+  std::cout << "  p50_us:       " << percentile(samples, 50) / 1000.0 << "\n";
+  std::cout << "  p99_us:       " << percentile(samples, 99) / 1000.0 << "\n\n";
+  report.add(label, {{"pool_size", pool_size}, {"requests", iterations}},
+             {{"connections", connections},
+              {"mean_us", (total / iterations) / 1000.0},
+              {"p50_us", percentile(samples, 50) / 1000.0},
+              {"p99_us", percentile(samples, 99) / 1000.0}});
+
+  server.stop();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+  JsonReport report("bench_execution_gateway");
+
+  run_case(report, "per-call handle", 0, iterations);
+  run_case(report, "pooled keep-alive", 4, iterations);
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+// Book updates and price comparisons: double vs fixed-point Price/Qty.
+//
+// A 0.05-tick book receives random level updates. Inserts and resizes carry
+// prices parsed from feed text ("2999.95"); deletes carry prices derived by
+// stepping down from mid one tick at a time, the way a strategy walks the
+// book. The double book counts deletes that miss their level because the
+// walked price is not bit-equal to the parsed one; the fixed-point book only
+// misses levels that are genuinely absent. The comparison case checks orders
+// against best bid/ask for crossing.
+
+#include "BenchUtil.hpp"
+#include "pulseexec/FixedPoint.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+template <typename P, typename Q> struct Level {
+  P price;
+  Q amount;
+};
+
+// Bids sorted best (highest) first. Returns false if a delete found no level.
+template <typename P, typename Q>
+bool apply_bid(std::vector<Level<P, Q>>& bids, P price, Q amount, Q zero) {
+  auto it = std::lower_bound(bids.begin(), bids.end(), price,
+                             [](const Level<P, Q>& level, P p) { return level.price > p; });
+  bool found = it != bids.end() && it->price == price;
+  if (amount == zero) {
+    if (found) {
+      bids.erase(it);
+    }
+    return found;
+  }
+  if (found) {
+    it->amount = amount;
+  } else {
+    bids.insert(it, Level<P, Q>{price, amount});
+  }
+  return true;
+}
+
+template <typename P, typename Q> struct Update {
+  P price;
+  Q amount; // Zero = delete
+};
+
+template <typename P, typename Q>
+void run_book(JsonReport& report, const std::string& label,
+              const std::vector<Update<P, Q>>& updates, Q zero) {
+  std::vector<Level<P, Q>> bids;
+  bids.reserve(256);
+  int misses = 0;
+
+  int64_t start = now_ns();
+  for (const auto& u : updates) {
+    if (!apply_bid(bids, u.price, u.amount, zero)) {
+      ++misses;
+    }
+  }
+  int64_t elapsed = now_ns() - start;
+  int64_t ns_per_update = elapsed / static_cast<int64_t>(updates.size());
+
+  std::cout << "  " << label << " updates=" << updates.size() << " ns_per_update=" << ns_per_update
+            << " levels=" << bids.size() << " missed_deletes=" << misses << "\n";
+  report.add("book " + label, {{"updates", updates.size()}},
+             {{"ns_per_update", ns_per_update},
+              {"levels", bids.size()},
+              {"missed_deletes", misses}});
+}
+
+template <typename P>
+void run_compare(JsonReport& report, const std::string& label, const std::vector<P>& orders,
+                 P best_bid, P best_ask) {
+  int64_t crossing = 0;
+  int64_t start = now_ns();
+  for (int rep = 0; rep < 100; ++rep) {
+    for (const P& price : orders) {
+      crossing += (price >= best_ask) + (price <= best_bid);
+    }
+  }
+  int64_t elapsed = now_ns() - start;
+  double ns_per_compare = static_cast<double>(elapsed) / (orders.size() * 200.0);
+
+  std::cout << "  " << label << " comparisons=" << orders.size() * 200
+            << " ns_per_compare=" << ns_per_compare << " crossing=" << crossing << "\n";
+  report.add("compare " + label, {{"comparisons", orders.size() * 200}},
+             {{"ns_per_compare", ns_per_compare}});
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  JsonReport report("bench_fixed_point");
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> tick_dist(0, 199);
+  std::uniform_int_distribution<int> lot_dist(0, 5);
+
+  const double mid = 3000.0;
+  const double tick = 0.05;
+  const InstrumentScale scale{2, 0, Price(0.05, 2), Qty(1.0, 0)};
+  const Price fixed_mid = scale.price(mid);
+  const Price fixed_tick = scale.tick_size;
+
+  // Prepared up front so only the book update is timed
+  std::vector<Update<double, double>> double_updates;
+  std::vector<Update<Price, Qty>> fixed_updates;
+  for (int i = 0; i < count; ++i) {
+    int k = tick_dist(rng);
+    int lots = lot_dist(rng);
+    Price fixed_price = fixed_mid - Price::from_mantissa(k * fixed_tick.mantissa(), 2);
+    double feed_price = std::strtod(fixed_price.to_string().c_str(), nullptr);
+    double walked_price = mid;
+    for (int step = 0; step < k; ++step) {
+      walked_price -= tick;
+    }
+    double_updates.push_back({lots == 0 ? walked_price : feed_price, lots * 1.0});
+    fixed_updates.push_back({fixed_price, Qty::from_mantissa(lots, 0)});
+  }
+
+  std::cout << "Book updates\n";
+  run_book<double, double>(report, "double", double_updates, 0.0);
+  run_book<Price, Qty>(report, "fixed", fixed_updates, Qty::from_mantissa(0, 0));
+
+  std::vector<double> double_orders;
+  std::vector<Price> fixed_orders;
+  for (int i = 0; i < 10000; ++i) {
+    int k = tick_dist(rng) - 100;
+    double_orders.push_back(mid + k * tick);
+    fixed_orders.push_back(Price::from_mantissa(fixed_mid.mantissa() + k * 5, 2));
+  }
+
+  std::cout << "Order comparisons\n";
+  run_compare<double>(report, "double", double_orders, mid - tick, mid + tick);
+  run_compare<Price>(report, "fixed", fixed_orders, fixed_mid - fixed_tick, fixed_mid + fixed_tick);
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+// ExecutionGateway request build / response parse cost, without any transport.
+//
+// Times the Deribit JSON-RPC encode of a limit order and the decode of a
+// typical private/buy response, i.e. the CPU work place_order adds on top of
+// the HTTP round trip. Each sample covers a batch of calls so clock overhead
+// stays out of the per-call figure.
+//
+// Encoding is measured three ways: through a nlohmann::json DOM as the
+// gateway used to (kept here as the baseline), through the build_* functions,
+// which return a copy, and through the RequestWriter the gateway now uses.
+// Heap allocations per call are counted by replacing operator new.
+
+#include "BenchUtil.hpp"
+#include "pulseexec/DeribitCodec.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+}
+
+void* operator new(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+// GCC flags the free() as mismatched once operator new is inlined into it
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+constexpr int kBatch = 100;
+
+// Order section trimmed from a Deribit testnet private/buy response
+const std::string kPlaceOrderResponse =
+    R"({"jsonrpc":"2.0","id":1,"usIn":1700000000000000,"usOut":1700000000000250,)"
+    R"("usDiff":250,"testnet":true,"result":{"trades":[],"order":{"web":false,)"
+    R"("time_in_force":"good_til_cancelled","replaced":false,"reduce_only":false,)"
+    R"("price":50000.0,"post_only":false,"order_type":"limit","order_state":"open",)"
+    R"("order_id":"ETH-584849853","max_show":10.0,"last_update_timestamp":1700000000000,)"
+    R"("label":"ORDER_1700000000000_1","is_liquidation":false,"instrument_name":)"
+    R"("BTC-PERPETUAL","filled_amount":0.0,"direction":"buy","creation_timestamp":)"
+    R"(1700000000000,"average_price":0.0,"api":true,"amount":10.0}}})";
+
+// The gateway's encoding before RequestWriter: a params DOM, dumped
+std::string dom_place_order_body(const OrderRequest& request) {
+  nlohmann::json params;
+  params["instrument_name"] = request.symbol;
+  params["amount"] = request.amount.to_double();
+  params["type"] = to_string(request.type);
+  if (request.type == OrderType::LIMIT) {
+    params["price"] = request.price.to_double();
+  }
+  if (!request.client_order_id.empty()) {
+    params["label"] = request.client_order_id;
+  }
+  return deribit::build_jsonrpc_request(request.side == Side::BUY ? "private/buy" : "private/sell",
+                                        params);
+}
+
+std::string dom_order_id_body(const std::string& exchange_order_id) {
+  nlohmann::json j;
+  j["order_id"] = exchange_order_id;
+  return j.dump();
+}
+
+std::string dom_modify_order_body(const std::string& exchange_order_id, Price new_price,
+                                  Qty new_amount) {
+  nlohmann::json j;
+  j["order_id"] = exchange_order_id;
+  j["amount"] = new_amount.to_double();
+  j["price"] = new_price.to_double();
+  return j.dump();
+}
+
+template <typename Fn>
+void run_case(JsonReport& report, const std::string& label, int iterations, Fn&& fn) {
+  std::vector<int64_t> samples;
+  samples.reserve(iterations / kBatch + 1);
+  size_t sink = fn(); // Warm-up: lets reusable buffers reach their size
+
+  uint64_t allocations = g_allocations.load(std::memory_order_relaxed);
+  for (int i = 0; i < iterations; i += kBatch) {
+    int64_t start = now_ns();
+    for (int j = 0; j < kBatch; ++j) {
+      sink += fn();
+    }
+    samples.push_back((now_ns() - start) / kBatch);
+  }
+  // Includes the samples vector, which was reserved up front
+  double allocs_per_call =
+      static_cast<double>(g_allocations.load(std::memory_order_relaxed) - allocations) /
+      (static_cast<double>(samples.size()) * kBatch);
+
+  int64_t p50 = percentile(samples, 50);
+  int64_t p99 = percentile(samples, 99);
+  std::cout << "  " << label << " p50_ns=" << p50 << " p99_ns=" << p99
+            << " allocs_per_call=" << allocs_per_call << (sink == 0 ? " (empty output)" : "")
+            << "\n";
+  report.add(label, {{"iterations", iterations}},
+             {{"p50_ns", p50}, {"p99_ns", p99}, {"allocs_per_call", allocs_per_call}});
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+  JsonReport report("bench_gateway_codec");
+
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT,
+                   "ORDER_1700000000000_1");
+
+  const std::string order_id = "ETH-584849853";
+  deribit::RequestWriter writer;
+
+  std::cout << "Deribit codec, per call\n";
+  run_case(report, "place_order (json DOM)", iterations,
+           [&] { return dom_place_order_body(req).size(); });
+  run_case(report, "place_order (build_place_order_body)", iterations,
+           [&] { return deribit::build_place_order_body(req).size(); });
+  run_case(report, "place_order (RequestWriter)", iterations,
+           [&] { return writer.place_order(req).size(); });
+
+  run_case(report, "cancel_order (json DOM)", iterations,
+           [&] { return dom_order_id_body(order_id).size(); });
+  run_case(report, "cancel_order (RequestWriter)", iterations,
+           [&] { return writer.cancel_order(order_id).size(); });
+
+  run_case(report, "modify_order (json DOM)", iterations, [&] {
+    return dom_modify_order_body(order_id, Price(50010.5), Qty(20.0)).size();
+  });
+  run_case(report, "modify_order (RequestWriter)", iterations, [&] {
+    return writer.modify_order(order_id, Price(50010.5), Qty(20.0)).size();
+  });
+
+  run_case(report, "parse_place_order", iterations, [&] {
+    return deribit::parse_place_order_response(200, true, kPlaceOrderResponse)
+        .exchange_order_id.size();
+  });
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+// Logger producer-side latency under contention.
+//
+// Each producer thread times one "Created order" log call, the way
+// OrderManager issues it. Three paths are compared:
+//   event - log_event with a static format id and raw args (deferred formatting)
+//   ring  - string concatenation + log() into the lock-free ring
+//   mutex - string concatenation + the previous enqueue path (mutex + std::queue
+//           + condvar notify), reproduced here since Logger no longer contains it
+
+#include "BenchUtil.hpp"
+#include "pulseexec/Logger.hpp"
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+// The pre-ring Logger enqueue path, drained by its own consumer thread
+class MutexQueueBaseline {
+public:
+  explicit MutexQueueBaseline(size_t capacity) : capacity_(capacity) {
+    consumer_ = std::thread([this] {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (running_ || !queue_.empty()) {
+        cv_.wait(lock, [this] { return !queue_.empty() || !running_; });
+        while (!queue_.empty()) {
+          queue_.pop();
+        }
+      }
+    });
+  }
+
+  ~MutexQueueBaseline() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_ = false;
+    }
+    cv_.notify_one();
+    consumer_.join();
+  }
+
+  void log(LogLevel level, const std::string& component, const std::string& message) {
+    LogMessage msg(level, component, message, now_ns() / 1000);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queue_.size() >= capacity_) {
+        return;
+      }
+      queue_.push(std::move(msg));
+    }
+    cv_.notify_one();
+  }
+
+private:
+  size_t capacity_;
+  std::queue<LogMessage> queue_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool running_ = true;
+  std::thread consumer_;
+};
+
+template <typename LogFn>
+void run_case(JsonReport& report, const std::string& label, int threads, int messages_per_thread,
+              LogFn&& log_fn) {
+  std::vector<std::vector<int64_t>> per_thread(threads);
+  std::vector<std::thread> producers;
+
+  for (int t = 0; t < threads; ++t) {
+    producers.emplace_back([&, t] {
+      auto& samples = per_thread[t];
+      samples.reserve(messages_per_thread);
+      std::string client_order_id = "ORDER_1700000000000_" + std::to_string(t);
+      for (int i = 0; i < messages_per_thread; ++i) {
+        int64_t start = now_ns();
+        log_fn(client_order_id);
+        samples.push_back(now_ns() - start);
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  std::vector<int64_t> all;
+  for (auto& samples : per_thread) {
+    all.insert(all.end(), samples.begin(), samples.end());
+  }
+
+  int64_t p50 = percentile(all, 50);
+  int64_t p99 = percentile(all, 99);
+  std::cout << "  " << label << " threads=" << threads << " p50_ns=" << p50 << " p99_ns=" << p99
+            << "\n";
+  report.add(label, {{"threads", threads}, {"messages_per_thread", messages_per_thread}},
+             {{"p50_ns", p50}, {"p99_ns", p99}});
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int messages_per_thread = argc > 1 ? std::atoi(argv[1]) : 20000;
+  const size_t capacity = 1 << 16;
+  const std::string symbol = "BTC-PERPETUAL";
+  JsonReport report("bench_logger");
+
+  for (int threads : {1, 2, 4, 8, 16}) {
+    {
+      Logger logger("/dev/null", capacity);
+      logger.start();
+      run_case(report, "event", threads, messages_per_thread, [&](const std::string& id) {
+        logger.log_event(LogLevel::INFO, LogFormatId::ORDER_CREATED, id, symbol);
+      });
+      logger.stop();
+    }
+    {
+      Logger logger("/dev/null", capacity);
+      logger.start();
+      run_case(report, "ring", threads, messages_per_thread, [&](const std::string& id) {
+        logger.log(LogLevel::INFO, "OrderManager", "Created order: " + id + " for " + symbol);
+      });
+      logger.stop();
+    }
+    {
+      MutexQueueBaseline baseline(capacity);
+      run_case(report, "mutex", threads, messages_per_thread, [&](const std::string& id) {
+        baseline.log(LogLevel::INFO, "OrderManager", "Created order: " + id + " for " + symbol);
+      });
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+// MarketDataFeed throughput: book updates applied per second.
+//
+// A synthetic BTC-PERPETUAL session (one snapshot, then chained changes that
+// insert, resize and delete levels near the top of the book) is generated up
+// front. It is applied twice: replayed in-process through process_message
+// (JSON parse plus book update only), and streamed from a loopback WebSocket
+// stand-in to a connected feed (adds framing, socket reads, the I/O thread and
+// a top-10 copy per update for the book handler).
+
+#include "BenchUtil.hpp"
+#include "LocalWebSocketServer.hpp"
+#include "pulseexec/MarketDataFeed.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+using json = nlohmann::json;
+
+namespace {
+
+const std::string kChannel = "book.BTC-PERPETUAL.100ms";
+const InstrumentScale kScale{1, 0, Price(0.5, 1), Qty(10.0, 0)};
+
+std::string notification(json data) {
+  json message = {{"jsonrpc", "2.0"},
+                  {"method", "subscription"},
+                  {"params", {{"channel", kChannel}, {"data", std::move(data)}}}};
+  return message.dump();
+}
+
+// Snapshot plus `changes` chained change messages
+std::vector<std::string> generate_session(int changes) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> offset_dist(1, 200);
+  std::uniform_int_distribution<int> amount_dist(1, 500);
+  std::uniform_int_distribution<int> action_dist(0, 2);
+
+  // Prices in half-dollar ticks
+  std::map<int, int> bids;
+  std::map<int, int> asks;
+  int mid = 100000;
+  for (int i = 1; i <= 200; ++i) {
+    bids[mid - i] = amount_dist(rng) * 10;
+    asks[mid + i] = amount_dist(rng) * 10;
+  }
+
+  auto levels = [](const std::map<int, int>& side) {
+    json out = json::array();
+    for (const auto& [tick, amount] : side) {
+      out.push_back({"new", tick * 0.5, amount});
+    }
+    return out;
+  };
+
+  std::vector<std::string> session;
+  session.push_back(notification({{"type", "snapshot"},
+                                  {"timestamp", 1700000000000},
+                                  {"change_id", 1},
+                                  {"bids", levels(bids)},
+                                  {"asks", levels(asks)}}));
+
+  for (int i = 0; i < changes; ++i) {
+    json bid_updates = json::array();
+    json ask_updates = json::array();
+
+    bool bid_side = i % 2 == 0;
+    auto& side = bid_side ? bids : asks;
+    json& updates = bid_side ? bid_updates : ask_updates;
+    int tick = bid_side ? mid - offset_dist(rng) : mid + offset_dist(rng);
+
+    auto it = side.find(tick);
+    int action = action_dist(rng);
+    if (it == side.end()) {
+      int amount = amount_dist(rng) * 10;
+      side[tick] = amount;
+      updates.push_back({"new", tick * 0.5, amount});
+    } else if (action == 0) {
+      side.erase(it);
+      updates.push_back({"delete", tick * 0.5, 0});
+    } else {
+      it->second = amount_dist(rng) * 10;
+      updates.push_back({"change", tick * 0.5, it->second});
+    }
+
+    session.push_back(notification({{"type", "change"},
+                                    {"timestamp", 1700000000000 + i},
+                                    {"change_id", i + 2},
+                                    {"prev_change_id", i + 1},
+                                    {"bids", bid_updates},
+                                    {"asks", ask_updates}}));
+  }
+  return session;
+}
+
+void report(JsonReport& results, const std::string& label, size_t updates, int64_t elapsed_ns,
+            const MarketDataFeed& feed) {
+  auto stats = feed.stats();
+  double seconds = static_cast<double>(elapsed_ns) / 1e9;
+  int64_t updates_per_sec = static_cast<int64_t>(static_cast<double>(updates) / seconds);
+  int64_t ns_per_update = elapsed_ns / static_cast<int64_t>(updates);
+  std::cout << "  " << label << " updates=" << updates << " updates_per_sec=" << updates_per_sec
+            << " ns_per_update=" << ns_per_update << " applied=" << stats.deltas_applied
+            << " gaps=" << stats.gaps << "\n";
+  results.add(label, {{"updates", updates}},
+           {{"updates_per_sec", updates_per_sec},
+            {"ns_per_update", ns_per_update},
+            {"applied", stats.deltas_applied},
+            {"gaps", stats.gaps}});
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int changes = argc > 1 ? std::atoi(argv[1]) : 200000;
+  std::vector<std::string> session = generate_session(changes);
+  std::cout << "MarketDataFeed, " << session.size() << " messages\n";
+  JsonReport results("bench_market_data_feed");
+
+  {
+    MarketDataFeed feed("ws://127.0.0.1:1/ws/api/v2", nullptr);
+    feed.subscribe("BTC-PERPETUAL", kScale);
+
+    int64_t start = now_ns();
+    for (const auto& message : session) {
+      feed.process_message(message);
+    }
+    report(results, "in-process", session.size(), now_ns() - start, feed);
+  }
+
+  {
+    testing::LocalWebSocketServer server([&](const std::string& text) {
+      auto request = json::parse(text);
+      std::vector<std::string> replies{
+          json{{"jsonrpc", "2.0"}, {"id", request["id"]}, {"result", json::array({kChannel})}}
+              .dump()};
+      if (request["method"] == "public/subscribe") {
+        replies.insert(replies.end(), session.begin(), session.end());
+      }
+      return replies;
+    });
+    server.start();
+
+    MarketDataFeed feed(server.url(), nullptr);
+    feed.subscribe("BTC-PERPETUAL", kScale);
+
+    // Time from the snapshot being applied to the last change being applied
+    std::atomic<int64_t> first_ns{0};
+    std::atomic<int64_t> last_ns{0};
+    feed.set_book_handler([&](const OrderBook& book) {
+      if (book.sequence == 1) {
+        first_ns = now_ns();
+      } else if (book.sequence == session.size()) {
+        last_ns = now_ns();
+      }
+    });
+    feed.start();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (last_ns.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    feed.stop();
+    server.stop();
+
+    if (last_ns.load() == 0) {
+      std::cout << "  websocket timed out, applied=" << feed.stats().deltas_applied << "\n";
+      return 1;
+    }
+    report(results, "websocket", session.size() - 1, last_ns - first_ns, feed);
+  }
+
+  return 0;
+}
@@ -0,0 +1,108 @@
+// OrderJournal append latency and throughput from 1 to 16 threads.
+//
+// With fsync each append waits for the group commit that covers it, so the
+// interesting numbers are how many appends share one fdatasync (appends per
+// sync) and what that does to per-append latency. Without fsync an append is
+// an encode plus memcpy into the mapping. Each thread journals its own orders
+// through the lifecycle pending -> open -> partial -> filled.
+
+#include "BenchUtil.hpp"
+#include "pulseexec/OrderJournal.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+void run_case(JsonReport& report, const std::string& path, bool fsync, int threads,
+              int appends_per_thread) {
+  std::remove(path.c_str());
+
+  OrderJournalOptions options;
+  options.fsync = fsync;
+  OrderJournal journal(path, nullptr, options);
+  if (!journal.open()) {
+    std::cerr << "failed to open " << path << "\n";
+    return;
+  }
+
+  const OrderState lifecycle[] = {OrderState::PENDING, OrderState::OPEN, OrderState::PARTIAL,
+                                  OrderState::FILLED};
+  std::vector<std::vector<int64_t>> latencies(threads);
+  std::vector<std::thread> workers;
+
+  int64_t start = now_ns();
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT);
+      Order order("T" + std::to_string(t) + "_0", req, 0);
+      latencies[t].reserve(appends_per_thread);
+      for (int i = 0; i < appends_per_thread; ++i) {
+        if (i % 4 == 0) {
+          order.client_order_id = "T" + std::to_string(t) + "_" + std::to_string(i / 4);
+        }
+        order.state = lifecycle[i % 4];
+        int64_t begin = now_ns();
+        journal.append(order);
+        latencies[t].push_back(now_ns() - begin);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  int64_t elapsed_ns = now_ns() - start;
+
+  std::vector<int64_t> all;
+  for (auto& samples : latencies) {
+    all.insert(all.end(), samples.begin(), samples.end());
+  }
+  uint64_t appends = journal.last_sequence();
+  double seconds = static_cast<double>(elapsed_ns) / 1e9;
+  int64_t appends_per_sec = static_cast<int64_t>(appends / seconds);
+  double appends_per_sync =
+      journal.sync_count() > 0 ? static_cast<double>(appends) / journal.sync_count() : 0.0;
+  int64_t p50_ns = percentile(all, 50);
+  int64_t p99_ns = percentile(all, 99);
+
+  std::string label = std::string(fsync ? "fsync" : "no fsync") + ", " + std::to_string(threads) +
+                      (threads == 1 ? " thread" : " threads");
+  std::cout << label << "\n";
+  std::cout << "  appends:          " << appends << "\n";
+  std::cout << "  appends_per_sec:  " << appends_per_sec << "\n";
+  std::cout << "  appends_per_sync: " << appends_per_sync << "\n";
+  std::cout << "  p50_us:           " << p50_ns / 1000.0 << "\n";
+  std::cout << "  p99_us:           " << p99_ns / 1000.0 << "\n\n";
+  report.add("append", {{"fsync", fsync}, {"threads", threads}},
+             {{"appends", appends},
+              {"appends_per_sec", appends_per_sec},
+              {"appends_per_sync", appends_per_sync},
+              {"p50_ns", p50_ns},
+              {"p99_ns", p99_ns}});
+
+  journal.close();
+  std::remove(path.c_str());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int appends = argc > 1 ? std::atoi(argv[1]) : 20000;
+  std::string path = argc > 2 ? argv[2] : "./bench_order_journal.bin";
+  JsonReport report("bench_order_journal");
+
+  for (bool fsync : {false, true}) {
+    for (int threads : {1, 4, 16}) {
+      // Fixed total, so the fsync cases stay short on slow disks
+      run_case(report, path, fsync, threads, std::max(1, appends / threads));
+    }
+  }
+
+  return 0;
+}
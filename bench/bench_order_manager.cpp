@@ -0,0 +1,84 @@
+// OrderManager create/update/get throughput from 1 to 32 threads.
+//
+// Each thread creates its own orders, then runs a mixed loop of updates and
+// lookups over them (1 update : 4 gets). Three paths are compared:
+//   handle    - internal OrderHandle lookups (array index, no hashing)
+//   client_id - string client_order_id lookups through the sharded index
+//   1 shard   - string lookups with every key on one lock, like the old map_mutex_
+// Logger and DBWriter are disabled so only the order store is measured.
+
+#include "BenchUtil.hpp"
+#include "pulseexec/OrderManager.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+template <typename Key>
+void run_case(JsonReport& report, const std::string& label, size_t shards, int threads,
+              int orders_per_thread, int rounds) {
+  OrderManager manager(nullptr, nullptr, shards);
+  std::vector<std::thread> workers;
+
+  int64_t start = now_ns();
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      std::vector<Key> ids;
+      ids.reserve(orders_per_thread);
+      for (int i = 0; i < orders_per_thread; ++i) {
+        std::string id = "T" + std::to_string(t) + "_" + std::to_string(i);
+        OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT, id);
+        OrderHandle handle = manager.create_order(req);
+        if constexpr (std::is_same_v<Key, OrderHandle>) {
+          ids.push_back(handle);
+        } else {
+          ids.push_back(id);
+        }
+      }
+
+      Order order;
+      const Qty filled(0.5);
+      for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < ids.size(); ++i) {
+          if ((i + r) % 5 == 0) {
+            manager.update_order(ids[i], OrderState::OPEN, "", filled);
+          } else {
+            manager.get_order(ids[i], order);
+          }
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  int64_t elapsed = now_ns() - start;
+
+  double ops = static_cast<double>(threads) * orders_per_thread * (1 + rounds);
+  int64_t ops_per_s = static_cast<int64_t>(ops * 1e9 / elapsed);
+  std::cout << "  " << label << " threads=" << threads << " ops_per_s=" << ops_per_s << "\n";
+  report.add(label, {{"threads", threads}, {"shards", shards}}, {{"ops_per_s", ops_per_s}});
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int orders_per_thread = argc > 1 ? std::atoi(argv[1]) : 2000;
+  int rounds = argc > 2 ? std::atoi(argv[2]) : 10;
+  JsonReport report("bench_order_manager");
+
+  for (int threads : {1, 2, 4, 8, 16, 32}) {
+    run_case<OrderHandle>(report, "handle", 64, threads, orders_per_thread, rounds);
+    run_case<std::string>(report, "client_id", 64, threads, orders_per_thread, rounds);
+    run_case<std::string>(report, "1 shard", 1, threads, orders_per_thread, rounds);
+  }
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+// Warm-start recovery time: how long a restart takes to bring open orders back
+// from SQLite into OrderManager, and to confirm them with the exchange.
+//
+// load+restore reads every non-terminal row of the orders table in one scan
+// and bulk-publishes them (a quarter of the persisted orders are terminal and
+// must be skipped). reconcile runs get_order_state for each restored order
+// against a loopback stand-in that reports every other order as filled, with
+// a fixed service delay per request.
+
+#include "BenchUtil.hpp"
+#include "LocalHttpServer.hpp"
+#include "pulseexec/DBWriter.hpp"
+#include "pulseexec/ExecutionGateway.hpp"
+#include "pulseexec/Logger.hpp"
+#include "pulseexec/OrderManager.hpp"
+#include "pulseexec/OrderRecovery.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+constexpr size_t kConnections = 16;
+
+void remove_db(const std::string& db_path) {
+  std::remove(db_path.c_str());
+  std::remove((db_path + "-wal").c_str());
+  std::remove((db_path + "-shm").c_str());
+}
+
+// Writes open orders plus one terminal order for every three open ones
+void populate(const std::string& db_path, std::shared_ptr<Logger> logger, int open_orders) {
+  remove_db(db_path);
+  DBWriter writer(db_path, logger, 1 << 20, 4096);
+  writer.start();
+
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT);
+  int total = open_orders + open_orders / 3;
+  for (int i = 0; i < total; ++i) {
+    Order order("RECOVER_" + std::to_string(i), req, i);
+    order.exchange_order_id = "EX-" + std::to_string(i);
+    order.state = i % 4 == 3 ? OrderState::FILLED : OrderState::OPEN;
+    writer.write_order(order);
+  }
+  writer.stop();
+}
+
+LocalHttpServer::Handler exchange_reply(int latency_us) {
+  return [latency_us](const std::string&, const std::string& target, const std::string& body) {
+    std::this_thread::sleep_for(std::chrono::microseconds(latency_us));
+    if (target.find("get_order_state") == std::string::npos) {
+      return LocalHttpServer::Reply{
+          200, R"({"jsonrpc":"2.0","id":1,"result":{"access_token":"bench_token",)"
+               R"("expires_in":3600}})"};
+    }
+
+    std::string order_id = nlohmann::json::parse(body, nullptr, false).value("order_id", "");
+    bool filled = !order_id.empty() && (order_id.back() - '0') % 2 == 0;
+    nlohmann::json result = {{"order_id", order_id},
+                             {"instrument_name", "BTC-PERPETUAL"},
+                             {"direction", "buy"},
+                             {"price", 50000.0},
+                             {"amount", 10.0},
+                             {"order_type", "limit"},
+                             {"order_state", filled ? "filled" : "open"},
+                             {"filled_amount", filled ? 10.0 : 0.0}};
+    return LocalHttpServer::Reply{
+        200, nlohmann::json{{"jsonrpc", "2.0"}, {"id", 1}, {"result", result}}.dump()};
+  };
+}
+
+void report(JsonReport& results, const std::string& label, int open_orders,
+            const RecoveryStats& stats) {
+  int64_t elapsed_us = stats.load_us + stats.reconcile_us;
+  int64_t orders_per_sec =
+      elapsed_us > 0 ? static_cast<int64_t>(stats.restored * 1e6 / elapsed_us) : 0;
+  std::cout << label << "\n";
+  std::cout << "  restored:        " << stats.restored << "\n";
+  std::cout << "  load_us:         " << stats.load_us << "\n";
+  std::cout << "  reconcile_us:    " << stats.reconcile_us << "\n";
+  std::cout << "  confirmed:       " << stats.confirmed << "\n";
+  std::cout << "  updated:         " << stats.updated << "\n";
+  std::cout << "  unconfirmed:     " << stats.unconfirmed << "\n";
+  std::cout << "  orders_per_sec:  " << orders_per_sec << "\n\n";
+  results.add(label, {{"open_orders", open_orders}},
+              {{"restored", stats.restored},
+               {"load_us", stats.load_us},
+               {"reconcile_us", stats.reconcile_us},
+               {"confirmed", stats.confirmed},
+               {"updated", stats.updated},
+               {"unconfirmed", stats.unconfirmed},
+               {"orders_per_sec", orders_per_sec}});
+}
+
+void run_restore(JsonReport& results, int open_orders) {
+  std::string db_path = "/tmp/pulseexec_bench_recovery.db";
+  auto logger = std::make_shared<Logger>();
+  populate(db_path, logger, open_orders);
+
+  auto db_writer = std::make_shared<DBWriter>(db_path, logger);
+  db_writer->start();
+  auto manager = std::make_shared<OrderManager>(logger, db_writer);
+
+  OrderRecovery recovery(logger, db_writer, manager, nullptr);
+  report(results, "load+restore", open_orders, recovery.run(std::chrono::milliseconds(0)));
+
+  db_writer->stop();
+  remove_db(db_path);
+}
+
+void run_reconcile(JsonReport& results, int open_orders, int latency_us, size_t window) {
+  std::string db_path = "/tmp/pulseexec_bench_recovery_reconcile.db";
+  auto logger = std::make_shared<Logger>();
+  populate(db_path, logger, open_orders);
+
+  LocalHttpServer server(exchange_reply(latency_us));
+  server.start();
+
+  auto db_writer = std::make_shared<DBWriter>(db_path, logger);
+  db_writer->start();
+  auto manager = std::make_shared<OrderManager>(logger, db_writer);
+  auto gateway = std::make_shared<ExecutionGateway>("bench_key", "bench_secret",
+                                                    server.base_url(), nullptr, kConnections);
+
+  OrderRecovery recovery(logger, db_writer, manager, gateway, window);
+  report(results, "load+restore+reconcile (window=" + std::to_string(window) + ")", open_orders,
+         recovery.run(std::chrono::seconds(60)));
+
+  db_writer->stop();
+  remove_db(db_path);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int open_orders = argc > 1 ? std::atoi(argv[1]) : 100000;
+  int reconcile_orders = argc > 2 ? std::atoi(argv[2]) : 2000;
+  int latency_us = argc > 3 ? std::atoi(argv[3]) : 500;
+  JsonReport results("bench_order_recovery");
+
+  run_restore(results, open_orders);
+
+  std::cout << "simulated exchange latency: " << latency_us << "us, connections: " << kConnections
+            << "\n\n";
+  for (size_t window : {16, 64}) {
+    run_reconcile(results, reconcile_orders, latency_us, window);
+  }
+
+  return 0;
+}
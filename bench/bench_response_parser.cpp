@@ -0,0 +1,224 @@
+// Response decode cost: nlohmann::json DOM against the on-demand JsonScanner.
+//
+// Payloads are shaped like the exchange's: public/get_order_book results with
+// the full set of ticker fields around 10, 100 and 1000 levels a side, book
+// subscription snapshots of the same depths, and the private/buy and
+// get_order_state results the gateway reads. Each is decoded the way the
+// code did before JsonScanner (kept here as the baseline) and the way it does
+// now. The snapshot case goes through MarketDataFeed::process_message, so the
+// scanner figure also includes rebuilding the book from the snapshot.
+
+#include "BenchUtil.hpp"
+#include "pulseexec/DeribitCodec.hpp"
+#include "pulseexec/MarketDataFeed.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+using json = nlohmann::json;
+
+namespace {
+
+const InstrumentScale kScale{1, 0, Price(0.5, 1), Qty(10.0, 0)};
+
+const std::string kPlaceOrderResponse =
+    R"({"jsonrpc":"2.0","id":1,"result":{"trades":[],"order":{"web":false,"time_in_force":)"
+    R"("good_til_cancelled","replaced":false,"reduce_only":false,"profit_loss":0.0,"price":)"
+    R"(50000.0,"post_only":false,"order_type":"limit","order_state":"open","order_id":)"
+    R"("ETH-584849853","max_show":10.0,"last_update_timestamp":1550657341322,"label":)"
+    R"("BENCH_1","is_liquidation":false,"instrument_name":"BTC-PERPETUAL","filled_amount":0.0,)"
+    R"("direction":"buy","creation_timestamp":1550657341322,"commission":0.0,"average_price":)"
+    R"(0.0,"api":true,"amount":10.0}},"usIn":1550657341322164,"usOut":1550657341322544,)"
+    R"("usDiff":380,"testnet":false})";
+
+const std::string kOrderStateResponse =
+    R"({"jsonrpc":"2.0","id":1,"result":{"time_in_force":"good_til_cancelled","reduce_only":)"
+    R"(false,"profit_loss":0.0,"price":50000.0,"post_only":false,"order_type":"limit",)"
+    R"("order_state":"open","order_id":"ETH-584849853","max_show":10.0,)"
+    R"("last_update_timestamp":1550657341322,"label":"BENCH_1","is_liquidation":false,)"
+    R"("instrument_name":"BTC-PERPETUAL","filled_amount":2.0,"direction":"buy",)"
+    R"("creation_timestamp":1550657341322,"commission":0.0,"average_price":50000.0,"api":)"
+    R"(true,"amount":10.0},"usIn":1550657341322164,"usOut":1550657341322544,"usDiff":380,)"
+    R"("testnet":false})";
+
+// [[price, amount], ...] or [["new", price, amount], ...] around a 50000 mid
+json levels(std::mt19937& rng, size_t depth, int direction, bool with_action) {
+  std::uniform_int_distribution<int> lots(1, 5000);
+  json out = json::array();
+  for (size_t i = 0; i < depth; ++i) {
+    double price = 50000.0 + direction * (0.5 + static_cast<double>(i) * 0.5);
+    double amount = lots(rng) * 10.0;
+    out.push_back(with_action ? json{"new", price, amount} : json{price, amount});
+  }
+  return out;
+}
+
+std::string order_book_response(size_t depth) {
+  std::mt19937 rng(static_cast<unsigned>(depth));
+  json result = {{"timestamp", 1700000000000},
+                 {"stats", {{"volume_usd", 1.2e9}, {"volume", 24111.7}, {"price_change", -0.52},
+                            {"low", 49600.5}, {"high", 50400.0}}},
+                 {"state", "open"},
+                 {"settlement_price", 49980.25},
+                 {"open_interest", 754512340},
+                 {"min_price", 49250.0},
+                 {"max_price", 50750.0},
+                 {"mark_price", 50000.21},
+                 {"last_price", 50000.5},
+                 {"instrument_name", "BTC-PERPETUAL"},
+                 {"index_price", 50001.18},
+                 {"funding_8h", 0.00001},
+                 {"estimated_delivery_price", 50001.18},
+                 {"current_funding", 0.0},
+                 {"change_id", 61734530562},
+                 {"bids", levels(rng, depth, -1, false)},
+                 {"best_bid_price", 49999.5},
+                 {"best_bid_amount", 1000.0},
+                 {"best_ask_price", 50000.5},
+                 {"best_ask_amount", 1200.0},
+                 {"asks", levels(rng, depth, 1, false)}};
+  return json{{"jsonrpc", "2.0"}, {"id", 1}, {"result", result},
+              {"usIn", 1700000000000123}, {"usOut", 1700000000000456}, {"usDiff", 333},
+              {"testnet", false}}
+      .dump();
+}
+
+std::string book_snapshot(size_t depth) {
+  std::mt19937 rng(static_cast<unsigned>(depth) + 1);
+  json data = {{"type", "snapshot"},
+               {"timestamp", 1700000000000},
+               {"instrument_name", "BTC-PERPETUAL"},
+               {"change_id", 61734530562},
+               {"bids", levels(rng, depth, -1, true)},
+               {"asks", levels(rng, depth, 1, true)}};
+  return json{{"jsonrpc", "2.0"},
+              {"method", "subscription"},
+              {"params", {{"channel", "book.BTC-PERPETUAL.100ms"}, {"data", data}}}}
+      .dump();
+}
+
+// ExecutionGateway::get_orderbook before JsonScanner
+size_t dom_order_book(const std::string& body, OrderBook& book) {
+  json response = json::parse(body);
+  const json& result = response["result"];
+  book.bids.clear();
+  book.asks.clear();
+  for (const auto& bid : result["bids"]) {
+    book.bids.emplace_back(book.scale.price(bid[0].get<double>()),
+                           book.scale.qty(bid[1].get<double>()));
+  }
+  for (const auto& ask : result["asks"]) {
+    book.asks.emplace_back(book.scale.price(ask[0].get<double>()),
+                           book.scale.qty(ask[1].get<double>()));
+  }
+  book.timestamp_us = result.value("timestamp", 0L);
+  return book.bids.size() + book.asks.size();
+}
+
+// MarketDataFeed's book notification decode before JsonScanner
+size_t dom_book_snapshot(const std::string& text, BookDelta& delta) {
+  json message = json::parse(text);
+  const json& data = message["params"]["data"];
+  delta.bids.clear();
+  delta.asks.clear();
+  delta.snapshot = data.value("type", "") == "snapshot";
+  delta.change_id = data["change_id"].get<uint64_t>();
+  delta.timestamp_us = data.value("timestamp", int64_t(0)) * 1000;
+  for (auto* side : {&delta.bids, &delta.asks}) {
+    for (const auto& level : data[side == &delta.bids ? "bids" : "asks"]) {
+      LevelUpdate update;
+      update.price = kScale.price(level[1].get<double>());
+      update.amount = kScale.qty(level[2].get<double>());
+      side->push_back(update);
+    }
+  }
+  return delta.bids.size() + delta.asks.size();
+}
+
+template <typename Fn>
+void run_case(JsonReport& report, const std::string& label, size_t bytes, int iterations,
+              Fn&& fn) {
+  std::vector<int64_t> samples;
+  samples.reserve(iterations);
+  size_t sink = fn(); // Warm-up
+
+  for (int i = 0; i < iterations; ++i) {
+    int64_t start = now_ns();
+    sink += fn();
+    samples.push_back(now_ns() - start);
+  }
+
+  int64_t p50 = percentile(samples, 50);
+  int64_t p99 = percentile(samples, 99);
+  int64_t mb_per_sec = p50 > 0 ? static_cast<int64_t>(bytes * 1000 / p50) : 0;
+  std::cout << "  " << label << " p50_ns=" << p50 << " p99_ns=" << p99
+            << " MB/s=" << mb_per_sec << (sink == 0 ? " (empty output)" : "") << "\n";
+  report.add(label, {{"iterations", iterations}, {"bytes", bytes}},
+             {{"p50_ns", p50}, {"p99_ns", p99}, {"mb_per_sec", mb_per_sec}});
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int budget = argc > 1 ? std::atoi(argv[1]) : 200000; // Levels decoded per case
+  JsonReport report("bench_response_parser");
+
+  std::cout << "Order responses, per call\n";
+  Order order;
+  run_case(report, "place_order (json DOM)", kPlaceOrderResponse.size(), budget / 10, [&] {
+    return json::parse(kPlaceOrderResponse)["result"]["order"]
+        .value("order_id", "")
+        .size();
+  });
+  run_case(report, "place_order (JsonScanner)", kPlaceOrderResponse.size(), budget / 10, [&] {
+    return deribit::parse_place_order_response(200, true, kPlaceOrderResponse)
+        .exchange_order_id.size();
+  });
+  run_case(report, "get_order_state (json DOM)", kOrderStateResponse.size(), budget / 10, [&] {
+    json result = json::parse(kOrderStateResponse)["result"];
+    order.request.price = Price(result["price"].get<double>());
+    order.request.amount = Qty(result["amount"].get<double>());
+    order.filled_amount = Qty(result["filled_amount"].get<double>());
+    order.state = parse_order_state(result["order_state"].get<std::string>());
+    return result["order_id"].get<std::string>().size();
+  });
+  run_case(report, "get_order_state (JsonScanner)", kOrderStateResponse.size(), budget / 10,
+           [&] {
+             return deribit::parse_order_state_response(200, true, kOrderStateResponse, order)
+                 .exchange_order_id.size();
+           });
+
+  for (size_t depth : {10, 100, 1000}) {
+    int iterations = std::max(20, budget / static_cast<int>(depth));
+    std::string depth_label = std::to_string(depth) + " levels";
+    std::cout << "\n" << depth_label << " a side, per call\n";
+
+    OrderBook book;
+    book.scale = kScale;
+    std::string body = order_book_response(depth);
+    run_case(report, "get_order_book " + depth_label + " (json DOM)", body.size(), iterations,
+             [&] { return dom_order_book(body, book); });
+    run_case(report, "get_order_book " + depth_label + " (JsonScanner)", body.size(), iterations,
+             [&] {
+               deribit::parse_order_book_response(200, true, body, book);
+               return book.bids.size() + book.asks.size();
+             });
+
+    BookDelta delta;
+    std::string snapshot = book_snapshot(depth);
+    MarketDataFeed feed("ws://127.0.0.1:1/ws/api/v2", nullptr);
+    feed.subscribe("BTC-PERPETUAL", kScale);
+    run_case(report, "book snapshot " + depth_label + " decode (json DOM)", snapshot.size(),
+             iterations, [&] { return dom_book_snapshot(snapshot, delta); });
+    run_case(report, "book snapshot " + depth_label + " process_message (JsonScanner)",
+             snapshot.size(), iterations, [&] {
+               feed.process_message(snapshot);
+               return static_cast<size_t>(feed.stats().deltas_applied);
+             });
+  }
+  return 0;
+}
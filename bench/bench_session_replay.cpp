@@ -0,0 +1,189 @@
+// Session recording cost and whole-pipeline replay throughput.
+//
+// A synthetic session is driven through MarketDataFeed::process_message and
+// OrderManager: chained BTC-PERPETUAL book changes, with an order lifecycle
+// (create, exchange reply, open, partial, filled) after every few of them.
+// It runs once without and once with a SessionRecorder attached; the
+// difference is the recording overhead per event. The recording is then
+// replayed as fast as possible into a fresh feed and order manager, first
+// without persistence and then through a SQLite DBWriter, which is the full
+// pipeline minus the network.
+
+#include "BenchUtil.hpp"
+#include "pulseexec/DBWriter.hpp"
+#include "pulseexec/MarketDataFeed.hpp"
+#include "pulseexec/OrderManager.hpp"
+#include "pulseexec/SessionRecorder.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace {
+
+const std::string kFeedUrl = "ws://127.0.0.1:1/ws/api/v2";
+const InstrumentScale kScale{1, 0, Price(0.5, 1), Qty(10.0, 0)};
+constexpr int kLevels = 50;
+constexpr int kChangesPerOrder = 4;
+
+std::string book_message(const std::string& type, uint64_t change_id, const std::string& bids,
+                         const std::string& asks) {
+  std::string prev =
+      type == "snapshot" ? "" : R"("prev_change_id":)" + std::to_string(change_id - 1) + ",";
+  return R"({"jsonrpc":"2.0","method":"subscription",)"
+         R"("params":{"channel":"book.BTC-PERPETUAL.100ms","data":{"type":")" +
+         type + R"(","timestamp":1700000000000,"instrument_name":"BTC-PERPETUAL",)" +
+         R"("change_id":)" + std::to_string(change_id) + "," + prev + R"("bids":)" + bids +
+         R"(,"asks":)" + asks + "}}}";
+}
+
+// Snapshot, then changes that resize existing levels so the chain never gaps
+std::vector<std::string> generate_feed(int changes) {
+  std::string bids = "[";
+  std::string asks = "[";
+  for (int i = 0; i < kLevels; ++i) {
+    bids += (i ? "," : "") + std::string(R"([["new",)") + std::to_string(50000.0 - i * 0.5) +
+            ",100]";
+    asks += (i ? "," : "") + std::string(R"([["new",)") + std::to_string(50000.5 + i * 0.5) +
+            ",100]";
+  }
+  std::vector<std::string> messages{book_message("snapshot", 1, bids + "]", asks + "]")};
+
+  for (int i = 0; i < changes; ++i) {
+    std::string level = R"([["change",)" + std::to_string(50000.0 - (i % kLevels) * 0.5) + "," +
+                        std::to_string(10 * (1 + i % 37)) + "]]";
+    messages.push_back(i % 2 == 0 ? book_message("change", i + 2, level, "[]")
+                                  : book_message("change", i + 2, "[]", level));
+  }
+  return messages;
+}
+
+// Returns the wall time in ns of driving the session through feed and manager
+int64_t drive_session(const std::vector<std::string>& feed_messages,
+                      std::shared_ptr<SessionRecorder> recorder) {
+  auto feed = std::make_shared<MarketDataFeed>(kFeedUrl, nullptr);
+  auto manager = std::make_shared<OrderManager>(nullptr, nullptr);
+  if (recorder) {
+    feed->set_recorder(recorder);
+    manager->set_recorder(recorder);
+  }
+  feed->subscribe("BTC-PERPETUAL", kScale);
+
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 20.0, OrderType::LIMIT);
+  const std::string reply = R"({"jsonrpc":"2.0","id":1,"result":{"order":{"order_id":"EX-1"}}})";
+
+  int64_t start = now_ns();
+  for (size_t i = 0; i < feed_messages.size(); ++i) {
+    feed->process_message(feed_messages[i]);
+    if (i % kChangesPerOrder != 0) {
+      continue;
+    }
+    req.client_order_id = "REPLAY_" + std::to_string(i);
+    OrderHandle handle = manager->create_order(req);
+    if (recorder) {
+      recorder->record_gateway_response("/api/v2/private/buy", 200, true, reply);
+    }
+    manager->update_order(handle, OrderState::OPEN, "EX-" + std::to_string(i));
+    manager->update_order(handle, OrderState::PARTIAL, "", Qty(10.0));
+    manager->update_order(handle, OrderState::FILLED, "", Qty(20.0));
+  }
+  return now_ns() - start;
+}
+
+void report_replay(JsonReport& report, const std::string& label, const ReplayStats& stats,
+                   int64_t elapsed_ns) {
+  double seconds = static_cast<double>(elapsed_ns) / 1e9;
+  int64_t events_per_sec = static_cast<int64_t>(stats.events / seconds);
+  std::cout << label << "\n";
+  std::cout << "  events:           " << stats.events << "\n";
+  std::cout << "  market_data:      " << stats.market_data << "\n";
+  std::cout << "  order_commands:   " << stats.order_commands << "\n";
+  std::cout << "  commands_failed:  " << stats.commands_failed << "\n";
+  std::cout << "  elapsed_ms:       " << elapsed_ns / 1e6 << "\n";
+  std::cout << "  events_per_sec:   " << events_per_sec << "\n\n";
+  report.add(label, {{"events", stats.events}},
+             {{"market_data", stats.market_data},
+              {"order_commands", stats.order_commands},
+              {"commands_failed", stats.commands_failed},
+              {"elapsed_ns", elapsed_ns},
+              {"events_per_sec", events_per_sec}});
+}
+
+void remove_db(const std::string& db_path) {
+  std::remove(db_path.c_str());
+  std::remove((db_path + "-wal").c_str());
+  std::remove((db_path + "-shm").c_str());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int changes = argc > 1 ? std::atoi(argv[1]) : 200000;
+  std::string path = argc > 2 ? argv[2] : "./bench_session_replay.bin";
+  std::string db_path = "/tmp/pulseexec_bench_session_replay.db";
+  JsonReport report("bench_session_replay");
+
+  std::vector<std::string> feed_messages = generate_feed(changes);
+
+  // Recording overhead
+  int64_t plain_ns = drive_session(feed_messages, nullptr);
+  auto recorder = std::make_shared<SessionRecorder>(path, nullptr);
+  if (!recorder->open()) {
+    std::cerr << "failed to open " << path << "\n";
+    return 1;
+  }
+  int64_t recorded_ns = drive_session(feed_messages, recorder);
+  recorder->close();
+
+  uint64_t events = recorder->event_count();
+  double bytes_per_event = static_cast<double>(recorder->bytes_written()) / events;
+  double overhead_ns = static_cast<double>(recorded_ns - plain_ns) / events;
+  std::cout << "record\n";
+  std::cout << "  events:           " << events << "\n";
+  std::cout << "  bytes_per_event:  " << bytes_per_event << "\n";
+  std::cout << "  session_ms:       " << plain_ns / 1e6 << " without recorder, "
+            << recorded_ns / 1e6 << " with\n";
+  std::cout << "  overhead_ns:      " << overhead_ns << " per event\n\n";
+  report.add("record", {{"book_changes", changes}},
+             {{"events", events},
+              {"bytes_per_event", bytes_per_event},
+              {"session_ns", plain_ns},
+              {"recorded_session_ns", recorded_ns},
+              {"overhead_ns_per_event", overhead_ns}});
+
+  // Replay without persistence: parse, book updates and order state only
+  {
+    auto feed = std::make_shared<MarketDataFeed>(kFeedUrl, nullptr);
+    auto manager = std::make_shared<OrderManager>(nullptr, nullptr);
+    SessionReplayer replayer(nullptr, manager, feed);
+    ReplayStats stats;
+    int64_t start = now_ns();
+    replayer.run(path, 0, stats);
+    report_replay(report, "replay (no persistence)", stats, now_ns() - start);
+  }
+
+  // Replay through SQLite; the clock stops once every write is committed
+  {
+    remove_db(db_path);
+    auto db_writer = std::make_shared<DBWriter>(db_path, nullptr);
+    db_writer->set_overflow_policy(DBOverflowPolicy::BLOCK, std::chrono::milliseconds(1000));
+    db_writer->start();
+    auto feed = std::make_shared<MarketDataFeed>(kFeedUrl, nullptr);
+    auto manager = std::make_shared<OrderManager>(nullptr, db_writer);
+    SessionReplayer replayer(nullptr, manager, feed);
+    ReplayStats stats;
+    int64_t start = now_ns();
+    replayer.run(path, 0, stats);
+    db_writer->stop();
+    report_replay(report, "replay (sqlite)", stats, now_ns() - start);
+    remove_db(db_path);
+  }
+
+  std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,236 @@
+// WebSocketServer fan-out latency: time from publish() to each subscriber
+// having read the frame.
+//
+// Hundreds of loopback client sessions subscribe to one topic. Each published
+// payload carries the steady-clock timestamp taken just before publish(); a
+// client records now - ts when it reads the frame. Per-delivery latency is
+// reported, as is fan-out latency (publish until the last subscriber has the
+// frame). Clients share a single I/O thread, so the numbers include client-side
+// queueing and are an upper bound on the server's own cost.
+
+#include "BenchUtil.hpp"
+#include "pulseexec/WebSocketServer.hpp"
+#include <atomic>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+using namespace pulseexec::bench;
+
+namespace beast = boost::beast;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+namespace {
+
+const std::string kTopic = "book.BTC-PERPETUAL";
+
+// Latest arrival per sequence number, shared by every client
+struct Arrivals {
+  explicit Arrivals(size_t messages) : last_ns(messages), received(messages) {}
+
+  std::vector<std::atomic<int64_t>> last_ns;
+  std::vector<std::atomic<int>> received;
+};
+
+class Client : public std::enable_shared_from_this<Client> {
+public:
+  Client(net::io_context& io, Arrivals& arrivals, std::atomic<int>& subscribed)
+      : ws_(io), arrivals_(arrivals), subscribed_(subscribed) {}
+
+  void start(const tcp::endpoint& endpoint) {
+    beast::get_lowest_layer(ws_).async_connect(
+        endpoint, [self = shared_from_this()](beast::error_code ec) {
+          if (ec) {
+            return;
+          }
+          self->ws_.async_handshake("127.0.0.1", "/", [self](beast::error_code ec) {
+            if (ec) {
+              return;
+            }
+            self->request_ = R"({"jsonrpc":"2.0","id":1,"method":"subscribe",)"
+                             R"("params":{"topics":[")" +
+                             kTopic + R"("]}})";
+            self->ws_.async_write(net::buffer(self->request_),
+                                  [self](beast::error_code ec, size_t) {
+                                    if (!ec) {
+                                      self->read_next();
+                                    }
+                                  });
+          });
+        });
+  }
+
+  void close() {
+    beast::error_code ec;
+    beast::get_lowest_layer(ws_).socket().close(ec);
+  }
+
+  // Samples are handed over once reading has stopped
+  std::vector<int64_t> take_samples() { return std::move(samples_); }
+
+private:
+  void read_next() {
+    ws_.async_read(buffer_, [self = shared_from_this()](beast::error_code ec, size_t) {
+      if (ec) {
+        return;
+      }
+      int64_t now = now_ns();
+      self->handle(static_cast<const char*>(self->buffer_.data().data()),
+                   self->buffer_.size(), now);
+      self->buffer_.consume(self->buffer_.size());
+      self->read_next();
+    });
+  }
+
+  void handle(const char* data, size_t size, int64_t now) {
+    std::string_view text(data, size);
+    if (text.find("\"result\"") != std::string_view::npos) {
+      subscribed_.fetch_add(1);
+      return;
+    }
+
+    int64_t seq = 0;
+    int64_t ts = 0;
+    if (!read_field(text, "\"seq\":", seq) || !read_field(text, "\"ts\":", ts)) {
+      return;
+    }
+    samples_.push_back(now - ts);
+    auto& last = arrivals_.last_ns[static_cast<size_t>(seq)];
+    int64_t prev = last.load(std::memory_order_relaxed);
+    while (prev < now && !last.compare_exchange_weak(prev, now)) {
+    }
+    arrivals_.received[static_cast<size_t>(seq)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static bool read_field(std::string_view text, std::string_view key, int64_t& out) {
+    size_t pos = text.find(key);
+    if (pos == std::string_view::npos) {
+      return false;
+    }
+    const char* begin = text.data() + pos + key.size();
+    return std::from_chars(begin, text.data() + text.size(), out).ec == std::errc();
+  }
+
+  beast::websocket::stream<beast::tcp_stream> ws_;
+  beast::flat_buffer buffer_;
+  std::string request_;
+  Arrivals& arrivals_;
+  std::atomic<int>& subscribed_;
+  std::vector<int64_t> samples_;
+};
+
+void print_latency(JsonReport& report, const std::string& label, int clients,
+                   std::vector<int64_t>& samples) {
+  int64_t p50 = percentile(samples, 50) / 1000;
+  int64_t p99 = percentile(samples, 99) / 1000;
+  int64_t max = percentile(samples, 100) / 1000;
+  std::cout << "  " << label << " samples=" << samples.size() << " p50_us=" << p50
+            << " p99_us=" << p99 << " max_us=" << max << "\n";
+  report.add(label, {{"clients", clients}},
+             {{"samples", samples.size()}, {"p50_us", p50}, {"p99_us", p99}, {"max_us", max}});
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  int clients = argc > 1 ? std::atoi(argv[1]) : 200;
+  int messages = argc > 2 ? std::atoi(argv[2]) : 500;
+  std::cout << "WebSocketServer fan-out, " << clients << " sessions, " << messages
+            << " messages\n";
+  JsonReport report("bench_websocket_server");
+
+  WebSocketServer server("127.0.0.1", 0, nullptr);
+  if (!server.start()) {
+    std::cerr << "Cannot start server\n";
+    return 1;
+  }
+
+  net::io_context io;
+  Arrivals arrivals(static_cast<size_t>(messages));
+  std::atomic<int> subscribed{0};
+  std::vector<std::shared_ptr<Client>> sessions;
+  tcp::endpoint endpoint(net::ip::make_address("127.0.0.1"), server.port());
+  for (int i = 0; i < clients; ++i) {
+    sessions.push_back(std::make_shared<Client>(io, arrivals, subscribed));
+    sessions.back()->start(endpoint);
+  }
+  auto guard = net::make_work_guard(io);
+  std::thread client_thread([&] { io.run(); });
+  auto shutdown = [&] {
+    net::post(io, [&] {
+      for (auto& session : sessions) {
+        session->close();
+      }
+    });
+    guard.reset();
+    client_thread.join();
+    server.stop();
+  };
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (subscribed.load() < clients && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  if (subscribed.load() < clients) {
+    std::cerr << "Only " << subscribed.load() << " sessions subscribed\n";
+    shutdown();
+    return 1;
+  }
+
+  // Paced so each frame is measured on its own rather than behind a backlog
+  std::vector<int64_t> publish_ns(static_cast<size_t>(messages));
+  for (int seq = 0; seq < messages; ++seq) {
+    int64_t ts = now_ns();
+    publish_ns[static_cast<size_t>(seq)] = ts;
+    std::string data = R"({"seq":)" + std::to_string(seq) + R"(,"ts":)" + std::to_string(ts) +
+                       R"(,"best_bid":50000.0,"best_ask":50000.5})";
+    server.publish(kTopic, data);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  auto all_received = [&] {
+    for (auto& count : arrivals.received) {
+      if (count.load() < clients) {
+        return false;
+      }
+    }
+    return true;
+  };
+  deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (!all_received() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  shutdown();
+
+  std::vector<int64_t> delivery;
+  for (auto& session : sessions) {
+    auto samples = session->take_samples();
+    delivery.insert(delivery.end(), samples.begin(), samples.end());
+  }
+  std::vector<int64_t> fan_out;
+  for (size_t seq = 0; seq < publish_ns.size(); ++seq) {
+    if (arrivals.received[seq].load() == clients) {
+      fan_out.push_back(arrivals.last_ns[seq].load() - publish_ns[seq]);
+    }
+  }
+
+  print_latency(report, "delivery", clients, delivery);
+  print_latency(report, "fan-out", clients, fan_out);
+  auto stats = server.stats();
+  std::cout << "  frames_sent=" << stats.frames_sent
+            << " frames_conflated=" << stats.frames_conflated
+            << " slow_consumer_disconnects=" << stats.slow_consumer_disconnects << "\n";
+  return delivery.size() == static_cast<size_t>(clients) * static_cast<size_t>(messages) ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <curl/curl.h>
+#include <mutex>
+#include <vector>
+
+namespace pulseexec {
+
+// Pool of reusable libcurl easy handles owned by ExecutionGateway.
+//
+// Handles keep their live connections between requests, and all handles share
+// one CURLSH so DNS results, TLS sessions and the connection cache are reused
+// across the pool. A pool size of 0 disables pooling: every acquire() creates
+// a fresh handle that is cleaned up on release (the original per-call mode).
+class CurlHandlePool {
+public:
+  // RAII lease on a pooled handle; returns the handle to the pool on destruction.
+  class Lease {
+  public:
+    Lease() = default;
+    Lease(CurlHandlePool* pool, CURL* handle) : pool_(pool), handle_(handle) {}
+    ~Lease() { reset(); }
+
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    Lease(Lease&& other) noexcept : pool_(other.pool_), handle_(other.handle_) {
+      other.pool_ = nullptr;
+      other.handle_ = nullptr;
+    }
+
+    Lease& operator=(Lease&& other) noexcept {
+      if (this != &other) {
+        reset();
+        pool_ = other.pool_;
+        handle_ = other.handle_;
+        other.pool_ = nullptr;
+        other.handle_ = nullptr;
+      }
+      return *this;
+    }
+
+    CURL* get() const { return handle_; }
+    explicit operator bool() const { return handle_ != nullptr; }
+
+    void reset() {
+      if (pool_ && handle_) {
+        pool_->release(handle_);
+      }
+      pool_ = nullptr;
+      handle_ = nullptr;
+    }
+
+  private:
+    CurlHandlePool* pool_ = nullptr;
+    CURL* handle_ = nullptr;
+  };
+
+  explicit CurlHandlePool(size_t pool_size);
+  ~CurlHandlePool();
+
+  CurlHandlePool(const CurlHandlePool&) = delete;
+  CurlHandlePool& operator=(const CurlHandlePool&) = delete;
+
+  // Blocks while all pool_size handles are leased. The returned lease is empty
+  // if a handle could not be created.
+  Lease acquire();
+
+  size_t pool_size() const { return pool_size_; }
+  size_t idle_count() const;
+  uint64_t created_count() const { return created_count_.load(std::memory_order_relaxed); }
+
+private:
+  void release(CURL* handle);
+  CURL* create_handle();
+  void apply_defaults(CURL* handle);
+
+  static void share_lock(CURL* handle, curl_lock_data data, curl_lock_access access,
+                         void* userptr);
+  static void share_unlock(CURL* handle, curl_lock_data data, void* userptr);
+
+  size_t pool_size_;
+  CURLSH* share_;
+  std::mutex share_mutexes_[CURL_LOCK_DATA_LAST];
+
+  mutable std::mutex pool_mutex_;
+  std::condition_variable pool_cv_;
+  std::vector<CURL*> idle_handles_;
+  size_t total_handles_;
+
+  std::atomic<uint64_t> created_count_{0};
+};
+
+} // namespace pulseexec
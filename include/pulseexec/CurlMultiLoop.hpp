@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <curl/curl.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pulseexec {
+
+// Single-threaded curl_multi event loop for non-blocking HTTP requests.
+//
+// Any thread may submit transfers; all I/O and completion callbacks run on the
+// loop thread, so callbacks must be short and must not block. Delayed
+// submissions are kept on a timer heap, which lets callers schedule retries
+// without parking a thread.
+class CurlMultiLoop {
+public:
+  struct Transfer {
+    std::string url;
+    std::string body; // POST body; ignored for GET
+    bool post = false;
+    std::vector<std::string> headers;
+  };
+
+  struct Response {
+    bool success = false;
+    int http_status = 0;
+    std::string body;
+  };
+
+  using Completion = std::function<void(const Response&)>;
+
+  // max_connections caps concurrent connections per host (0 = no cap); excess
+  // transfers queue inside libcurl until a connection frees up.
+  explicit CurlMultiLoop(size_t max_connections = 16);
+  ~CurlMultiLoop();
+
+  CurlMultiLoop(const CurlMultiLoop&) = delete;
+  CurlMultiLoop& operator=(const CurlMultiLoop&) = delete;
+
+  void start();
+  void stop();
+
+  // Queue a transfer to start after delay_ms. Returns false if the loop is not running.
+  bool submit(std::shared_ptr<const Transfer> transfer, Completion on_complete, int delay_ms = 0);
+
+  size_t in_flight_count() const { return in_flight_count_.load(std::memory_order_relaxed); }
+  size_t pending_count() const { return pending_count_.load(std::memory_order_relaxed); }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Scheduled {
+    Clock::time_point due;
+    uint64_t seq; // FIFO tie-break for equal due times
+    std::shared_ptr<const Transfer> transfer;
+    Completion on_complete;
+
+    bool operator>(const Scheduled& other) const {
+      return due != other.due ? due > other.due : seq > other.seq;
+    }
+  };
+
+  struct Active {
+    std::shared_ptr<const Transfer> transfer;
+    Completion on_complete;
+    CURL* easy = nullptr;
+    curl_slist* headers = nullptr;
+    std::string response_body;
+  };
+
+  void loop_thread();
+  void start_due_transfers();
+  void start_transfer(Scheduled&& item);
+  void drain_completions();
+  void finish(CURL* easy, const Response& response);
+  void abort_all(const std::string& reason);
+  int next_timeout_ms() const;
+
+  CURL* take_easy_handle();
+  void return_easy_handle(CURL* easy);
+
+  size_t max_connections_;
+  CURLM* multi_;
+
+  std::atomic<bool> running_{false};
+  std::thread worker_;
+
+  // Submissions from other threads, moved onto timers_ by the loop thread
+  std::mutex submit_mutex_;
+  std::vector<Scheduled> submissions_;
+  uint64_t submit_seq_ = 0;
+
+  // Loop-thread-only state
+  std::priority_queue<Scheduled, std::vector<Scheduled>, std::greater<Scheduled>> timers_;
+  std::unordered_map<CURL*, std::unique_ptr<Active>> active_;
+  std::vector<CURL*> idle_easy_handles_;
+
+  std::atomic<size_t> in_flight_count_{0};
+  std::atomic<size_t> pending_count_{0};
+};
+
+} // namespace pulseexec
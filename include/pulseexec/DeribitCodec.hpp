@@ -0,0 +1,127 @@
+#pragma once
+
+#include "pulseexec/ExecutionGateway.hpp"
+#include "pulseexec/FixedPoint.hpp"
+#include "pulseexec/OrderBook.hpp"
+#include <charconv>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+
+namespace pulseexec {
+namespace deribit {
+
+// Deribit JSON-RPC request bodies and response parsing used by
+// ExecutionGateway. Kept free of any transport state so the encode/decode
+// cost can be measured and tested on its own.
+
+// Writes order request bodies straight into a buffer that keeps its capacity
+// between calls, so once it has grown to the largest body a thread sends,
+// encoding allocates nothing. Each call overwrites the previous body and
+// returns the buffer. Prices and amounts are written exactly from their
+// fixed-point mantissa rather than through a double. Not thread-safe; keep
+// one writer per thread.
+class RequestWriter {
+public:
+  explicit RequestWriter(size_t capacity = 512) { buf_.reserve(capacity); }
+
+  // private/buy or private/sell params (by request.side) in a JSON-RPC envelope
+  const std::string& place_order(const OrderRequest& request);
+  const std::string& cancel_order(std::string_view exchange_order_id);
+  const std::string& modify_order(std::string_view exchange_order_id, Price new_price,
+                                  Qty new_amount);
+  const std::string& get_order_state(std::string_view exchange_order_id);
+  // private/get_order_state_by_label params
+  const std::string& get_order_state_by_label(std::string_view currency, std::string_view label);
+
+private:
+  void append_string(std::string_view text); // Quoted and escaped
+
+  // Trailing fractional zeros trimmed, as FixedPoint::to_string
+  template <typename Tag> void append_decimal(FixedPoint<Tag> value) {
+    char digits[24];
+    int64_t mantissa = value.mantissa();
+    uint64_t magnitude =
+        mantissa < 0 ? 0 - static_cast<uint64_t>(mantissa) : static_cast<uint64_t>(mantissa);
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), magnitude);
+    size_t len = static_cast<size_t>(end - digits);
+    size_t decimals = value.decimals();
+
+    if (mantissa < 0) {
+      buf_ += '-';
+    }
+    size_t whole = len > decimals ? len - decimals : 0;
+    if (whole > 0) {
+      buf_.append(digits, whole);
+    } else {
+      buf_ += '0';
+    }
+
+    size_t last = len;
+    while (last > whole && digits[last - 1] == '0') {
+      --last;
+    }
+    if (last > whole) {
+      buf_ += '.';
+      buf_.append(decimals - (len - whole), '0');
+      buf_.append(digits + whole, last - whole);
+    }
+  }
+
+  std::string buf_;
+};
+
+std::string build_jsonrpc_request(const std::string& method, const nlohmann::json& params);
+
+// Copies of what RequestWriter produces, for callers that keep the body.
+// private/buy or private/sell, chosen by request.side
+std::string build_place_order_body(const OrderRequest& request);
+std::string build_cancel_order_body(const std::string& exchange_order_id);
+std::string build_modify_order_body(const std::string& exchange_order_id, Price new_price,
+                                    Qty new_amount);
+std::string build_get_order_state_body(const std::string& exchange_order_id);
+
+// Responses are read with JsonScanner, picking out only the fields below
+// without building a DOM.
+
+// Extracts result.order.order_id. A transport failure (success == false)
+// passes body through as the error message.
+ExecutionResult parse_place_order_response(int http_status, bool success, const std::string& body);
+
+// Fills out_order from result (order_id, label, instrument_name, direction,
+// price, amount, order_type, order_state, filled_amount); fields the
+// exchange did not send are left as they were.
+ExecutionResult parse_order_state_response(int http_status, bool success, const std::string& body,
+                                           Order& out_order);
+
+// Like parse_order_state_response for the first order in a
+// private/get_order_state_by_label result array. An empty array still
+// succeeds but leaves result.exchange_order_id empty: the exchange has no
+// order with that label.
+ExecutionResult parse_order_state_by_label_response(int http_status, bool success,
+                                                    const std::string& body, Order& out_order);
+
+// The currency an instrument settles in, which the by-currency endpoints
+// take: "BTC-PERPETUAL" -> "BTC", "SOL_USDC-PERPETUAL" -> "USDC"
+std::string_view instrument_currency(std::string_view instrument);
+
+// Extracts result.access_token and result.expires_in (seconds) from a
+// public/auth reply; false if either is missing or the lifetime is not positive
+bool parse_auth_response(const std::string& body, std::string& access_token,
+                         int64_t& expires_in_s);
+
+// Replaces out_book's levels with result.bids and result.asks, at
+// out_book.scale's decimals, and sets its timestamp_us from result.timestamp.
+ExecutionResult parse_order_book_response(int http_status, bool success, const std::string& body,
+                                          OrderBook& out_book);
+
+// Sets out_scale from a public/get_instrument reply: result.tick_size and
+// result.min_trade_amount become the tick and lot, and the decimals they are
+// written with the price and quantity decimals. out_scale is left alone
+// unless both are present and positive.
+ExecutionResult parse_instrument_response(int http_status, bool success, const std::string& body,
+                                          InstrumentScale& out_scale);
+
+} // namespace deribit
+} // namespace pulseexec
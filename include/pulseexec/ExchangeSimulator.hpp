@@ -0,0 +1,137 @@
+#pragma once
+
+#include "pulseexec/FixedPoint.hpp"
+#include "pulseexec/MatchingEngine.hpp"
+#include "pulseexec/OrderBook.hpp"
+#include "pulseexec/RateLimiter.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pulseexec {
+
+class Logger;
+
+// Local stand-in for the Deribit REST API, backed by one MatchingEngine per
+// instrument. handle() takes a request as ExecutionGateway sends it and
+// returns the HTTP status and JSON-RPC body the exchange would, so it can sit
+// behind any loopback HTTP server or be called in-process:
+//
+//   POST /api/v2/public/auth                  access_token, expires_in
+//   POST /api/v2/private/buy, /private/sell   result.order, result.trades
+//   POST /api/v2/private/cancel               result (the order)
+//   POST /api/v2/private/edit                 result.order, result.trades
+//   GET|POST /api/v2/private/get_order_state  result (the order)
+//   GET  /api/v2/public/get_order_book        result.bids, result.asks
+//
+// Parameters are read from the JSON-RPC "params" object, a flat JSON body or
+// the query string, whichever the request carries. Errors come back as HTTP
+// 400 with a JSON-RPC error object. Credentials are not checked; rate limits
+// are only enforced when set_rate_limits() has been called.
+//
+// Requests are scanned and replies written by hand rather than through a JSON
+// DOM: the simulator has to outrun the client it is benchmarking, and a DOM
+// parse and dump cost several times more than matching the order.
+//
+// Instruments are created on first use with the default scale unless added
+// beforehand. Each has its own lock, so requests for different instruments
+// run in parallel; order IDs carry the instrument so cancels and edits find
+// the book without a global index.
+class ExchangeSimulator {
+public:
+  struct Reply {
+    int status = 200;
+    std::string body;
+  };
+
+  // Receives Deribit "book.<instrument>.100ms" change notifications
+  using BookListener = std::function<void(const std::string& notification)>;
+
+  explicit ExchangeSimulator(std::shared_ptr<Logger> logger = nullptr,
+                             const InstrumentScale& default_scale = InstrumentScale());
+
+  ExchangeSimulator(const ExchangeSimulator&) = delete;
+  ExchangeSimulator& operator=(const ExchangeSimulator&) = delete;
+
+  // False if the instrument already exists
+  bool add_instrument(const std::string& instrument, const InstrumentScale& scale);
+
+  // Thread-safe
+  Reply handle(const std::string& method, const std::string& target, const std::string& body);
+
+  // Called after every operation that changed the book, with that instrument's
+  // lock held so notifications arrive in change_id order. Set before traffic
+  // starts; the listener must not call back into the simulator.
+  void set_book_listener(BookListener listener);
+
+  // Meter requests against the exchange's credit pools, answering HTTP 429
+  // with error 10028 "too_many_requests" when one is short. Set before
+  // traffic starts.
+  void set_rate_limits(const RateLimiter::Config& limits);
+
+  // Full-depth snapshot notification at the current change_id, for a feed
+  // that subscribes while the book is live. Empty if the instrument is unknown.
+  std::string snapshot_notification(const std::string& instrument);
+
+  // Copies of engine state, for tests and benchmarks
+  bool get_order(const std::string& order_id, MatchingOrder& out);
+  bool get_book(const std::string& instrument, size_t depth, OrderBook& out);
+
+  uint64_t orders_placed() const { return orders_placed_.load(std::memory_order_relaxed); }
+  uint64_t requests_failed() const { return requests_failed_.load(std::memory_order_relaxed); }
+  uint64_t requests_rate_limited() const {
+    return requests_rate_limited_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Book {
+    explicit Book(MatchingEngine engine) : engine(std::move(engine)) {}
+
+    std::mutex mutex;
+    MatchingEngine engine;
+    uint32_t index = 0;
+    uint64_t next_seq = 1;
+    uint64_t change_id = 0;
+  };
+
+  Book* find_book(const std::string& instrument);
+  Book* find_or_add_book(const std::string& instrument);
+  Book* book_for_order(const std::string& order_id, uint64_t& id);
+
+  // Flat request parameters; defined in the .cpp
+  struct RequestParams;
+
+  Reply place(const RequestParams& params, Side side);
+  Reply cancel(const RequestParams& params);
+  Reply edit(const RequestParams& params);
+  Reply order_state(const RequestParams& params);
+  Reply order_book(const RequestParams& params);
+  Reply auth(const RequestParams& params);
+  Reply error(const RequestParams& params, int code, const char* message);
+
+  // Caller holds book.mutex
+  void append_order(std::string& out, const Book& book, const MatchingOrder& order) const;
+  void append_trades(std::string& out, const Book& book, Side taker_side) const;
+  void publish_changes(Book& book, int64_t ts_ms);
+
+  std::shared_ptr<Logger> logger_;
+  InstrumentScale default_scale_;
+  BookListener book_listener_;
+  std::unique_ptr<RateLimiter> rate_limiter_;
+
+  std::shared_mutex books_mutex_;
+  std::vector<std::unique_ptr<Book>> books_;
+  std::unordered_map<std::string, Book*> books_by_name_;
+
+  std::atomic<uint64_t> orders_placed_{0};
+  std::atomic<uint64_t> requests_failed_{0};
+  std::atomic<uint64_t> requests_rate_limited_{0};
+};
+
+} // namespace pulseexec
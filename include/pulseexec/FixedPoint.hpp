@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace pulseexec {
+
+// Decimal fixed-point number: value = mantissa * 10^-decimals.
+//
+// The number of decimals is chosen per instrument (see InstrumentScale) and
+// travels with the value, so printing and wire encoding need no lookup. Values
+// with equal decimals - everything belonging to one instrument - compare and
+// add as plain int64s; mixed decimals are aligned first. Tag keeps prices and
+// quantities from being mixed up.
+template <typename Tag> class FixedPoint {
+public:
+  static constexpr uint8_t kMaxDecimals = 18;
+
+  constexpr FixedPoint() = default;
+
+  // Rounds to the nearest representable value
+  explicit FixedPoint(double value, uint8_t decimals = Tag::kDefaultDecimals)
+      : mantissa_(std::llround(value * static_cast<double>(pow10(clamp(decimals))))),
+        decimals_(clamp(decimals)) {}
+
+  static constexpr FixedPoint from_mantissa(int64_t mantissa, uint8_t decimals) {
+    FixedPoint v;
+    v.mantissa_ = mantissa;
+    v.decimals_ = clamp(decimals);
+    return v;
+  }
+
+  // Exact parse of "[-]digits[.digits]"; digits beyond `decimals` are rounded.
+  // Fails if the scaled value does not fit the int64 mantissa.
+  static bool parse(std::string_view text, FixedPoint& out,
+                    uint8_t decimals = Tag::kDefaultDecimals) {
+    decimals = clamp(decimals);
+    bool negative = !text.empty() && text.front() == '-';
+    if (negative) {
+      text.remove_prefix(1);
+    }
+
+    size_t dot = text.find('.');
+    std::string_view whole = text.substr(0, dot);
+    std::string_view frac = dot == std::string_view::npos ? "" : text.substr(dot + 1);
+    if (whole.empty() && frac.empty()) {
+      return false;
+    }
+
+    // from_chars would take a second sign, and a negative mantissa would slip
+    // past the overflow checks below
+    if (!whole.empty() && whole.front() == '-') {
+      return false;
+    }
+
+    int64_t mantissa = 0;
+    if (!whole.empty()) {
+      auto [ptr, ec] = std::from_chars(whole.data(), whole.data() + whole.size(), mantissa);
+      if (ec != std::errc() || ptr != whole.data() + whole.size()) {
+        return false;
+      }
+    }
+
+    bool round_up = false;
+    for (size_t i = 0; i < frac.size(); ++i) {
+      char c = frac[i];
+      if (c < '0' || c > '9') {
+        return false;
+      }
+      if (i < decimals) {
+        if (mantissa > (INT64_MAX - (c - '0')) / 10) {
+          return false;
+        }
+        mantissa = mantissa * 10 + (c - '0');
+      } else if (i == decimals) {
+        round_up = c >= '5';
+      }
+    }
+    for (size_t i = frac.size(); i < decimals; ++i) {
+      if (mantissa > INT64_MAX / 10) {
+        return false;
+      }
+      mantissa *= 10;
+    }
+    if (round_up) {
+      if (mantissa == INT64_MAX) {
+        return false;
+      }
+      ++mantissa;
+    }
+
+    out = from_mantissa(negative ? -mantissa : mantissa, decimals);
+    return true;
+  }
+
+  int64_t mantissa() const { return mantissa_; }
+  uint8_t decimals() const { return decimals_; }
+  bool is_zero() const { return mantissa_ == 0; }
+
+  double to_double() const {
+    return static_cast<double>(mantissa_) / static_cast<double>(pow10(decimals_));
+  }
+
+  // Exact decimal text with trailing fractional zeros trimmed ("50000", "0.001")
+  std::string to_string() const {
+    uint64_t magnitude = mantissa_ < 0 ? 0 - static_cast<uint64_t>(mantissa_) : mantissa_;
+    uint64_t scale = static_cast<uint64_t>(pow10(decimals_));
+
+    std::string out = mantissa_ < 0 ? "-" : "";
+    out += std::to_string(magnitude / scale);
+
+    uint64_t frac = magnitude % scale;
+    if (frac != 0) {
+      std::string digits = std::to_string(frac);
+      digits.insert(0, decimals_ - digits.size(), '0');
+      digits.erase(digits.find_last_not_of('0') + 1);
+      out += '.';
+      out += digits;
+    }
+    return out;
+  }
+
+  // Same value at a different number of decimals; rounds half away from zero
+  // when digits are dropped
+  FixedPoint rescaled(uint8_t decimals) const {
+    decimals = clamp(decimals);
+    if (decimals >= decimals_) {
+      return from_mantissa(mantissa_ * pow10(decimals - decimals_), decimals);
+    }
+    int64_t divisor = pow10(decimals_ - decimals);
+    int64_t half = divisor / 2;
+    int64_t m = mantissa_ >= 0 ? (mantissa_ + half) / divisor : (mantissa_ - half) / divisor;
+    return from_mantissa(m, decimals);
+  }
+
+  // Nearest multiple of increment (a tick or lot size); zero increment is a no-op
+  FixedPoint round_to(FixedPoint increment) const {
+    if (increment.is_zero()) {
+      return *this;
+    }
+    uint8_t d = std::max(decimals_, increment.decimals_);
+    int64_t m = rescaled(d).mantissa_;
+    int64_t step = increment.rescaled(d).mantissa_;
+    int64_t steps = m >= 0 ? (m + step / 2) / step : (m - step / 2) / step;
+    return from_mantissa(steps * step, d);
+  }
+
+  friend FixedPoint operator+(FixedPoint a, FixedPoint b) {
+    uint8_t d = std::max(a.decimals_, b.decimals_);
+    return from_mantissa(a.rescaled(d).mantissa_ + b.rescaled(d).mantissa_, d);
+  }
+  friend FixedPoint operator-(FixedPoint a, FixedPoint b) {
+    uint8_t d = std::max(a.decimals_, b.decimals_);
+    return from_mantissa(a.rescaled(d).mantissa_ - b.rescaled(d).mantissa_, d);
+  }
+  FixedPoint& operator+=(FixedPoint other) { return *this = *this + other; }
+  FixedPoint& operator-=(FixedPoint other) { return *this = *this - other; }
+
+  // Same-decimals fast path keeps comparisons within one instrument a single int64 compare
+  friend bool operator==(FixedPoint a, FixedPoint b) {
+    return a.decimals_ == b.decimals_ ? a.mantissa_ == b.mantissa_ : compare_mixed(a, b) == 0;
+  }
+  friend bool operator<(FixedPoint a, FixedPoint b) {
+    return a.decimals_ == b.decimals_ ? a.mantissa_ < b.mantissa_ : compare_mixed(a, b) < 0;
+  }
+  friend bool operator!=(FixedPoint a, FixedPoint b) { return !(a == b); }
+  friend bool operator>(FixedPoint a, FixedPoint b) { return b < a; }
+  friend bool operator<=(FixedPoint a, FixedPoint b) { return !(b < a); }
+  friend bool operator>=(FixedPoint a, FixedPoint b) { return !(a < b); }
+
+  friend std::ostream& operator<<(std::ostream& os, FixedPoint v) { return os << v.to_string(); }
+
+private:
+  static constexpr uint8_t clamp(uint8_t decimals) { return std::min(decimals, kMaxDecimals); }
+
+  static constexpr int64_t pow10(unsigned n) {
+    int64_t p = 1;
+    while (n-- > 0) {
+      p *= 10;
+    }
+    return p;
+  }
+
+  static int compare_mixed(FixedPoint a, FixedPoint b) {
+    uint8_t d = std::max(a.decimals_, b.decimals_);
+    int64_t x = a.rescaled(d).mantissa_;
+    int64_t y = b.rescaled(d).mantissa_;
+    return x < y ? -1 : (x > y ? 1 : 0);
+  }
+
+  int64_t mantissa_ = 0;
+  uint8_t decimals_ = 0;
+};
+
+struct PriceTag {
+  static constexpr uint8_t kDefaultDecimals = 4;
+};
+
+struct QtyTag {
+  static constexpr uint8_t kDefaultDecimals = 8;
+};
+
+using Price = FixedPoint<PriceTag>;
+using Qty = FixedPoint<QtyTag>;
+
+// Per-instrument decimal scales and increments. Zero tick/lot sizes mean the
+// instrument has no known increment and values are only rescaled.
+struct InstrumentScale {
+  uint8_t price_decimals = PriceTag::kDefaultDecimals;
+  uint8_t qty_decimals = QtyTag::kDefaultDecimals;
+  Price tick_size;
+  Qty lot_size;
+
+  Price price(double value) const { return Price(value, price_decimals); }
+  Qty qty(double value) const { return Qty(value, qty_decimals); }
+
+  // Bring a value onto this instrument's scale and increment
+  Price normalize(Price value) const { return value.round_to(tick_size).rescaled(price_decimals); }
+  Qty normalize(Qty value) const { return value.round_to(lot_size).rescaled(qty_decimals); }
+};
+
+} // namespace pulseexec
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "pulseexec/FixedPoint.hpp"
+#include "pulseexec/OrderBook.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pulseexec {
+
+// One level update from a book change message
+struct LevelUpdate {
+  enum class Action : uint8_t { NEW, CHANGE, DELETE };
+
+  Action action = Action::NEW;
+  Price price;
+  Qty amount;
+};
+
+// Decoded book notification (Deribit "book.<instrument>.<interval>" channel).
+// Snapshots carry every level as NEW; changes are chained by prev_change_id.
+struct BookDelta {
+  bool snapshot = false;
+  uint64_t change_id = 0;
+  uint64_t prev_change_id = 0;
+  int64_t timestamp_us = 0;
+  std::vector<LevelUpdate> bids;
+  std::vector<LevelUpdate> asks;
+};
+
+// Full-depth local order book maintained from a snapshot plus incremental
+// changes. Each side is a vector sorted so the best level is at the back: most
+// updates land near the top of the book, so inserts and erases there shift
+// only a few elements. Not thread-safe; the owner serializes access.
+class IncrementalBook {
+public:
+  enum class ApplyResult {
+    APPLIED,
+    GAP,               // prev_change_id did not match; book is out of sync
+    AWAITING_SNAPSHOT, // Change dropped because no snapshot has been applied since the last gap
+  };
+
+  IncrementalBook() = default;
+  IncrementalBook(std::string symbol, const InstrumentScale& scale)
+      : symbol_(std::move(symbol)), scale_(scale) {}
+
+  ApplyResult apply(const BookDelta& delta);
+
+  // Forget all levels; the next change is dropped until a snapshot arrives
+  void invalidate();
+
+  // Copy the best `depth` levels per side (best first) into out
+  void top(size_t depth, OrderBook& out) const;
+
+  bool synced() const { return synced_; }
+  uint64_t change_id() const { return change_id_; }
+  int64_t timestamp_us() const { return timestamp_us_; }
+  size_t bid_depth() const { return bids_.size(); }
+  size_t ask_depth() const { return asks_.size(); }
+
+  const std::string& symbol() const { return symbol_; }
+  const InstrumentScale& scale() const { return scale_; }
+
+private:
+  // Bids ascend and asks descend, so both sides keep their best level at the back
+  static void apply_level(std::vector<PriceLevel>& side, const LevelUpdate& update,
+                          bool ascending);
+
+  std::string symbol_;
+  InstrumentScale scale_;
+  std::vector<PriceLevel> bids_;
+  std::vector<PriceLevel> asks_;
+  uint64_t change_id_ = 0;
+  int64_t timestamp_us_ = 0;
+  bool synced_ = false;
+};
+
+} // namespace pulseexec
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "pulseexec/FixedPoint.hpp"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace pulseexec {
+
+// Compact id for an interned instrument name ("BTC-PERPETUAL" -> 1)
+using InstrumentId = uint32_t;
+inline constexpr InstrumentId kInvalidInstrumentId = 0;
+
+// Interns instrument names so internal code can compare and key on a small
+// integer instead of hashing strings, and holds each instrument's price/qty
+// scale. Ids are dense, start at 1 and are never reused; names stay valid for
+// the registry's lifetime.
+//
+// With a scale loader, intern() looks up each new instrument's scale (from
+// the exchange, say) before the instrument becomes visible, so every value of
+// an instrument is on the same scale from its first use.
+class InstrumentRegistry {
+public:
+  // Fills scale for symbol; false keeps the default scale
+  using ScaleLoader = std::function<bool(const std::string& symbol, InstrumentScale& scale)>;
+
+  // Set before the first intern()
+  void set_scale_loader(ScaleLoader loader);
+
+  // Returns the existing id for symbol, or assigns the next one. A new symbol
+  // is passed to the scale loader first, outside the registry's lock.
+  InstrumentId intern(std::string_view symbol);
+
+  // kInvalidInstrumentId if symbol has not been interned
+  InstrumentId find(std::string_view symbol) const;
+
+  // Empty string for unknown ids
+  const std::string& name(InstrumentId id) const;
+
+  // Instruments start with the default InstrumentScale until one is set
+  void set_scale(InstrumentId id, const InstrumentScale& scale);
+  InstrumentScale scale(InstrumentId id) const;
+
+  size_t size() const;
+
+private:
+  struct Entry {
+    std::string name;
+    InstrumentScale scale;
+  };
+
+  ScaleLoader scale_loader_;
+  mutable std::shared_mutex mutex_;
+  std::deque<Entry> entries_; // entries_[id - 1]; deque keeps references stable
+  std::unordered_map<std::string_view, InstrumentId> ids_; // Views into entry names
+};
+
+} // namespace pulseexec
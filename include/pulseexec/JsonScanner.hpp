@@ -0,0 +1,110 @@
+#pragma once
+
+#include "pulseexec/FixedPoint.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace pulseexec {
+
+// Forward-only, on-demand JSON reader over a borrowed buffer.
+//
+// Nothing is parsed until asked for: the caller walks objects and arrays,
+// reads the few values it wants straight into its own types and skips the
+// rest. Skipping a string or a whole nested value scans 16 bytes at a time
+// for quotes, backslashes and brackets (SSE2 where available), so large
+// parts of a payload that are not needed cost little more than a memory
+// pass. Nothing is allocated except by read_string().
+//
+// Every value handed out by next_key() or next_element() must be read or
+// skipped before asking for the next one, and an object or array that was
+// entered must be walked to its end, or left with leave(), before going on
+// in its parent. Anything malformed in what is read fails the scanner: every
+// call after that returns false, so loops end on their own and the caller
+// checks ok() once. Skipped values are only checked for terminated strings
+// and balanced brackets, and text after the last value read is not looked at.
+//
+//   JsonScanner s(body);
+//   std::string_view key;
+//   s.enter_object();
+//   while (s.next_key(key)) {
+//     key == "order_id" ? s.read_string(id) : s.skip_value();
+//   }
+//   if (!s.ok()) { ... }
+class JsonScanner {
+public:
+  explicit JsonScanner(std::string_view text) : text_(text) {}
+
+  // Consumes '{'. next_key() then yields each member's key, positioned on
+  // its value, and returns false after the closing '}'
+  bool enter_object();
+  // Keys are returned as written, escapes included
+  bool next_key(std::string_view& key);
+  // Skips members until `key`; false if the object ends first
+  bool find_key(std::string_view key);
+
+  // Consumes '['. next_element() then stops on each element and returns
+  // false after the closing ']'
+  bool enter_array();
+  bool next_element();
+
+  // Skips the rest of the object or array being walked, past its close
+  bool leave();
+
+  // Next value's first character ('{', '[', '"', 't', 'f', 'n' or a number
+  // character), or '\0' at the end of the text
+  char peek();
+
+  bool read_string(std::string& out); // Unescaped
+  // The characters between the quotes, escapes left as written
+  bool read_raw_string(std::string_view& out);
+  // The number's text as written
+  bool read_number(std::string_view& out);
+  bool read_int(int64_t& out);
+  bool read_uint(uint64_t& out);
+  bool read_double(double& out);
+
+  // Exact onto `decimals` (see FixedPoint::parse); exponent forms go
+  // through a double
+  template <typename Tag>
+  bool read_decimal(FixedPoint<Tag>& out, uint8_t decimals = Tag::kDefaultDecimals) {
+    std::string_view number;
+    if (!read_number(number)) {
+      return false;
+    }
+    if (FixedPoint<Tag>::parse(number, out, decimals)) {
+      return true;
+    }
+    double value = 0;
+    if (!parse_double(number, value)) {
+      return fail();
+    }
+    out = FixedPoint<Tag>(value, decimals);
+    return true;
+  }
+
+  // Any value, nested ones included; `raw` receives its text
+  bool skip_value(std::string_view* raw = nullptr);
+
+  bool ok() const { return !failed_; }
+  // Offset of the failure, or of the next unread byte
+  size_t position() const { return pos_; }
+
+private:
+  void skip_ws();
+  bool consume(char c);
+  bool fail();
+  bool skip_string(); // pos_ on the opening quote; leaves it past the closing one
+  // Moves pos_ past the close that brings `depth` open brackets to zero
+  bool close_brackets(int depth);
+  bool skip_literal(std::string_view literal);
+  static bool parse_double(std::string_view number, double& out);
+
+  std::string_view text_;
+  size_t pos_ = 0;
+  bool first_ = false; // No ',' expected before the next member or element
+  bool failed_ = false;
+};
+
+} // namespace pulseexec
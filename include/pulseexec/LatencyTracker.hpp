@@ -0,0 +1,123 @@
+#pragma once
+
+#include "pulseexec/ShardedFlatMap.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pulseexec {
+
+// Stages of an order's tick-to-order path that are timed
+enum class LatencyOp : uint8_t {
+  CREATE_TO_SEND,     // OrderManager::create_order -> gateway request sent
+  GATEWAY_ROUND_TRIP, // Gateway request sent -> response received
+  CREATE_TO_ACK,      // create_order -> gateway response (end to end)
+  DB_PERSIST,         // Order write enqueued -> committed to SQLite
+  COUNT,
+};
+
+const char* to_string(LatencyOp op);
+
+// Fixed-size log-linear histogram in the style of HdrHistogram. Values below
+// 2 * kSubBuckets are exact; above that every power-of-two range is split into
+// kSubBuckets linear buckets, so any recorded value is reported within ~3%.
+// record() is a few relaxed atomic increments and safe from any thread.
+class LatencyHistogram {
+public:
+  static constexpr unsigned kSubBucketBits = 5;
+  static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits; // 32
+  static constexpr unsigned kMaxValueBits = 42;                           // ~73 min in ns
+  static constexpr uint64_t kMaxValue = (uint64_t(1) << kMaxValueBits) - 1;
+  static constexpr size_t kBucketCount =
+      (kMaxValueBits - kSubBucketBits) * kSubBuckets + kSubBuckets;
+
+  // Negative values count as 0, values above kMaxValue as kMaxValue
+  void record(int64_t value);
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  int64_t max() const { return static_cast<int64_t>(max_.load(std::memory_order_relaxed)); }
+
+  // Highest value equivalent to the pct (0-100) percentile; 0 when empty
+  int64_t percentile(double pct) const;
+
+  // Moves this histogram's samples into other, leaving this one empty
+  void drain_into(LatencyHistogram& other);
+  void reset();
+
+  static size_t bucket_index(uint64_t value);
+  static uint64_t bucket_upper_bound(size_t index);
+
+private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+// Per-order latency tracing along the order path.
+//
+// OrderManager opens a trace when it creates an order, ExecutionGateway marks
+// the request going out and the response coming back, and DBWriter reports
+// how long each order write waited to be committed. Traces are keyed by
+// client_order_id and closed on the gateway response (or forget()), so only
+// in-flight orders hold state; at most max_open_traces are tracked at once.
+// Every sample lands in a cumulative histogram for percentiles() and an
+// interval histogram that take_interval() hands to the latency_metrics flush.
+class LatencyTracker {
+public:
+  struct Summary {
+    LatencyOp op = LatencyOp::COUNT;
+    uint64_t count = 0;
+    int64_t p50_ns = 0;
+    int64_t p99_ns = 0;
+    int64_t p999_ns = 0;
+    int64_t max_ns = 0;
+  };
+
+  explicit LatencyTracker(size_t max_open_traces = 65536);
+
+  LatencyTracker(const LatencyTracker&) = delete;
+  LatencyTracker& operator=(const LatencyTracker&) = delete;
+
+  void mark_created(const std::string& client_order_id);
+  void mark_sent(const std::string& client_order_id);
+  // Records the gateway and end-to-end latencies and closes the trace
+  void mark_acked(const std::string& client_order_id);
+  // Drops the trace of an order that will never be acknowledged
+  void forget(const std::string& client_order_id);
+
+  void record(LatencyOp op, int64_t latency_ns);
+
+  // Since construction, one entry per LatencyOp
+  std::vector<Summary> percentiles() const;
+  // Since the previous call; ops without samples are skipped
+  std::vector<Summary> take_interval();
+
+  size_t open_traces() const { return open_traces_.load(std::memory_order_relaxed); }
+  uint64_t dropped_traces() const { return dropped_traces_.load(std::memory_order_relaxed); }
+
+private:
+  struct Trace {
+    int64_t created_ns = 0;
+    int64_t sent_ns = 0;
+  };
+
+  static Summary summarize(LatencyOp op, const LatencyHistogram& histogram);
+
+  static constexpr size_t kOpCount = static_cast<size_t>(LatencyOp::COUNT);
+
+  size_t max_open_traces_;
+  ShardedFlatMap<Trace> traces_;
+  std::atomic<size_t> open_traces_{0};
+  std::atomic<uint64_t> dropped_traces_{0};
+
+  std::array<LatencyHistogram, kOpCount> total_;
+  std::array<LatencyHistogram, kOpCount> interval_;
+  LatencyHistogram scratch_; // Guarded by interval_mutex_
+  std::mutex interval_mutex_;
+};
+
+} // namespace pulseexec
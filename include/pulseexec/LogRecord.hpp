@@ -0,0 +1,153 @@
+#pragma once
+
+#include "pulseexec/Order.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace pulseexec {
+
+// Static log formats for structured (deferred-format) logging. Producers record
+// only the id and raw arguments; "{}" placeholders are filled in by the logger
+// thread or offline by pulseexec_logdump. Append new ids at the end so
+// existing binary logs keep decoding.
+enum class LogFormatId : uint16_t {
+  ORDER_CREATED,
+  ORDER_UPDATED,
+  ORDER_NOT_FOUND,
+  DUPLICATE_CLIENT_ORDER_ID,
+  CANCEL_INACTIVE_ORDER,
+  REQUEST_RETRY,
+  ORDER_STORE_FULL,
+  COUNT,
+
+  // Free-text record produced by the string-based Logger::log API
+  TEXT = 0xFFFF,
+};
+
+struct LogFormatSpec {
+  const char* component;
+  const char* format;
+};
+
+inline constexpr LogFormatSpec kLogFormats[] = {
+    {"OrderManager", "Created order: {} for {}"},
+    {"OrderManager", "Updated order: {} -> {}"},
+    {"OrderManager", "Order not found: {}"},
+    {"OrderManager", "Duplicate client_order_id: {}"},
+    {"OrderManager", "Cannot cancel inactive order: {}"},
+    {"ExecutionGateway", "Retrying after {}ms (attempt {}/{})"},
+    {"OrderManager", "Order store full, dropped order: {}"},
+};
+
+static_assert(sizeof(kLogFormats) / sizeof(kLogFormats[0]) ==
+                  static_cast<size_t>(LogFormatId::COUNT),
+              "every LogFormatId needs a kLogFormats entry");
+
+enum class LogArgType : uint8_t { INT64, UINT64, DOUBLE, STRING, ORDER_STATE };
+
+// One log entry as it travels through the Logger ring. Structured records keep
+// their arguments as raw bytes in a fixed inline payload (no allocation);
+// free-text records carry component/message strings instead.
+struct LogRecord {
+  static constexpr size_t kMaxArgs = 8;
+  static constexpr size_t kPayloadBytes = 128;
+
+  int64_t timestamp_us = 0;
+  uint8_t level = 0;
+  LogFormatId format_id = LogFormatId::TEXT;
+  uint8_t arg_count = 0;
+  uint8_t payload_used = 0;
+  LogArgType arg_types[kMaxArgs] = {};
+  char payload[kPayloadBytes];
+
+  std::string component;
+  std::string message;
+
+  LogRecord() = default;
+  LogRecord(uint8_t lvl, LogFormatId id, int64_t ts)
+      : timestamp_us(ts), level(lvl), format_id(id) {}
+
+  bool is_text() const { return format_id == LogFormatId::TEXT; }
+
+  // Reinitialise a reused ring slot as an empty structured record
+  void reset(uint8_t lvl, LogFormatId id, int64_t ts) {
+    timestamp_us = ts;
+    level = lvl;
+    format_id = id;
+    arg_count = 0;
+    payload_used = 0;
+  }
+
+  // Arguments that do not fit in kMaxArgs / kPayloadBytes are dropped and
+  // render as "?"; strings are truncated to the remaining payload space.
+  void add_arg(LogArgType type, const void* data, size_t size) {
+    if (arg_count >= kMaxArgs || payload_used + size > kPayloadBytes) {
+      return;
+    }
+    arg_types[arg_count++] = type;
+    std::memcpy(payload + payload_used, data, size);
+    payload_used = static_cast<uint8_t>(payload_used + size);
+  }
+
+  void add_string(std::string_view value) {
+    if (arg_count >= kMaxArgs || payload_used >= kPayloadBytes) {
+      return;
+    }
+    size_t len = std::min(value.size(), kPayloadBytes - payload_used - 1);
+    len = std::min<size_t>(len, 255);
+    arg_types[arg_count++] = LogArgType::STRING;
+    payload[payload_used] = static_cast<char>(len);
+    std::memcpy(payload + payload_used + 1, value.data(), len);
+    payload_used = static_cast<uint8_t>(payload_used + 1 + len);
+  }
+};
+
+inline void encode_log_arg(LogRecord& record, std::string_view value) { record.add_string(value); }
+inline void encode_log_arg(LogRecord& record, const std::string& value) {
+  record.add_string(value);
+}
+inline void encode_log_arg(LogRecord& record, const char* value) { record.add_string(value); }
+
+inline void encode_log_arg(LogRecord& record, OrderState value) {
+  int64_t raw = static_cast<int64_t>(value);
+  record.add_arg(LogArgType::ORDER_STATE, &raw, sizeof(raw));
+}
+
+template <typename T>
+inline std::enable_if_t<std::is_arithmetic_v<T>> encode_log_arg(LogRecord& record, T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    double raw = static_cast<double>(value);
+    record.add_arg(LogArgType::DOUBLE, &raw, sizeof(raw));
+  } else if constexpr (std::is_signed_v<T>) {
+    int64_t raw = static_cast<int64_t>(value);
+    record.add_arg(LogArgType::INT64, &raw, sizeof(raw));
+  } else {
+    uint64_t raw = static_cast<uint64_t>(value);
+    record.add_arg(LogArgType::UINT64, &raw, sizeof(raw));
+  }
+}
+
+template <typename... Args> inline void encode_log_args(LogRecord& record, const Args&... args) {
+  (encode_log_arg(record, args), ...);
+}
+
+// Substitute the record's arguments into its format (or return the free text)
+std::string render_log_message(const LogRecord& record);
+
+// Component name for structured records comes from the format table
+std::string_view log_record_component(const LogRecord& record);
+
+// Compact JSON line: {"component":..,"level":..,"message":..,"timestamp":..}
+std::string render_log_json(const LogRecord& record);
+
+// Compact binary encoding used by LogOutputFormat::BINARY and pulseexec_logdump
+void write_binary_log_record(std::ostream& out, const LogRecord& record);
+bool read_binary_log_record(std::istream& in, LogRecord& record);
+
+} // namespace pulseexec
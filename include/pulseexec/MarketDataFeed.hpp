@@ -0,0 +1,153 @@
+#pragma once
+
+#include "pulseexec/IncrementalBook.hpp"
+#include "pulseexec/OrderBook.hpp"
+#include <atomic>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace pulseexec {
+
+class JsonScanner;
+class Logger;
+class SessionRecorder;
+
+// WebSocket client for the exchange's incremental order book channels.
+//
+// Subscribes to "book.<instrument>.<interval>" over ws:// or wss:// and keeps a
+// full-depth IncrementalBook per instrument. Changes are chained by change id;
+// when a change does not follow the last applied one the book is dropped and
+// the channel is resubscribed, which makes the exchange send a fresh snapshot.
+// Dropped connections reconnect with exponential backoff and resubscribe
+// everything. All socket I/O and book updates run on one internal I/O thread;
+// get_book may be called from any thread.
+class MarketDataFeed {
+public:
+  struct Stats {
+    uint64_t messages = 0;
+    uint64_t deltas_applied = 0; // Snapshots and changes
+    uint64_t gaps = 0;
+    uint64_t dropped_changes = 0; // Arrived while waiting for a snapshot
+    uint64_t resnapshots = 0;
+    uint64_t reconnects = 0;
+  };
+
+  // Called on the I/O thread with the top `depth` levels after every applied delta
+  using BookHandler = std::function<void(const OrderBook&)>;
+
+  // url: ws://host[:port][/path] or wss://host[:port][/path]
+  MarketDataFeed(const std::string& url, std::shared_ptr<Logger> logger, size_t depth = 10,
+                 const std::string& interval = "100ms");
+  ~MarketDataFeed();
+
+  MarketDataFeed(const MarketDataFeed&) = delete;
+  MarketDataFeed& operator=(const MarketDataFeed&) = delete;
+
+  // May be called before or after start(); subscribing twice is a no-op
+  void subscribe(const std::string& instrument, const InstrumentScale& scale = InstrumentScale());
+
+  // Set before start()
+  void set_book_handler(BookHandler handler);
+
+  // Records subscriptions and every raw message for later replay. Set before
+  // subscribe() and start().
+  void set_recorder(std::shared_ptr<SessionRecorder> recorder);
+
+  // Returns false if the URL is invalid; connecting happens in the background
+  bool start();
+  void stop();
+
+  bool connected() const { return connected_.load(std::memory_order_relaxed); }
+
+  // Top `depth` levels; false if the instrument is unknown or not in sync
+  bool get_book(const std::string& instrument, OrderBook& out) const;
+
+  // Handle one raw feed message. Normally called by the I/O thread; public so
+  // recorded sessions can be replayed without a socket.
+  void process_message(std::string_view text);
+
+  Stats stats() const;
+
+private:
+  struct Connection;
+
+  struct Subscription {
+    explicit Subscription(std::string instrument, const InstrumentScale& scale)
+        : book(std::move(instrument), scale) {}
+
+    mutable std::mutex mutex;
+    IncrementalBook book;
+  };
+
+  std::string channel_for(const std::string& instrument) const;
+  std::string build_request(const std::string& method, const nlohmann::json& params);
+
+  // Reads the params object the scanner is positioned on
+  void handle_subscription(JsonScanner& params);
+  void request_snapshot(const std::string& channel);
+
+  // I/O thread only
+  void connect();
+  void on_tcp_connected(const std::shared_ptr<Connection>& conn);
+  void start_ws_handshake(const std::shared_ptr<Connection>& conn);
+  void on_open(const std::shared_ptr<Connection>& conn);
+  void read_next(const std::shared_ptr<Connection>& conn);
+  void write_next(const std::shared_ptr<Connection>& conn);
+  void on_disconnect(const std::shared_ptr<Connection>& conn, const std::string& what,
+                     const std::string& error);
+  void send(std::string text);
+  void close_connection();
+
+  // Safe from any thread; runs send() on the I/O thread
+  void send_async(std::string text);
+
+  std::string url_;
+  bool tls_ = false;
+  std::string host_;
+  std::string port_;
+  std::string path_;
+  std::shared_ptr<Logger> logger_;
+  size_t depth_;
+  std::string interval_;
+  BookHandler book_handler_;
+  std::shared_ptr<SessionRecorder> recorder_;
+
+  mutable std::shared_mutex subscriptions_mutex_;
+  std::unordered_map<std::string, std::unique_ptr<Subscription>> subscriptions_; // By channel
+
+  boost::asio::io_context io_;
+  std::unique_ptr<boost::asio::ssl::context> tls_context_;
+  std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>
+      work_guard_;
+  boost::asio::steady_timer reconnect_timer_;
+  std::thread io_thread_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> connected_{false};
+  std::atomic<uint64_t> next_request_id_{1};
+
+  // I/O thread only
+  std::shared_ptr<Connection> conn_;
+  std::chrono::milliseconds backoff_;
+
+  std::atomic<uint64_t> messages_{0};
+  std::atomic<uint64_t> deltas_applied_{0};
+  std::atomic<uint64_t> gaps_{0};
+  std::atomic<uint64_t> dropped_changes_{0};
+  std::atomic<uint64_t> resnapshots_{0};
+  std::atomic<uint64_t> reconnects_{0};
+};
+
+} // namespace pulseexec
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "pulseexec/FixedPoint.hpp"
+#include "pulseexec/Order.hpp"
+#include "pulseexec/OrderBook.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pulseexec {
+
+// An order as the matching engine sees it
+struct MatchingOrder {
+  uint64_t id = 0;
+  std::string label; // The client order ID the order was placed with
+  Side side = Side::BUY;
+  OrderType type = OrderType::LIMIT;
+  Price price;
+  Qty amount;
+  Qty filled;
+  OrderState state = OrderState::OPEN;
+  int64_t created_ts_ms = 0;
+  int64_t updated_ts_ms = 0;
+
+  Qty remaining() const { return amount - filled; }
+};
+
+struct MatchingFill {
+  uint64_t trade_id = 0;
+  uint64_t maker_id = 0;
+  uint64_t taker_id = 0;
+  Price price;
+  Qty amount;
+};
+
+// A level whose resting amount changed in the last operation; zero means the
+// level is gone
+struct MatchingLevelChange {
+  Side side = Side::BUY;
+  Price price;
+  Qty amount;
+};
+
+// Price-time priority limit order book for one instrument.
+//
+// Each side is a vector of levels sorted so the best one is at the back, as in
+// IncrementalBook; a level keeps its resting orders in a FIFO queue. Cancels
+// and priority-losing edits do not search the queue: the level's total is
+// reduced at once and the stale queue entry is skipped when matching reaches
+// it. Open orders stay queryable by ID, and so do the last
+// `terminal_retention` orders that filled, were canceled or were rejected;
+// older ones are dropped, so memory follows the open book rather than the
+// order history.
+//
+// Prices and amounts are brought onto the instrument's scale on entry. Market
+// orders take what liquidity there is and cancel the rest. Not thread-safe; the
+// owner serializes access.
+class MatchingEngine {
+public:
+  static constexpr size_t kDefaultTerminalRetention = 100000;
+
+  explicit MatchingEngine(std::string instrument, const InstrumentScale& scale = InstrumentScale(),
+                          size_t terminal_retention = kDefaultTerminalRetention);
+
+  // Matches against the other side and rests a limit remainder. Fills and
+  // level changes of this call are in fills() and level_changes(). nullptr,
+  // with the book untouched, if the ID is still open or retained.
+  const MatchingOrder* submit(uint64_t id, Side side, OrderType type, Price price, Qty amount,
+                              const std::string& label, int64_t now_ms);
+
+  // False if the order is unknown or no longer open
+  bool cancel(uint64_t id, int64_t now_ms);
+
+  // New price and total amount (filled included). The order keeps its place in
+  // the queue only if the price is unchanged and the amount does not grow. A
+  // new price that crosses the book matches. False if the order is unknown or
+  // no longer open, or if the amount is not above what has already filled.
+  bool edit(uint64_t id, Price price, Qty amount, int64_t now_ms);
+
+  // nullptr for unknown orders and for terminal ones past the retention
+  const MatchingOrder* find(uint64_t id) const;
+
+  // Copy the best `depth` levels per side (best first) into out
+  void top(size_t depth, OrderBook& out) const;
+
+  const std::vector<MatchingFill>& fills() const { return fills_; }
+  const std::vector<MatchingLevelChange>& level_changes() const { return level_changes_; }
+
+  const std::string& instrument() const { return instrument_; }
+  const InstrumentScale& scale() const { return scale_; }
+  size_t order_count() const { return orders_.size(); } // Open plus retained terminal
+  size_t bid_depth() const { return bids_.size(); }
+  size_t ask_depth() const { return asks_.size(); }
+  uint64_t trade_count() const { return next_trade_id_ - 1; }
+
+private:
+  struct QueueEntry {
+    uint64_t id;
+    uint64_t generation; // Stale once the order re-queued or left the book
+  };
+
+  struct Level {
+    Price price;
+    Qty total;
+    std::deque<QueueEntry> queue;
+  };
+
+  struct Resting {
+    MatchingOrder order;
+    uint64_t generation = 0;
+  };
+
+  // Best level at the back: bids ascend, asks descend
+  static bool better(Side side, Price a, Price b) { return side == Side::BUY ? a > b : a < b; }
+  std::vector<Level>& side_levels(Side side) { return side == Side::BUY ? bids_ : asks_; }
+
+  void begin_operation();
+  void match(Resting& taker, int64_t now_ms);
+  void rest(Resting& resting);
+  void reduce_level(Side side, Price price, Qty amount);
+  void touch(Side side, Price price);
+  void retire(uint64_t id);
+  void finish_operation();
+  const Level* find_level(Side side, Price price) const;
+
+  std::string instrument_;
+  InstrumentScale scale_;
+  std::vector<Level> bids_;
+  std::vector<Level> asks_;
+  std::unordered_map<uint64_t, Resting> orders_;
+  std::deque<uint64_t> terminal_; // Retained terminal orders, oldest first
+  size_t terminal_retention_;
+  uint64_t next_trade_id_ = 1;
+
+  // Results of the last operation
+  std::vector<MatchingFill> fills_;
+  std::vector<MatchingLevelChange> level_changes_;
+};
+
+} // namespace pulseexec
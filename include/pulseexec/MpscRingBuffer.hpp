@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace pulseexec {
+
+// Bounded lock-free multi-producer single-consumer ring buffer.
+//
+// Slots are preallocated and each carries a sequence number (Vyukov's bounded
+// queue), so producers claim a slot with one CAS on the tail and never touch a
+// lock. try_push fails instead of blocking when the ring is full. Capacity is
+// rounded up to a power of two.
+template <typename T> class MpscRingBuffer {
+public:
+  explicit MpscRingBuffer(size_t capacity)
+      : capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1),
+        slots_(std::make_unique<Slot[]>(capacity_)) {
+    for (size_t i = 0; i < capacity_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscRingBuffer(const MpscRingBuffer&) = delete;
+  MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+  // Safe to call from any number of threads. Returns false if the ring is full.
+  // T's move assignment must not throw.
+  bool try_push(T&& value) {
+    return try_push_with([&value](T& slot) noexcept(std::is_nothrow_move_assignable_v<T>) {
+      slot = std::move(value);
+    });
+  }
+
+  // Like try_push, but fill(T&) writes the claimed slot in place, which avoids
+  // building and moving a temporary. fill must overwrite every field the
+  // consumer reads; the slot still holds whatever the consumer left behind.
+  template <typename Fill> bool try_push_with(Fill&& fill) {
+    // A fill that threw would leave its claimed slot unpublished forever, and
+    // the consumer stuck behind it
+    static_assert(noexcept(fill(std::declval<T&>())), "fill must be noexcept");
+
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& slot = slots_[pos & mask_];
+      size_t seq = slot.sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          fill(slot.value);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false; // Full: the consumer has not freed this slot yet
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Consumer thread only. Returns false if the ring is empty.
+  bool try_pop(T& out) {
+    Slot& slot = slots_[head_ & mask_];
+    size_t seq = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(head_ + 1) < 0) {
+      return false;
+    }
+
+    out = std::move(slot.value);
+    slot.sequence.store(head_ + capacity_, std::memory_order_release);
+    ++head_;
+    return true;
+  }
+
+  // Consumer thread only
+  bool empty() const {
+    const Slot& slot = slots_[head_ & mask_];
+    return slot.sequence.load(std::memory_order_acquire) != head_ + 1;
+  }
+
+  size_t capacity() const { return capacity_; }
+
+private:
+  static constexpr size_t kCacheLine = 64;
+
+  struct alignas(kCacheLine) Slot {
+    std::atomic<size_t> sequence{0};
+    T value{};
+  };
+
+  static size_t round_up_pow2(size_t n) {
+    size_t cap = 1;
+    while (cap < n) {
+      cap <<= 1;
+    }
+    return cap;
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // Producers contend on tail_; keep it off the consumer's cache line
+  alignas(kCacheLine) std::atomic<size_t> tail_{0};
+  alignas(kCacheLine) size_t head_ = 0;
+};
+
+} // namespace pulseexec
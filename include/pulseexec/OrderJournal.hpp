@@ -0,0 +1,125 @@
+#pragma once
+
+#include "pulseexec/Order.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace pulseexec {
+
+class Logger;
+
+// One journaled order event: the full order as it was after a state change
+struct JournalRecord {
+  uint64_t sequence = 0;
+  Order order;
+};
+
+struct OrderJournalOptions {
+  bool fsync = true;                // append() returns once the record is on disk
+  size_t grow_bytes = 64u << 20;    // The file is extended and remapped in steps of this
+  size_t rotate_bytes = 256u << 20; // Checkpointed record bytes that rotate the file; 0 never
+  bool keep_rotated = false;        // Keep each rotated-out file as <path>.<last sequence>
+};
+
+// Append-only, checksummed journal of order state changes in a memory-mapped
+// file.
+//
+// append() encodes the order straight into the mapping and, with fsync on,
+// blocks until a background thread has made it durable. That thread issues
+// one fdatasync for everything appended since the previous one, so concurrent
+// appends share a sync (group commit) instead of paying for one each. A failed
+// fdatasync latches the journal as failed: the appends it covered, and every one
+// after, return 0, since a retried sync can report success for lost pages. Without
+// fsync a record survives a process crash as soon as append() returns, since
+// it is already in the page cache, but not a power loss.
+//
+// Each record carries a sequence number and a CRC-32 of its contents; opening
+// an existing journal scans forward to the first record that fails either
+// check, so a write torn by a crash is discarded and overwritten. replay()
+// walks the records in order.
+//
+// checkpoint() records how far SQLite is known to be up to date. Once at least
+// rotate_bytes of records are covered by it, the journal rotates: the records
+// after the checkpoint are copied to a new file, synced, and renamed over the
+// old one, so neither the file nor the scan on open grows without bound. With
+// keep_rotated the old file is kept alongside, and the journal files together
+// hold every transition for auditing.
+//
+// File layout: a 4 KiB header page (magic, checkpoint, sequence before the
+// first record), then records of
+// [u32 payload length][u32 crc][u64 sequence][payload], each padded to 8 bytes.
+class OrderJournal {
+public:
+  OrderJournal(const std::string& path, std::shared_ptr<Logger> logger,
+               OrderJournalOptions options = {});
+  ~OrderJournal();
+
+  OrderJournal(const OrderJournal&) = delete;
+  OrderJournal& operator=(const OrderJournal&) = delete;
+
+  // Creates or maps the file and finds the end of the valid records
+  bool open();
+  void close();
+  bool is_open() const { return base_ != nullptr; }
+
+  // Thread-safe. Returns the record's sequence, or 0 if it could not be written
+  // or, with fsync on, not made durable.
+  uint64_t append(const Order& order);
+
+  // Calls fn(const JournalRecord&) for every record after sequence `after`, in
+  // order, and returns how many there were. Records appended once the call has
+  // started are left out. Safe against concurrent appends; fn runs without the
+  // journal's lock, so it may append too.
+  size_t replay(uint64_t after, const std::function<void(const JournalRecord&)>& fn) const;
+
+  // Everything up to sequence is reflected in SQLite; persisted in the header.
+  // May rotate the file, blocking appends while the rest is copied.
+  void checkpoint(uint64_t sequence);
+  uint64_t checkpoint_sequence() const;
+
+  uint64_t last_sequence() const;
+  uint64_t durable_sequence() const;
+  uint64_t sync_count() const { return sync_count_.load(std::memory_order_relaxed); }
+  size_t size_bytes() const;
+  bool failed() const;
+
+private:
+  bool map(size_t size);
+  bool grow(size_t min_size);
+  size_t offset_after(uint64_t sequence) const;
+  bool rotate(std::unique_lock<std::mutex>& lock, uint64_t through);
+  void sync_thread();
+
+  std::string path_;
+  std::shared_ptr<Logger> logger_;
+  OrderJournalOptions options_;
+
+  int fd_ = -1;
+  char* base_ = nullptr;
+  size_t mapped_size_ = 0;
+
+  // Guards the mapping, end_offset_ and the sequences
+  mutable std::mutex mutex_;
+  size_t end_offset_ = 0;
+  uint64_t last_sequence_ = 0;
+  uint64_t durable_sequence_ = 0;
+  bool failed_ = false; // An fdatasync or remap failed; appends are refused
+  uint64_t rotations_ = 0; // Record offsets change with each rotation
+
+  // Group commit
+  std::thread syncer_;
+  bool running_ = false;
+  bool syncing_ = false; // The syncer is in fdatasync on fd_, outside the lock
+  std::condition_variable sync_cv_;    // Appends wake the syncer
+  std::condition_variable durable_cv_; // The syncer wakes waiting appends
+  std::atomic<uint64_t> sync_count_{0};
+};
+
+} // namespace pulseexec
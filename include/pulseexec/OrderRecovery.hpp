@@ -0,0 +1,75 @@
+#pragma once
+
+#include "pulseexec/Order.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pulseexec {
+
+class DBWriter;
+class ExecutionGateway;
+class Logger;
+class OrderJournal;
+class OrderManager;
+
+struct RecoveryStats {
+  size_t journal_replayed = 0; // Journal records after the checkpoint, re-applied to SQLite
+  size_t loaded = 0;      // Non-terminal rows read from the orders table
+  size_t restored = 0;    // Published into OrderManager
+  size_t queried = 0;     // Status requests sent to the exchange
+  size_t confirmed = 0;   // Exchange answered and agreed with the database
+  size_t updated = 0;     // Exchange answered with a newer state, which was applied
+  size_t not_found = 0;   // Never acknowledged, and no exchange order carries its label
+  size_t unconfirmed = 0; // Not found, request failed or timed out
+  int64_t load_us = 0;
+  int64_t reconcile_us = 0;
+};
+
+// Warm start: rebuilds OrderManager's open orders from the SQLite orders
+// table, then asks the exchange for the current state of each one.
+//
+// With a journal, SQLite is first brought up to date from it: every record
+// after the journal's checkpoint may have been lost from DBWriter's queue in
+// a crash, so the latest version of each order it touched is written again
+// (INSERT OR REPLACE makes that idempotent) before the table is read.
+//
+// Loading is a single read-only scan followed by a bulk restore into the
+// order store and both ID indexes; nothing is logged, re-persisted or
+// reported to update callbacks. Reconciliation keeps up to max_in_flight
+// get_order_state requests outstanding on the gateway's async loop and
+// applies any state the exchange reports that differs from the database.
+// Orders never acknowledged by the exchange have no exchange ID; they are
+// looked up by label (the client order ID) with get_order_state_by_label and
+// take the ID of the order found. Those the exchange does not know are left
+// as loaded, counted in not_found and logged for the operator to check.
+class OrderRecovery {
+public:
+  // gateway may be null to skip reconciliation
+  OrderRecovery(std::shared_ptr<Logger> logger, std::shared_ptr<DBWriter> db_writer,
+                std::shared_ptr<OrderManager> order_manager,
+                std::shared_ptr<ExecutionGateway> gateway, size_t max_in_flight = 64);
+
+  // Call before run(); the journal must be open
+  void set_journal(std::shared_ptr<OrderJournal> journal);
+
+  // Call after DBWriter::start() and before new orders are created. Waits at
+  // most reconcile_timeout for the exchange; later answers are still applied.
+  RecoveryStats run(std::chrono::milliseconds reconcile_timeout);
+
+private:
+  size_t replay_journal();
+  void reconcile(const std::vector<OrderHandle>& handles, std::chrono::milliseconds timeout,
+                 RecoveryStats& stats);
+
+  std::shared_ptr<Logger> logger_;
+  std::shared_ptr<DBWriter> db_writer_;
+  std::shared_ptr<OrderManager> order_manager_;
+  std::shared_ptr<ExecutionGateway> gateway_;
+  std::shared_ptr<OrderJournal> journal_;
+  size_t max_in_flight_;
+};
+
+} // namespace pulseexec
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "pulseexec/Order.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pulseexec {
+
+// Immutable version of an order. Readers and update subscribers share it;
+// it stays valid however the order changes afterwards.
+using OrderSnapshot = std::shared_ptr<const Order>;
+
+// Handle-indexed order storage.
+//
+// The low 32 bits of a handle are slot index + 1, so resolving one is two
+// array indexations: no hashing, no string compares. Slots live in
+// fixed-size chunks that are allocated on demand and never move, so
+// concurrent readers need no store-wide lock. retire() frees a slot for
+// reuse; the high 32 bits carry the slot's generation, so a retired handle
+// never resolves to the order that reused its slot.
+//
+// Each slot holds the order's current OrderSnapshot, RCU style: readers load
+// the pointer with std::atomic_load, writers serialize on the slot mutex, copy
+// the current version, modify the copy and publish it. Readers never wait for
+// the slot mutex or a writer's copy, and listing orders never deep-copies an
+// Order. They are not lock-free, though: libstdc++ implements the atomic
+// shared_ptr functions with a small pool of internal mutexes, hashed by
+// address, each held for one pointer swap or reference count update. The
+// store also keeps an index of active orders so they can be listed in
+// O(active).
+class OrderStore {
+public:
+  static constexpr size_t kChunkBits = 12;
+  static constexpr size_t kChunkSize = size_t(1) << kChunkBits;
+  static constexpr size_t kMaxChunks = 4096; // 16M orders
+
+  OrderStore();
+  ~OrderStore();
+
+  OrderStore(const OrderStore&) = delete;
+  OrderStore& operator=(const OrderStore&) = delete;
+
+  // Reserve a handle, reusing a retired slot when one is free; the slot stays
+  // invisible until publish(). Returns kInvalidOrderHandle when the store is full.
+  OrderHandle reserve();
+
+  // Give back a reserved handle that was never published
+  void release(OrderHandle handle);
+
+  // Remove a published order and free its slot; the handle stops resolving.
+  // Returns the removed version, or nullptr for unknown handles.
+  OrderSnapshot retire(OrderHandle handle);
+
+  // Store the order under a reserved handle and call fn(const OrderSnapshot&)
+  // while the order's writer lock is still held
+  template <typename F> void publish(OrderHandle handle, Order order, F&& fn) {
+    Slot* slot = slot_for(handle);
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    order.handle = handle;
+    OrderSnapshot snapshot = std::make_shared<const Order>(std::move(order));
+    std::atomic_store_explicit(&slot->current, snapshot, std::memory_order_release);
+    live_count_.fetch_add(1, std::memory_order_relaxed);
+    track_active(*slot, handle, snapshot->is_active());
+    fn(snapshot);
+  }
+
+  // Calls mutate(Order&) on a copy of the current version, publishes it, then
+  // calls on_updated(const OrderSnapshot&); both run under the order's writer
+  // lock. Returns false for unknown handles.
+  template <typename Mutate, typename OnUpdated>
+  bool update(OrderHandle handle, Mutate&& mutate, OnUpdated&& on_updated) {
+    Slot* slot = slot_for(handle);
+    if (!slot) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    OrderSnapshot current = std::atomic_load_explicit(&slot->current, std::memory_order_acquire);
+    if (!current || current->handle != handle) {
+      return false;
+    }
+
+    auto next = std::make_shared<Order>(*current);
+    mutate(*next);
+    OrderSnapshot snapshot = std::move(next);
+    std::atomic_store_explicit(&slot->current, snapshot, std::memory_order_release);
+    track_active(*slot, handle, snapshot->is_active());
+    on_updated(snapshot);
+    return true;
+  }
+
+  template <typename Mutate> bool update(OrderHandle handle, Mutate&& mutate) {
+    return update(handle, std::forward<Mutate>(mutate), [](const OrderSnapshot&) {});
+  }
+
+  // Current version of the order, or nullptr for unknown or retired handles.
+  // Never waits for the order's writer lock.
+  OrderSnapshot snapshot(OrderHandle handle) const {
+    const Slot* slot = slot_for(handle);
+    if (!slot) {
+      return nullptr;
+    }
+    OrderSnapshot order = std::atomic_load_explicit(&slot->current, std::memory_order_acquire);
+    return order && order->handle == handle ? order : nullptr;
+  }
+
+  template <typename F> bool read(OrderHandle handle, F&& fn) const {
+    OrderSnapshot order = snapshot(handle);
+    if (!order) {
+      return false;
+    }
+    fn(*order);
+    return true;
+  }
+
+  // Visits the current version of every stored order in slot order
+  template <typename F> void for_each(F&& fn) const {
+    for_each_snapshot([&fn](const OrderSnapshot& order) { fn(*order); });
+  }
+
+  template <typename F> void for_each_snapshot(F&& fn) const {
+    size_t count = slot_count();
+    for (size_t index = 0; index < count; ++index) {
+      const Slot* slot = slot_for(static_cast<OrderHandle>(index) + 1);
+      if (!slot) {
+        continue;
+      }
+      if (OrderSnapshot order =
+              std::atomic_load_explicit(&slot->current, std::memory_order_acquire)) {
+        fn(order);
+      }
+    }
+  }
+
+  // Visits active orders only, in no particular order. The index is copied
+  // under a short lock; orders that became inactive since are skipped.
+  template <typename F> void for_each_active(F&& fn) const {
+    std::vector<OrderHandle> handles;
+    {
+      std::lock_guard<std::mutex> lock(active_mutex_);
+      handles = active_;
+    }
+    for (OrderHandle handle : handles) {
+      OrderSnapshot order = snapshot(handle);
+      if (order && order->is_active()) {
+        fn(order);
+      }
+    }
+  }
+
+  size_t active_count() const {
+    std::lock_guard<std::mutex> lock(active_mutex_);
+    return active_.size();
+  }
+
+  // Orders published and not yet retired
+  size_t size() const { return live_count_.load(std::memory_order_relaxed); }
+
+  // Slots ever allocated; this, not size(), is what the store's memory follows
+  size_t slot_count() const {
+    return std::min<size_t>(next_index_.load(std::memory_order_acquire), kChunkSize * kMaxChunks);
+  }
+
+private:
+  static constexpr size_t kNotActive = static_cast<size_t>(-1);
+  static constexpr unsigned kGenerationShift = 32;
+
+  struct Slot {
+    std::mutex mutex;                // Serializes writers of this order
+    OrderSnapshot current;           // Accessed only through std::atomic_load/store
+    size_t active_pos = kNotActive;  // Position in active_; guarded by active_mutex_
+    uint32_t generation = 0;         // Bumped on release; guarded by free_mutex_
+  };
+
+  // Ignores the generation; callers compare the stored order's handle
+  Slot* slot_for(OrderHandle handle) const;
+
+  // Called with the slot's writer lock held; ignores stale handles
+  void free_slot(Slot& slot, OrderHandle handle);
+
+  // Called with the slot's writer lock held
+  void track_active(Slot& slot, OrderHandle handle, bool active);
+
+  std::unique_ptr<std::atomic<Slot*>[]> chunks_;
+  std::atomic<size_t> next_index_{0};
+  std::atomic<size_t> live_count_{0};
+
+  // Retired slot indexes, reused most recently freed first
+  std::mutex free_mutex_;
+  std::vector<uint32_t> free_slots_;
+
+  // Unordered set of active handles; removal swaps the last entry into the hole
+  mutable std::mutex active_mutex_;
+  std::vector<OrderHandle> active_;
+};
+
+} // namespace pulseexec
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "pulseexec/MpscRingBuffer.hpp"
+#include "pulseexec/OrderStore.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pulseexec {
+
+using OrderUpdateCallback = std::function<void(const Order&)>;
+
+// Delivers order updates to subscribers on a dedicated dispatcher thread.
+//
+// publish() pushes an immutable OrderSnapshot (the version OrderStore just
+// published) onto a lock-free MPSC ring, so the caller (OrderManager, under
+// the order's lock) never runs subscriber code. Snapshots are delivered in
+// publish order, which keeps each order's updates in sequence. A slow subscriber delays later
+// deliveries but no longer stalls order state transitions; its lag (published
+// but not yet delivered) is visible through subscriber_stats().
+//
+// No update is dropped. When the ring is full, snapshots go to an overflow
+// list that keeps only the latest snapshot of each order, so a subscriber
+// that falls behind skips intermediate states but always sees an order's
+// latest one, terminal states included. The overflow holds at most one
+// snapshot per order. Until the dispatcher has delivered it, later updates
+// go there too, which keeps each order's updates in sequence.
+class OrderUpdateDispatcher {
+public:
+  using SubscriberId = uint64_t;
+
+  struct SubscriberStats {
+    SubscriberId id = 0;
+    uint64_t delivered = 0;
+    uint64_t lag = 0;      // Published since subscribing, not yet delivered
+    uint64_t failures = 0; // Callbacks that threw
+  };
+
+  explicit OrderUpdateDispatcher(size_t queue_capacity = 65536);
+  ~OrderUpdateDispatcher();
+
+  OrderUpdateDispatcher(const OrderUpdateDispatcher&) = delete;
+  OrderUpdateDispatcher& operator=(const OrderUpdateDispatcher&) = delete;
+
+  // Starts the dispatcher thread on first use
+  SubscriberId subscribe(OrderUpdateCallback callback);
+  void unsubscribe(SubscriberId id);
+  bool has_subscribers() const { return subscriber_count_.load(std::memory_order_acquire) > 0; }
+
+  // Any thread; a no-op without subscribers
+  void publish(OrderSnapshot snapshot);
+  // Copies order into a new snapshot first
+  void publish(const Order& order);
+
+  // Delivers everything queued, then stops the thread
+  void stop();
+
+  // Blocks until every update published so far has been delivered
+  bool wait_idle(std::chrono::milliseconds timeout) const;
+
+  std::vector<SubscriberStats> subscriber_stats() const;
+  uint64_t published_count() const { return published_.load(std::memory_order_relaxed); }
+  // Snapshots replaced in the overflow by a newer one of the same order
+  uint64_t coalesced_count() const { return coalesced_.load(std::memory_order_relaxed); }
+
+private:
+  struct Subscriber {
+    SubscriberId id;
+    OrderUpdateCallback callback;
+    uint64_t published_at_subscribe;
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> failures{0};
+  };
+  using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+  void dispatcher_thread();
+  void deliver(const OrderSnapshot& snapshot, const SubscriberList& subscribers);
+  void overflow(OrderSnapshot snapshot);
+  bool take_overflow(std::vector<OrderSnapshot>& out);
+
+  MpscRingBuffer<OrderSnapshot> ring_;
+  std::atomic<uint64_t> published_{0};
+  std::atomic<uint64_t> dispatched_{0};
+  std::atomic<uint64_t> coalesced_{0};
+
+  // Latest snapshot per order, in order of first overflow. While
+  // overflowing_ is set, publishers bypass the ring.
+  std::mutex overflow_mutex_;
+  std::vector<OrderSnapshot> overflow_;
+  std::unordered_map<std::string, size_t> overflow_index_;
+  std::atomic<bool> overflowing_{false};
+
+  // Copy-on-write: the dispatcher picks up a new list when version_ changes
+  mutable std::mutex subscribers_mutex_;
+  std::shared_ptr<const SubscriberList> subscribers_;
+  std::atomic<uint64_t> version_{0};
+  std::atomic<size_t> subscriber_count_{0};
+  SubscriberId next_id_ = 1;
+
+  std::thread worker_;
+  std::atomic<bool> running_{false};
+  std::mutex lifecycle_mutex_;
+
+  // Parking, as in Logger: publishers only touch the mutex when the thread sleeps
+  std::mutex park_mutex_;
+  std::condition_variable park_cv_;
+  std::atomic<bool> consumer_parked_{false};
+};
+
+} // namespace pulseexec
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace pulseexec {
+
+// Client-side model of Deribit's credit-based rate limits.
+//
+// The exchange meters an account through two pools: requests that reach the
+// matching engine (buy, sell, edit, cancel and friends) and everything else.
+// Each pool holds up to `capacity` credits, refills at `refill_per_sec` and
+// every request takes `cost` from it; a request finding too few credits is
+// answered with HTTP 429 and, repeated often enough, the session is cut off.
+// ExecutionGateway asks this limiter first so that over-limit requests wait or
+// fail locally instead of spending a round trip on a rejection.
+//
+// Each pool is a token bucket kept as a single atomic: the time at which it
+// will be full again. Taking credits is a compare-and-swap on that, so the
+// order path never takes a lock. A request the pool cannot serve yet may
+// reserve credits up to `max_wait` ahead and is told how long to hold back;
+// past that it is rejected without touching the pool.
+class RateLimiter {
+public:
+  enum class Pool : uint8_t { MATCHING_ENGINE = 0, NON_MATCHING = 1 };
+
+  struct PoolConfig {
+    int64_t capacity = 0;
+    int64_t refill_per_sec = 0; // 0 leaves the pool unlimited
+    int64_t cost = 1;
+  };
+
+  // Defaults are Deribit's for an account without a volume tier: 5 matching
+  // engine requests a second with bursts of 20, and non-matching requests at
+  // 500 credits each from a 50,000 credit pool refilled at 10,000 a second.
+  struct Config {
+    PoolConfig matching_engine{20, 5, 1};
+    PoolConfig non_matching{50000, 10000, 500};
+    std::chrono::milliseconds max_wait{50};
+  };
+
+  struct Credits {
+    int64_t available = 0; // Negative while requests wait on reserved credits
+    int64_t capacity = 0;
+    uint64_t delayed = 0;  // Requests that had to wait for credits
+    uint64_t rejected = 0; // Requests refused locally
+    uint64_t exchange_rejections = 0; // 429s that got through anyway
+  };
+
+  RateLimiter();
+  explicit RateLimiter(const Config& config);
+
+  RateLimiter(const RateLimiter&) = delete;
+  RateLimiter& operator=(const RateLimiter&) = delete;
+
+  // Pool a REST endpoint ("/api/v2/private/buy?...") draws from
+  static Pool pool_for(std::string_view endpoint);
+
+  // Takes one request's credits. Returns false if they would not be there
+  // within max_wait; otherwise `wait` is how long the request must be held
+  // back before sending (zero when the pool had them). Thread-safe.
+  bool acquire(Pool pool, std::chrono::microseconds& wait);
+
+  // The exchange answered 429: its view of the pool is empty, so stop
+  // spending until this side's copy has refilled too
+  void on_rate_limited(Pool pool);
+
+  Credits credits(Pool pool) const;
+
+private:
+  struct Bucket {
+    int64_t capacity = 0;
+    int64_t ns_per_credit = 0; // 0 when unlimited
+    int64_t cost_ns = 0;       // Refill time of one request's credits
+    int64_t burst_ns = 0;      // Refill time of the whole pool
+    std::atomic<int64_t> full_at_ns{0};
+    std::atomic<uint64_t> delayed{0};
+    std::atomic<uint64_t> rejected{0};
+    std::atomic<uint64_t> exchange_rejections{0};
+  };
+
+  static void configure(Bucket& bucket, const PoolConfig& config);
+  Bucket& bucket(Pool pool) { return buckets_[static_cast<size_t>(pool)]; }
+  const Bucket& bucket(Pool pool) const { return buckets_[static_cast<size_t>(pool)]; }
+
+  Bucket buckets_[2];
+  int64_t max_wait_ns_;
+};
+
+} // namespace pulseexec
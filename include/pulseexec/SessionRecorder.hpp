@@ -0,0 +1,187 @@
+#pragma once
+
+#include "pulseexec/FixedPoint.hpp"
+#include "pulseexec/Order.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace pulseexec {
+
+class Logger;
+class MarketDataFeed;
+class OrderManager;
+
+enum class SessionEventType : uint8_t {
+  FEED_SUBSCRIBE = 1,   // MarketDataFeed::subscribe
+  MARKET_DATA = 2,      // One raw feed message, as handed to process_message
+  GATEWAY_RESPONSE = 3, // Final response to an ExecutionGateway request, after retries
+  ORDER_CREATE = 4,     // OrderManager::create_order
+  ORDER_UPDATE = 5,     // OrderManager::update_order
+  ORDER_RESTORE = 6,    // OrderManager::restore_orders, one event per order
+};
+
+// One recorded input. Which fields are meaningful depends on type:
+//   FEED_SUBSCRIBE    text (instrument), scale
+//   MARKET_DATA       text
+//   GATEWAY_RESPONSE  endpoint, http_status, success, text (body)
+//   ORDER_CREATE      order.client_order_id, order.request
+//   ORDER_UPDATE      order.client_order_id, order.state, order.exchange_order_id,
+//                     order.filled_amount, order.error_message
+//   ORDER_RESTORE     order
+struct SessionEvent {
+  SessionEventType type = SessionEventType::MARKET_DATA;
+  int64_t ts_us = 0; // Since the recording started
+  std::string text;
+  std::string endpoint;
+  int http_status = 0;
+  bool success = false;
+  InstrumentScale scale;
+  Order order;
+};
+
+// Records the inputs of a session (market data, gateway responses and order
+// commands) so an incident can be reproduced offline with SessionReplayer.
+//
+// Components hold a shared_ptr to the recorder (set_recorder) and report each
+// input as it arrives, from whatever thread they run on. Events are encoded
+// under one mutex, which also fixes their order in the file, and go through a
+// stdio buffer, so a record costs an encode and a memcpy. The buffer is
+// flushed every 256 records and by a background thread every 100 ms, so a
+// crash loses at most that much of the tail, and the reader stops cleanly at a
+// torn last record. A failed write is logged and stops the recording;
+// failed() reports it.
+//
+// File layout: an 8-byte magic and the wall-clock start time (u64 us), then
+// records of [u32 length][u8 type][varint us since the previous record][fields],
+// with integers as varints and strings as varint length + bytes.
+class SessionRecorder {
+public:
+  SessionRecorder(const std::string& path, std::shared_ptr<Logger> logger);
+  ~SessionRecorder();
+
+  SessionRecorder(const SessionRecorder&) = delete;
+  SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+  // Truncates path and writes the header
+  bool open();
+  void close();
+  bool is_open() const;
+
+  // Thread-safe; no-ops while the recorder is closed
+  void record_feed_subscribe(const std::string& instrument, const InstrumentScale& scale);
+  void record_market_data(std::string_view text);
+  void record_gateway_response(const std::string& endpoint, int http_status, bool success,
+                               const std::string& body);
+  void record_order_create(const Order& order);
+  void record_order_update(const std::string& client_order_id, OrderState state,
+                           const std::string& exchange_order_id, Qty filled_amount,
+                           const std::string& error_msg);
+  void record_order_restore(const Order& order);
+
+  uint64_t event_count() const;
+  uint64_t bytes_written() const;
+
+  // A write or flush failed and recording stopped
+  bool failed() const;
+
+private:
+  // Caller holds mutex_. begin_record starts record_ with the type and
+  // timestamp; end_record fills in the length and hands it to stdio.
+  void begin_record(SessionEventType type);
+  void end_record();
+  void flush_locked();
+  void fail_locked(const char* what);
+
+  // Flushes whatever the last kFlushInterval left in the stdio buffer
+  void flush_loop();
+
+  std::string path_;
+  std::shared_ptr<Logger> logger_;
+
+  mutable std::mutex mutex_;
+  FILE* file_ = nullptr;
+  std::string record_; // Scratch for the record being encoded
+  std::chrono::steady_clock::time_point start_;
+  int64_t last_ts_us_ = 0;
+  uint64_t event_count_ = 0;
+  uint64_t bytes_written_ = 0;
+  uint64_t unflushed_records_ = 0;
+  bool failed_ = false;
+
+  std::condition_variable flush_cv_;
+  bool flusher_stop_ = false;
+  std::thread flusher_;
+};
+
+// Reads a recorded session back one event at a time
+class SessionReader {
+public:
+  explicit SessionReader(const std::string& path);
+  ~SessionReader();
+
+  SessionReader(const SessionReader&) = delete;
+  SessionReader& operator=(const SessionReader&) = delete;
+
+  // False if the file is missing or not a session recording
+  bool open();
+
+  // False at the end of the file or at the first record that cannot be decoded
+  bool next(SessionEvent& event);
+
+  // The last next() stopped at a partial or undecodable record, not at the end
+  bool truncated() const { return truncated_; }
+  int64_t start_wall_us() const { return start_wall_us_; }
+
+private:
+  std::string path_;
+  FILE* file_ = nullptr;
+  std::string record_;
+  int64_t ts_us_ = 0;
+  int64_t start_wall_us_ = 0;
+  bool truncated_ = false;
+};
+
+struct ReplayStats {
+  uint64_t events = 0;
+  uint64_t market_data = 0;
+  uint64_t gateway_responses = 0;
+  uint64_t gateway_errors = 0;   // Responses that parse to a failed result
+  uint64_t order_commands = 0;   // Creates, updates and restores
+  uint64_t commands_failed = 0;  // Rejected by OrderManager (duplicate or unknown order)
+  bool truncated = false;
+  int64_t recorded_us = 0;       // Span of the recording
+  int64_t elapsed_us = 0;        // Wall time of the replay
+};
+
+// Feeds a recorded session back through MarketDataFeed::process_message,
+// the gateway's response parsers and OrderManager, on the calling thread.
+//
+// speed scales the recorded gaps between events: 1.0 replays in real time,
+// 10.0 ten times faster, and 0 as fast as possible, which makes the replay a
+// network-free throughput benchmark of the whole pipeline. Order commands
+// reuse the recorded client order IDs, so the order manager should start
+// empty; either component may be null to skip its events.
+class SessionReplayer {
+public:
+  SessionReplayer(std::shared_ptr<Logger> logger, std::shared_ptr<OrderManager> order_manager,
+                  std::shared_ptr<MarketDataFeed> feed);
+
+  // False if the file cannot be opened; stats are filled either way
+  bool run(const std::string& path, double speed, ReplayStats& stats);
+
+private:
+  void apply(const SessionEvent& event, ReplayStats& stats);
+
+  std::shared_ptr<Logger> logger_;
+  std::shared_ptr<OrderManager> order_manager_;
+  std::shared_ptr<MarketDataFeed> feed_;
+};
+
+} // namespace pulseexec
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pulseexec {
+
+// String-keyed hash map split into independently locked shards.
+//
+// A key's shard is picked from the high bits of its hash, so unrelated keys
+// rarely share a lock. Each shard is a flat open-addressing table (linear
+// probing, backward-shift erase) stored in one vector, so lookups touch
+// contiguous memory instead of chasing node pointers. Values move when a
+// shard grows, so callers never get references that outlive the lock: access
+// goes through visitor functions that run while the shard lock is held.
+// Readers take the shard lock shared and run in parallel.
+template <typename V> class ShardedFlatMap {
+public:
+  explicit ShardedFlatMap(size_t shard_count = 64, size_t initial_capacity = 16)
+      : shard_bits_(log2_ceil(shard_count)), shards_(size_t(1) << shard_bits_) {
+    for (auto& shard : shards_) {
+      shard.slots.resize(round_up_pow2(std::max<size_t>(initial_capacity, 2)));
+    }
+  }
+
+  ShardedFlatMap(const ShardedFlatMap&) = delete;
+  ShardedFlatMap& operator=(const ShardedFlatMap&) = delete;
+
+  // Insert key -> value; returns false (and leaves the map unchanged) if the key exists
+  bool insert(const std::string& key, V value) {
+    return insert_with(key, std::move(value), [](V&) {});
+  }
+
+  // Like insert, but on success calls on_inserted(V&) while the shard is still locked
+  template <typename F> bool insert_with(const std::string& key, V value, F&& on_inserted) {
+    uint64_t hash = hash_key(key);
+    Shard& shard = shard_for(hash);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    if (find_slot(shard, hash, key) != kNotFound) {
+      return false;
+    }
+    V& stored = emplace_new(shard, hash, key, std::move(value));
+    on_inserted(stored);
+    return true;
+  }
+
+  void insert_or_assign(const std::string& key, V value) {
+    uint64_t hash = hash_key(key);
+    Shard& shard = shard_for(hash);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    size_t index = find_slot(shard, hash, key);
+    if (index != kNotFound) {
+      shard.slots[index].value = std::move(value);
+    } else {
+      emplace_new(shard, hash, key, std::move(value));
+    }
+  }
+
+  // Calls fn(V&) under the shard's exclusive lock; returns false if key is absent
+  template <typename F> bool update(const std::string& key, F&& fn) {
+    uint64_t hash = hash_key(key);
+    Shard& shard = shard_for(hash);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    size_t index = find_slot(shard, hash, key);
+    if (index == kNotFound) {
+      return false;
+    }
+    fn(shard.slots[index].value);
+    return true;
+  }
+
+  // Calls fn(const V&) under the shard's shared lock; returns false if key is absent
+  template <typename F> bool read(const std::string& key, F&& fn) const {
+    uint64_t hash = hash_key(key);
+    const Shard& shard = shard_for(hash);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+    size_t index = find_slot(shard, hash, key);
+    if (index == kNotFound) {
+      return false;
+    }
+    fn(shard.slots[index].value);
+    return true;
+  }
+
+  bool contains(const std::string& key) const {
+    return read(key, [](const V&) {});
+  }
+
+  bool erase(const std::string& key) {
+    return erase_if(key, [](const V&) { return true; });
+  }
+
+  // Erases key only if pred(const V&) holds, checked under the shard lock
+  template <typename Pred> bool erase_if(const std::string& key, Pred&& pred) {
+    uint64_t hash = hash_key(key);
+    Shard& shard = shard_for(hash);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    size_t index = find_slot(shard, hash, key);
+    if (index == kNotFound || !pred(std::as_const(shard.slots[index].value))) {
+      return false;
+    }
+
+    // Backward-shift deletion: pull later entries of the probe run into the
+    // hole so lookups never need tombstones
+    size_t mask = shard.slots.size() - 1;
+    size_t hole = index;
+    for (size_t next = (hole + 1) & mask; shard.slots[next].occupied; next = (next + 1) & mask) {
+      size_t home = shard.slots[next].hash & mask;
+      // Move next into the hole unless its home lies cyclically in (hole, next]
+      bool stays = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+      if (!stays) {
+        shard.slots[hole] = std::move(shard.slots[next]);
+        hole = next;
+      }
+    }
+    shard.slots[hole] = Slot{};
+    --shard.size;
+    return true;
+  }
+
+  // Visits every entry, one shard at a time under its shared lock. Entries
+  // inserted or erased concurrently may or may not be seen.
+  template <typename F> void for_each(F&& fn) const {
+    for (const auto& shard : shards_) {
+      std::shared_lock<std::shared_mutex> lock(shard.mutex);
+      for (const auto& slot : shard.slots) {
+        if (slot.occupied) {
+          fn(slot.key, slot.value);
+        }
+      }
+    }
+  }
+
+  size_t size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+      std::shared_lock<std::shared_mutex> lock(shard.mutex);
+      total += shard.size;
+    }
+    return total;
+  }
+
+  size_t shard_count() const { return shards_.size(); }
+
+private:
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+  static constexpr size_t kCacheLine = 64;
+
+  struct Slot {
+    bool occupied = false;
+    uint64_t hash = 0;
+    std::string key;
+    V value{};
+  };
+
+  struct alignas(kCacheLine) Shard {
+    mutable std::shared_mutex mutex;
+    std::vector<Slot> slots;
+    size_t size = 0;
+  };
+
+  static uint64_t hash_key(const std::string& key) {
+    // Mix so shard (high bits) and slot (low bits) selection are independent
+    uint64_t h = std::hash<std::string>{}(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  static size_t round_up_pow2(size_t n) {
+    size_t cap = 1;
+    while (cap < n) {
+      cap <<= 1;
+    }
+    return cap;
+  }
+
+  static unsigned log2_ceil(size_t n) {
+    unsigned bits = 0;
+    while ((size_t(1) << bits) < n) {
+      ++bits;
+    }
+    return bits;
+  }
+
+  Shard& shard_for(uint64_t hash) {
+    return shards_[shard_bits_ == 0 ? 0 : hash >> (64 - shard_bits_)];
+  }
+  const Shard& shard_for(uint64_t hash) const {
+    return shards_[shard_bits_ == 0 ? 0 : hash >> (64 - shard_bits_)];
+  }
+
+  static size_t find_slot(const Shard& shard, uint64_t hash, const std::string& key) {
+    size_t mask = shard.slots.size() - 1;
+    for (size_t index = hash & mask; shard.slots[index].occupied; index = (index + 1) & mask) {
+      const Slot& slot = shard.slots[index];
+      if (slot.hash == hash && slot.key == key) {
+        return index;
+      }
+    }
+    return kNotFound;
+  }
+
+  // Caller holds the shard lock and has checked that key is absent
+  static V& emplace_new(Shard& shard, uint64_t hash, const std::string& key, V&& value) {
+    if ((shard.size + 1) * 4 > shard.slots.size() * 3) {
+      grow(shard);
+    }
+
+    size_t mask = shard.slots.size() - 1;
+    size_t index = hash & mask;
+    while (shard.slots[index].occupied) {
+      index = (index + 1) & mask;
+    }
+
+    Slot& slot = shard.slots[index];
+    slot.occupied = true;
+    slot.hash = hash;
+    slot.key = key;
+    slot.value = std::move(value);
+    ++shard.size;
+    return slot.value;
+  }
+
+  static void grow(Shard& shard) {
+    std::vector<Slot> old = std::move(shard.slots);
+    shard.slots = std::vector<Slot>(old.size() * 2);
+    size_t mask = shard.slots.size() - 1;
+
+    for (auto& slot : old) {
+      if (!slot.occupied) {
+        continue;
+      }
+      size_t index = slot.hash & mask;
+      while (shard.slots[index].occupied) {
+        index = (index + 1) & mask;
+      }
+      shard.slots[index] = std::move(slot);
+    }
+  }
+
+  const unsigned shard_bits_;
+  std::vector<Shard> shards_;
+};
+
+} // namespace pulseexec
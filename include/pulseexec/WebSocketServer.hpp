@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pulseexec {
+
+class Logger;
+
+// A frame serialized once by publish() and shared by every session it is sent to
+struct OutboundMessage {
+  std::string topic;
+  std::string text;
+};
+using SharedMessage = std::shared_ptr<const OutboundMessage>;
+
+enum class SlowConsumerPolicy {
+  DISCONNECT, // Close a session whose send queue is full
+  CONFLATE,   // Replace the queued message for the same topic; close only if there is none
+};
+
+struct WebSocketServerOptions {
+  size_t io_threads = 2;
+  size_t max_queued_messages = 256; // Per session
+  SlowConsumerPolicy slow_consumer_policy = SlowConsumerPolicy::CONFLATE;
+};
+
+// Bounded per-session send queue. The front message stays queued while it is
+// being written and is never conflated.
+class SendQueue {
+public:
+  enum class PushResult { QUEUED, CONFLATED, FULL };
+
+  SendQueue(size_t capacity, SlowConsumerPolicy policy) : capacity_(capacity), policy_(policy) {}
+
+  PushResult push(SharedMessage message);
+
+  // Marks the front message in flight and returns it; queue must not be empty
+  const SharedMessage& begin_write();
+  void end_write();
+
+  bool writing() const { return writing_; }
+  bool empty() const { return messages_.empty(); }
+  size_t size() const { return messages_.size(); }
+
+private:
+  size_t capacity_;
+  SlowConsumerPolicy policy_;
+  std::deque<SharedMessage> messages_;
+  bool writing_ = false;
+};
+
+// WebSocket server that fans topic updates out to subscribed clients.
+//
+// Clients send JSON-RPC requests {"id":1,"method":"subscribe","params":
+// {"topics":["book.BTC-PERPETUAL"]}} (or "unsubscribe") and receive
+// {"method":"subscription","params":{"channel":<topic>,"data":<payload>}}
+// notifications. publish() serializes each update once; sessions share the
+// frame by reference count. Each session runs on its own strand of a
+// multi-threaded io_context and owns a bounded send queue, so a slow client
+// only ever delays itself: when its queue fills it is conflated or disconnected
+// according to the slow-consumer policy.
+class WebSocketServer {
+public:
+  struct Stats {
+    uint64_t sessions_accepted = 0;
+    uint64_t sessions_active = 0;
+    uint64_t messages_published = 0;
+    uint64_t frames_queued = 0;
+    uint64_t frames_sent = 0;
+    uint64_t frames_conflated = 0;
+    uint64_t slow_consumer_disconnects = 0;
+  };
+
+  // port 0 picks a free port; see port()
+  WebSocketServer(const std::string& address, uint16_t port, std::shared_ptr<Logger> logger,
+                  const WebSocketServerOptions& options = WebSocketServerOptions());
+  ~WebSocketServer();
+
+  WebSocketServer(const WebSocketServer&) = delete;
+  WebSocketServer& operator=(const WebSocketServer&) = delete;
+
+  // Binds and starts accepting; false if the address cannot be bound
+  bool start();
+  void stop();
+
+  uint16_t port() const { return bound_port_; }
+
+  // Queue data (a JSON value) for every subscriber of topic. Safe from any
+  // thread; returns the number of sessions it was queued for.
+  size_t publish(const std::string& topic, std::string_view data_json);
+
+  size_t subscriber_count(const std::string& topic) const;
+  Stats stats() const;
+
+private:
+  class Session;
+  friend class Session;
+
+  void accept_next();
+  void subscribe(const std::shared_ptr<Session>& session, const std::string& topic);
+  void unsubscribe(const std::shared_ptr<Session>& session, const std::string& topic);
+  void remove_session(const std::shared_ptr<Session>& session);
+
+  std::string address_;
+  uint16_t port_;
+  uint16_t bound_port_ = 0;
+  std::shared_ptr<Logger> logger_;
+  WebSocketServerOptions options_;
+
+  boost::asio::io_context io_;
+  std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>
+      work_guard_;
+  std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor_;
+  std::vector<std::thread> io_threads_;
+  std::atomic<bool> running_{false};
+
+  // Guards both maps; publish takes it shared
+  mutable std::shared_mutex sessions_mutex_;
+  std::unordered_map<std::string, std::vector<std::shared_ptr<Session>>> subscribers_;
+  std::unordered_map<Session*, std::shared_ptr<Session>> sessions_;
+
+  std::atomic<uint64_t> sessions_accepted_{0};
+  std::atomic<uint64_t> messages_published_{0};
+  std::atomic<uint64_t> frames_queued_{0};
+  std::atomic<uint64_t> frames_sent_{0};
+  std::atomic<uint64_t> frames_conflated_{0};
+  std::atomic<uint64_t> slow_consumer_disconnects_{0};
+};
+
+} // namespace pulseexec
@@ -0,0 +1,127 @@
+#include "pulseexec/CurlHandlePool.hpp"
+
+namespace pulseexec {
+
+CurlHandlePool::CurlHandlePool(size_t pool_size)
+    : pool_size_(pool_size), share_(nullptr), total_handles_(0) {
+  if (pool_size_ == 0) {
+    return; // Per-call handles, nothing to share
+  }
+
+  share_ = curl_share_init();
+  if (share_) {
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &CurlHandlePool::share_lock);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &CurlHandlePool::share_unlock);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+  }
+
+  idle_handles_.reserve(pool_size_);
+}
+
+CurlHandlePool::~CurlHandlePool() {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  for (CURL* handle : idle_handles_) {
+    curl_easy_cleanup(handle);
+  }
+  idle_handles_.clear();
+
+  // All handles must be cleaned up before the share they reference
+  if (share_) {
+    curl_share_cleanup(share_);
+    share_ = nullptr;
+  }
+}
+
+CurlHandlePool::Lease CurlHandlePool::acquire() {
+  if (pool_size_ == 0) {
+    CURL* handle = create_handle();
+    return handle ? Lease(this, handle) : Lease();
+  }
+
+  CURL* handle = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    pool_cv_.wait(lock, [this] { return !idle_handles_.empty() || total_handles_ < pool_size_; });
+
+    if (!idle_handles_.empty()) {
+      handle = idle_handles_.back();
+      idle_handles_.pop_back();
+    } else {
+      ++total_handles_;
+    }
+  }
+
+  if (handle) {
+    // Reset per-request options; live connections and caches survive a reset
+    curl_easy_reset(handle);
+    apply_defaults(handle);
+    return Lease(this, handle);
+  }
+
+  handle = create_handle();
+  if (!handle) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    --total_handles_;
+    pool_cv_.notify_one();
+    return Lease();
+  }
+
+  return Lease(this, handle);
+}
+
+size_t CurlHandlePool::idle_count() const {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  return idle_handles_.size();
+}
+
+void CurlHandlePool::release(CURL* handle) {
+  if (pool_size_ == 0) {
+    curl_easy_cleanup(handle);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    idle_handles_.push_back(handle);
+  }
+  pool_cv_.notify_one();
+}
+
+CURL* CurlHandlePool::create_handle() {
+  CURL* handle = curl_easy_init();
+  if (handle) {
+    created_count_.fetch_add(1, std::memory_order_relaxed);
+    apply_defaults(handle);
+  }
+  return handle;
+}
+
+void CurlHandlePool::apply_defaults(CURL* handle) {
+  if (share_) {
+    curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+  }
+
+  // Keep idle connections warm and avoid Nagle delays on small request bodies
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPIDLE, 30L);
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPINTVL, 15L);
+  curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+  curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(handle, CURLOPT_DNS_CACHE_TIMEOUT, 300L);
+}
+
+void CurlHandlePool::share_lock(CURL* /*handle*/, curl_lock_data data,
+                                curl_lock_access /*access*/, void* userptr) {
+  auto* pool = static_cast<CurlHandlePool*>(userptr);
+  pool->share_mutexes_[data].lock();
+}
+
+void CurlHandlePool::share_unlock(CURL* /*handle*/, curl_lock_data data, void* userptr) {
+  auto* pool = static_cast<CurlHandlePool*>(userptr);
+  pool->share_mutexes_[data].unlock();
+}
+
+} // namespace pulseexec
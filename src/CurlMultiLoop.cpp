@@ -0,0 +1,267 @@
+#include "pulseexec/CurlMultiLoop.hpp"
+#include <algorithm>
+
+namespace pulseexec {
+
+// Upper bound on a single poll so the loop notices stop() promptly
+static constexpr int kMaxPollMs = 100;
+
+// A throwing callback must not take the loop thread down with it
+static void complete(const CurlMultiLoop::Completion& on_complete,
+                     const CurlMultiLoop::Response& response) {
+  try {
+    on_complete(response);
+  } catch (...) {
+  }
+}
+
+static size_t write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
+  ((std::string*)userp)->append((char*)contents, size * nmemb);
+  return size * nmemb;
+}
+
+CurlMultiLoop::CurlMultiLoop(size_t max_connections)
+    : max_connections_(max_connections), multi_(curl_multi_init()) {
+  if (multi_) {
+    long max_conn = static_cast<long>(max_connections_);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, max_conn);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, max_conn);
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, max_conn);
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  }
+}
+
+CurlMultiLoop::~CurlMultiLoop() {
+  stop();
+
+  for (CURL* easy : idle_easy_handles_) {
+    curl_easy_cleanup(easy);
+  }
+  idle_easy_handles_.clear();
+
+  if (multi_) {
+    curl_multi_cleanup(multi_);
+    multi_ = nullptr;
+  }
+}
+
+void CurlMultiLoop::start() {
+  if (!multi_ || running_.exchange(true)) {
+    return; // No multi handle or already running
+  }
+  worker_ = std::thread(&CurlMultiLoop::loop_thread, this);
+}
+
+void CurlMultiLoop::stop() {
+  {
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+    if (!running_.exchange(false)) {
+      return; // Already stopped
+    }
+  }
+
+  curl_multi_wakeup(multi_);
+
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+
+  // Loop thread is gone; fail everything still queued or in flight
+  abort_all("Request loop stopped");
+}
+
+bool CurlMultiLoop::submit(std::shared_ptr<const Transfer> transfer, Completion on_complete,
+                           int delay_ms) {
+  {
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+    if (!running_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+
+    Scheduled item;
+    item.due = Clock::now() + std::chrono::milliseconds(std::max(delay_ms, 0));
+    item.seq = submit_seq_++;
+    item.transfer = std::move(transfer);
+    item.on_complete = std::move(on_complete);
+    submissions_.push_back(std::move(item));
+    pending_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  curl_multi_wakeup(multi_);
+  return true;
+}
+
+void CurlMultiLoop::loop_thread() {
+  while (running_.load(std::memory_order_relaxed)) {
+    {
+      std::lock_guard<std::mutex> lock(submit_mutex_);
+      for (auto& item : submissions_) {
+        timers_.push(std::move(item));
+      }
+      submissions_.clear();
+    }
+
+    start_due_transfers();
+
+    int still_running = 0;
+    curl_multi_perform(multi_, &still_running);
+
+    drain_completions();
+
+    curl_multi_poll(multi_, nullptr, 0, next_timeout_ms(), nullptr);
+  }
+}
+
+void CurlMultiLoop::start_due_transfers() {
+  auto now = Clock::now();
+  while (!timers_.empty() && timers_.top().due <= now) {
+    // priority_queue::top is const; the element is popped right after the move
+    Scheduled item = std::move(const_cast<Scheduled&>(timers_.top()));
+    timers_.pop();
+    pending_count_.fetch_sub(1, std::memory_order_relaxed);
+    start_transfer(std::move(item));
+  }
+}
+
+void CurlMultiLoop::start_transfer(Scheduled&& item) {
+  CURL* easy = take_easy_handle();
+  if (!easy) {
+    Response response;
+    response.body = "Failed to initialize CURL";
+    complete(item.on_complete, response);
+    return;
+  }
+
+  auto active = std::make_unique<Active>();
+  active->transfer = std::move(item.transfer);
+  active->on_complete = std::move(item.on_complete);
+  active->easy = easy;
+
+  const Transfer& transfer = *active->transfer;
+  for (const auto& header : transfer.headers) {
+    active->headers = curl_slist_append(active->headers, header.c_str());
+  }
+
+  curl_easy_setopt(easy, CURLOPT_URL, transfer.url.c_str());
+  if (transfer.post) {
+    curl_easy_setopt(easy, CURLOPT_POST, 1L);
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDS, transfer.body.c_str());
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(transfer.body.size()));
+  }
+  curl_easy_setopt(easy, CURLOPT_HTTPHEADER, active->headers);
+  curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, write_callback);
+  curl_easy_setopt(easy, CURLOPT_WRITEDATA, &active->response_body);
+  curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(easy, CURLOPT_TCP_NODELAY, 1L);
+  curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+
+  active_.emplace(easy, std::move(active));
+  in_flight_count_.fetch_add(1, std::memory_order_relaxed);
+  curl_multi_add_handle(multi_, easy);
+}
+
+void CurlMultiLoop::drain_completions() {
+  int msgs_left = 0;
+  while (CURLMsg* msg = curl_multi_info_read(multi_, &msgs_left)) {
+    if (msg->msg != CURLMSG_DONE) {
+      continue;
+    }
+
+    CURL* easy = msg->easy_handle;
+    CURLcode res = msg->data.result;
+    curl_multi_remove_handle(multi_, easy);
+
+    auto it = active_.find(easy);
+    if (it == active_.end()) {
+      continue;
+    }
+
+    Response response;
+    if (res == CURLE_OK) {
+      long http_code = 0;
+      curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &http_code);
+      response.http_status = static_cast<int>(http_code);
+      response.body = std::move(it->second->response_body);
+      response.success = (http_code >= 200 && http_code < 300);
+    } else {
+      response.success = false;
+      response.http_status = 0;
+      response.body = curl_easy_strerror(res);
+    }
+
+    finish(easy, response);
+  }
+}
+
+void CurlMultiLoop::finish(CURL* easy, const Response& response) {
+  auto it = active_.find(easy);
+  std::unique_ptr<Active> active = std::move(it->second);
+  active_.erase(it);
+
+  curl_slist_free_all(active->headers);
+  return_easy_handle(easy);
+  in_flight_count_.fetch_sub(1, std::memory_order_relaxed);
+
+  complete(active->on_complete, response);
+}
+
+void CurlMultiLoop::abort_all(const std::string& reason) {
+  Response response;
+  response.success = false;
+  response.http_status = 0;
+  response.body = reason;
+
+  std::vector<CURL*> in_flight;
+  for (const auto& [easy, active] : active_) {
+    in_flight.push_back(easy);
+  }
+  for (CURL* easy : in_flight) {
+    curl_multi_remove_handle(multi_, easy);
+    finish(easy, response);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+    for (auto& item : submissions_) {
+      timers_.push(std::move(item));
+    }
+    submissions_.clear();
+  }
+
+  while (!timers_.empty()) {
+    Scheduled item = std::move(const_cast<Scheduled&>(timers_.top()));
+    timers_.pop();
+    pending_count_.fetch_sub(1, std::memory_order_relaxed);
+    complete(item.on_complete, response);
+  }
+}
+
+int CurlMultiLoop::next_timeout_ms() const {
+  if (timers_.empty()) {
+    return kMaxPollMs;
+  }
+  auto wait =
+      std::chrono::duration_cast<std::chrono::milliseconds>(timers_.top().due - Clock::now());
+  return static_cast<int>(std::clamp<int64_t>(wait.count(), 0, kMaxPollMs));
+}
+
+CURL* CurlMultiLoop::take_easy_handle() {
+  if (!idle_easy_handles_.empty()) {
+    CURL* easy = idle_easy_handles_.back();
+    idle_easy_handles_.pop_back();
+    curl_easy_reset(easy);
+    return easy;
+  }
+  return curl_easy_init();
+}
+
+void CurlMultiLoop::return_easy_handle(CURL* easy) {
+  // max_connections_ == 0 means no connection cap, so keep every handle
+  if (max_connections_ == 0 || idle_easy_handles_.size() < max_connections_) {
+    idle_easy_handles_.push_back(easy);
+  } else {
+    curl_easy_cleanup(easy);
+  }
+}
+
+} // namespace pulseexec
@@ -1,20 +1,65 @@
 #include "pulseexec/DBWriter.hpp"
+#include "pulseexec/LatencyTracker.hpp"
 #include "pulseexec/Logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <nlohmann/json.hpp>
 #include <sqlite3.h>
 #include <sstream>
+#include <thread>
 
 namespace pulseexec {
 
+using json = nlohmann::json;
+
+// A batch whose commit fails is retried with doubling waits from the first
+// to the last; after that its writes are reported lost
+static constexpr int kMaxCommitAttempts = 8;
+static constexpr std::chrono::milliseconds kFirstCommitRetry(10);
+static constexpr std::chrono::milliseconds kMaxCommitRetry(1000);
+
+// Completed with a WHERE clause by each order lookup
+static constexpr const char* kSelectOrderSql = R"(
+    SELECT client_order_id, exchange_order_id, symbol, side, price, amount, order_type,
+           state, filled_amount, created_ts_us, last_update_ts_us, error_message
+    FROM orders WHERE )";
+
 DBWriter::DBWriter(const std::string& db_path, std::shared_ptr<Logger> logger,
-                   size_t queue_capacity)
-    : db_path_(db_path), db_(nullptr), logger_(logger), queue_capacity_(queue_capacity) {}
+                   size_t queue_capacity, size_t max_batch_size,
+                   std::chrono::microseconds max_batch_latency)
+    : db_path_(db_path), db_(nullptr), logger_(logger), queue_capacity_(queue_capacity),
+      max_batch_size_(max_batch_size > 0 ? max_batch_size : 1),
+      max_batch_latency_(max_batch_latency), spill_path_(db_path + ".spill") {}
 
 DBWriter::~DBWriter() {
   stop();
+  finalize_statements();
   if (db_) {
     sqlite3_close(db_);
     db_ = nullptr;
   }
+  if (read_db_) {
+    sqlite3_close(read_db_);
+    read_db_ = nullptr;
+  }
+  close_spill();
+}
+
+void DBWriter::set_latency_tracker(std::shared_ptr<LatencyTracker> tracker,
+                                   std::chrono::milliseconds flush_interval) {
+  latency_tracker_ = std::move(tracker);
+  latency_flush_interval_ = flush_interval;
+}
+
+void DBWriter::set_write_coalescing(bool enabled) { coalesce_writes_ = enabled; }
+
+void DBWriter::set_overflow_policy(DBOverflowPolicy policy, std::chrono::milliseconds block_timeout,
+                                   const std::string& spill_path) {
+  overflow_policy_ = policy;
+  block_timeout_ = block_timeout;
+  if (!spill_path.empty()) {
+    spill_path_ = spill_path;
+  }
 }
 
 void DBWriter::start() {
@@ -30,6 +75,9 @@ void DBWriter::start() {
     return;
   }
 
+  // A spill file left behind by a crash holds the newest writes of that run
+  replay_leftover_spill();
+
   worker_ = std::thread(&DBWriter::worker_thread, this);
 }
 
@@ -46,52 +94,569 @@ void DBWriter::stop() {
 }
 
 bool DBWriter::write_order(const Order& order) {
+  uint64_t sequence = 0;
+  return write_order(order, sequence);
+}
+
+bool DBWriter::write_order(const Order& order, uint64_t& sequence) {
   {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    if (write_queue_.size() >= queue_capacity_) {
-      dropped_count_.fetch_add(1, std::memory_order_relaxed);
-      return false;
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+
+    // Once spilling, every write goes to the spill file until the worker has
+    // read it back, so writes still reach SQLite in the order they were made
+    if (spilling_ || write_queue_.size() >= queue_capacity_) {
+      switch (overflow_policy_) {
+      case DBOverflowPolicy::SPILL:
+        if (!append_spill(order)) {
+          dropped_count_.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        sequence = ++enqueued_sequence_;
+        lock.unlock();
+        queue_cv_.notify_one();
+        return true;
+
+      case DBOverflowPolicy::BLOCK:
+        blocked_count_.fetch_add(1, std::memory_order_relaxed);
+        if (space_cv_.wait_for(lock, block_timeout_,
+                               [this] { return write_queue_.size() < queue_capacity_; })) {
+          break;
+        }
+        [[fallthrough]];
+
+      case DBOverflowPolicy::DROP:
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
     }
+
     write_queue_.emplace(order);
+    sequence = ++enqueued_sequence_;
+    queue_high_watermark_ = std::max(queue_high_watermark_, write_queue_.size());
   }
 
   queue_cv_.notify_one();
   return true;
 }
 
+DBWriter::Stats DBWriter::stats() const {
+  Stats s;
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    s.queue_depth = write_queue_.size();
+    s.queue_high_watermark = queue_high_watermark_;
+    s.spill_depth = spill_depth_;
+  }
+  s.written = written_count_.load(std::memory_order_relaxed);
+  s.coalesced = coalesced_count_.load(std::memory_order_relaxed);
+  s.dropped = dropped_count_.load(std::memory_order_relaxed);
+  s.blocked = blocked_count_.load(std::memory_order_relaxed);
+  s.spilled = spilled_count_.load(std::memory_order_relaxed);
+  s.failed_commits = failed_commits_.load(std::memory_order_relaxed);
+  s.lost = lost_count_.load(std::memory_order_relaxed);
+  return s;
+}
+
+bool DBWriter::load_order(const std::string& client_order_id, Order& out_order) const {
+  return load_order_where(select_order_stmt_, client_order_id, out_order);
+}
+
+bool DBWriter::load_order_by_exchange_id(const std::string& exchange_order_id,
+                                         Order& out_order) const {
+  return load_order_where(select_order_by_exchange_id_stmt_, exchange_order_id, out_order);
+}
+
+static std::string column_string(sqlite3_stmt* stmt, int column) {
+  const unsigned char* text = sqlite3_column_text(stmt, column);
+  return text ? std::string(reinterpret_cast<const char*>(text)) : std::string();
+}
+
+// Columns as selected by kSelectOrderSql, i.e. as written by execute_order_write
+static Order read_order_row(sqlite3_stmt* stmt) {
+  Order order;
+  order.client_order_id = column_string(stmt, 0);
+  order.exchange_order_id = column_string(stmt, 1);
+  order.request.symbol = column_string(stmt, 2);
+  order.request.side = parse_side(column_string(stmt, 3));
+  order.request.price = Price(sqlite3_column_double(stmt, 4));
+  order.request.amount = Qty(sqlite3_column_double(stmt, 5));
+  order.request.type = parse_order_type(column_string(stmt, 6));
+  order.request.client_order_id = order.client_order_id;
+  order.state = parse_order_state(column_string(stmt, 7));
+  order.filled_amount = Qty(sqlite3_column_double(stmt, 8));
+  order.created_ts_us = sqlite3_column_int64(stmt, 9);
+  order.last_update_ts_us = sqlite3_column_int64(stmt, 10);
+  order.error_message = column_string(stmt, 11);
+  return order;
+}
+
+bool DBWriter::load_open_orders(std::vector<Order>& out_orders) const {
+  std::lock_guard<std::mutex> lock(read_mutex_);
+  if (!read_db_) {
+    return false; // Not started
+  }
+
+  // One-off at startup, so the statement is not cached
+  std::string sql = std::string(kSelectOrderSql) +
+                    "state NOT IN ('filled', 'canceled', 'rejected') ORDER BY created_ts_us;";
+  sqlite3_stmt* stmt = nullptr;
+  if (sqlite3_prepare_v2(read_db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    if (logger_) {
+      logger_->log_error("DBWriter", "Failed to prepare statement: " +
+                                         std::string(sqlite3_errmsg(read_db_)));
+    }
+    return false;
+  }
+
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    out_orders.push_back(read_order_row(stmt));
+  }
+  sqlite3_finalize(stmt);
+
+  if (rc != SQLITE_DONE) {
+    if (logger_) {
+      logger_->log_error("DBWriter",
+                         "Failed to load open orders: " + std::string(sqlite3_errmsg(read_db_)));
+    }
+    return false;
+  }
+  return true;
+}
+
+bool DBWriter::load_order_where(sqlite3_stmt* stmt, const std::string& key,
+                                Order& out_order) const {
+  std::lock_guard<std::mutex> lock(read_mutex_);
+  if (!stmt) {
+    return false; // Not started
+  }
+
+  sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_STATIC);
+  int rc = sqlite3_step(stmt);
+  bool found = rc == SQLITE_ROW;
+  if (found) {
+    out_order = read_order_row(stmt);
+  } else if (rc != SQLITE_DONE && logger_) {
+    logger_->log_error("DBWriter",
+                       "Failed to load order: " + std::string(sqlite3_errmsg(read_db_)));
+  }
+
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  return found;
+}
+
 void DBWriter::worker_thread() {
+  std::vector<DBWriteRequest> batch;
+  batch.reserve(max_batch_size_);
+  size_t skipped = 0;
+  auto next_latency_flush = std::chrono::steady_clock::now() + latency_flush_interval_;
+
   while (running_.load(std::memory_order_relaxed)) {
-    std::unique_lock<std::mutex> lock(queue_mutex_);
+    bool read_spilled = false;
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+
+      auto has_work = [this] {
+        return !write_queue_.empty() || spilling_ || !running_.load(std::memory_order_relaxed);
+      };
+      if (latency_tracker_) {
+        // Wake for the metrics flush even when no orders are written
+        queue_cv_.wait_until(lock, next_latency_flush, has_work);
+      } else {
+        queue_cv_.wait(lock, has_work);
+      }
 
-    queue_cv_.wait(lock, [this] {
-      return !write_queue_.empty() || !running_.load(std::memory_order_relaxed);
-    });
+      // The first write in a batch waits at most max_batch_latency_ for company;
+      // a wake-up for the metrics flush with nothing queued skips batching
+      auto deadline = std::chrono::steady_clock::now() + max_batch_latency_;
+
+      while (!write_queue_.empty() && batch.size() < max_batch_size_) {
+        batch.push_back(std::move(write_queue_.front()));
+        write_queue_.pop();
+
+        if (write_queue_.empty() && batch.size() < max_batch_size_ && !spilling_) {
+          bool more = queue_cv_.wait_until(lock, deadline, [this] {
+            return !write_queue_.empty() || !running_.load(std::memory_order_relaxed);
+          });
+          if (!more) {
+            break;
+          }
+        }
+      }
 
-    while (!write_queue_.empty()) {
-      DBWriteRequest req = std::move(write_queue_.front());
-      write_queue_.pop();
+      // Spilled writes are newer than anything queued before spilling began
+      read_spilled = spilling_ && write_queue_.empty();
+    }
+    space_cv_.notify_all();
 
-      lock.unlock();
+    if (read_spilled) {
+      skipped = read_spill(batch);
+    }
+    commit_batch(batch, skipped);
+    batch.clear();
+    skipped = 0;
 
-      // Execute write
-      if (req.type == DBWriteRequest::ORDER) {
-        execute_order_write(req.order);
+    if (latency_tracker_ && std::chrono::steady_clock::now() >= next_latency_flush) {
+      flush_latency_metrics();
+      next_latency_flush = std::chrono::steady_clock::now() + latency_flush_interval_;
+    }
+  }
+
+  // Drain remaining writes, then whatever was spilled after them. The lock is
+  // only held to take each batch, never across a commit or a spill read.
+  while (true) {
+    bool read_spilled = false;
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      while (!write_queue_.empty() && batch.size() < max_batch_size_) {
+        batch.push_back(std::move(write_queue_.front()));
+        write_queue_.pop();
       }
+      read_spilled = spilling_ && write_queue_.empty();
+    }
+    space_cv_.notify_all();
+    if (batch.empty() && !read_spilled) {
+      break;
+    }
+
+    skipped = read_spilled ? read_spill(batch) : 0;
+    commit_batch(batch, skipped);
+    batch.clear();
+  }
+
+  if (latency_tracker_) {
+    flush_latency_metrics();
+  }
+}
+
+static json order_to_json(const Order& order) {
+  return {{"client_order_id", order.client_order_id},
+          {"exchange_order_id", order.exchange_order_id},
+          {"symbol", order.request.symbol},
+          {"side", to_string(order.request.side)},
+          {"price", order.request.price.to_double()},
+          {"amount", order.request.amount.to_double()},
+          {"order_type", to_string(order.request.type)},
+          {"state", to_string(order.state)},
+          {"filled_amount", order.filled_amount.to_double()},
+          {"created_ts_us", order.created_ts_us},
+          {"last_update_ts_us", order.last_update_ts_us},
+          {"error_message", order.error_message}};
+}
+
+static Order order_from_json(const json& j) {
+  Order order;
+  order.client_order_id = j.value("client_order_id", "");
+  order.exchange_order_id = j.value("exchange_order_id", "");
+  order.request.symbol = j.value("symbol", "");
+  order.request.side = parse_side(j.value("side", ""));
+  order.request.price = Price(j.value("price", 0.0));
+  order.request.amount = Qty(j.value("amount", 0.0));
+  order.request.type = parse_order_type(j.value("order_type", ""));
+  order.request.client_order_id = order.client_order_id;
+  order.state = parse_order_state(j.value("state", ""));
+  order.filled_amount = Qty(j.value("filled_amount", 0.0));
+  order.created_ts_us = j.value("created_ts_us", int64_t(0));
+  order.last_update_ts_us = j.value("last_update_ts_us", int64_t(0));
+  order.error_message = j.value("error_message", "");
+  return order;
+}
+
+bool DBWriter::append_spill(const Order& order) {
+  if (!spill_out_) {
+    spill_out_ = std::fopen(spill_path_.c_str(), "ab");
+    spill_in_ = spill_out_ ? std::fopen(spill_path_.c_str(), "rb") : nullptr;
+    if (!spill_in_) {
+      if (logger_) {
+        logger_->log_error("DBWriter", "Failed to open spill file " + spill_path_);
+      }
+      close_spill();
+      return false;
+    }
+  }
+
+  // One JSON object per line; flushed so the worker's read handle sees it
+  std::string line = order_to_json(order).dump();
+  line.push_back('\n');
+  if (std::fwrite(line.data(), 1, line.size(), spill_out_) != line.size() ||
+      std::fflush(spill_out_) != 0) {
+    if (logger_) {
+      logger_->log_error("DBWriter", "Failed to append to spill file " + spill_path_);
+    }
+    return false;
+  }
+
+  if (!spilling_ && logger_) {
+    logger_->log_warning("DBWriter", "Write queue full, spilling to " + spill_path_);
+  }
+  spilling_ = true;
+  ++spill_depth_;
+  spilled_count_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
 
-      lock.lock();
+bool DBWriter::read_spill_line(std::string& line) {
+  line.clear();
+  std::clearerr(spill_in_); // Lines appended after an earlier EOF are still read
+  char buf[512];
+  while (std::fgets(buf, sizeof(buf), spill_in_)) {
+    line += buf;
+    if (!line.empty() && line.back() == '\n') {
+      line.pop_back();
+      return true;
     }
   }
+  return false;
+}
 
-  // Drain remaining writes
+size_t DBWriter::read_spill(std::vector<DBWriteRequest>& batch) {
+  // Only the lines counted so far are read, and only the worker reads
+  // spill_in_, so the file I/O and parsing run without the queue lock;
+  // producers keep appending meanwhile
+  size_t to_read = 0;
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    to_read = std::min(spill_depth_, max_batch_size_ - std::min(batch.size(), max_batch_size_));
+  }
+
+  size_t read = 0;
+  size_t skipped = 0;
+  std::string line;
+  while (read < to_read && read_spill_line(line)) {
+    ++read;
+    json j = json::parse(line, nullptr, false);
+    if (j.is_discarded()) {
+      if (logger_) {
+        logger_->log_error("DBWriter", "Skipping corrupt spill record");
+      }
+      dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      ++skipped;
+      continue;
+    }
+    batch.emplace_back(order_from_json(j));
+  }
+
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  spill_depth_ -= read;
+
+  // Caught up: later writes can use the queue again
+  if (spill_depth_ == 0) {
+    close_spill();
+    std::remove(spill_path_.c_str());
+    spilling_ = false;
+  }
+  return skipped;
+}
+
+void DBWriter::close_spill() {
+  if (spill_out_) {
+    std::fclose(spill_out_);
+    spill_out_ = nullptr;
+  }
+  if (spill_in_) {
+    std::fclose(spill_in_);
+    spill_in_ = nullptr;
+  }
+}
+
+void DBWriter::replay_leftover_spill() {
   std::lock_guard<std::mutex> lock(queue_mutex_);
-  while (!write_queue_.empty()) {
-    DBWriteRequest req = std::move(write_queue_.front());
-    write_queue_.pop();
+  if (spill_out_) {
+    return; // Spilled by this writer before start(); the worker reads it back
+  }
+  spill_in_ = std::fopen(spill_path_.c_str(), "rb");
+  if (!spill_in_) {
+    return;
+  }
+
+  // These writes were never given sequences by this writer, so they are
+  // committed directly rather than through commit_batch
+  std::vector<DBWriteRequest> batch;
+  std::string line;
+  size_t replayed = 0;
+  bool committed = true;
+  while (committed && read_spill_line(line)) {
+    json j = json::parse(line, nullptr, false);
+    if (j.is_discarded()) {
+      continue; // Torn final line from the crash
+    }
+    batch.emplace_back(order_from_json(j));
+    if (batch.size() >= max_batch_size_) {
+      replayed += batch.size();
+      committed = execute_batch_with_retry(batch);
+      batch.clear();
+    }
+  }
+  replayed += batch.size();
+  committed = committed && execute_batch_with_retry(batch);
+
+  close_spill();
+  if (!committed) {
+    // Kept for inspection; a new spill file must not append to it
+    std::string kept = spill_path_ + ".failed";
+    std::rename(spill_path_.c_str(), kept.c_str());
+    if (logger_) {
+      logger_->log_error("DBWriter", "Could not replay " + spill_path_ + ", kept as " + kept);
+    }
+    return;
+  }
+  std::remove(spill_path_.c_str());
+  if (logger_) {
+    logger_->log_info("DBWriter", "Replayed " + std::to_string(replayed) +
+                                      " writes left in " + spill_path_);
+  }
+}
+
+void DBWriter::commit_batch(const std::vector<DBWriteRequest>& batch, size_t skipped) {
+  if (!execute_batch_with_retry(batch)) {
+    lost_count_.fetch_add(batch.size(), std::memory_order_relaxed);
+    if (logger_) {
+      logger_->log_error("DBWriter",
+                         "Gave up on a batch of " + std::to_string(batch.size()) + " writes" +
+                             (batch_lost_ ? "" : "; orders stay in memory from here on"));
+    }
+    batch_lost_ = true;
+    return;
+  }
+
+  // Settled only once committed, so flushed_sequence() never runs ahead of
+  // SQLite. After a lost batch nothing is settled: a settled sequence lets
+  // OrderManager evict the order, and the lost write may have been its last.
+  if (!batch_lost_) {
+    flushed_sequence_.fetch_add(batch.size() + skipped, std::memory_order_release);
+  }
+}
+
+bool DBWriter::execute_batch_with_retry(const std::vector<DBWriteRequest>& batch) {
+  auto retry_in = kFirstCommitRetry;
+  for (int attempt = 1; !execute_batch(batch); ++attempt) {
+    failed_commits_.fetch_add(1, std::memory_order_relaxed);
+    if (attempt == kMaxCommitAttempts) {
+      return false;
+    }
+    std::this_thread::sleep_for(retry_in);
+    retry_in = std::min(retry_in * 2, kMaxCommitRetry);
+  }
+  return true;
+}
+
+bool DBWriter::execute_batch(const std::vector<DBWriteRequest>& batch) {
+  if (batch.empty()) {
+    return true;
+  }
+
+  // One transaction per batch: a single WAL commit instead of one per write
+  if (!step_statement(begin_stmt_)) {
+    if (logger_) {
+      logger_->log_error("DBWriter", "Failed to begin transaction: " +
+                                         std::string(sqlite3_errmsg(db_)));
+    }
+    return false;
+  }
+
+  // An order that went open -> partial -> filled within the batch window only
+  // needs its last version written: the earlier ones would be replaced inside
+  // this same transaction, so no reader could ever see them
+  if (coalesce_writes_) {
+    latest_write_.clear();
+    for (size_t i = 0; i < batch.size(); ++i) {
+      if (batch[i].type == DBWriteRequest::ORDER) {
+        latest_write_[batch[i].order.client_order_id] = i;
+      }
+    }
+  }
 
-    if (req.type == DBWriteRequest::ORDER) {
-      execute_order_write(req.order);
+  // Counted only once the transaction commits; a failed write fails the
+  // whole batch, which is rolled back and retried by the caller
+  uint64_t written = 0;
+  uint64_t coalesced = 0;
+  bool ok = true;
+  for (size_t i = 0; ok && i < batch.size(); ++i) {
+    const auto& req = batch[i];
+    if (req.type != DBWriteRequest::ORDER) {
+      continue;
+    }
+    if (coalesce_writes_ && latest_write_.find(req.order.client_order_id)->second != i) {
+      ++coalesced;
+      continue;
     }
+    ok = execute_order_write(req.order);
+    written += ok ? 1 : 0;
+  }
+
+  if (!ok || !step_statement(commit_stmt_)) {
+    if (ok && logger_) {
+      logger_->log_error("DBWriter", "Failed to commit batch of " + std::to_string(batch.size()) +
+                                         ": " + std::string(sqlite3_errmsg(db_)));
+    }
+    step_statement(rollback_stmt_);
+    return false;
+  }
+  written_count_.fetch_add(written, std::memory_order_relaxed);
+  coalesced_count_.fetch_add(coalesced, std::memory_order_relaxed);
+
+  if (latency_tracker_) {
+    // Order timestamps are set just before write_order, so this is queueing
+    // plus batching plus the commit
+    int64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    for (const auto& req : batch) {
+      if (req.type == DBWriteRequest::ORDER) {
+        latency_tracker_->record(LatencyOp::DB_PERSIST,
+                                 (now_us - req.order.last_update_ts_us) * 1000);
+      }
+    }
+  }
+
+  return true;
+}
+
+void DBWriter::flush_latency_metrics() {
+  std::vector<LatencyTracker::Summary> summaries = latency_tracker_->take_interval();
+  if (summaries.empty() || !insert_latency_stmt_) {
+    return;
+  }
+
+  int64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+
+  // One row per operation and statistic, e.g. ("create_to_ack.p99", 1830, ts)
+  bool in_transaction = step_statement(begin_stmt_);
+  for (const auto& summary : summaries) {
+    std::string op = to_string(summary.op);
+    const std::pair<const char*, int64_t> rows[] = {
+        {".p50", summary.p50_ns},
+        {".p99", summary.p99_ns},
+        {".p999", summary.p999_ns},
+        {".max", summary.max_ns},
+    };
+    for (const auto& [suffix, latency_ns] : rows) {
+      std::string operation = op + suffix;
+      sqlite3_bind_text(insert_latency_stmt_, 1, operation.c_str(), -1, SQLITE_STATIC);
+      sqlite3_bind_int64(insert_latency_stmt_, 2, latency_ns / 1000);
+      sqlite3_bind_int64(insert_latency_stmt_, 3, now_us);
+      if (!step_statement(insert_latency_stmt_) && logger_) {
+        logger_->log_error("DBWriter", "Failed to write latency metric: " +
+                                           std::string(sqlite3_errmsg(db_)));
+      }
+      sqlite3_clear_bindings(insert_latency_stmt_);
+    }
+  }
+  if (in_transaction && !step_statement(commit_stmt_)) {
+    step_statement(rollback_stmt_);
+  }
+}
+
+bool DBWriter::step_statement(sqlite3_stmt* stmt) {
+  if (!stmt) {
+    return false;
   }
+  int rc = sqlite3_step(stmt);
+  sqlite3_reset(stmt);
+  return rc == SQLITE_DONE;
 }
 
 bool DBWriter::init_database() {
@@ -115,7 +680,103 @@ bool DBWriter::init_database() {
   }
 
   // Create tables
-  return create_tables();
+  if (!create_tables()) {
+    return false;
+  }
+
+  if (!prepare_statements()) {
+    return false;
+  }
+
+  // No other connection can see an in-memory database; archived order
+  // lookups are then unavailable, but writes are unaffected
+  if (db_path_ != ":memory:") {
+    open_read_connection();
+  }
+  return true;
+}
+
+bool DBWriter::open_read_connection() {
+  // Lookups of archived orders use their own connection: under WAL they read
+  // the last commit without waiting for, or blocking, the writer
+  int rc = sqlite3_open_v2(db_path_.c_str(), &read_db_, SQLITE_OPEN_READONLY, nullptr);
+  if (rc != SQLITE_OK) {
+    if (logger_) {
+      logger_->log_error("DBWriter", "Failed to open read connection: " +
+                                         std::string(sqlite3_errmsg(read_db_)));
+    }
+    return false;
+  }
+
+  const std::string select_order_sql = kSelectOrderSql;
+
+  struct {
+    std::string sql;
+    sqlite3_stmt** stmt;
+  } statements[] = {
+      {select_order_sql + "client_order_id = ?;", &select_order_stmt_},
+      {select_order_sql + "exchange_order_id = ? ORDER BY last_update_ts_us DESC LIMIT 1;",
+       &select_order_by_exchange_id_stmt_},
+  };
+
+  std::lock_guard<std::mutex> lock(read_mutex_);
+  for (const auto& entry : statements) {
+    rc = sqlite3_prepare_v2(read_db_, entry.sql.c_str(), -1, entry.stmt, nullptr);
+    if (rc != SQLITE_OK) {
+      if (logger_) {
+        logger_->log_error("DBWriter", "Failed to prepare statement: " +
+                                           std::string(sqlite3_errmsg(read_db_)));
+      }
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool DBWriter::prepare_statements() {
+  const char* insert_order_sql = R"(
+    INSERT OR REPLACE INTO orders 
+    (client_order_id, exchange_order_id, symbol, side, price, amount, order_type, 
+     state, filled_amount, created_ts_us, last_update_ts_us, error_message)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
+  )";
+
+  struct {
+    const char* sql;
+    sqlite3_stmt** stmt;
+  } statements[] = {
+      {insert_order_sql, &insert_order_stmt_},
+      {"INSERT INTO latency_metrics (operation, latency_us, timestamp_us) VALUES (?, ?, ?);",
+       &insert_latency_stmt_},
+      {"BEGIN;", &begin_stmt_},
+      {"COMMIT;", &commit_stmt_},
+      {"ROLLBACK;", &rollback_stmt_},
+  };
+
+  for (const auto& entry : statements) {
+    int rc = sqlite3_prepare_v2(db_, entry.sql, -1, entry.stmt, nullptr);
+    if (rc != SQLITE_OK) {
+      if (logger_) {
+        logger_->log_error("DBWriter",
+                           "Failed to prepare statement: " + std::string(sqlite3_errmsg(db_)));
+      }
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void DBWriter::finalize_statements() {
+  for (sqlite3_stmt** stmt :
+       {&insert_order_stmt_, &insert_latency_stmt_, &begin_stmt_, &commit_stmt_, &rollback_stmt_,
+        &select_order_stmt_, &select_order_by_exchange_id_stmt_}) {
+    if (*stmt) {
+      sqlite3_finalize(*stmt);
+      *stmt = nullptr;
+    }
+  }
 }
 
 bool DBWriter::create_tables() {
@@ -167,6 +828,19 @@ bool DBWriter::create_tables() {
     return false;
   }
 
+  // Archived orders are also looked up by exchange ID
+  rc = sqlite3_exec(db_,
+                    "CREATE INDEX IF NOT EXISTS idx_orders_exchange_order_id "
+                    "ON orders (exchange_order_id);",
+                    nullptr, nullptr, &err_msg);
+  if (rc != SQLITE_OK) {
+    if (logger_) {
+      logger_->log_error("DBWriter", "Failed to create orders index: " + std::string(err_msg));
+    }
+    sqlite3_free(err_msg);
+    return false;
+  }
+
   // Create positions table
   rc = sqlite3_exec(db_, positions_table_sql, nullptr, nullptr, &err_msg);
   if (rc != SQLITE_OK) {
@@ -191,39 +865,29 @@ bool DBWriter::create_tables() {
 }
 
 bool DBWriter::execute_order_write(const Order& order) {
-  const char* sql = R"(
-    INSERT OR REPLACE INTO orders 
-    (client_order_id, exchange_order_id, symbol, side, price, amount, order_type, 
-     state, filled_amount, created_ts_us, last_update_ts_us, error_message)
-    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
-  )";
-
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
-    if (logger_) {
-      logger_->log_error("DBWriter", "Failed to prepare statement: " + std::string(sqlite3_errmsg(db_)));
-    }
+  sqlite3_stmt* stmt = insert_order_stmt_;
+  if (!stmt) {
     return false;
   }
 
-  // Bind parameters
-  sqlite3_bind_text(stmt, 1, order.client_order_id.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(stmt, 2, order.exchange_order_id.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(stmt, 3, order.request.symbol.c_str(), -1, SQLITE_TRANSIENT);
+  // Bind parameters (order outlives the step, so its strings need no copy)
+  sqlite3_bind_text(stmt, 1, order.client_order_id.c_str(), -1, SQLITE_STATIC);
+  sqlite3_bind_text(stmt, 2, order.exchange_order_id.c_str(), -1, SQLITE_STATIC);
+  sqlite3_bind_text(stmt, 3, order.request.symbol.c_str(), -1, SQLITE_STATIC);
   sqlite3_bind_text(stmt, 4, to_string(order.request.side).c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_double(stmt, 5, order.request.price);
-  sqlite3_bind_double(stmt, 6, order.request.amount);
+  sqlite3_bind_double(stmt, 5, order.request.price.to_double());
+  sqlite3_bind_double(stmt, 6, order.request.amount.to_double());
   sqlite3_bind_text(stmt, 7, to_string(order.request.type).c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_text(stmt, 8, to_string(order.state).c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_double(stmt, 9, order.filled_amount);
+  sqlite3_bind_double(stmt, 9, order.filled_amount.to_double());
   sqlite3_bind_int64(stmt, 10, order.created_ts_us);
   sqlite3_bind_int64(stmt, 11, order.last_update_ts_us);
-  sqlite3_bind_text(stmt, 12, order.error_message.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, 12, order.error_message.c_str(), -1, SQLITE_STATIC);
 
-  // Execute
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  // Execute, then reset so the cached statement can be reused
+  int rc = sqlite3_step(stmt);
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
 
   if (rc != SQLITE_DONE) {
     if (logger_) {
@@ -0,0 +1,463 @@
+#include "pulseexec/DeribitCodec.hpp"
+#include "pulseexec/JsonScanner.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+using json = nlohmann::json;
+
+namespace pulseexec {
+namespace deribit {
+
+std::string build_jsonrpc_request(const std::string& method, const json& params) {
+  json request;
+  request["jsonrpc"] = "2.0";
+  request["id"] = 1;
+  request["method"] = method;
+  request["params"] = params;
+  return request.dump();
+}
+
+namespace {
+
+// Backs the build_* copies; gateway threads keep their own writer
+RequestWriter& thread_writer() {
+  thread_local RequestWriter writer;
+  return writer;
+}
+
+ExecutionResult& parse_error(ExecutionResult& result, const JsonScanner& scanner) {
+  result.success = false;
+  result.error_message = "JSON parse error at offset " + std::to_string(scanner.position());
+  return result;
+}
+
+// Reads a result order object into out_order; true once it is fully read
+bool read_order(JsonScanner& scanner, ExecutionResult& result, Order& out_order) {
+  std::string text;
+  std::string_view key;
+  scanner.enter_object();
+  while (scanner.next_key(key)) {
+    if (key == "order_id") {
+      scanner.read_string(result.exchange_order_id);
+      if (!result.exchange_order_id.empty()) {
+        out_order.exchange_order_id = result.exchange_order_id;
+      }
+    } else if (key == "label") {
+      scanner.read_string(text);
+      if (!text.empty()) {
+        out_order.client_order_id = text;
+      }
+    } else if (key == "instrument_name") {
+      scanner.read_string(out_order.request.symbol);
+    } else if (key == "direction") {
+      scanner.read_string(text);
+      out_order.request.side = parse_side(text);
+    } else if (key == "price" && scanner.peek() != '"') { // "market_price" on market orders
+      scanner.read_decimal(out_order.request.price);
+    } else if (key == "amount") {
+      scanner.read_decimal(out_order.request.amount);
+    } else if (key == "order_type") {
+      scanner.read_string(text);
+      out_order.request.type = parse_order_type(text);
+    } else if (key == "order_state") {
+      scanner.read_string(text);
+      out_order.state = parse_order_state(text);
+    } else if (key == "filled_amount") {
+      scanner.read_decimal(out_order.filled_amount);
+    } else {
+      scanner.skip_value();
+    }
+  }
+  return scanner.ok();
+}
+
+// Fractional digits a number is written with, trailing zeros aside:
+// "0.0005" -> 4, "5e-05" -> 5, "10" -> 0
+uint8_t written_decimals(std::string_view number) {
+  size_t e = number.find_first_of("eE");
+  int exponent = 0;
+  if (e != std::string_view::npos) {
+    std::string_view digits = number.substr(e + 1);
+    if (!digits.empty() && digits.front() == '+') {
+      digits.remove_prefix(1);
+    }
+    std::from_chars(digits.data(), digits.data() + digits.size(), exponent);
+    number = number.substr(0, e);
+  }
+
+  int decimals = 0;
+  size_t dot = number.find('.');
+  if (dot != std::string_view::npos) {
+    std::string_view fraction = number.substr(dot + 1);
+    while (!fraction.empty() && fraction.back() == '0') {
+      fraction.remove_suffix(1);
+    }
+    decimals = static_cast<int>(fraction.size());
+  }
+  decimals -= exponent;
+  return static_cast<uint8_t>(std::clamp<int>(decimals, 0, Price::kMaxDecimals));
+}
+
+// A tick or lot size, kept at the decimals it is written with
+template <typename Tag> bool read_increment(JsonScanner& scanner, FixedPoint<Tag>& out) {
+  std::string_view text;
+  if (!scanner.read_number(text)) {
+    return false;
+  }
+  uint8_t decimals = written_decimals(text);
+  if (!FixedPoint<Tag>::parse(text, out, decimals)) {
+    // Exponent form
+    out = FixedPoint<Tag>(std::strtod(std::string(text).c_str(), nullptr), decimals);
+  }
+  return out.mantissa() > 0;
+}
+
+// [[price, amount], ...], rounded onto the book's scale. Levels shorter
+// than that are dropped.
+void read_levels(JsonScanner& scanner, const InstrumentScale& scale,
+                 std::vector<PriceLevel>& out) {
+  scanner.enter_array();
+  while (scanner.next_element()) {
+    Price price;
+    Qty amount;
+    if (scanner.enter_array() && scanner.next_element() &&
+        scanner.read_decimal(price, scale.price_decimals) && scanner.next_element() &&
+        scanner.read_decimal(amount, scale.qty_decimals)) {
+      out.emplace_back(price, amount);
+      scanner.leave(); // Anything after the amount
+    }
+  }
+}
+
+} // namespace
+
+const std::string& RequestWriter::place_order(const OrderRequest& request) {
+  buf_.clear();
+  buf_ += request.side == Side::BUY ? R"({"jsonrpc":"2.0","id":1,"method":"private/buy",)"
+                                    : R"({"jsonrpc":"2.0","id":1,"method":"private/sell",)";
+  buf_ += R"("params":{"instrument_name":)";
+  append_string(request.symbol);
+  buf_ += R"(,"amount":)";
+  append_decimal(request.amount);
+  buf_ += request.type == OrderType::LIMIT ? R"(,"type":"limit")" : R"(,"type":"market")";
+
+  if (request.type == OrderType::LIMIT) {
+    buf_ += R"(,"price":)";
+    append_decimal(request.price);
+  }
+
+  if (!request.client_order_id.empty()) {
+    buf_ += R"(,"label":)";
+    append_string(request.client_order_id);
+  }
+  buf_ += "}}";
+  return buf_;
+}
+
+const std::string& RequestWriter::cancel_order(std::string_view exchange_order_id) {
+  buf_.clear();
+  buf_ += R"({"order_id":)";
+  append_string(exchange_order_id);
+  buf_ += '}';
+  return buf_;
+}
+
+const std::string& RequestWriter::modify_order(std::string_view exchange_order_id,
+                                               Price new_price, Qty new_amount) {
+  buf_.clear();
+  buf_ += R"({"order_id":)";
+  append_string(exchange_order_id);
+  buf_ += R"(,"amount":)";
+  append_decimal(new_amount);
+  buf_ += R"(,"price":)";
+  append_decimal(new_price);
+  buf_ += '}';
+  return buf_;
+}
+
+const std::string& RequestWriter::get_order_state(std::string_view exchange_order_id) {
+  return cancel_order(exchange_order_id); // Same {"order_id":...} body
+}
+
+const std::string& RequestWriter::get_order_state_by_label(std::string_view currency,
+                                                           std::string_view label) {
+  buf_.clear();
+  buf_ += R"({"currency":)";
+  append_string(currency);
+  buf_ += R"(,"label":)";
+  append_string(label);
+  buf_ += '}';
+  return buf_;
+}
+
+void RequestWriter::append_string(std::string_view text) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  buf_ += '"';
+  size_t clean = 0; // Start of the run not yet copied
+  for (size_t i = 0; i < text.size(); ++i) {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    buf_.append(text.data() + clean, i - clean);
+    clean = i + 1;
+    if (c == '"' || c == '\\') {
+      buf_ += '\\';
+      buf_ += static_cast<char>(c);
+    } else {
+      buf_ += "\\u00";
+      buf_ += kHex[c >> 4];
+      buf_ += kHex[c & 0xf];
+    }
+  }
+  buf_.append(text.data() + clean, text.size() - clean);
+  buf_ += '"';
+}
+
+std::string build_place_order_body(const OrderRequest& request) {
+  return thread_writer().place_order(request);
+}
+
+std::string build_cancel_order_body(const std::string& exchange_order_id) {
+  return thread_writer().cancel_order(exchange_order_id);
+}
+
+std::string build_modify_order_body(const std::string& exchange_order_id, Price new_price,
+                                    Qty new_amount) {
+  return thread_writer().modify_order(exchange_order_id, new_price, new_amount);
+}
+
+std::string build_get_order_state_body(const std::string& exchange_order_id) {
+  return thread_writer().get_order_state(exchange_order_id);
+}
+
+ExecutionResult parse_place_order_response(int http_status, bool success, const std::string& body) {
+  ExecutionResult result;
+  result.http_status = http_status;
+  result.success = success;
+
+  if (!success) {
+    result.error_message = body;
+    return result;
+  }
+
+  JsonScanner scanner(body);
+  bool found = scanner.enter_object() && scanner.find_key("result") &&
+               scanner.peek() == '{' && scanner.enter_object() && scanner.find_key("order") &&
+               scanner.peek() == '{' && scanner.enter_object();
+  if (found) {
+    std::string_view key;
+    while (scanner.next_key(key)) {
+      if (key == "order_id" && scanner.peek() == '"') {
+        scanner.read_string(result.exchange_order_id);
+        break; // Nothing else is needed from the order
+      }
+      scanner.skip_value();
+    }
+  }
+
+  if (!scanner.ok()) {
+    return parse_error(result, scanner);
+  }
+  result.success = found;
+  if (!found) {
+    result.error_message = "Invalid response format";
+  }
+  return result;
+}
+
+ExecutionResult parse_order_state_response(int http_status, bool success, const std::string& body,
+                                           Order& out_order) {
+  ExecutionResult result;
+  result.http_status = http_status;
+  result.success = success;
+
+  if (!success) {
+    result.error_message = body;
+    return result;
+  }
+
+  JsonScanner scanner(body);
+  std::string_view key;
+  std::string_view error;
+  bool has_result = false;
+  scanner.enter_object();
+  while (!has_result && scanner.next_key(key)) {
+    if (key == "result" && scanner.peek() == '{') {
+      has_result = read_order(scanner, result, out_order);
+    } else if (key == "error") {
+      scanner.skip_value(&error);
+    } else {
+      scanner.skip_value();
+    }
+  }
+
+  if (!scanner.ok()) {
+    return parse_error(result, scanner);
+  }
+  result.success = has_result;
+  if (!has_result) {
+    result.error_message = error.empty() ? "Invalid response format" : std::string(error);
+  }
+  return result;
+}
+
+ExecutionResult parse_order_state_by_label_response(int http_status, bool success,
+                                                    const std::string& body, Order& out_order) {
+  ExecutionResult result;
+  result.http_status = http_status;
+  result.success = success;
+
+  if (!success) {
+    result.error_message = body;
+    return result;
+  }
+
+  JsonScanner scanner(body);
+  std::string_view key;
+  std::string_view error;
+  bool has_result = false;
+  scanner.enter_object();
+  while (!has_result && scanner.next_key(key)) {
+    if (key == "result" && scanner.peek() == '[') {
+      scanner.enter_array();
+      if (scanner.next_element() && scanner.peek() == '{') {
+        read_order(scanner, result, out_order);
+      }
+      has_result = scanner.ok();
+    } else if (key == "error") {
+      scanner.skip_value(&error);
+    } else {
+      scanner.skip_value();
+    }
+  }
+
+  if (!scanner.ok()) {
+    return parse_error(result, scanner);
+  }
+  result.success = has_result;
+  if (!has_result) {
+    result.error_message = error.empty() ? "Invalid response format" : std::string(error);
+  }
+  return result;
+}
+
+std::string_view instrument_currency(std::string_view instrument) {
+  std::string_view underlying = instrument.substr(0, instrument.find('-'));
+  size_t quote = underlying.find('_');
+  return quote == std::string_view::npos ? underlying : underlying.substr(quote + 1);
+}
+
+bool parse_auth_response(const std::string& body, std::string& access_token,
+                         int64_t& expires_in_s) {
+  JsonScanner scanner(body);
+  if (!scanner.enter_object() || !scanner.find_key("result") || scanner.peek() != '{' ||
+      !scanner.enter_object()) {
+    return false;
+  }
+
+  bool has_token = false;
+  bool has_expiry = false;
+  std::string_view key;
+  while (scanner.next_key(key)) {
+    if (key == "access_token") {
+      has_token = scanner.read_string(access_token);
+    } else if (key == "expires_in") {
+      has_expiry = scanner.read_int(expires_in_s);
+    } else {
+      scanner.skip_value();
+    }
+  }
+  return scanner.ok() && has_token && has_expiry && !access_token.empty() && expires_in_s > 0;
+}
+
+ExecutionResult parse_order_book_response(int http_status, bool success, const std::string& body,
+                                          OrderBook& out_book) {
+  ExecutionResult result;
+  result.http_status = http_status;
+  result.success = success;
+
+  if (!success) {
+    result.error_message = body;
+    return result;
+  }
+
+  out_book.bids.clear();
+  out_book.asks.clear();
+
+  JsonScanner scanner(body);
+  bool found = scanner.enter_object() && scanner.find_key("result") &&
+               scanner.peek() == '{' && scanner.enter_object();
+  if (found) {
+    std::string_view key;
+    while (scanner.next_key(key)) {
+      if (key == "bids") {
+        read_levels(scanner, out_book.scale, out_book.bids);
+      } else if (key == "asks") {
+        read_levels(scanner, out_book.scale, out_book.asks);
+      } else if (key == "timestamp") {
+        scanner.read_int(out_book.timestamp_us);
+      } else {
+        scanner.skip_value();
+      }
+    }
+  }
+
+  if (!scanner.ok()) {
+    return parse_error(result, scanner);
+  }
+  result.success = found;
+  if (!found) {
+    result.error_message = "Invalid response format";
+  }
+  return result;
+}
+
+ExecutionResult parse_instrument_response(int http_status, bool success, const std::string& body,
+                                          InstrumentScale& out_scale) {
+  ExecutionResult result;
+  result.http_status = http_status;
+  result.success = success;
+
+  if (!success) {
+    result.error_message = body;
+    return result;
+  }
+
+  Price tick_size;
+  Qty lot_size;
+  bool has_tick = false;
+  bool has_lot = false;
+  JsonScanner scanner(body);
+  bool found = scanner.enter_object() && scanner.find_key("result") &&
+               scanner.peek() == '{' && scanner.enter_object();
+  if (found) {
+    std::string_view key;
+    while (scanner.next_key(key)) {
+      if (key == "tick_size") {
+        has_tick = read_increment(scanner, tick_size);
+      } else if (key == "min_trade_amount") {
+        has_lot = read_increment(scanner, lot_size);
+      } else {
+        scanner.skip_value();
+      }
+    }
+  }
+
+  if (!scanner.ok()) {
+    return parse_error(result, scanner);
+  }
+  result.success = found && has_tick && has_lot;
+  if (!result.success) {
+    result.error_message = "Invalid response format";
+    return result;
+  }
+  out_scale.price_decimals = tick_size.decimals();
+  out_scale.qty_decimals = lot_size.decimals();
+  out_scale.tick_size = tick_size;
+  out_scale.lot_size = lot_size;
+  return result;
+}
+
+} // namespace deribit
+} // namespace pulseexec
@@ -0,0 +1,809 @@
+#include "pulseexec/ExchangeSimulator.hpp"
+#include "pulseexec/Logger.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <string_view>
+#include <utility>
+
+namespace pulseexec {
+
+namespace {
+
+// Deribit error codes
+constexpr int kOrderNotFound = 10004;
+constexpr int kNotOpenOrder = 11044;
+constexpr int kTooManyRequests = 10028;
+constexpr int kMethodNotFound = -32601;
+constexpr int kInvalidParams = -32602;
+constexpr int kInternalError = -32603;
+constexpr int kParseError = -32700;
+
+// Order IDs are (instrument index << kSeqBits) | per-instrument sequence
+constexpr unsigned kSeqBits = 40;
+
+using Fields = std::vector<std::pair<std::string, std::string>>;
+
+int64_t now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+// Deribit reports partially filled orders as still open
+const char* deribit_order_state(OrderState state) {
+  switch (state) {
+  case OrderState::FILLED:
+    return "filled";
+  case OrderState::CANCELED:
+    return "cancelled";
+  case OrderState::REJECTED:
+    return "rejected";
+  default:
+    return "open";
+  }
+}
+
+void append_json_string(std::string& out, std::string_view text) {
+  static const char* kHex = "0123456789abcdef";
+  out += '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out += "\\u00";
+      out += kHex[(c >> 4) & 0xf];
+      out += kHex[c & 0xf];
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+void append_int(std::string& out, int64_t value) {
+  char buf[24];
+  auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+  out.append(buf, end);
+}
+
+void append_uint(std::string& out, uint64_t value) {
+  char buf[24];
+  auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+  out.append(buf, end);
+}
+
+// Reads the members of a JSON object into key/text pairs. Strings are
+// unescaped, numbers and literals kept as written and nested values skipped,
+// except the top-level "params" object, whose members replace the top-level
+// ones, and the top-level "id", kept as raw JSON to be echoed back.
+class RequestScanner {
+public:
+  explicit RequestScanner(std::string_view text) : text_(text) {}
+
+  bool parse(Fields& fields, std::string& id) {
+    Fields params;
+    bool has_params = false;
+    if (!parse_object(fields, &params, &has_params, &id)) {
+      return false;
+    }
+    skip_ws();
+    if (pos_ != text_.size()) {
+      return false;
+    }
+    if (has_params) {
+      fields = std::move(params);
+    }
+    return true;
+  }
+
+private:
+  bool parse_object(Fields& fields, Fields* params, bool* has_params, std::string* id) {
+    skip_ws();
+    if (!consume('{')) {
+      return false;
+    }
+    skip_ws();
+    if (consume('}')) {
+      return true;
+    }
+
+    while (true) {
+      std::string key;
+      skip_ws();
+      if (!parse_string(key)) {
+        return false;
+      }
+      skip_ws();
+      if (!consume(':')) {
+        return false;
+      }
+      skip_ws();
+      if (pos_ >= text_.size()) {
+        return false;
+      }
+
+      bool is_id = id && key == "id";
+      size_t start = pos_;
+      char c = text_[pos_];
+      if (c == '{' && params && key == "params") {
+        if (!parse_object(*params, nullptr, nullptr, nullptr)) {
+          return false;
+        }
+        *has_params = true;
+      } else if (c == '{' || c == '[') {
+        if (!skip_nested()) {
+          return false;
+        }
+      } else if (c == '"') {
+        std::string value;
+        if (!parse_string(value)) {
+          return false;
+        }
+        fields.emplace_back(std::move(key), std::move(value));
+      } else {
+        while (pos_ < text_.size() && !is_delimiter(text_[pos_])) {
+          ++pos_;
+        }
+        if (pos_ == start) {
+          return false;
+        }
+        fields.emplace_back(std::move(key), std::string(text_.substr(start, pos_ - start)));
+      }
+      if (is_id) {
+        *id = std::string(text_.substr(start, pos_ - start));
+      }
+
+      skip_ws();
+      if (consume('}')) {
+        return true;
+      }
+      if (!consume(',')) {
+        return false;
+      }
+    }
+  }
+
+  bool parse_string(std::string& out) {
+    if (!consume('"')) {
+      return false;
+    }
+    while (pos_ < text_.size()) {
+      char c = text_[pos_++];
+      if (c == '"') {
+        return true;
+      }
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) {
+        return false;
+      }
+      char e = text_[pos_++];
+      switch (e) {
+      case 'b':
+        out += '\b';
+        break;
+      case 'f':
+        out += '\f';
+        break;
+      case 'n':
+        out += '\n';
+        break;
+      case 'r':
+        out += '\r';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case 'u': {
+        unsigned code = 0;
+        if (pos_ + 4 > text_.size()) {
+          return false;
+        }
+        auto [ptr, ec] = std::from_chars(text_.data() + pos_, text_.data() + pos_ + 4, code, 16);
+        if (ec != std::errc() || ptr != text_.data() + pos_ + 4) {
+          return false;
+        }
+        pos_ += 4;
+        // Basic multilingual plane only; labels and instrument names are ASCII
+        if (code < 0x80) {
+          out += static_cast<char>(code);
+        } else if (code < 0x800) {
+          out += static_cast<char>(0xc0 | (code >> 6));
+          out += static_cast<char>(0x80 | (code & 0x3f));
+        } else {
+          out += static_cast<char>(0xe0 | (code >> 12));
+          out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+          out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        break;
+      }
+      default:
+        out += e; // \" \\ \/
+      }
+    }
+    return false;
+  }
+
+  bool skip_nested() {
+    int depth = 0;
+    while (pos_ < text_.size()) {
+      char c = text_[pos_];
+      if (c == '"') {
+        std::string ignored;
+        if (!parse_string(ignored)) {
+          return false;
+        }
+        continue;
+      }
+      ++pos_;
+      if (c == '{' || c == '[') {
+        ++depth;
+      } else if ((c == '}' || c == ']') && --depth == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool is_delimiter(char c) {
+    return c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+  void skip_ws() {
+    while (pos_ < text_.size() &&
+           (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\r' ||
+            text_[pos_] == '\n')) {
+      ++pos_;
+    }
+  }
+
+  bool consume(char c) {
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  std::string_view text_;
+  size_t pos_ = 0;
+};
+
+// The "[[action,] price, amount], ..." array body of one book side
+void append_levels(std::string& out, const std::vector<PriceLevel>& levels, const char* action) {
+  out += '[';
+  for (size_t i = 0; i < levels.size(); ++i) {
+    out += i ? ",[" : "[";
+    if (action) {
+      out += '"';
+      out += action;
+      out += "\",";
+    }
+    out += levels[i].price.to_string();
+    out += ',';
+    out += levels[i].amount.to_string();
+    out += ']';
+  }
+  out += ']';
+}
+
+void append_level_changes(std::string& out, const std::vector<MatchingLevelChange>& changes,
+                          Side side) {
+  out += '[';
+  bool first = true;
+  for (const auto& change : changes) {
+    if (change.side != side) {
+      continue;
+    }
+    out += first ? "[" : ",[";
+    out += change.amount.is_zero() ? "\"delete\"," : "\"change\",";
+    out += change.price.to_string();
+    out += ',';
+    out += change.amount.to_string();
+    out += ']';
+    first = false;
+  }
+  out += ']';
+}
+
+// Opens a book subscription notification up to the start of "data"'s members
+void begin_book_notification(std::string& out, const std::string& instrument, const char* type,
+                             int64_t ts_ms) {
+  out += R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"book.)";
+  out += instrument;
+  out += R"(.100ms","data":{"type":")";
+  out += type;
+  out += R"(","timestamp":)";
+  append_int(out, ts_ms);
+  out += R"(,"instrument_name":)";
+  append_json_string(out, instrument);
+}
+
+} // namespace
+
+// Parameters of one request, from the body and the query string
+struct ExchangeSimulator::RequestParams {
+  std::string id = "0"; // JSON-RPC id as sent, echoed in the reply
+  Fields fields;
+
+  const std::string* find(std::string_view key) const {
+    for (const auto& field : fields) {
+      if (field.first == key) {
+        return &field.second;
+      }
+    }
+    return nullptr;
+  }
+
+  std::string text(std::string_view key) const {
+    const std::string* value = find(key);
+    return value ? *value : "";
+  }
+
+  // Exact decimal parse onto decimals; exponent forms fall back to strtod
+  template <typename Value> bool decimal(std::string_view key, uint8_t decimals, Value& out) const {
+    const std::string* value = find(key);
+    if (!value || value->empty()) {
+      return false;
+    }
+    if (Value::parse(*value, out, decimals)) {
+      return true;
+    }
+    char* end = nullptr;
+    double parsed = std::strtod(value->c_str(), &end);
+    if (*end != '\0') {
+      return false;
+    }
+    out = Value(parsed, decimals);
+    return true;
+  }
+
+  void add_query(const std::string& target) {
+    size_t pos = target.find('?');
+    while (pos != std::string::npos && pos + 1 < target.size()) {
+      size_t start = pos + 1;
+      pos = target.find('&', start);
+      std::string pair = target.substr(start, pos == std::string::npos ? pos : pos - start);
+      size_t eq = pair.find('=');
+      if (eq != std::string::npos) {
+        fields.emplace_back(pair.substr(0, eq), pair.substr(eq + 1));
+      }
+    }
+  }
+};
+
+ExchangeSimulator::ExchangeSimulator(std::shared_ptr<Logger> logger,
+                                     const InstrumentScale& default_scale)
+    : logger_(logger), default_scale_(default_scale) {}
+
+bool ExchangeSimulator::add_instrument(const std::string& instrument,
+                                       const InstrumentScale& scale) {
+  std::unique_lock<std::shared_mutex> lock(books_mutex_);
+  if (books_by_name_.count(instrument)) {
+    return false;
+  }
+
+  auto book = std::make_unique<Book>(MatchingEngine(instrument, scale));
+  book->index = static_cast<uint32_t>(books_.size());
+  books_by_name_[instrument] = book.get();
+  books_.push_back(std::move(book));
+  return true;
+}
+
+void ExchangeSimulator::set_book_listener(BookListener listener) {
+  book_listener_ = std::move(listener);
+}
+
+ExchangeSimulator::Reply ExchangeSimulator::handle(const std::string& method,
+                                                   const std::string& target,
+                                                   const std::string& body) {
+  RequestParams params;
+  if (!body.empty() && !RequestScanner(body).parse(params.fields, params.id)) {
+    params.id = "0";
+    return error(params, kParseError, "parse_error");
+  }
+  params.add_query(target);
+
+  std::string_view path(target.data(), std::min(target.find('?'), target.size()));
+  if (rate_limiter_) {
+    std::chrono::microseconds wait;
+    if (!rate_limiter_->acquire(RateLimiter::pool_for(path), wait)) {
+      requests_rate_limited_.fetch_add(1, std::memory_order_relaxed);
+      Reply reply = error(params, kTooManyRequests, "too_many_requests");
+      reply.status = 429;
+      return reply;
+    }
+  }
+
+  if (path == "/api/v2/private/buy" && method == "POST") {
+    return place(params, Side::BUY);
+  }
+  if (path == "/api/v2/private/sell" && method == "POST") {
+    return place(params, Side::SELL);
+  }
+  if (path == "/api/v2/private/cancel" && method == "POST") {
+    return cancel(params);
+  }
+  if (path == "/api/v2/private/edit" && method == "POST") {
+    return edit(params);
+  }
+  if (path == "/api/v2/private/get_order_state") {
+    return order_state(params);
+  }
+  if (path == "/api/v2/public/get_order_book") {
+    return order_book(params);
+  }
+  if (path == "/api/v2/public/auth") {
+    return auth(params);
+  }
+  return error(params, kMethodNotFound, "method_not_found");
+}
+
+void ExchangeSimulator::set_rate_limits(const RateLimiter::Config& limits) {
+  // The exchange answers at once; only the client queues for credits
+  RateLimiter::Config enforced = limits;
+  enforced.max_wait = std::chrono::milliseconds(0);
+  rate_limiter_ = std::make_unique<RateLimiter>(enforced);
+}
+
+std::string ExchangeSimulator::snapshot_notification(const std::string& instrument) {
+  Book* book = find_book(instrument);
+  if (!book) {
+    return "";
+  }
+
+  std::lock_guard<std::mutex> lock(book->mutex);
+  OrderBook top;
+  book->engine.top(SIZE_MAX, top);
+
+  std::string out;
+  begin_book_notification(out, instrument, "snapshot", now_ms());
+  out += R"(,"change_id":)";
+  append_uint(out, book->change_id);
+  out += R"(,"bids":)";
+  append_levels(out, top.bids, "new");
+  out += R"(,"asks":)";
+  append_levels(out, top.asks, "new");
+  out += "}}}";
+  return out;
+}
+
+bool ExchangeSimulator::get_order(const std::string& order_id, MatchingOrder& out) {
+  uint64_t id = 0;
+  Book* book = book_for_order(order_id, id);
+  if (!book) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(book->mutex);
+  const MatchingOrder* order = book->engine.find(id);
+  if (!order) {
+    return false;
+  }
+  out = *order;
+  return true;
+}
+
+bool ExchangeSimulator::get_book(const std::string& instrument, size_t depth, OrderBook& out) {
+  Book* book = find_book(instrument);
+  if (!book) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(book->mutex);
+  book->engine.top(depth, out);
+  out.sequence = book->change_id;
+  return true;
+}
+
+ExchangeSimulator::Book* ExchangeSimulator::find_book(const std::string& instrument) {
+  std::shared_lock<std::shared_mutex> lock(books_mutex_);
+  auto it = books_by_name_.find(instrument);
+  return it == books_by_name_.end() ? nullptr : it->second;
+}
+
+ExchangeSimulator::Book* ExchangeSimulator::find_or_add_book(const std::string& instrument) {
+  if (Book* book = find_book(instrument)) {
+    return book;
+  }
+  if (add_instrument(instrument, default_scale_) && logger_) {
+    logger_->log_info("ExchangeSimulator", "Added instrument " + instrument);
+  }
+  return find_book(instrument);
+}
+
+ExchangeSimulator::Book* ExchangeSimulator::book_for_order(const std::string& order_id,
+                                                           uint64_t& id) {
+  auto [ptr, ec] = std::from_chars(order_id.data(), order_id.data() + order_id.size(), id);
+  if (order_id.empty() || ec != std::errc() || ptr != order_id.data() + order_id.size()) {
+    return nullptr;
+  }
+
+  std::shared_lock<std::shared_mutex> lock(books_mutex_);
+  uint64_t index = id >> kSeqBits;
+  return index < books_.size() ? books_[index].get() : nullptr;
+}
+
+ExchangeSimulator::Reply ExchangeSimulator::place(const RequestParams& params, Side side) {
+  std::string instrument = params.text("instrument_name");
+  OrderType type = parse_order_type(params.text("type"));
+  if (instrument.empty() || !params.find("amount")) {
+    return error(params, kInvalidParams, "instrument_name and amount are required");
+  }
+  if (type == OrderType::LIMIT && !params.find("price")) {
+    return error(params, kInvalidParams, "price is required for limit orders");
+  }
+
+  Book* book = find_or_add_book(instrument);
+  std::lock_guard<std::mutex> lock(book->mutex);
+  MatchingEngine& engine = book->engine;
+  Price price;
+  Qty amount;
+  if (!params.decimal("amount", engine.scale().qty_decimals, amount) ||
+      (type == OrderType::LIMIT &&
+       !params.decimal("price", engine.scale().price_decimals, price))) {
+    return error(params, kInvalidParams, "invalid amount or price");
+  }
+
+  uint64_t order_id = (static_cast<uint64_t>(book->index) << kSeqBits) | book->next_seq++;
+  int64_t now = now_ms();
+  const MatchingOrder* placed =
+      engine.submit(order_id, side, type, price, amount, params.text("label"), now);
+  if (!placed) {
+    return error(params, kInternalError, "duplicate order id"); // Sequence wrapped
+  }
+  const MatchingOrder& order = *placed;
+  if (order.state == OrderState::REJECTED) {
+    return error(params, kInvalidParams, "invalid amount or price");
+  }
+  orders_placed_.fetch_add(1, std::memory_order_relaxed);
+
+  Reply reply;
+  reply.body.reserve(512);
+  reply.body += R"({"jsonrpc":"2.0","id":)";
+  reply.body += params.id;
+  reply.body += R"(,"result":{"order":)";
+  append_order(reply.body, *book, order);
+  reply.body += R"(,"trades":)";
+  append_trades(reply.body, *book, side);
+  reply.body += "}}";
+  publish_changes(*book, now);
+  return reply;
+}
+
+ExchangeSimulator::Reply ExchangeSimulator::cancel(const RequestParams& params) {
+  uint64_t order_id = 0;
+  Book* book = book_for_order(params.text("order_id"), order_id);
+  if (!book) {
+    return error(params, kOrderNotFound, "order_not_found");
+  }
+
+  std::lock_guard<std::mutex> lock(book->mutex);
+  MatchingEngine& engine = book->engine;
+  const MatchingOrder* order = engine.find(order_id);
+  if (!order) {
+    return error(params, kOrderNotFound, "order_not_found");
+  }
+  int64_t now = now_ms();
+  if (!engine.cancel(order_id, now)) {
+    return error(params, kNotOpenOrder, "not_open_order");
+  }
+
+  Reply reply;
+  reply.body += R"({"jsonrpc":"2.0","id":)";
+  reply.body += params.id;
+  reply.body += R"(,"result":)";
+  append_order(reply.body, *book, *order);
+  reply.body += '}';
+  publish_changes(*book, now);
+  return reply;
+}
+
+ExchangeSimulator::Reply ExchangeSimulator::edit(const RequestParams& params) {
+  uint64_t order_id = 0;
+  Book* book = book_for_order(params.text("order_id"), order_id);
+  if (!book) {
+    return error(params, kOrderNotFound, "order_not_found");
+  }
+
+  std::lock_guard<std::mutex> lock(book->mutex);
+  MatchingEngine& engine = book->engine;
+  const MatchingOrder* order = engine.find(order_id);
+  if (!order) {
+    return error(params, kOrderNotFound, "order_not_found");
+  }
+  if (order->state != OrderState::OPEN && order->state != OrderState::PARTIAL) {
+    return error(params, kNotOpenOrder, "not_open_order");
+  }
+
+  Qty amount;
+  Price price = order->price;
+  if (!params.decimal("amount", engine.scale().qty_decimals, amount)) {
+    return error(params, kInvalidParams, "amount is required");
+  }
+  if (params.find("price") && !params.decimal("price", engine.scale().price_decimals, price)) {
+    return error(params, kInvalidParams, "invalid price");
+  }
+  int64_t now = now_ms();
+  if (!engine.edit(order_id, price, amount, now)) {
+    return error(params, kInvalidParams, "invalid amount or price");
+  }
+
+  Reply reply;
+  reply.body.reserve(512);
+  reply.body += R"({"jsonrpc":"2.0","id":)";
+  reply.body += params.id;
+  reply.body += R"(,"result":{"order":)";
+  append_order(reply.body, *book, *order);
+  reply.body += R"(,"trades":)";
+  append_trades(reply.body, *book, order->side);
+  reply.body += "}}";
+  publish_changes(*book, now);
+  return reply;
+}
+
+ExchangeSimulator::Reply ExchangeSimulator::order_state(const RequestParams& params) {
+  uint64_t order_id = 0;
+  Book* book = book_for_order(params.text("order_id"), order_id);
+  if (!book) {
+    return error(params, kOrderNotFound, "order_not_found");
+  }
+
+  std::lock_guard<std::mutex> lock(book->mutex);
+  const MatchingOrder* order = book->engine.find(order_id);
+  if (!order) {
+    return error(params, kOrderNotFound, "order_not_found");
+  }
+
+  Reply reply;
+  reply.body += R"({"jsonrpc":"2.0","id":)";
+  reply.body += params.id;
+  reply.body += R"(,"result":)";
+  append_order(reply.body, *book, *order);
+  reply.body += '}';
+  return reply;
+}
+
+ExchangeSimulator::Reply ExchangeSimulator::order_book(const RequestParams& params) {
+  Book* book = find_book(params.text("instrument_name"));
+  if (!book) {
+    return error(params, kInvalidParams, "unknown instrument_name");
+  }
+  size_t depth = 10;
+  std::string depth_text = params.text("depth");
+  std::from_chars(depth_text.data(), depth_text.data() + depth_text.size(), depth);
+
+  OrderBook top;
+  uint64_t change_id = 0;
+  {
+    std::lock_guard<std::mutex> lock(book->mutex);
+    book->engine.top(depth, top);
+    change_id = book->change_id;
+  }
+
+  Reply reply;
+  reply.body += R"({"jsonrpc":"2.0","id":)";
+  reply.body += params.id;
+  reply.body += R"(,"result":{"instrument_name":)";
+  append_json_string(reply.body, top.symbol);
+  reply.body += R"(,"timestamp":)";
+  append_int(reply.body, now_ms());
+  reply.body += R"(,"change_id":)";
+  append_uint(reply.body, change_id);
+  reply.body += R"(,"bids":)";
+  append_levels(reply.body, top.bids, nullptr);
+  reply.body += R"(,"asks":)";
+  append_levels(reply.body, top.asks, nullptr);
+  reply.body += "}}";
+  return reply;
+}
+
+ExchangeSimulator::Reply ExchangeSimulator::auth(const RequestParams& params) {
+  Reply reply;
+  reply.body += R"({"jsonrpc":"2.0","id":)";
+  reply.body += params.id;
+  reply.body += R"(,"result":{"access_token":"simulator_token",)"
+                R"("refresh_token":"simulator_refresh","token_type":"bearer",)"
+                R"("expires_in":3600,"scope":"trade:read_write"}})";
+  return reply;
+}
+
+ExchangeSimulator::Reply ExchangeSimulator::error(const RequestParams& params, int code,
+                                                  const char* message) {
+  requests_failed_.fetch_add(1, std::memory_order_relaxed);
+  Reply reply;
+  reply.status = 400;
+  reply.body += R"({"jsonrpc":"2.0","id":)";
+  reply.body += params.id;
+  reply.body += R"(,"error":{"code":)";
+  append_int(reply.body, code);
+  reply.body += R"(,"message":)";
+  append_json_string(reply.body, message);
+  reply.body += "}}";
+  return reply;
+}
+
+void ExchangeSimulator::append_order(std::string& out, const Book& book,
+                                     const MatchingOrder& order) const {
+  out += R"({"order_id":")";
+  append_uint(out, order.id);
+  out += R"(","label":)";
+  append_json_string(out, order.label);
+  out += R"(,"instrument_name":)";
+  append_json_string(out, book.engine.instrument());
+  out += R"(,"direction":")";
+  out += to_string(order.side);
+  out += R"(","order_type":")";
+  out += to_string(order.type);
+  out += R"(","price":)";
+  if (order.type == OrderType::LIMIT) {
+    out += order.price.to_string();
+  } else {
+    out += R"("market_price")";
+  }
+  out += R"(,"amount":)";
+  out += order.amount.to_string();
+  out += R"(,"filled_amount":)";
+  out += order.filled.to_string();
+  out += R"(,"order_state":")";
+  out += deribit_order_state(order.state);
+  out += R"(","creation_timestamp":)";
+  append_int(out, order.created_ts_ms);
+  out += R"(,"last_update_timestamp":)";
+  append_int(out, order.updated_ts_ms);
+  out += '}';
+}
+
+void ExchangeSimulator::append_trades(std::string& out, const Book& book, Side taker_side) const {
+  out += '[';
+  bool first = true;
+  for (const auto& fill : book.engine.fills()) {
+    out += first ? R"({"trade_id":")" : R"(,{"trade_id":")";
+    append_uint(out, fill.trade_id);
+    out += R"(","order_id":")";
+    append_uint(out, fill.taker_id);
+    out += R"(","instrument_name":)";
+    append_json_string(out, book.engine.instrument());
+    out += R"(,"direction":")";
+    out += to_string(taker_side);
+    out += R"(","price":)";
+    out += fill.price.to_string();
+    out += R"(,"amount":)";
+    out += fill.amount.to_string();
+    out += R"(,"liquidity":"T"})";
+    first = false;
+  }
+  out += ']';
+}
+
+void ExchangeSimulator::publish_changes(Book& book, int64_t ts_ms) {
+  const auto& changes = book.engine.level_changes();
+  if (changes.empty()) {
+    return;
+  }
+  ++book.change_id;
+  if (!book_listener_) {
+    return;
+  }
+
+  std::string out;
+  out.reserve(256);
+  begin_book_notification(out, book.engine.instrument(), "change", ts_ms);
+  out += R"(,"change_id":)";
+  append_uint(out, book.change_id);
+  out += R"(,"prev_change_id":)";
+  append_uint(out, book.change_id - 1);
+  out += R"(,"bids":)";
+  append_level_changes(out, changes, Side::BUY);
+  out += R"(,"asks":)";
+  append_level_changes(out, changes, Side::SELL);
+  out += "}}}";
+  book_listener_(out);
+}
+
+} // namespace pulseexec
@@ -1,5 +1,12 @@
 #include "pulseexec/ExecutionGateway.hpp"
+#include "pulseexec/CurlHandlePool.hpp"
+#include "pulseexec/CurlMultiLoop.hpp"
+#include "pulseexec/DeribitCodec.hpp"
+#include "pulseexec/LatencyTracker.hpp"
 #include "pulseexec/Logger.hpp"
+#include "pulseexec/RateLimiter.hpp"
+#include "pulseexec/SessionRecorder.hpp"
+#include <algorithm>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
 #include <random>
@@ -10,6 +17,32 @@ using json = nlohmann::json;
 
 namespace pulseexec {
 
+// Built once rather than per request
+static const std::string kBuyEndpoint = "/api/v2/private/buy";
+static const std::string kSellEndpoint = "/api/v2/private/sell";
+static const std::string kCancelEndpoint = "/api/v2/private/cancel";
+static const std::string kEditEndpoint = "/api/v2/private/edit";
+static const std::string kGetOrderStateEndpoint = "/api/v2/private/get_order_state";
+static const std::string kGetOrderStateByLabelEndpoint =
+    "/api/v2/private/get_order_state_by_label";
+
+static const std::string kAuthEndpoint = "/api/v2/public/auth";
+
+// Share of a token's lifetime after which it is renewed in the background,
+// and after which it is no longer used at all
+static constexpr int64_t kTokenRefreshPermille = 500;
+static constexpr int64_t kTokenExpiryPermille = 900;
+
+// However short-lived the exchange says a token is, the refresher waits at
+// least this long between renewals rather than spinning on public/auth
+static constexpr auto kMinTokenRefresh = std::chrono::seconds(1);
+
+// Encode buffer reused by every order request a thread sends
+static deribit::RequestWriter& request_writer() {
+  thread_local deribit::RequestWriter writer;
+  return writer;
+}
+
 // CURL write callback
 static size_t write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
   ((std::string*)userp)->append((char*)contents, size * nmemb);
@@ -17,194 +50,165 @@ static size_t write_callback(void* contents, size_t size, size_t nmemb, void* us
 }
 
 ExecutionGateway::ExecutionGateway(const std::string& api_key, const std::string& api_secret,
-                                   const std::string& base_url, std::shared_ptr<Logger> logger)
+                                   const std::string& base_url, std::shared_ptr<Logger> logger,
+                                   size_t connection_pool_size)
     : api_key_(api_key), api_secret_(api_secret), base_url_(base_url), logger_(logger),
       max_retries_(3), base_backoff_ms_(100) {
   curl_global_init(CURL_GLOBAL_DEFAULT);
+  curl_pool_ = std::make_unique<CurlHandlePool>(connection_pool_size);
+  async_loop_ = std::make_unique<CurlMultiLoop>(connection_pool_size);
 }
 
-ExecutionGateway::~ExecutionGateway() { curl_global_cleanup(); }
-
-ExecutionResult ExecutionGateway::place_order(const OrderRequest& request) {
-  ExecutionResult result;
-
-  // Build JSON-RPC 2.0 request body for Deribit
-  json params;
-  params["instrument_name"] = request.symbol;
-  params["amount"] = request.amount;
-  params["type"] = to_string(request.type);
-
-  if (request.type == OrderType::LIMIT) {
-    params["price"] = request.price;
+ExecutionGateway::~ExecutionGateway() {
+  {
+    std::lock_guard<std::mutex> lock(token_mutex_);
+    token_refresher_stop_ = true;
   }
-
-  if (!request.client_order_id.empty()) {
-    params["label"] = request.client_order_id;
+  token_cv_.notify_all();
+  if (token_refresher_.joinable()) {
+    token_refresher_.join();
   }
 
-  // Deribit uses JSON-RPC 2.0 format
-  std::string method = request.side == Side::BUY ? "private/buy" : "private/sell";
-  std::string body = build_jsonrpc_request(method, params);
-
-  std::string endpoint = std::string("/api/v2/private/") + (request.side == Side::BUY ? "buy" : "sell");
-  Response resp = execute_with_retry(endpoint, "POST", body);
-
-  result.http_status = resp.http_status;
-  result.success = resp.success;
+  // Fail outstanding async requests while the gateway is still intact
+  async_loop_->stop();
+  async_loop_.reset();
 
-  if (resp.success) {
-    try {
-      json response = json::parse(resp.body);
-      if (response.contains("result") && response["result"].contains("order")) {
-        json order = response["result"]["order"];
-        result.exchange_order_id = order.value("order_id", "");
-        result.success = true;
-      } else {
-        result.success = false;
-        result.error_message = "Invalid response format";
-      }
-    } catch (const std::exception& e) {
-      result.success = false;
-      result.error_message = std::string("JSON parse error: ") + e.what();
-    }
-  } else {
-    result.error_message = resp.body;
-  }
-
-  return result;
+  // Pooled handles must be released before libcurl is torn down
+  curl_pool_.reset();
+  curl_global_cleanup();
 }
 
-ExecutionResult ExecutionGateway::cancel_order(const std::string& exchange_order_id) {
-  ExecutionResult result;
-
-  json j;
-  j["order_id"] = exchange_order_id;
-
-  std::string endpoint = "/api/v2/private/cancel";
-  std::string body = j.dump();
+void ExecutionGateway::set_latency_tracker(std::shared_ptr<LatencyTracker> tracker) {
+  latency_tracker_ = std::move(tracker);
+}
 
-  Response resp = execute_with_retry(endpoint, "POST", body);
+void ExecutionGateway::set_recorder(std::shared_ptr<SessionRecorder> recorder) {
+  recorder_ = std::move(recorder);
+}
 
-  result.http_status = resp.http_status;
-  result.success = resp.success;
+void ExecutionGateway::set_rate_limiter(std::shared_ptr<RateLimiter> limiter) {
+  rate_limiter_ = std::move(limiter);
+}
 
-  if (!resp.success) {
-    result.error_message = resp.body;
-  }
+ExecutionResult ExecutionGateway::place_order(const OrderRequest& request) {
+  const std::string& body = request_writer().place_order(request);
+  trace_sent(request.client_order_id);
+  Response resp = execute_with_retry(place_order_endpoint(request.side), "POST", body);
+  trace_response(request.client_order_id, resp);
+  return parse_place_order_response(resp);
+}
 
-  return result;
+ExecutionResult ExecutionGateway::cancel_order(const std::string& exchange_order_id) {
+  Response resp = execute_with_retry(kCancelEndpoint, "POST",
+                                     request_writer().cancel_order(exchange_order_id));
+  return to_execution_result(resp);
 }
 
 ExecutionResult ExecutionGateway::modify_order(const std::string& exchange_order_id,
-                                                double new_price, double new_amount) {
-  ExecutionResult result;
-
-  json j;
-  j["order_id"] = exchange_order_id;
-  j["amount"] = new_amount;
-  j["price"] = new_price;
-
-  std::string endpoint = "/api/v2/private/edit";
-  std::string body = j.dump();
+                                                Price new_price, Qty new_amount) {
+  const std::string& body = request_writer().modify_order(exchange_order_id, new_price, new_amount);
+  Response resp = execute_with_retry(kEditEndpoint, "POST", body);
+  return to_execution_result(resp);
+}
 
-  Response resp = execute_with_retry(endpoint, "POST", body);
+void ExecutionGateway::place_order_async(const OrderRequest& request, ExecutionCallback callback) {
+  trace_sent(request.client_order_id);
+  execute_async(place_order_endpoint(request.side), request_writer().place_order(request),
+                [this, client_order_id = request.client_order_id,
+                 callback = std::move(callback)](const Response& resp) {
+                  trace_response(client_order_id, resp);
+                  callback(parse_place_order_response(resp));
+                });
+}
 
-  result.http_status = resp.http_status;
-  result.success = resp.success;
+void ExecutionGateway::cancel_order_async(const std::string& exchange_order_id,
+                                          ExecutionCallback callback) {
+  execute_async(kCancelEndpoint, request_writer().cancel_order(exchange_order_id),
+                [this, callback = std::move(callback)](const Response& resp) {
+                  callback(to_execution_result(resp));
+                });
+}
 
-  if (!resp.success) {
-    result.error_message = resp.body;
-  }
+void ExecutionGateway::modify_order_async(const std::string& exchange_order_id, Price new_price,
+                                          Qty new_amount, ExecutionCallback callback) {
+  execute_async(kEditEndpoint,
+                request_writer().modify_order(exchange_order_id, new_price, new_amount),
+                [this, callback = std::move(callback)](const Response& resp) {
+                  callback(to_execution_result(resp));
+                });
+}
 
-  return result;
+size_t ExecutionGateway::async_in_flight() const {
+  return async_loop_->in_flight_count() + async_loop_->pending_count();
 }
 
 ExecutionResult ExecutionGateway::get_order_status(const std::string& exchange_order_id,
                                                     Order& out_order) {
-  ExecutionResult result;
-
   std::string endpoint = "/api/v2/private/get_order_state?order_id=" + exchange_order_id;
 
   Response resp = execute_with_retry(endpoint, "GET");
+  return deribit::parse_order_state_response(resp.http_status, resp.success, resp.body, out_order);
+}
 
-  result.http_status = resp.http_status;
-  result.success = resp.success;
-
-  if (resp.success) {
-    try {
-      json response = json::parse(resp.body);
-      if (response.contains("result")) {
-        json order_data = response["result"];
-        // Parse order data and populate out_order
-        // This is simplified - add full parsing logic
-        result.success = true;
-      }
-    } catch (const std::exception& e) {
-      result.success = false;
-      result.error_message = std::string("JSON parse error: ") + e.what();
-    }
-  } else {
-    result.error_message = resp.body;
-  }
+void ExecutionGateway::get_order_status_async(const std::string& exchange_order_id,
+                                              OrderStatusCallback callback) {
+  execute_async(kGetOrderStateEndpoint, request_writer().get_order_state(exchange_order_id),
+                [callback = std::move(callback)](const Response& resp) {
+                  Order order;
+                  ExecutionResult result = deribit::parse_order_state_response(
+                      resp.http_status, resp.success, resp.body, order);
+                  callback(result, order);
+                });
+}
 
-  return result;
+void ExecutionGateway::get_order_status_by_label_async(const std::string& symbol,
+                                                       const std::string& label,
+                                                       OrderStatusCallback callback) {
+  execute_async(kGetOrderStateByLabelEndpoint,
+                request_writer().get_order_state_by_label(deribit::instrument_currency(symbol),
+                                                          label),
+                [callback = std::move(callback)](const Response& resp) {
+                  Order order;
+                  ExecutionResult result = deribit::parse_order_state_by_label_response(
+                      resp.http_status, resp.success, resp.body, order);
+                  callback(result, order);
+                });
 }
 
 ExecutionResult ExecutionGateway::get_orderbook(const std::string& symbol,
                                                  OrderBook& out_orderbook) {
-  ExecutionResult result;
-
   std::string endpoint = "/api/v2/public/get_order_book?instrument_name=" + symbol + "&depth=10";
 
   Response resp = execute_with_retry(endpoint, "GET");
 
-  result.http_status = resp.http_status;
-  result.success = resp.success;
+  out_orderbook.symbol = symbol;
+  return deribit::parse_order_book_response(resp.http_status, resp.success, resp.body,
+                                            out_orderbook);
+}
 
-  if (resp.success) {
-    try {
-      json response = json::parse(resp.body);
-      if (response.contains("result")) {
-        json book = response["result"];
-        
-        out_orderbook.symbol = symbol;
-        out_orderbook.bids.clear();
-        out_orderbook.asks.clear();
-
-        if (book.contains("bids")) {
-          for (const auto& bid : book["bids"]) {
-            double price = bid[0].get<double>();
-            double amount = bid[1].get<double>();
-            out_orderbook.bids.emplace_back(price, amount);
-          }
-        }
-
-        if (book.contains("asks")) {
-          for (const auto& ask : book["asks"]) {
-            double price = ask[0].get<double>();
-            double amount = ask[1].get<double>();
-            out_orderbook.asks.emplace_back(price, amount);
-          }
-        }
-
-        out_orderbook.timestamp_us = book.value("timestamp", 0L);
-        result.success = true;
-      }
-    } catch (const std::exception& e) {
-      result.success = false;
-      result.error_message = std::string("JSON parse error: ") + e.what();
-    }
-  } else {
-    result.error_message = resp.body;
-  }
+ExecutionResult ExecutionGateway::get_instrument_scale(const std::string& symbol,
+                                                       InstrumentScale& out_scale) {
+  std::string endpoint = "/api/v2/public/get_instrument?instrument_name=" + symbol;
 
-  return result;
+  Response resp = execute_with_retry(endpoint, "GET");
+
+  return deribit::parse_instrument_response(resp.http_status, resp.success, resp.body, out_scale);
 }
 
 ExecutionGateway::Response ExecutionGateway::http_post(const std::string& endpoint,
                                                         const std::string& json_body) {
   Response response;
-  CURL* curl = curl_easy_init();
+
+  // Resolve the access token before leasing a handle: access_token may
+  // itself issue a request and would otherwise need a second handle. Tokens
+  // outlive every request, so the pointer stays valid after a renewal.
+  const AccessToken* token = nullptr;
+  if (endpoint.find("/private/") != std::string::npos) {
+    token = access_token();
+  }
+
+  CurlHandlePool::Lease lease = curl_pool_->acquire();
+  CURL* curl = lease.get();
 
   if (!curl) {
     response.success = false;
@@ -213,19 +217,17 @@ ExecutionGateway::Response ExecutionGateway::http_post(const std::string& endpoi
     return response;
   }
 
-  std::string url = base_url_ + endpoint;
+  // Per-thread scratch keeps the URL string off the allocator
+  thread_local std::string url;
+  url.assign(base_url_).append(endpoint);
   std::string response_body;
 
   struct curl_slist* headers = nullptr;
   headers = curl_slist_append(headers, "Content-Type: application/json");
-  
+
   // For private endpoints, add access token
-  if (endpoint.find("/private/") != std::string::npos) {
-    std::string token = get_access_token();
-    if (!token.empty()) {
-      std::string auth_header = "Authorization: Bearer " + token;
-      headers = curl_slist_append(headers, auth_header.c_str());
-    }
+  if (token) {
+    headers = curl_slist_append(headers, token->auth_header.c_str());
   }
 
   curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
@@ -250,14 +252,14 @@ ExecutionGateway::Response ExecutionGateway::http_post(const std::string& endpoi
   }
 
   curl_slist_free_all(headers);
-  curl_easy_cleanup(curl);
 
   return response;
 }
 
 ExecutionGateway::Response ExecutionGateway::http_get(const std::string& endpoint) {
   Response response;
-  CURL* curl = curl_easy_init();
+  CurlHandlePool::Lease lease = curl_pool_->acquire();
+  CURL* curl = lease.get();
 
   if (!curl) {
     response.success = false;
@@ -295,7 +297,6 @@ ExecutionGateway::Response ExecutionGateway::http_get(const std::string& endpoin
   }
 
   curl_slist_free_all(headers);
-  curl_easy_cleanup(curl);
 
   return response;
 }
@@ -306,6 +307,14 @@ ExecutionGateway::Response ExecutionGateway::execute_with_retry(const std::strin
   Response response;
 
   for (int attempt = 0; attempt <= max_retries_; ++attempt) {
+    std::chrono::microseconds wait(0);
+    if (!take_credits(endpoint, wait, response)) {
+      break;
+    }
+    if (wait.count() > 0) {
+      std::this_thread::sleep_for(wait);
+    }
+
     if (method == "POST") {
       response = http_post(endpoint, json_body);
     } else if (method == "GET") {
@@ -314,7 +323,10 @@ ExecutionGateway::Response ExecutionGateway::execute_with_retry(const std::strin
 
     // Success
     if (response.success) {
-      return response;
+      break;
+    }
+    if (response.http_status == 429 && rate_limiter_) {
+      rate_limiter_->on_rate_limited(RateLimiter::pool_for(endpoint));
     }
 
     // Check if we should retry (429 or 5xx)
@@ -328,17 +340,140 @@ ExecutionGateway::Response ExecutionGateway::execute_with_retry(const std::strin
     // Calculate backoff and sleep
     int backoff_ms = calculate_backoff_ms(attempt);
     if (logger_) {
-      logger_->log_warning("ExecutionGateway",
-                           "Retrying after " + std::to_string(backoff_ms) + "ms (attempt " +
-                               std::to_string(attempt + 1) + "/" + std::to_string(max_retries_) +
-                               ")");
+      logger_->log_event(LogLevel::WARNING, LogFormatId::REQUEST_RETRY, backoff_ms, attempt + 1,
+                         max_retries_);
     }
     std::this_thread::sleep_for(std::chrono::milliseconds(backoff_ms));
   }
 
+  record_response(endpoint, response);
   return response;
 }
 
+void ExecutionGateway::execute_async(const std::string& endpoint, const std::string& json_body,
+                                     ResponseHandler on_response) {
+  auto transfer = std::make_shared<CurlMultiLoop::Transfer>();
+  transfer->url = base_url_ + endpoint;
+  transfer->body = json_body;
+  transfer->post = true;
+  transfer->headers.push_back("Content-Type: application/json");
+
+  // For private endpoints, add access token
+  if (endpoint.find("/private/") != std::string::npos) {
+    if (const AccessToken* token = access_token()) {
+      transfer->headers.push_back(token->auth_header);
+    }
+  }
+
+  send_async(std::move(transfer), 0, std::move(on_response), 0);
+}
+
+void ExecutionGateway::send_async(std::shared_ptr<const CurlMultiLoop::Transfer> transfer,
+                                  int attempt, ResponseHandler on_response, int delay_ms) {
+  // Runs on the loop thread: retries are re-submitted on a timer instead of sleeping
+  auto on_complete = [this, transfer, attempt,
+                      on_response](const CurlMultiLoop::Response& loop_resp) {
+    Response response;
+    response.success = loop_resp.success;
+    response.http_status = loop_resp.http_status;
+    response.body = loop_resp.body;
+
+    if (response.http_status == 429 && rate_limiter_) {
+      rate_limiter_->on_rate_limited(
+          RateLimiter::pool_for(std::string_view(transfer->url).substr(base_url_.size())));
+    }
+    bool should_retry = !response.success &&
+                        (response.http_status == 429 || response.http_status >= 500) &&
+                        attempt < max_retries_;
+
+    if (should_retry) {
+      int backoff_ms = calculate_backoff_ms(attempt);
+      if (logger_) {
+        logger_->log_event(LogLevel::WARNING, LogFormatId::REQUEST_RETRY, backoff_ms,
+                           attempt + 1, max_retries_);
+      }
+      send_async(transfer, attempt + 1, on_response, backoff_ms);
+      return;
+    }
+
+    record_response(transfer->url.substr(base_url_.size()), response);
+    on_response(response);
+  };
+
+  // Over-limit requests are queued on the loop's timer rather than sent early
+  std::chrono::microseconds wait(0);
+  Response rejected;
+  if (!take_credits(std::string_view(transfer->url).substr(base_url_.size()), wait, rejected)) {
+    record_response(transfer->url.substr(base_url_.size()), rejected);
+    on_response(rejected);
+    return;
+  }
+  delay_ms = std::max<int>(delay_ms, static_cast<int>((wait.count() + 999) / 1000));
+
+  if (!async_loop().submit(transfer, std::move(on_complete), delay_ms)) {
+    Response response;
+    response.success = false;
+    response.http_status = 0;
+    response.body = "Async request loop is not running";
+    record_response(transfer->url.substr(base_url_.size()), response);
+    on_response(response);
+  }
+}
+
+CurlMultiLoop& ExecutionGateway::async_loop() {
+  // The loop thread is only spawned once async submission is actually used
+  std::call_once(async_loop_once_, [this] { async_loop_->start(); });
+  return *async_loop_;
+}
+
+void ExecutionGateway::record_response(const std::string& endpoint, const Response& resp) {
+  // Auth replies go through http_post directly and never reach here, so no
+  // access token is written to a recording
+  if (recorder_) {
+    recorder_->record_gateway_response(endpoint, resp.http_status, resp.success, resp.body);
+  }
+}
+
+void ExecutionGateway::trace_sent(const std::string& client_order_id) {
+  if (latency_tracker_ && !client_order_id.empty()) {
+    latency_tracker_->mark_sent(client_order_id);
+  }
+}
+
+void ExecutionGateway::trace_response(const std::string& client_order_id, const Response& resp) {
+  if (!latency_tracker_ || client_order_id.empty()) {
+    return;
+  }
+  // Transport failures carry no exchange round trip worth recording
+  if (resp.http_status != 0) {
+    latency_tracker_->mark_acked(client_order_id);
+  } else {
+    latency_tracker_->forget(client_order_id);
+  }
+}
+
+bool ExecutionGateway::take_credits(std::string_view endpoint, std::chrono::microseconds& wait,
+                                    Response& rejected) {
+  if (!rate_limiter_) {
+    return true;
+  }
+  RateLimiter::Pool pool = RateLimiter::pool_for(endpoint);
+  if (rate_limiter_->acquire(pool, wait)) {
+    return true;
+  }
+
+  // Never sent, so like a transport failure it carries no HTTP status
+  rejected.success = false;
+  rejected.http_status = 0;
+  rejected.body = pool == RateLimiter::Pool::MATCHING_ENGINE
+                      ? "Rate limited locally: matching engine credits exhausted"
+                      : "Rate limited locally: non-matching credits exhausted";
+  if (logger_) {
+    logger_->log_warning("ExecutionGateway", rejected.body);
+  }
+  return false;
+}
+
 int ExecutionGateway::calculate_backoff_ms(int attempt) const {
   // Exponential backoff with jitter
   int base = base_backoff_ms_ * (1 << attempt); // 2^attempt
@@ -357,55 +492,122 @@ std::string ExecutionGateway::get_auth_header() const {
 }
 
 std::string ExecutionGateway::build_jsonrpc_request(const std::string& method, const json& params) const {
-  json request;
-  request["jsonrpc"] = "2.0";
-  request["id"] = 1;
-  request["method"] = method;
-  request["params"] = params;
-  return request.dump();
-}
-
-std::string ExecutionGateway::get_access_token() {
-  // Check if we have a valid cached token
-  auto now = std::chrono::steady_clock::now();
-  if (!access_token_.empty() && now < token_expiry_) {
-    return access_token_;
+  return deribit::build_jsonrpc_request(method, params);
+}
+
+const std::string& ExecutionGateway::place_order_endpoint(Side side) {
+  return side == Side::BUY ? kBuyEndpoint : kSellEndpoint;
+}
+
+ExecutionResult ExecutionGateway::parse_place_order_response(const Response& resp) const {
+  return deribit::parse_place_order_response(resp.http_status, resp.success, resp.body);
+}
+
+ExecutionResult ExecutionGateway::to_execution_result(const Response& resp) const {
+  ExecutionResult result;
+  result.http_status = resp.http_status;
+  result.success = resp.success;
+
+  if (!resp.success) {
+    result.error_message = resp.body;
   }
 
-  // Authenticate and get new access token
+  return result;
+}
+
+const ExecutionGateway::AccessToken* ExecutionGateway::access_token() {
+  // The order path: a lock-free load of the token the refresher keeps current
+  const AccessToken* token = token_.load(std::memory_order_acquire);
+  if (token && std::chrono::steady_clock::now() < token->expires_at) {
+    return token;
+  }
+
+  // First private request, or renewals have been failing: authenticate inline
+  std::call_once(token_refresher_once_,
+                 [this] { token_refresher_ = std::thread([this] { refresh_tokens(); }); });
+
+  // One request authenticates and the rest wait here for its token.
+  // token_mutex_ is not held across the round trip, only to publish.
+  std::lock_guard<std::mutex> lock(inline_auth_mutex_);
+  token = token_.load(std::memory_order_acquire);
+  if (token && std::chrono::steady_clock::now() < token->expires_at) {
+    return token; // Renewed while this thread waited for the lock
+  }
+  return renew_token();
+}
+
+void ExecutionGateway::refresh_tokens() {
+  std::unique_lock<std::mutex> lock(token_mutex_);
+  int failures = 0;
+  while (!token_refresher_stop_) {
+    const AccessToken* token = token_.load(std::memory_order_acquire);
+    size_t generation = issued_tokens_.size();
+    auto replaced = [&] { return token_refresher_stop_ || issued_tokens_.size() != generation; };
+
+    // Nothing to renew until a request has authenticated
+    if (!token) {
+      token_cv_.wait(lock, replaced);
+      continue;
+    }
+
+    auto renew_at = failures == 0 ? token->refresh_at
+                                  : std::chrono::steady_clock::now() +
+                                        std::chrono::milliseconds(
+                                            calculate_backoff_ms(std::min(failures - 1, 5)));
+    if (token_cv_.wait_until(lock, renew_at, replaced)) {
+      continue; // Stopping, or a request renewed it inline
+    }
+
+    // Unlocked for the auth round trip, so neither an inline renewal nor
+    // the destructor's stop request waits on it
+    lock.unlock();
+    bool renewed = renew_token() != nullptr;
+    lock.lock();
+    failures = renewed ? 0 : failures + 1;
+  }
+}
+
+const ExecutionGateway::AccessToken* ExecutionGateway::renew_token() {
+  auto issued = std::chrono::steady_clock::now();
+
   json params;
   params["grant_type"] = "client_credentials";
   params["client_id"] = api_key_;
   params["client_secret"] = api_secret_;
 
-  std::string body = build_jsonrpc_request("public/auth", params);
-  
-  Response resp = http_post("/api/v2/public/auth", body);
-  
-  if (resp.success) {
-    try {
-      json response = json::parse(resp.body);
-      if (response.contains("result")) {
-        access_token_ = response["result"]["access_token"].get<std::string>();
-        int expires_in = response["result"]["expires_in"].get<int>();
-        
-        // Set expiry to 90% of actual expiry for safety margin
-        token_expiry_ = now + std::chrono::seconds(expires_in * 9 / 10);
-        
-        if (logger_) {
-          logger_->log_info("ExecutionGateway", "Successfully authenticated with Deribit");
-        }
-        return access_token_;
-      }
-    } catch (const std::exception& e) {
-      if (logger_) {
-        logger_->log_error("ExecutionGateway", 
-                          std::string("Auth failed: ") + e.what());
-      }
+  Response resp = http_post(kAuthEndpoint, build_jsonrpc_request("public/auth", params));
+
+  std::string access_token;
+  int64_t expires_in_s = 0;
+  if (!resp.success || !deribit::parse_auth_response(resp.body, access_token, expires_in_s)) {
+    if (logger_) {
+      logger_->log_error("ExecutionGateway",
+                         "Auth failed (HTTP " + std::to_string(resp.http_status) + ")");
     }
+    return nullptr;
   }
-  
-  return "";
+
+  auto token = std::make_unique<AccessToken>();
+  token->auth_header = "Authorization: Bearer " + access_token;
+  token->refresh_at = issued + std::max<std::chrono::steady_clock::duration>(
+                                   std::chrono::milliseconds(expires_in_s * kTokenRefreshPermille),
+                                   kMinTokenRefresh);
+  token->expires_at = issued + std::chrono::milliseconds(expires_in_s * kTokenExpiryPermille);
+  const AccessToken* published = token.get();
+  {
+    // Published under the lock the refresher waits with, so it cannot miss
+    // it. Superseded tokens are kept until the gateway is destroyed: a reader
+    // may still be copying one's header, and there is one per renewal
+    std::lock_guard<std::mutex> lock(token_mutex_);
+    issued_tokens_.push_back(std::move(token));
+    token_.store(published, std::memory_order_release);
+  }
+  token_cv_.notify_all();
+
+  if (logger_) {
+    logger_->log_info("ExecutionGateway", "Successfully authenticated with Deribit");
+  }
+  return published;
 }
 
 } // namespace pulseexec
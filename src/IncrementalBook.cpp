@@ -0,0 +1,72 @@
+#include "pulseexec/IncrementalBook.hpp"
+#include <algorithm>
+
+namespace pulseexec {
+
+IncrementalBook::ApplyResult IncrementalBook::apply(const BookDelta& delta) {
+  if (delta.snapshot) {
+    bids_.clear();
+    asks_.clear();
+  } else if (!synced_) {
+    return ApplyResult::AWAITING_SNAPSHOT;
+  } else if (delta.prev_change_id != change_id_) {
+    invalidate();
+    return ApplyResult::GAP;
+  }
+
+  for (const auto& update : delta.bids) {
+    apply_level(bids_, update, true);
+  }
+  for (const auto& update : delta.asks) {
+    apply_level(asks_, update, false);
+  }
+
+  change_id_ = delta.change_id;
+  timestamp_us_ = delta.timestamp_us;
+  synced_ = true;
+  return ApplyResult::APPLIED;
+}
+
+void IncrementalBook::invalidate() {
+  bids_.clear();
+  asks_.clear();
+  synced_ = false;
+}
+
+void IncrementalBook::top(size_t depth, OrderBook& out) const {
+  out.symbol = symbol_;
+  out.scale = scale_;
+  out.timestamp_us = timestamp_us_;
+  out.sequence = change_id_;
+
+  out.bids.assign(bids_.rbegin(), bids_.rbegin() + std::min(depth, bids_.size()));
+  out.asks.assign(asks_.rbegin(), asks_.rbegin() + std::min(depth, asks_.size()));
+}
+
+void IncrementalBook::apply_level(std::vector<PriceLevel>& side, const LevelUpdate& update,
+                                  bool ascending) {
+  auto it = ascending ? std::lower_bound(side.begin(), side.end(), update.price,
+                                         [](const PriceLevel& level, Price price) {
+                                           return level.price < price;
+                                         })
+                      : std::lower_bound(side.begin(), side.end(), update.price,
+                                         [](const PriceLevel& level, Price price) {
+                                           return level.price > price;
+                                         });
+  bool found = it != side.end() && it->price == update.price;
+
+  if (update.action == LevelUpdate::Action::DELETE || update.amount.is_zero()) {
+    if (found) {
+      side.erase(it);
+    }
+    return;
+  }
+
+  if (found) {
+    it->amount = update.amount;
+  } else {
+    side.insert(it, PriceLevel(update.price, update.amount));
+  }
+}
+
+} // namespace pulseexec
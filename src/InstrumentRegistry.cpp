@@ -0,0 +1,74 @@
+#include "pulseexec/InstrumentRegistry.hpp"
+#include <mutex>
+
+namespace pulseexec {
+
+void InstrumentRegistry::set_scale_loader(ScaleLoader loader) {
+  scale_loader_ = std::move(loader);
+}
+
+InstrumentId InstrumentRegistry::intern(std::string_view symbol) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(symbol);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+  }
+
+  // May be a network round trip; two threads interning the same new symbol
+  // both load it and the first to insert wins
+  InstrumentScale scale;
+  if (scale_loader_ && !scale_loader_(std::string(symbol), scale)) {
+    scale = InstrumentScale{};
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto it = ids_.find(symbol);
+  if (it != ids_.end()) {
+    return it->second; // Interned by another thread in between
+  }
+
+  entries_.push_back(Entry{std::string(symbol), scale});
+  auto id = static_cast<InstrumentId>(entries_.size());
+  ids_.emplace(entries_.back().name, id);
+  return id;
+}
+
+InstrumentId InstrumentRegistry::find(std::string_view symbol) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = ids_.find(symbol);
+  return it != ids_.end() ? it->second : kInvalidInstrumentId;
+}
+
+const std::string& InstrumentRegistry::name(InstrumentId id) const {
+  static const std::string empty;
+
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  if (id == kInvalidInstrumentId || id > entries_.size()) {
+    return empty;
+  }
+  return entries_[id - 1].name;
+}
+
+void InstrumentRegistry::set_scale(InstrumentId id, const InstrumentScale& scale) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (id != kInvalidInstrumentId && id <= entries_.size()) {
+    entries_[id - 1].scale = scale;
+  }
+}
+
+InstrumentScale InstrumentRegistry::scale(InstrumentId id) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  if (id == kInvalidInstrumentId || id > entries_.size()) {
+    return InstrumentScale{};
+  }
+  return entries_[id - 1].scale;
+}
+
+size_t InstrumentRegistry::size() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return entries_.size();
+}
+
+} // namespace pulseexec
@@ -0,0 +1,449 @@
+#include "pulseexec/JsonScanner.hpp"
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace pulseexec {
+
+namespace {
+
+// First '"' or '\\' in [p, end), or end
+const char* find_quote_or_escape(const char* p, const char* end) {
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  for (; end - p >= 16; p += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    int mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+    if (mask != 0) {
+      return p + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+  }
+#endif
+  for (; p < end; ++p) {
+    if (*p == '"' || *p == '\\') {
+      break;
+    }
+  }
+  return p;
+}
+
+// First '"', '[', ']', '{' or '}' in [p, end), or end. Setting bit 5 folds
+// '[' onto '{' and ']' onto '}', so three compares cover all five.
+const char* find_structural(const char* p, const char* end) {
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  const __m128i open = _mm_set1_epi8('{');
+  const __m128i close = _mm_set1_epi8('}');
+  for (; end - p >= 16; p += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i folded = _mm_or_si128(chunk, case_bit);
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                _mm_or_si128(_mm_cmpeq_epi8(folded, open),
+                                             _mm_cmpeq_epi8(folded, close)));
+    int mask = _mm_movemask_epi8(hits);
+    if (mask != 0) {
+      return p + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+  }
+#endif
+  for (; p < end; ++p) {
+    char folded = static_cast<char>(*p | 0x20);
+    if (*p == '"' || folded == '{' || folded == '}') {
+      break;
+    }
+  }
+  return p;
+}
+
+bool is_number_char(char c) {
+  return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+int hex_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  c = static_cast<char>(c | 0x20);
+  return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+bool read_hex4(std::string_view text, size_t pos, uint32_t& out) {
+  if (pos + 4 > text.size()) {
+    return false;
+  }
+  out = 0;
+  for (size_t i = pos; i < pos + 4; ++i) {
+    int digit = hex_value(text[i]);
+    if (digit < 0) {
+      return false;
+    }
+    out = (out << 4) | static_cast<uint32_t>(digit);
+  }
+  return true;
+}
+
+void append_utf8(std::string& out, uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xc0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xe0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  } else {
+    out += static_cast<char>(0xf0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  }
+}
+
+} // namespace
+
+bool JsonScanner::enter_object() {
+  if (failed_) {
+    return false;
+  }
+  skip_ws();
+  if (!consume('{')) {
+    return fail();
+  }
+  first_ = true;
+  return true;
+}
+
+bool JsonScanner::next_key(std::string_view& key) {
+  if (failed_) {
+    return false;
+  }
+  skip_ws();
+  if (consume('}')) {
+    first_ = false;
+    return false;
+  }
+  if (!first_ && !consume(',')) {
+    return fail();
+  }
+  first_ = false;
+  if (!read_raw_string(key)) {
+    return false;
+  }
+  skip_ws();
+  return consume(':') || fail();
+}
+
+bool JsonScanner::find_key(std::string_view key) {
+  std::string_view found;
+  while (next_key(found)) {
+    if (found == key) {
+      return true;
+    }
+    if (!skip_value()) {
+      return false;
+    }
+  }
+  return false;
+}
+
+bool JsonScanner::enter_array() {
+  if (failed_) {
+    return false;
+  }
+  skip_ws();
+  if (!consume('[')) {
+    return fail();
+  }
+  first_ = true;
+  return true;
+}
+
+bool JsonScanner::next_element() {
+  if (failed_) {
+    return false;
+  }
+  skip_ws();
+  if (consume(']')) {
+    first_ = false;
+    return false;
+  }
+  if (!first_ && !consume(',')) {
+    return fail();
+  }
+  first_ = false;
+  return true;
+}
+
+bool JsonScanner::leave() {
+  if (failed_) {
+    return false;
+  }
+  first_ = false;
+  return close_brackets(1);
+}
+
+char JsonScanner::peek() {
+  if (failed_) {
+    return '\0';
+  }
+  skip_ws();
+  return pos_ < text_.size() ? text_[pos_] : '\0';
+}
+
+bool JsonScanner::read_string(std::string& out) {
+  std::string_view raw;
+  if (!read_raw_string(raw)) {
+    return false;
+  }
+  size_t escape = raw.find('\\');
+  if (escape == std::string_view::npos) {
+    out.assign(raw.data(), raw.size());
+    return true;
+  }
+
+  out.assign(raw.data(), escape);
+  for (size_t i = escape; i < raw.size(); ++i) {
+    if (raw[i] != '\\') {
+      out += raw[i];
+      continue;
+    }
+    if (++i == raw.size()) {
+      return fail();
+    }
+    switch (raw[i]) {
+    case '"':
+    case '\\':
+    case '/':
+      out += raw[i];
+      break;
+    case 'b':
+      out += '\b';
+      break;
+    case 'f':
+      out += '\f';
+      break;
+    case 'n':
+      out += '\n';
+      break;
+    case 'r':
+      out += '\r';
+      break;
+    case 't':
+      out += '\t';
+      break;
+    case 'u': {
+      uint32_t cp = 0;
+      if (!read_hex4(raw, i + 1, cp)) {
+        return fail();
+      }
+      i += 4;
+      // A high surrogate combines with the \uXXXX low surrogate after it
+      uint32_t low = 0;
+      if (cp >= 0xd800 && cp < 0xdc00 && i + 2 < raw.size() && raw[i + 1] == '\\' &&
+          raw[i + 2] == 'u' && read_hex4(raw, i + 3, low) && low >= 0xdc00 && low < 0xe000) {
+        cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+        i += 6;
+      }
+      append_utf8(out, cp);
+      break;
+    }
+    default:
+      return fail();
+    }
+  }
+  return true;
+}
+
+bool JsonScanner::read_raw_string(std::string_view& out) {
+  if (failed_) {
+    return false;
+  }
+  skip_ws();
+  if (pos_ >= text_.size() || text_[pos_] != '"') {
+    return fail();
+  }
+  size_t start = pos_ + 1;
+  if (!skip_string()) {
+    return false;
+  }
+  out = text_.substr(start, pos_ - 1 - start);
+  return true;
+}
+
+bool JsonScanner::read_number(std::string_view& out) {
+  if (failed_) {
+    return false;
+  }
+  skip_ws();
+  size_t start = pos_;
+  while (pos_ < text_.size() && is_number_char(text_[pos_])) {
+    ++pos_;
+  }
+  if (pos_ == start || !(text_[start] == '-' || (text_[start] >= '0' && text_[start] <= '9'))) {
+    pos_ = start;
+    return fail();
+  }
+  out = text_.substr(start, pos_ - start);
+  return true;
+}
+
+bool JsonScanner::read_int(int64_t& out) {
+  std::string_view number;
+  if (!read_number(number)) {
+    return false;
+  }
+  auto [end, ec] = std::from_chars(number.data(), number.data() + number.size(), out);
+  return (ec == std::errc() && end == number.data() + number.size()) || fail();
+}
+
+bool JsonScanner::read_uint(uint64_t& out) {
+  std::string_view number;
+  if (!read_number(number)) {
+    return false;
+  }
+  auto [end, ec] = std::from_chars(number.data(), number.data() + number.size(), out);
+  return (ec == std::errc() && end == number.data() + number.size()) || fail();
+}
+
+bool JsonScanner::read_double(double& out) {
+  std::string_view number;
+  return read_number(number) && (parse_double(number, out) || fail());
+}
+
+bool JsonScanner::skip_value(std::string_view* raw) {
+  if (failed_) {
+    return false;
+  }
+  skip_ws();
+  size_t start = pos_;
+  bool skipped = false;
+  switch (pos_ < text_.size() ? text_[pos_] : '\0') {
+  case '"':
+    skipped = skip_string();
+    break;
+  case '{':
+  case '[':
+    ++pos_;
+    skipped = close_brackets(1);
+    break;
+  case 't':
+    skipped = skip_literal("true");
+    break;
+  case 'f':
+    skipped = skip_literal("false");
+    break;
+  case 'n':
+    skipped = skip_literal("null");
+    break;
+  default: {
+    std::string_view number;
+    skipped = read_number(number);
+    break;
+  }
+  }
+  if (skipped && raw) {
+    *raw = text_.substr(start, pos_ - start);
+  }
+  return skipped;
+}
+
+void JsonScanner::skip_ws() {
+  while (pos_ < text_.size()) {
+    char c = text_[pos_];
+    if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+      break;
+    }
+    ++pos_;
+  }
+}
+
+bool JsonScanner::consume(char c) {
+  if (pos_ < text_.size() && text_[pos_] == c) {
+    ++pos_;
+    return true;
+  }
+  return false;
+}
+
+bool JsonScanner::fail() {
+  failed_ = true;
+  return false;
+}
+
+bool JsonScanner::skip_string() {
+  const char* data = text_.data();
+  const char* end = data + text_.size();
+  const char* p = data + pos_ + 1;
+  while (true) {
+    p = find_quote_or_escape(p, end);
+    if (p == end) {
+      return fail();
+    }
+    if (*p == '"') {
+      pos_ = static_cast<size_t>(p + 1 - data);
+      return true;
+    }
+    p += 2; // The backslash and the character it escapes
+    if (p > end) {
+      return fail();
+    }
+  }
+}
+
+bool JsonScanner::close_brackets(int depth) {
+  const char* data = text_.data();
+  const char* end = data + text_.size();
+  const char* p = data + pos_;
+  while (true) {
+    p = find_structural(p, end);
+    if (p == end) {
+      return fail();
+    }
+    char c = *p;
+    if (c == '"') {
+      pos_ = static_cast<size_t>(p - data);
+      if (!skip_string()) {
+        return false;
+      }
+      p = data + pos_;
+      continue;
+    }
+    ++p;
+    if (c == '{' || c == '[') {
+      ++depth;
+    } else if (--depth == 0) {
+      pos_ = static_cast<size_t>(p - data);
+      return true;
+    }
+  }
+}
+
+bool JsonScanner::skip_literal(std::string_view literal) {
+  if (text_.compare(pos_, literal.size(), literal) != 0) {
+    return fail();
+  }
+  pos_ += literal.size();
+  return true;
+}
+
+bool JsonScanner::parse_double(std::string_view number, double& out) {
+  char buf[64];
+  if (number.size() >= sizeof(buf)) {
+    return false;
+  }
+  std::memcpy(buf, number.data(), number.size());
+  buf[number.size()] = '\0';
+  char* end = nullptr;
+  out = std::strtod(buf, &end);
+  return end == buf + number.size();
+}
+
+} // namespace pulseexec
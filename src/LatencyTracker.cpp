@@ -0,0 +1,199 @@
+#include "pulseexec/LatencyTracker.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace pulseexec {
+
+namespace {
+
+int64_t steady_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+unsigned msb(uint64_t value) { return 63 - static_cast<unsigned>(__builtin_clzll(value)); }
+
+void raise_max(std::atomic<uint64_t>& max, uint64_t value) {
+  uint64_t prev = max.load(std::memory_order_relaxed);
+  while (prev < value && !max.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+  }
+}
+
+} // namespace
+
+const char* to_string(LatencyOp op) {
+  switch (op) {
+  case LatencyOp::CREATE_TO_SEND:
+    return "create_to_send";
+  case LatencyOp::GATEWAY_ROUND_TRIP:
+    return "gateway_round_trip";
+  case LatencyOp::CREATE_TO_ACK:
+    return "create_to_ack";
+  case LatencyOp::DB_PERSIST:
+    return "db_persist";
+  default:
+    return "unknown";
+  }
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t value) {
+  if (value < 2 * kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+  // Shift the value down until it has kSubBucketBits + 1 significant bits
+  unsigned shift = msb(value) - kSubBucketBits;
+  return static_cast<size_t>(shift * kSubBuckets + (value >> shift));
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+  if (index < 2 * kSubBuckets) {
+    return index;
+  }
+  unsigned shift = static_cast<unsigned>(index / kSubBuckets - 1);
+  uint64_t mantissa = index - shift * kSubBuckets;
+  return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t value) {
+  uint64_t v = value < 0 ? 0 : std::min(static_cast<uint64_t>(value), kMaxValue);
+  buckets_[bucket_index(v)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  raise_max(max_, v);
+}
+
+int64_t LatencyHistogram::percentile(double pct) const {
+  uint64_t total = count();
+  if (total == 0) {
+    return 0;
+  }
+  // Rank of the sample at pct, 1-based
+  auto rank = static_cast<uint64_t>(std::ceil(std::clamp(pct, 0.0, 100.0) / 100.0 * total));
+  rank = std::max<uint64_t>(rank, 1);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return static_cast<int64_t>(std::min(bucket_upper_bound(i), static_cast<uint64_t>(max())));
+    }
+  }
+  return max();
+}
+
+void LatencyHistogram::drain_into(LatencyHistogram& other) {
+  uint64_t moved = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    uint64_t n = buckets_[i].exchange(0, std::memory_order_relaxed);
+    if (n != 0) {
+      other.buckets_[i].fetch_add(n, std::memory_order_relaxed);
+      moved += n;
+    }
+  }
+  // Count follows the buckets actually moved so a concurrent record() is
+  // never counted in one histogram and bucketed in the other
+  count_.fetch_sub(moved, std::memory_order_relaxed);
+  other.count_.fetch_add(moved, std::memory_order_relaxed);
+  raise_max(other.max_, max_.exchange(0, std::memory_order_relaxed));
+}
+
+void LatencyHistogram::reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+LatencyTracker::LatencyTracker(size_t max_open_traces) : max_open_traces_(max_open_traces) {}
+
+void LatencyTracker::mark_created(const std::string& client_order_id) {
+  if (open_traces_.load(std::memory_order_relaxed) >= max_open_traces_) {
+    dropped_traces_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (traces_.insert(client_order_id, Trace{steady_now_ns(), 0})) {
+    open_traces_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void LatencyTracker::mark_sent(const std::string& client_order_id) {
+  int64_t now = steady_now_ns();
+  int64_t created_ns = 0;
+  traces_.update(client_order_id, [&](Trace& trace) {
+    // Resubmissions keep the first send time
+    if (trace.sent_ns == 0) {
+      trace.sent_ns = now;
+      created_ns = trace.created_ns;
+    }
+  });
+  if (created_ns != 0) {
+    record(LatencyOp::CREATE_TO_SEND, now - created_ns);
+  }
+}
+
+void LatencyTracker::mark_acked(const std::string& client_order_id) {
+  int64_t now = steady_now_ns();
+  Trace trace;
+  if (!traces_.read(client_order_id, [&](const Trace& t) { trace = t; })) {
+    return;
+  }
+  forget(client_order_id);
+
+  if (trace.sent_ns != 0) {
+    record(LatencyOp::GATEWAY_ROUND_TRIP, now - trace.sent_ns);
+  }
+  record(LatencyOp::CREATE_TO_ACK, now - trace.created_ns);
+}
+
+void LatencyTracker::forget(const std::string& client_order_id) {
+  if (traces_.erase(client_order_id)) {
+    open_traces_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+void LatencyTracker::record(LatencyOp op, int64_t latency_ns) {
+  auto index = static_cast<size_t>(op);
+  if (index >= kOpCount) {
+    return;
+  }
+  total_[index].record(latency_ns);
+  interval_[index].record(latency_ns);
+}
+
+std::vector<LatencyTracker::Summary> LatencyTracker::percentiles() const {
+  std::vector<Summary> summaries;
+  summaries.reserve(kOpCount);
+  for (size_t i = 0; i < kOpCount; ++i) {
+    summaries.push_back(summarize(static_cast<LatencyOp>(i), total_[i]));
+  }
+  return summaries;
+}
+
+std::vector<LatencyTracker::Summary> LatencyTracker::take_interval() {
+  std::lock_guard<std::mutex> lock(interval_mutex_);
+  std::vector<Summary> summaries;
+  for (size_t i = 0; i < kOpCount; ++i) {
+    interval_[i].drain_into(scratch_);
+    if (scratch_.count() > 0) {
+      summaries.push_back(summarize(static_cast<LatencyOp>(i), scratch_));
+    }
+    scratch_.reset();
+  }
+  return summaries;
+}
+
+LatencyTracker::Summary LatencyTracker::summarize(LatencyOp op,
+                                                  const LatencyHistogram& histogram) {
+  Summary summary;
+  summary.op = op;
+  summary.count = histogram.count();
+  summary.p50_ns = histogram.percentile(50.0);
+  summary.p99_ns = histogram.percentile(99.0);
+  summary.p999_ns = histogram.percentile(99.9);
+  summary.max_ns = histogram.max();
+  return summary;
+}
+
+} // namespace pulseexec
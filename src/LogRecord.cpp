@@ -0,0 +1,218 @@
+#include "pulseexec/LogRecord.hpp"
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+using json = nlohmann::json;
+
+namespace pulseexec {
+
+// Marks the start of each binary record so a truncated file fails cleanly
+static constexpr uint16_t kRecordMarker = 0xB10C;
+
+static const char* level_name(uint8_t level) {
+  // Same order as LogLevel
+  static const char* const names[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+  return level < 4 ? names[level] : "UNKNOWN";
+}
+
+static const LogFormatSpec* format_spec(LogFormatId id) {
+  auto index = static_cast<size_t>(id);
+  return index < static_cast<size_t>(LogFormatId::COUNT) ? &kLogFormats[index] : nullptr;
+}
+
+// Bytes the argument at offset occupies, or 0 if it would run past
+// payload_used (a corrupt or hand-built record) or has an unknown type
+static size_t arg_bytes(const LogRecord& record, size_t arg, size_t offset) {
+  if (offset >= record.payload_used) {
+    return 0;
+  }
+  size_t size = 0;
+  switch (record.arg_types[arg]) {
+  case LogArgType::INT64:
+  case LogArgType::UINT64:
+  case LogArgType::DOUBLE:
+  case LogArgType::ORDER_STATE:
+    size = sizeof(int64_t);
+    break;
+  case LogArgType::STRING:
+    size = 1 + static_cast<uint8_t>(record.payload[offset]);
+    break;
+  }
+  return size <= record.payload_used - offset ? size : 0;
+}
+
+static bool append_arg(std::string& out, const LogRecord& record, size_t arg, size_t& offset) {
+  if (arg_bytes(record, arg, offset) == 0) {
+    return false;
+  }
+  const char* data = record.payload + offset;
+
+  switch (record.arg_types[arg]) {
+  case LogArgType::INT64: {
+    int64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    out += std::to_string(value);
+    offset += sizeof(value);
+    break;
+  }
+  case LogArgType::UINT64: {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    out += std::to_string(value);
+    offset += sizeof(value);
+    break;
+  }
+  case LogArgType::DOUBLE: {
+    double value;
+    std::memcpy(&value, data, sizeof(value));
+    std::ostringstream oss;
+    oss << value;
+    out += oss.str();
+    offset += sizeof(value);
+    break;
+  }
+  case LogArgType::STRING: {
+    auto len = static_cast<uint8_t>(data[0]);
+    out.append(data + 1, len);
+    offset += 1 + len;
+    break;
+  }
+  case LogArgType::ORDER_STATE: {
+    int64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    out += to_string(static_cast<OrderState>(value));
+    offset += sizeof(value);
+    break;
+  }
+  }
+  return true;
+}
+
+std::string render_log_message(const LogRecord& record) {
+  if (record.is_text()) {
+    return record.message;
+  }
+
+  const LogFormatSpec* spec = format_spec(record.format_id);
+  if (!spec) {
+    return "Unknown log format " + std::to_string(static_cast<unsigned>(record.format_id));
+  }
+
+  std::string out;
+  size_t arg = 0;
+  size_t offset = 0;
+  for (const char* p = spec->format; *p; ++p) {
+    if (p[0] == '{' && p[1] == '}') {
+      if (arg < record.arg_count && append_arg(out, record, arg, offset)) {
+        ++arg;
+      } else {
+        arg = record.arg_count; // Past a malformed argument nothing else is trustworthy
+        out += '?';
+      }
+      ++p;
+    } else {
+      out += *p;
+    }
+  }
+  return out;
+}
+
+std::string_view log_record_component(const LogRecord& record) {
+  if (record.is_text()) {
+    return record.component;
+  }
+  const LogFormatSpec* spec = format_spec(record.format_id);
+  return spec ? spec->component : "Unknown";
+}
+
+std::string render_log_json(const LogRecord& record) {
+  // Use compact JSON format
+  json j;
+  j["timestamp"] = record.timestamp_us;
+  j["level"] = level_name(record.level);
+  j["component"] = std::string(log_record_component(record));
+  j["message"] = render_log_message(record);
+
+  return j.dump();
+}
+
+template <typename T> static void write_raw(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T> static bool read_raw(std::istream& in, T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+void write_binary_log_record(std::ostream& out, const LogRecord& record) {
+  write_raw(out, kRecordMarker);
+  write_raw(out, record.timestamp_us);
+  write_raw(out, record.level);
+  write_raw(out, record.format_id);
+
+  if (record.is_text()) {
+    auto component_len = static_cast<uint32_t>(record.component.size());
+    auto message_len = static_cast<uint32_t>(record.message.size());
+    write_raw(out, component_len);
+    out.write(record.component.data(), component_len);
+    write_raw(out, message_len);
+    out.write(record.message.data(), message_len);
+    return;
+  }
+
+  write_raw(out, record.arg_count);
+  write_raw(out, record.payload_used);
+  out.write(reinterpret_cast<const char*>(record.arg_types), record.arg_count);
+  out.write(record.payload, record.payload_used);
+}
+
+bool read_binary_log_record(std::istream& in, LogRecord& record) {
+  uint16_t marker = 0;
+  if (!read_raw(in, marker) || marker != kRecordMarker) {
+    return false;
+  }
+  if (!read_raw(in, record.timestamp_us) || !read_raw(in, record.level) ||
+      !read_raw(in, record.format_id)) {
+    return false;
+  }
+
+  record.arg_count = 0;
+  record.payload_used = 0;
+  record.component.clear();
+  record.message.clear();
+
+  if (record.is_text()) {
+    uint32_t len = 0;
+    if (!read_raw(in, len)) {
+      return false;
+    }
+    record.component.resize(len);
+    if (!in.read(record.component.data(), len) || !read_raw(in, len)) {
+      return false;
+    }
+    record.message.resize(len);
+    return static_cast<bool>(in.read(record.message.data(), len));
+  }
+
+  if (!read_raw(in, record.arg_count) || !read_raw(in, record.payload_used) ||
+      record.arg_count > LogRecord::kMaxArgs || record.payload_used > LogRecord::kPayloadBytes) {
+    return false;
+  }
+  if (!in.read(reinterpret_cast<char*>(record.arg_types), record.arg_count) ||
+      !in.read(record.payload, record.payload_used)) {
+    return false;
+  }
+
+  // Every argument must lie within the payload that was read
+  size_t offset = 0;
+  for (size_t arg = 0; arg < record.arg_count; ++arg) {
+    size_t size = arg_bytes(record, arg, offset);
+    if (size == 0) {
+      return false;
+    }
+    offset += size;
+  }
+  return true;
+}
+
+} // namespace pulseexec
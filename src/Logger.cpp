@@ -1,18 +1,20 @@
 #include "pulseexec/Logger.hpp"
 #include <chrono>
-#include <iomanip>
 #include <iostream>
-#include <nlohmann/json.hpp>
-#include <sstream>
-
-using json = nlohmann::json;
 
 namespace pulseexec {
 
+// Empty polls the worker spins through before parking on the condition variable
+static constexpr int kSpinIterations = 64;
+
+// Upper bound on a park, so a missed wakeup only delays output briefly
+static constexpr auto kParkTimeout = std::chrono::milliseconds(5);
+
 Logger::Logger(const std::string& log_file, size_t queue_capacity)
-    : log_file_(log_file), queue_capacity_(queue_capacity), min_level_(LogLevel::INFO) {
+    : log_file_(log_file), queue_capacity_(queue_capacity), min_level_(LogLevel::INFO),
+      ring_(queue_capacity) {
   if (!log_file_.empty()) {
-    log_stream_.open(log_file_, std::ios::app);
+    log_stream_.open(log_file_, std::ios::app | std::ios::binary);
     if (!log_stream_.is_open()) {
       std::cerr << "Failed to open log file: " << log_file_ << std::endl;
     }
@@ -38,7 +40,10 @@ void Logger::stop() {
     return; // Already stopped
   }
 
-  queue_cv_.notify_one();
+  {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    park_cv_.notify_one();
+  }
 
   if (worker_.joinable()) {
     worker_.join();
@@ -50,23 +55,35 @@ void Logger::log(LogLevel level, const std::string& component, const std::string
     return; // Below minimum level
   }
 
-  auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(
-                     std::chrono::system_clock::now().time_since_epoch())
-                     .count();
+  LogRecord record(static_cast<uint8_t>(level), LogFormatId::TEXT, now_us());
+  record.component = component;
+  record.message = message;
 
-  LogMessage msg(level, component, message, now_us);
+  push_record(std::move(record));
+}
 
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    if (message_queue_.size() >= queue_capacity_) {
-      // Queue full - drop message
-      dropped_count_.fetch_add(1, std::memory_order_relaxed);
-      return;
-    }
-    message_queue_.push(std::move(msg));
+void Logger::push_record(LogRecord&& record) { after_push(ring_.try_push(std::move(record))); }
+
+void Logger::after_push(bool pushed) {
+  if (!pushed) {
+    // Ring full - drop message
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // Pairs with the fence in worker_thread: either the worker sees this message
+  // before parking, or we see it parked and wake it
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (consumer_parked_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    park_cv_.notify_one();
   }
+}
 
-  queue_cv_.notify_one();
+int64_t Logger::now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
 }
 
 void Logger::log_debug(const std::string& component, const std::string& message) {
@@ -87,72 +104,71 @@ void Logger::log_error(const std::string& component, const std::string& message)
 
 void Logger::set_min_level(LogLevel level) { min_level_ = level; }
 
-void Logger::worker_thread() {
-  while (running_.load(std::memory_order_relaxed)) {
-    std::unique_lock<std::mutex> lock(queue_mutex_);
-
-    queue_cv_.wait(lock, [this] {
-      return !message_queue_.empty() || !running_.load(std::memory_order_relaxed);
-    });
+void Logger::set_output_format(LogOutputFormat format) { output_format_ = format; }
 
-    while (!message_queue_.empty()) {
-      LogMessage msg = std::move(message_queue_.front());
-      message_queue_.pop();
+void Logger::worker_thread() {
+  LogRecord record;
+  bool pending_flush = false;
+  int idle_spins = 0;
 
-      lock.unlock();
+  while (running_.load(std::memory_order_relaxed)) {
+    if (ring_.try_pop(record)) {
+      write_record(record);
+      pending_flush = true;
+      idle_spins = 0;
+      continue;
+    }
 
-      // Format and write message
-      std::string formatted = format_message(msg);
+    // Ring drained - flush once rather than per message
+    if (pending_flush) {
+      flush_output();
+      pending_flush = false;
+    }
 
-      if (log_stream_.is_open()) {
-        log_stream_ << formatted << std::endl;
-        log_stream_.flush();
-      } else {
-        std::cout << formatted << std::endl;
-      }
+    // Spin briefly before parking so bursts don't pay for a wakeup
+    if (++idle_spins < kSpinIterations) {
+      std::this_thread::yield();
+      continue;
+    }
 
-      lock.lock();
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    consumer_parked_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring_.empty() && running_.load(std::memory_order_relaxed)) {
+      park_cv_.wait_for(lock, kParkTimeout);
     }
+    consumer_parked_.store(false, std::memory_order_relaxed);
+    idle_spins = 0;
   }
 
   // Drain remaining messages
-  std::lock_guard<std::mutex> lock(queue_mutex_);
-  while (!message_queue_.empty()) {
-    LogMessage msg = std::move(message_queue_.front());
-    message_queue_.pop();
-
-    std::string formatted = format_message(msg);
-    if (log_stream_.is_open()) {
-      log_stream_ << formatted << std::endl;
-    } else {
-      std::cout << formatted << std::endl;
-    }
+  while (ring_.try_pop(record)) {
+    write_record(record);
   }
+  flush_output();
 }
 
-std::string Logger::format_message(const LogMessage& msg) const {
-  // Use compact JSON format
-  json j;
-  j["timestamp"] = msg.timestamp_us;
-  j["level"] = level_to_string(msg.level);
-  j["component"] = msg.component;
-  j["message"] = msg.message;
+void Logger::write_record(const LogRecord& record) {
+  // Structured records are formatted here, off the producer's hot path
+  if (output_format_ == LogOutputFormat::BINARY && log_stream_.is_open()) {
+    write_binary_log_record(log_stream_, record);
+    return;
+  }
+
+  std::string formatted = render_log_json(record);
 
-  return j.dump();
+  if (log_stream_.is_open()) {
+    log_stream_ << formatted << '\n';
+  } else {
+    std::cout << formatted << '\n';
+  }
 }
 
-std::string Logger::level_to_string(LogLevel level) const {
-  switch (level) {
-  case LogLevel::DEBUG:
-    return "DEBUG";
-  case LogLevel::INFO:
-    return "INFO";
-  case LogLevel::WARNING:
-    return "WARNING";
-  case LogLevel::ERROR:
-    return "ERROR";
-  default:
-    return "UNKNOWN";
+void Logger::flush_output() {
+  if (log_stream_.is_open()) {
+    log_stream_.flush();
+  } else {
+    std::cout.flush();
   }
 }
 
@@ -1,8 +1,586 @@
 #include "pulseexec/MarketDataFeed.hpp"
+#include "pulseexec/JsonScanner.hpp"
+#include "pulseexec/Logger.hpp"
+#include "pulseexec/SessionRecorder.hpp"
+#include <algorithm>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/ssl/stream.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <deque>
 
-// Placeholder implementation
 namespace pulseexec {
 
-// TODO: Implement MarketDataFeed
+namespace beast = boost::beast;
+namespace net = boost::asio;
+namespace websocket = beast::websocket;
+using tcp = net::ip::tcp;
+using json = nlohmann::json;
+
+static constexpr std::chrono::seconds kConnectTimeout{10};
+static constexpr std::chrono::milliseconds kInitialBackoff{100};
+static constexpr std::chrono::milliseconds kMaxBackoff{5000};
+
+// One connection attempt. Handlers hold a shared_ptr to it and ignore
+// completions once it is no longer the feed's current connection.
+struct MarketDataFeed::Connection {
+  using PlainStream = websocket::stream<beast::tcp_stream>;
+  using TlsStream = websocket::stream<beast::ssl_stream<beast::tcp_stream>>;
+
+  Connection(net::io_context& io, net::ssl::context* tls_context) : resolver(io) {
+    if (tls_context) {
+      tls = std::make_unique<TlsStream>(io, *tls_context);
+    } else {
+      plain = std::make_unique<PlainStream>(io);
+    }
+  }
+
+  template <typename F> void visit(F&& fn) {
+    if (tls) {
+      fn(*tls);
+    } else {
+      fn(*plain);
+    }
+  }
+
+  tcp::resolver resolver;
+  std::unique_ptr<PlainStream> plain;
+  std::unique_ptr<TlsStream> tls;
+  beast::flat_buffer buffer;
+  std::deque<std::string> outbox;
+  bool writing = false;
+  bool open = false;
+};
+
+// Splits ws[s]://host[:port][/path]
+static bool parse_ws_url(const std::string& url, bool& tls, std::string& host, std::string& port,
+                         std::string& path) {
+  std::string rest;
+  if (url.rfind("wss://", 0) == 0) {
+    tls = true;
+    rest = url.substr(6);
+  } else if (url.rfind("ws://", 0) == 0) {
+    tls = false;
+    rest = url.substr(5);
+  } else {
+    return false;
+  }
+
+  size_t slash = rest.find('/');
+  std::string authority = rest.substr(0, slash);
+  path = slash == std::string::npos ? "/" : rest.substr(slash);
+
+  size_t colon = authority.rfind(':');
+  if (colon == std::string::npos) {
+    host = authority;
+    port = tls ? "443" : "80";
+  } else {
+    host = authority.substr(0, colon);
+    port = authority.substr(colon + 1);
+  }
+  return !host.empty() && !port.empty();
+}
+
+// Levels arrive as ["new"|"change"|"delete", price, amount]
+static bool parse_levels(JsonScanner& scanner, const InstrumentScale& scale,
+                         std::vector<LevelUpdate>& out) {
+  if (!scanner.enter_array()) {
+    return false;
+  }
+  std::string_view action;
+  while (scanner.next_element()) {
+    LevelUpdate update;
+    if (!scanner.enter_array() || !scanner.next_element() || !scanner.read_raw_string(action) ||
+        !scanner.next_element() || !scanner.read_decimal(update.price, scale.price_decimals) ||
+        !scanner.next_element() || !scanner.read_decimal(update.amount, scale.qty_decimals) ||
+        !scanner.leave()) {
+      return false;
+    }
+
+    if (action == "new") {
+      update.action = LevelUpdate::Action::NEW;
+    } else if (action == "change") {
+      update.action = LevelUpdate::Action::CHANGE;
+    } else if (action == "delete") {
+      update.action = LevelUpdate::Action::DELETE;
+    } else {
+      return false;
+    }
+    out.push_back(update);
+  }
+  return scanner.ok();
+}
+
+// Reads the data object the scanner is positioned on. A false return can
+// leave the scanner partway into it.
+static bool parse_book_data(JsonScanner& scanner, const InstrumentScale& scale, BookDelta& out) {
+  if (scanner.peek() != '{' || !scanner.enter_object()) {
+    return false;
+  }
+
+  bool has_change_id = false;
+  std::string_view key;
+  std::string_view type;
+  while (scanner.next_key(key)) {
+    if (key == "change_id") {
+      has_change_id = scanner.read_uint(out.change_id);
+    } else if (key == "prev_change_id") {
+      scanner.read_uint(out.prev_change_id);
+    } else if (key == "timestamp") {
+      int64_t timestamp_ms = 0;
+      scanner.read_int(timestamp_ms);
+      out.timestamp_us = timestamp_ms * 1000; // Exchange sends ms
+    } else if (key == "type" && scanner.peek() == '"') {
+      scanner.read_raw_string(type);
+    } else if (key == "bids") {
+      if (!parse_levels(scanner, scale, out.bids)) {
+        return false;
+      }
+    } else if (key == "asks") {
+      if (!parse_levels(scanner, scale, out.asks)) {
+        return false;
+      }
+    } else {
+      scanner.skip_value();
+    }
+  }
+
+  out.snapshot = type == "snapshot";
+  return scanner.ok() && has_change_id;
+}
+
+MarketDataFeed::MarketDataFeed(const std::string& url, std::shared_ptr<Logger> logger,
+                               size_t depth, const std::string& interval)
+    : url_(url), logger_(std::move(logger)), depth_(depth), interval_(interval),
+      reconnect_timer_(io_), backoff_(kInitialBackoff) {}
+
+MarketDataFeed::~MarketDataFeed() { stop(); }
+
+void MarketDataFeed::subscribe(const std::string& instrument, const InstrumentScale& scale) {
+  std::string channel = channel_for(instrument);
+  {
+    std::unique_lock<std::shared_mutex> lock(subscriptions_mutex_);
+    if (subscriptions_.count(channel) > 0) {
+      return;
+    }
+    subscriptions_.emplace(channel, std::make_unique<Subscription>(instrument, scale));
+  }
+  if (recorder_) {
+    recorder_->record_feed_subscribe(instrument, scale);
+  }
+
+  if (running_.load()) {
+    send_async(build_request("public/subscribe", {{"channels", {channel}}}));
+  }
+}
+
+void MarketDataFeed::set_book_handler(BookHandler handler) { book_handler_ = std::move(handler); }
+
+void MarketDataFeed::set_recorder(std::shared_ptr<SessionRecorder> recorder) {
+  recorder_ = std::move(recorder);
+}
+
+bool MarketDataFeed::start() {
+  if (!parse_ws_url(url_, tls_, host_, port_, path_)) {
+    if (logger_) {
+      logger_->log_error("MarketDataFeed", "Invalid WebSocket URL: " + url_);
+    }
+    return false;
+  }
+  if (running_.exchange(true)) {
+    return true; // Already running
+  }
+
+  if (tls_ && !tls_context_) {
+    tls_context_ = std::make_unique<net::ssl::context>(net::ssl::context::tls_client);
+    tls_context_->set_default_verify_paths();
+    tls_context_->set_verify_mode(net::ssl::verify_peer);
+  }
+
+  io_.restart();
+  work_guard_ = std::make_unique<net::executor_work_guard<net::io_context::executor_type>>(
+      io_.get_executor());
+  net::post(io_, [this] { connect(); });
+  io_thread_ = std::thread([this] { io_.run(); });
+  return true;
+}
+
+void MarketDataFeed::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+
+  net::post(io_, [this] {
+    reconnect_timer_.cancel();
+    close_connection();
+  });
+  work_guard_.reset();
+  if (io_thread_.joinable()) {
+    io_thread_.join();
+  }
+  conn_.reset();
+}
+
+bool MarketDataFeed::get_book(const std::string& instrument, OrderBook& out) const {
+  std::shared_lock<std::shared_mutex> lock(subscriptions_mutex_);
+  auto it = subscriptions_.find(channel_for(instrument));
+  if (it == subscriptions_.end()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> book_lock(it->second->mutex);
+  if (!it->second->book.synced()) {
+    return false;
+  }
+  it->second->book.top(depth_, out);
+  return true;
+}
+
+void MarketDataFeed::process_message(std::string_view text) {
+  messages_.fetch_add(1, std::memory_order_relaxed);
+  if (recorder_) {
+    recorder_->record_market_data(text);
+  }
+
+  // Read on demand: a subscription's params are handled in place when the
+  // method comes first, as the exchange sends it, and kept as raw text
+  // otherwise
+  JsonScanner scanner(text);
+  std::string_view key;
+  std::string_view method;
+  std::string_view params;
+  std::string_view error;
+  scanner.enter_object();
+  while (scanner.next_key(key)) {
+    if (key == "method" && scanner.peek() == '"') {
+      scanner.read_raw_string(method);
+    } else if (key == "params" && scanner.peek() == '{') {
+      if (method == "subscription") {
+        handle_subscription(scanner);
+        return;
+      }
+      scanner.skip_value(&params);
+    } else if (key == "error") {
+      scanner.skip_value(&error);
+    } else {
+      scanner.skip_value();
+    }
+  }
+
+  if (!scanner.ok()) {
+    if (logger_) {
+      logger_->log_warning("MarketDataFeed",
+                           "Malformed message: " + std::string(text.substr(0, 200)));
+    }
+    return;
+  }
+
+  if (!method.empty() && !params.empty()) {
+    JsonScanner params_scanner(params);
+    std::string_view type;
+    if (method == "subscription") {
+      handle_subscription(params_scanner);
+    } else if (method == "heartbeat" && params_scanner.enter_object() &&
+               params_scanner.find_key("type") && params_scanner.read_raw_string(type) &&
+               type == "test_request") {
+      send_async(build_request("public/test", json::object()));
+    }
+    return;
+  }
+
+  if (!error.empty() && logger_) {
+    logger_->log_error("MarketDataFeed", "Request failed: " + std::string(error));
+  }
+}
+
+MarketDataFeed::Stats MarketDataFeed::stats() const {
+  Stats s;
+  s.messages = messages_.load(std::memory_order_relaxed);
+  s.deltas_applied = deltas_applied_.load(std::memory_order_relaxed);
+  s.gaps = gaps_.load(std::memory_order_relaxed);
+  s.dropped_changes = dropped_changes_.load(std::memory_order_relaxed);
+  s.resnapshots = resnapshots_.load(std::memory_order_relaxed);
+  s.reconnects = reconnects_.load(std::memory_order_relaxed);
+  return s;
+}
+
+std::string MarketDataFeed::channel_for(const std::string& instrument) const {
+  return "book." + instrument + "." + interval_;
+}
+
+std::string MarketDataFeed::build_request(const std::string& method, const json& params) {
+  json request = {{"jsonrpc", "2.0"},
+                  {"id", next_request_id_.fetch_add(1, std::memory_order_relaxed)},
+                  {"method", method},
+                  {"params", params}};
+  return request.dump();
+}
+
+void MarketDataFeed::handle_subscription(JsonScanner& params) {
+  // Subscriptions are never removed, so the pointer outlives the map lock
+  auto find_subscription = [this](const std::string& channel) -> Subscription* {
+    std::shared_lock<std::shared_mutex> lock(subscriptions_mutex_);
+    auto it = subscriptions_.find(channel);
+    return it == subscriptions_.end() ? nullptr : it->second.get();
+  };
+
+  std::string channel;
+  Subscription* found = nullptr;
+  BookDelta delta;
+  bool parsed = false;
+  std::string_view data; // Only when it comes before the channel
+  std::string_view key;
+  params.enter_object();
+  while (!parsed && params.next_key(key)) {
+    if (key == "channel" && params.peek() == '"') {
+      params.read_string(channel);
+      found = find_subscription(channel);
+      if (!found) {
+        return;
+      }
+    } else if (key == "data" && found) {
+      if (!parse_book_data(params, found->book.scale(), delta)) {
+        break;
+      }
+      parsed = true;
+    } else if (key == "data") {
+      params.skip_value(&data);
+    } else {
+      params.skip_value();
+    }
+  }
+  if (!found) {
+    return;
+  }
+  if (!parsed && !data.empty()) {
+    JsonScanner data_scanner(data);
+    parsed = parse_book_data(data_scanner, found->book.scale(), delta);
+  }
+  if (!parsed) {
+    // The next change will not chain onto this one and triggers a resnapshot
+    if (logger_) {
+      logger_->log_warning("MarketDataFeed", "Unparseable book update on " + channel);
+    }
+    return;
+  }
+  Subscription& sub = *found;
+
+  OrderBook top;
+  IncrementalBook::ApplyResult result;
+  {
+    std::lock_guard<std::mutex> book_lock(sub.mutex);
+    result = sub.book.apply(delta);
+    if (result == IncrementalBook::ApplyResult::APPLIED && book_handler_) {
+      sub.book.top(depth_, top);
+    }
+  }
+
+  switch (result) {
+  case IncrementalBook::ApplyResult::APPLIED:
+    deltas_applied_.fetch_add(1, std::memory_order_relaxed);
+    if (book_handler_) {
+      book_handler_(top);
+    }
+    break;
+  case IncrementalBook::ApplyResult::GAP:
+    gaps_.fetch_add(1, std::memory_order_relaxed);
+    if (logger_) {
+      logger_->log_warning("MarketDataFeed", "Sequence gap on " + channel + ": expected prev " +
+                                                 std::to_string(delta.prev_change_id) +
+                                                 ", resnapshotting");
+    }
+    request_snapshot(channel);
+    break;
+  case IncrementalBook::ApplyResult::AWAITING_SNAPSHOT:
+    dropped_changes_.fetch_add(1, std::memory_order_relaxed);
+    break;
+  }
+}
+
+void MarketDataFeed::request_snapshot(const std::string& channel) {
+  // The exchange sends a snapshot as the first message of a new subscription
+  resnapshots_.fetch_add(1, std::memory_order_relaxed);
+  send_async(build_request("public/unsubscribe", {{"channels", {channel}}}));
+  send_async(build_request("public/subscribe", {{"channels", {channel}}}));
+}
+
+void MarketDataFeed::connect() {
+  auto conn = std::make_shared<Connection>(io_, tls_ ? tls_context_.get() : nullptr);
+  conn_ = conn;
+
+  conn->resolver.async_resolve(
+      host_, port_, [this, conn](beast::error_code ec, tcp::resolver::results_type results) {
+        if (ec) {
+          return on_disconnect(conn, "resolve", ec.message());
+        }
+        conn->visit([&](auto& ws) {
+          beast::get_lowest_layer(ws).expires_after(kConnectTimeout);
+          beast::get_lowest_layer(ws).async_connect(
+              results, [this, conn](beast::error_code ec, const tcp::endpoint&) {
+                if (ec) {
+                  return on_disconnect(conn, "connect", ec.message());
+                }
+                on_tcp_connected(conn);
+              });
+        });
+      });
+}
+
+void MarketDataFeed::on_tcp_connected(const std::shared_ptr<Connection>& conn) {
+  if (!conn->tls) {
+    return start_ws_handshake(conn);
+  }
+
+  auto& tls_stream = conn->tls->next_layer();
+  if (!SSL_set_tlsext_host_name(tls_stream.native_handle(), host_.c_str())) {
+    return on_disconnect(conn, "TLS SNI", "cannot set server name");
+  }
+  tls_stream.async_handshake(net::ssl::stream_base::client, [this, conn](beast::error_code ec) {
+    if (ec) {
+      return on_disconnect(conn, "TLS handshake", ec.message());
+    }
+    start_ws_handshake(conn);
+  });
+}
+
+void MarketDataFeed::start_ws_handshake(const std::shared_ptr<Connection>& conn) {
+  conn->visit([&](auto& ws) {
+    // The websocket layer has its own handshake and idle timeouts
+    beast::get_lowest_layer(ws).expires_never();
+    beast::get_lowest_layer(ws).socket().set_option(tcp::no_delay(true));
+    ws.set_option(websocket::stream_base::timeout::suggested(beast::role_type::client));
+    ws.async_handshake(host_ + ":" + port_, path_, [this, conn](beast::error_code ec) {
+      if (ec) {
+        return on_disconnect(conn, "handshake", ec.message());
+      }
+      on_open(conn);
+    });
+  });
+}
+
+void MarketDataFeed::on_open(const std::shared_ptr<Connection>& conn) {
+  if (conn != conn_) {
+    return;
+  }
+  conn->open = true;
+  connected_ = true;
+  backoff_ = kInitialBackoff;
+
+  json channels = json::array();
+  {
+    std::shared_lock<std::shared_mutex> lock(subscriptions_mutex_);
+    for (const auto& [channel, sub] : subscriptions_) {
+      channels.push_back(channel);
+    }
+  }
+  if (logger_) {
+    logger_->log_info("MarketDataFeed", "Connected to " + url_ + ", subscribing to " +
+                                            std::to_string(channels.size()) + " channels");
+  }
+  if (!channels.empty()) {
+    send(build_request("public/subscribe", {{"channels", channels}}));
+  }
+  read_next(conn);
+}
+
+void MarketDataFeed::read_next(const std::shared_ptr<Connection>& conn) {
+  conn->visit([&](auto& ws) {
+    ws.async_read(conn->buffer, [this, conn](beast::error_code ec, size_t) {
+      if (ec) {
+        return on_disconnect(conn, "read", ec.message());
+      }
+      auto data = conn->buffer.data();
+      process_message(std::string_view(static_cast<const char*>(data.data()), data.size()));
+      conn->buffer.consume(conn->buffer.size());
+      read_next(conn);
+    });
+  });
+}
+
+void MarketDataFeed::send(std::string text) {
+  if (!conn_ || !conn_->open) {
+    return; // Everything is resubscribed on the next connect
+  }
+  conn_->outbox.push_back(std::move(text));
+  if (!conn_->writing) {
+    write_next(conn_);
+  }
+}
+
+void MarketDataFeed::send_async(std::string text) {
+  net::dispatch(io_, [this, text = std::move(text)]() mutable { send(std::move(text)); });
+}
+
+void MarketDataFeed::write_next(const std::shared_ptr<Connection>& conn) {
+  conn->writing = true;
+  conn->visit([&](auto& ws) {
+    ws.text(true);
+    ws.async_write(net::buffer(conn->outbox.front()), [this, conn](beast::error_code ec, size_t) {
+      if (ec) {
+        return on_disconnect(conn, "write", ec.message());
+      }
+      conn->outbox.pop_front();
+      if (conn->outbox.empty()) {
+        conn->writing = false;
+      } else {
+        write_next(conn);
+      }
+    });
+  });
+}
+
+void MarketDataFeed::on_disconnect(const std::shared_ptr<Connection>& conn,
+                                   const std::string& what, const std::string& error) {
+  if (conn != conn_) {
+    return; // Stale completion from an earlier connection
+  }
+  close_connection();
+
+  {
+    std::shared_lock<std::shared_mutex> lock(subscriptions_mutex_);
+    for (const auto& [channel, sub] : subscriptions_) {
+      std::lock_guard<std::mutex> book_lock(sub->mutex);
+      sub->book.invalidate();
+    }
+  }
+
+  if (!running_.load()) {
+    return;
+  }
+
+  reconnects_.fetch_add(1, std::memory_order_relaxed);
+  if (logger_) {
+    logger_->log_warning("MarketDataFeed", "Connection lost (" + what + ": " + error +
+                                               "), reconnecting in " +
+                                               std::to_string(backoff_.count()) + "ms");
+  }
+
+  reconnect_timer_.expires_after(backoff_);
+  reconnect_timer_.async_wait([this](beast::error_code ec) {
+    if (!ec && running_.load()) {
+      connect();
+    }
+  });
+  backoff_ = std::min(backoff_ * 2, kMaxBackoff);
+}
+
+void MarketDataFeed::close_connection() {
+  if (!conn_) {
+    return;
+  }
+  connected_ = false;
+  conn_->open = false;
+  conn_->resolver.cancel();
+  conn_->visit([](auto& ws) {
+    beast::error_code ec;
+    beast::get_lowest_layer(ws).socket().close(ec);
+  });
+  conn_.reset();
+}
 
 } // namespace pulseexec
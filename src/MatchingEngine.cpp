@@ -0,0 +1,263 @@
+#include "pulseexec/MatchingEngine.hpp"
+#include <algorithm>
+
+namespace pulseexec {
+
+MatchingEngine::MatchingEngine(std::string instrument, const InstrumentScale& scale,
+                               size_t terminal_retention)
+    : instrument_(std::move(instrument)), scale_(scale),
+      terminal_retention_(std::max<size_t>(terminal_retention, 1)) {}
+
+const MatchingOrder* MatchingEngine::submit(uint64_t id, Side side, OrderType type, Price price,
+                                            Qty amount, const std::string& label,
+                                            int64_t now_ms) {
+  begin_operation();
+
+  // Reusing an ID would move an open order's queue entries onto the new one,
+  // or let retire() drop the new order under a stale terminal_ entry
+  auto inserted = orders_.emplace(id, Resting());
+  if (!inserted.second) {
+    return nullptr;
+  }
+  Resting& resting = inserted.first->second;
+  MatchingOrder& order = resting.order;
+  order.id = id;
+  order.label = label;
+  order.side = side;
+  order.type = type;
+  order.price = type == OrderType::LIMIT ? scale_.normalize(price) : Price();
+  order.amount = scale_.normalize(amount);
+  order.filled = Qty::from_mantissa(0, scale_.qty_decimals);
+  order.created_ts_ms = now_ms;
+  order.updated_ts_ms = now_ms;
+
+  if (order.amount <= order.filled || (type == OrderType::LIMIT && order.price <= Price())) {
+    order.state = OrderState::REJECTED;
+    retire(id);
+    return &order;
+  }
+
+  match(resting, now_ms);
+  if (order.remaining().is_zero()) {
+    order.state = OrderState::FILLED;
+    retire(id);
+  } else if (type == OrderType::MARKET) {
+    order.state = OrderState::CANCELED; // Nothing left to take
+    retire(id);
+  } else {
+    order.state = order.filled.is_zero() ? OrderState::OPEN : OrderState::PARTIAL;
+    rest(resting);
+  }
+
+  // Retention is at least one, so the order just retired is still there
+  finish_operation();
+  return &order;
+}
+
+bool MatchingEngine::cancel(uint64_t id, int64_t now_ms) {
+  auto it = orders_.find(id);
+  if (it == orders_.end()) {
+    return false;
+  }
+  Resting& resting = it->second;
+  MatchingOrder& order = resting.order;
+  if (order.state != OrderState::OPEN && order.state != OrderState::PARTIAL) {
+    return false;
+  }
+
+  begin_operation();
+  reduce_level(order.side, order.price, order.remaining());
+  ++resting.generation;
+  order.state = OrderState::CANCELED;
+  order.updated_ts_ms = now_ms;
+  retire(id);
+  finish_operation();
+  return true;
+}
+
+bool MatchingEngine::edit(uint64_t id, Price price, Qty amount, int64_t now_ms) {
+  auto it = orders_.find(id);
+  if (it == orders_.end()) {
+    return false;
+  }
+  Resting& resting = it->second;
+  MatchingOrder& order = resting.order;
+  if (order.state != OrderState::OPEN && order.state != OrderState::PARTIAL) {
+    return false;
+  }
+
+  price = scale_.normalize(price);
+  amount = scale_.normalize(amount);
+  if (amount <= order.filled || price <= Price()) {
+    return false;
+  }
+
+  begin_operation();
+  if (price == order.price && amount <= order.amount) {
+    // Shrinking in place keeps the queue position
+    if (amount < order.amount) {
+      reduce_level(order.side, order.price, order.amount - amount);
+      order.amount = amount;
+    }
+  } else {
+    reduce_level(order.side, order.price, order.remaining());
+    ++resting.generation;
+    order.price = price;
+    order.amount = amount;
+    match(resting, now_ms);
+    if (order.remaining().is_zero()) {
+      order.state = OrderState::FILLED;
+      retire(id);
+    } else {
+      order.state = order.filled.is_zero() ? OrderState::OPEN : OrderState::PARTIAL;
+      rest(resting);
+    }
+  }
+  order.updated_ts_ms = now_ms;
+  finish_operation();
+  return true;
+}
+
+const MatchingOrder* MatchingEngine::find(uint64_t id) const {
+  auto it = orders_.find(id);
+  return it == orders_.end() ? nullptr : &it->second.order;
+}
+
+void MatchingEngine::top(size_t depth, OrderBook& out) const {
+  out.symbol = instrument_;
+  out.scale = scale_;
+
+  out.bids.clear();
+  out.asks.clear();
+  for (auto it = bids_.rbegin(); it != bids_.rend() && out.bids.size() < depth; ++it) {
+    out.bids.emplace_back(it->price, it->total);
+  }
+  for (auto it = asks_.rbegin(); it != asks_.rend() && out.asks.size() < depth; ++it) {
+    out.asks.emplace_back(it->price, it->total);
+  }
+}
+
+void MatchingEngine::begin_operation() {
+  fills_.clear();
+  level_changes_.clear();
+}
+
+void MatchingEngine::match(Resting& taker, int64_t now_ms) {
+  MatchingOrder& order = taker.order;
+  Side maker_side = order.side == Side::BUY ? Side::SELL : Side::BUY;
+  std::vector<Level>& levels = side_levels(maker_side);
+
+  while (!order.remaining().is_zero() && !levels.empty()) {
+    Level& level = levels.back();
+    if (order.type == OrderType::LIMIT && better(maker_side, order.price, level.price)) {
+      break; // Best opposite price is beyond the limit
+    }
+
+    while (!order.remaining().is_zero() && !level.queue.empty()) {
+      QueueEntry entry = level.queue.front();
+      auto maker_it = orders_.find(entry.id);
+      if (maker_it == orders_.end() || maker_it->second.generation != entry.generation) {
+        // Canceled or re-queued since it was placed here, or retired since
+        level.queue.pop_front();
+        continue;
+      }
+      Resting& maker = maker_it->second;
+
+      Qty qty = std::min(order.remaining(), maker.order.remaining());
+      order.filled += qty;
+      maker.order.filled += qty;
+      maker.order.updated_ts_ms = now_ms;
+      level.total -= qty;
+      fills_.push_back(MatchingFill{next_trade_id_++, maker.order.id, order.id, level.price, qty});
+
+      if (maker.order.remaining().is_zero()) {
+        maker.order.state = OrderState::FILLED;
+        ++maker.generation;
+        level.queue.pop_front();
+        retire(maker.order.id);
+      } else {
+        maker.order.state = OrderState::PARTIAL;
+      }
+    }
+
+    touch(maker_side, level.price);
+    if (level.total.is_zero()) {
+      levels.pop_back(); // Drops any stale entries left in the queue with it
+    }
+  }
+}
+
+void MatchingEngine::rest(Resting& resting) {
+  MatchingOrder& order = resting.order;
+  std::vector<Level>& levels = side_levels(order.side);
+
+  // Best at the back means worse levels sort first
+  Side side = order.side;
+  auto it = std::lower_bound(levels.begin(), levels.end(), order.price,
+                             [side](const Level& level, Price price) {
+                               return better(side, price, level.price);
+                             });
+  if (it == levels.end() || it->price != order.price) {
+    it = levels.insert(it, Level{order.price, Qty::from_mantissa(0, scale_.qty_decimals), {}});
+  }
+
+  ++resting.generation;
+  it->queue.push_back(QueueEntry{order.id, resting.generation});
+  it->total += order.remaining();
+  touch(order.side, order.price);
+}
+
+void MatchingEngine::reduce_level(Side side, Price price, Qty amount) {
+  std::vector<Level>& levels = side_levels(side);
+  auto it = std::lower_bound(levels.begin(), levels.end(), price,
+                             [side](const Level& level, Price p) {
+                               return better(side, p, level.price);
+                             });
+  if (it == levels.end() || it->price != price) {
+    return;
+  }
+
+  it->total -= amount;
+  if (it->total.is_zero()) {
+    levels.erase(it);
+  }
+  touch(side, price);
+}
+
+void MatchingEngine::touch(Side side, Price price) {
+  for (const auto& change : level_changes_) {
+    if (change.side == side && change.price == price) {
+      return;
+    }
+  }
+  level_changes_.push_back(MatchingLevelChange{side, price, Qty()});
+}
+
+void MatchingEngine::retire(uint64_t id) {
+  terminal_.push_back(id);
+  while (terminal_.size() > terminal_retention_) {
+    // submit() refuses known IDs, so the entry still names this terminal order
+    orders_.erase(terminal_.front());
+    terminal_.pop_front();
+  }
+}
+
+void MatchingEngine::finish_operation() {
+  // Amounts are read once the operation is done, so a level touched several
+  // times reports only where it ended up
+  for (auto& change : level_changes_) {
+    const Level* level = find_level(change.side, change.price);
+    change.amount = level ? level->total : Qty::from_mantissa(0, scale_.qty_decimals);
+  }
+}
+
+const MatchingEngine::Level* MatchingEngine::find_level(Side side, Price price) const {
+  const std::vector<Level>& levels = side == Side::BUY ? bids_ : asks_;
+  auto it = std::lower_bound(levels.begin(), levels.end(), price,
+                             [side](const Level& level, Price p) {
+                               return better(side, p, level.price);
+                             });
+  return it == levels.end() || it->price != price ? nullptr : &*it;
+}
+
+} // namespace pulseexec
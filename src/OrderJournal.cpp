@@ -0,0 +1,609 @@
+#include "pulseexec/OrderJournal.hpp"
+#include "pulseexec/Logger.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace pulseexec {
+
+static constexpr char kMagic[8] = {'P', 'X', 'J', 'R', 'N', 'L', '0', '1'};
+static constexpr size_t kHeaderBytes = 4096;
+static constexpr size_t kCheckpointOffset = 16;
+static constexpr size_t kFirstSequenceOffset = 24; // 0 until the first rotation
+
+// [u32 payload length][u32 crc][u64 sequence]
+static constexpr size_t kRecordHeaderBytes = 16;
+
+// replay() decodes this many records per hold of the lock
+static constexpr size_t kReplayChunk = 256;
+
+static constexpr size_t padded(size_t n) { return (n + 7) & ~size_t(7); }
+
+static constexpr std::array<uint32_t, 256> make_crc_table() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; ++k) {
+      c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    }
+    table[i] = c;
+  }
+  return table;
+}
+
+static constexpr auto kCrcTable = make_crc_table();
+
+// CRC-32 (IEEE), continuing from crc
+static uint32_t crc32(uint32_t crc, const char* data, size_t size) {
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i) {
+    crc = kCrcTable[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+// pwrite until everything is written
+static bool write_all(int fd, const char* data, size_t size, off_t offset) {
+  while (size > 0) {
+    ssize_t n = ::pwrite(fd, data, size, offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= static_cast<size_t>(n);
+    offset += n;
+  }
+  return true;
+}
+
+// A rename only survives a power loss once its directory is synced
+static bool sync_directory(const std::string& path) {
+  size_t slash = path.rfind('/');
+  std::string dir = slash == std::string::npos ? "." : path.substr(0, std::max<size_t>(slash, 1));
+  int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0) {
+    return false;
+  }
+  bool synced = ::fsync(fd) == 0;
+  ::close(fd);
+  return synced;
+}
+
+static uint32_t record_crc(uint64_t sequence, const char* payload, size_t size) {
+  char seq_bytes[sizeof(sequence)];
+  std::memcpy(seq_bytes, &sequence, sizeof(sequence));
+  return crc32(crc32(0, seq_bytes, sizeof(seq_bytes)), payload, size);
+}
+
+// Payload encoding. Prices and quantities keep their exact mantissa and
+// decimals; strings are u16-length-prefixed.
+
+template <typename T> static void put(char*& p, T value) {
+  std::memcpy(p, &value, sizeof(value));
+  p += sizeof(value);
+}
+
+static void put_string(char*& p, const std::string& s) {
+  auto len = static_cast<uint16_t>(std::min<size_t>(s.size(), UINT16_MAX));
+  put(p, len);
+  std::memcpy(p, s.data(), len);
+  p += len;
+}
+
+template <typename Tag> static void put_fixed(char*& p, FixedPoint<Tag> value) {
+  put(p, value.mantissa());
+  put(p, value.decimals());
+}
+
+static size_t string_bytes(const std::string& s) {
+  return sizeof(uint16_t) + std::min<size_t>(s.size(), UINT16_MAX);
+}
+
+static size_t payload_bytes(const Order& order) {
+  return 2 * sizeof(int64_t) + 3 * (sizeof(int64_t) + sizeof(uint8_t)) + 3 * sizeof(uint8_t) +
+         string_bytes(order.client_order_id) + string_bytes(order.exchange_order_id) +
+         string_bytes(order.request.symbol) + string_bytes(order.error_message);
+}
+
+static void encode_order(char* p, const Order& order) {
+  put(p, order.created_ts_us);
+  put(p, order.last_update_ts_us);
+  put_fixed(p, order.request.price);
+  put_fixed(p, order.request.amount);
+  put_fixed(p, order.filled_amount);
+  put(p, static_cast<uint8_t>(order.request.side));
+  put(p, static_cast<uint8_t>(order.request.type));
+  put(p, static_cast<uint8_t>(order.state));
+  put_string(p, order.client_order_id);
+  put_string(p, order.exchange_order_id);
+  put_string(p, order.request.symbol);
+  put_string(p, order.error_message);
+}
+
+namespace {
+
+struct Reader {
+  const char* p;
+  const char* end;
+
+  template <typename T> bool get(T& value) {
+    if (static_cast<size_t>(end - p) < sizeof(value)) {
+      return false;
+    }
+    std::memcpy(&value, p, sizeof(value));
+    p += sizeof(value);
+    return true;
+  }
+
+  bool get_string(std::string& s) {
+    uint16_t len = 0;
+    if (!get(len) || static_cast<size_t>(end - p) < len) {
+      return false;
+    }
+    s.assign(p, len);
+    p += len;
+    return true;
+  }
+
+  template <typename Tag> bool get_fixed(FixedPoint<Tag>& value) {
+    int64_t mantissa = 0;
+    uint8_t decimals = 0;
+    if (!get(mantissa) || !get(decimals)) {
+      return false;
+    }
+    value = FixedPoint<Tag>::from_mantissa(mantissa, decimals);
+    return true;
+  }
+};
+
+} // namespace
+
+static bool decode_order(const char* data, size_t size, Order& order) {
+  Reader in{data, data + size};
+  uint8_t side = 0;
+  uint8_t type = 0;
+  uint8_t state = 0;
+  bool ok = in.get(order.created_ts_us) && in.get(order.last_update_ts_us) &&
+            in.get_fixed(order.request.price) && in.get_fixed(order.request.amount) &&
+            in.get_fixed(order.filled_amount) && in.get(side) && in.get(type) && in.get(state) &&
+            in.get_string(order.client_order_id) && in.get_string(order.exchange_order_id) &&
+            in.get_string(order.request.symbol) && in.get_string(order.error_message);
+  if (!ok) {
+    return false;
+  }
+  order.request.side = static_cast<Side>(side);
+  order.request.type = static_cast<OrderType>(type);
+  order.state = static_cast<OrderState>(state);
+  order.request.client_order_id = order.client_order_id;
+  return true;
+}
+
+OrderJournal::OrderJournal(const std::string& path, std::shared_ptr<Logger> logger,
+                           OrderJournalOptions options)
+    : path_(path), logger_(logger), options_(options) {
+  options_.grow_bytes = std::max(padded(options_.grow_bytes), kHeaderBytes);
+}
+
+OrderJournal::~OrderJournal() { close(); }
+
+bool OrderJournal::open() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (base_) {
+    return true;
+  }
+
+  fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+  struct stat st {};
+  if (fd_ < 0 || ::fstat(fd_, &st) != 0) {
+    if (logger_) {
+      logger_->log_error("OrderJournal",
+                         "Failed to open " + path_ + ": " + std::strerror(errno));
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    return false;
+  }
+
+  bool fresh = static_cast<size_t>(st.st_size) < kHeaderBytes;
+  size_t size = fresh ? kHeaderBytes + options_.grow_bytes : static_cast<size_t>(st.st_size);
+  if ((fresh && ::ftruncate(fd_, static_cast<off_t>(size)) != 0) || !map(size)) {
+    if (logger_) {
+      logger_->log_error("OrderJournal", "Failed to map " + path_ + ": " + std::strerror(errno));
+    }
+    ::close(fd_);
+    fd_ = -1;
+    return false;
+  }
+
+  if (fresh) {
+    std::memcpy(base_, kMagic, sizeof(kMagic));
+    ::fdatasync(fd_);
+  } else if (std::memcmp(base_, kMagic, sizeof(kMagic)) != 0) {
+    if (logger_) {
+      logger_->log_error("OrderJournal", path_ + " is not an order journal");
+    }
+    lock.unlock();
+    close();
+    return false;
+  }
+
+  // Find the end: the first record that is torn, corrupt or out of sequence
+  size_t offset = kHeaderBytes;
+  uint64_t sequence = 0;
+  std::memcpy(&sequence, base_ + kFirstSequenceOffset, sizeof(sequence));
+  while (offset + kRecordHeaderBytes <= mapped_size_) {
+    uint32_t length = 0;
+    uint32_t crc = 0;
+    uint64_t record_sequence = 0;
+    std::memcpy(&length, base_ + offset, sizeof(length));
+    std::memcpy(&crc, base_ + offset + 4, sizeof(crc));
+    std::memcpy(&record_sequence, base_ + offset + 8, sizeof(record_sequence));
+    if (length == 0 || length > mapped_size_ - offset - kRecordHeaderBytes ||
+        record_sequence != sequence + 1 ||
+        crc != record_crc(record_sequence, base_ + offset + kRecordHeaderBytes, length)) {
+      break;
+    }
+    sequence = record_sequence;
+    offset += kRecordHeaderBytes + padded(length);
+  }
+  end_offset_ = offset;
+  last_sequence_ = sequence;
+  durable_sequence_ = sequence;
+
+  if (options_.fsync) {
+    running_ = true;
+    syncer_ = std::thread(&OrderJournal::sync_thread, this);
+  }
+  return true;
+}
+
+void OrderJournal::close() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (running_) {
+    running_ = false;
+    sync_cv_.notify_one();
+    lock.unlock();
+    syncer_.join(); // Syncs whatever is still pending first
+    lock.lock();
+  }
+
+  if (base_) {
+    ::munmap(base_, mapped_size_);
+    base_ = nullptr;
+    mapped_size_ = 0;
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+bool OrderJournal::map(size_t size) {
+  void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (addr == MAP_FAILED) {
+    return false;
+  }
+  base_ = static_cast<char*>(addr);
+  mapped_size_ = size;
+  return true;
+}
+
+bool OrderJournal::grow(size_t min_size) {
+  size_t size = mapped_size_;
+  while (size < min_size) {
+    size += options_.grow_bytes;
+  }
+
+  // The syncer only uses fd_, so remapping under mutex_ is safe
+  if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+    return false;
+  }
+  char* old_base = base_;
+  size_t old_size = mapped_size_;
+  if (!map(size)) {
+    return false;
+  }
+  ::munmap(old_base, old_size);
+  return true;
+}
+
+uint64_t OrderJournal::append(const Order& order) {
+  size_t length = payload_bytes(order);
+  size_t record_bytes = kRecordHeaderBytes + padded(length);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!base_ || failed_) {
+    return 0;
+  }
+  if (end_offset_ + record_bytes > mapped_size_ && !grow(end_offset_ + record_bytes)) {
+    if (logger_) {
+      logger_->log_error("OrderJournal", "Failed to grow " + path_ + ": " + std::strerror(errno));
+    }
+    return 0;
+  }
+
+  char* record = base_ + end_offset_;
+  char* payload = record + kRecordHeaderBytes;
+  encode_order(payload, order);
+  std::memset(payload + length, 0, padded(length) - length);
+
+  uint64_t sequence = last_sequence_ + 1;
+  auto length32 = static_cast<uint32_t>(length);
+  uint32_t crc = record_crc(sequence, payload, length);
+  std::memcpy(record, &length32, sizeof(length32));
+  std::memcpy(record + 4, &crc, sizeof(crc));
+  std::memcpy(record + 8, &sequence, sizeof(sequence));
+
+  end_offset_ += record_bytes;
+  last_sequence_ = sequence;
+
+  if (!options_.fsync) {
+    durable_sequence_ = sequence; // In the page cache, which outlives the process
+    return sequence;
+  }
+
+  sync_cv_.notify_one();
+  // The syncer only stops once everything is durable, or on a failure
+  durable_cv_.wait(lock, [&] { return durable_sequence_ >= sequence || failed_; });
+  return durable_sequence_ >= sequence ? sequence : 0;
+}
+
+void OrderJournal::sync_thread() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    sync_cv_.wait(lock, [this] { return last_sequence_ > durable_sequence_ || !running_; });
+    if (last_sequence_ == durable_sequence_) {
+      break; // Stopped with nothing pending
+    }
+
+    // Every append up to target has finished writing into the mapping
+    uint64_t target = last_sequence_;
+    int fd = fd_;
+    syncing_ = true;
+    lock.unlock();
+    bool synced = ::fdatasync(fd) == 0;
+    int sync_errno = errno;
+    lock.lock();
+    syncing_ = false;
+
+    if (!synced) {
+      // The kernel may have dropped the dirty pages already, so a retry that
+      // succeeds proves nothing: fail everything from here on
+      if (logger_) {
+        logger_->log_error("OrderJournal", "fdatasync failed, journal disabled: " +
+                                               std::string(std::strerror(sync_errno)));
+      }
+      failed_ = true;
+      durable_cv_.notify_all();
+      break;
+    }
+    durable_sequence_ = target;
+    sync_count_.fetch_add(1, std::memory_order_relaxed);
+    durable_cv_.notify_all();
+  }
+}
+
+size_t OrderJournal::replay(uint64_t after,
+                            const std::function<void(const JournalRecord&)>& fn) const {
+  // An append may grow and remap the file at any time, so records are
+  // decoded a chunk at a time under the lock and handed to fn outside it
+  std::vector<JournalRecord> chunk;
+  size_t count = 0;
+  size_t offset = 0;
+  uint64_t last = 0;
+  uint64_t seen = after;
+  uint64_t rotations = 0;
+  bool undecodable = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last = last_sequence_;
+    offset = offset_after(after);
+    rotations = rotations_;
+  }
+
+  while (!undecodable) {
+    chunk.clear();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!base_) {
+        break;
+      }
+
+      // A rotation moved the records; those it dropped were checkpointed
+      if (rotations_ != rotations) {
+        offset = offset_after(seen);
+        rotations = rotations_;
+      }
+
+      // open() and append() validated every record before end_offset_
+      while (offset < end_offset_ && chunk.size() < kReplayChunk) {
+        uint32_t length = 0;
+        uint64_t sequence = 0;
+        std::memcpy(&length, base_ + offset, sizeof(length));
+        std::memcpy(&sequence, base_ + offset + 8, sizeof(sequence));
+        if (sequence > last) {
+          offset = end_offset_;
+          break;
+        }
+
+        if (sequence > seen) {
+          seen = sequence;
+          chunk.emplace_back();
+          chunk.back().sequence = sequence;
+          if (!decode_order(base_ + offset + kRecordHeaderBytes, length, chunk.back().order)) {
+            if (logger_) {
+              logger_->log_error("OrderJournal", "Undecodable record " + std::to_string(sequence) +
+                                                     " in " + path_);
+            }
+            chunk.pop_back();
+            undecodable = true;
+            break;
+          }
+        }
+        offset += kRecordHeaderBytes + padded(length);
+      }
+    }
+
+    if (chunk.empty() && !undecodable) {
+      break;
+    }
+    for (const JournalRecord& record : chunk) {
+      fn(record);
+    }
+    count += chunk.size();
+  }
+  return count;
+}
+
+void OrderJournal::checkpoint(uint64_t sequence) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!base_) {
+    return;
+  }
+  std::memcpy(base_ + kCheckpointOffset, &sequence, sizeof(sequence));
+  if (options_.fsync) {
+    ::msync(base_, kHeaderBytes, MS_SYNC);
+  }
+
+  // The scan for how much is covered only runs once the file is big enough
+  if (options_.rotate_bytes != 0 && !failed_ &&
+      end_offset_ - kHeaderBytes >= options_.rotate_bytes &&
+      offset_after(sequence) - kHeaderBytes >= options_.rotate_bytes) {
+    rotate(lock, sequence);
+  }
+}
+
+size_t OrderJournal::offset_after(uint64_t sequence) const {
+  size_t offset = kHeaderBytes;
+  while (offset < end_offset_) {
+    uint32_t length = 0;
+    uint64_t record_sequence = 0;
+    std::memcpy(&length, base_ + offset, sizeof(length));
+    std::memcpy(&record_sequence, base_ + offset + 8, sizeof(record_sequence));
+    if (record_sequence > sequence) {
+      break;
+    }
+    offset += kRecordHeaderBytes + padded(length);
+  }
+  return offset;
+}
+
+bool OrderJournal::rotate(std::unique_lock<std::mutex>& lock, uint64_t through) {
+  // The syncer uses fd_ outside the lock; let its fdatasync finish first
+  durable_cv_.wait(lock, [this] { return !syncing_; });
+  if (!base_ || failed_) {
+    return false;
+  }
+
+  uint64_t first_sequence = std::min(through, last_sequence_);
+  size_t tail = offset_after(first_sequence);
+  size_t tail_bytes = end_offset_ - tail;
+  size_t size = kHeaderBytes + options_.grow_bytes;
+  while (size < kHeaderBytes + tail_bytes) {
+    size += options_.grow_bytes;
+  }
+
+  char header[kHeaderBytes];
+  std::memcpy(header, base_, kHeaderBytes);
+  std::memcpy(header + kFirstSequenceOffset, &first_sequence, sizeof(first_sequence));
+
+  // The new file is complete and synced before it replaces the old one, so a
+  // crash at any point leaves one of the two intact under path_
+  std::string rotating = path_ + ".rotating";
+  std::string archive = path_ + "." + std::to_string(last_sequence_);
+  int fd = ::open(rotating.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  bool rotated = fd >= 0 && ::ftruncate(fd, static_cast<off_t>(size)) == 0 &&
+                 write_all(fd, header, kHeaderBytes, 0) &&
+                 write_all(fd, base_ + tail, tail_bytes, static_cast<off_t>(kHeaderBytes)) &&
+                 ::fdatasync(fd) == 0 &&
+                 (!options_.keep_rotated || ::link(path_.c_str(), archive.c_str()) == 0) &&
+                 ::rename(rotating.c_str(), path_.c_str()) == 0;
+  if (!rotated) {
+    if (logger_) {
+      logger_->log_error("OrderJournal", "Failed to rotate " + path_ + ": " + std::strerror(errno));
+    }
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    ::unlink(rotating.c_str());
+    return false;
+  }
+  if (!sync_directory(path_) && logger_) {
+    logger_->log_warning("OrderJournal", "Failed to sync the directory of " + path_ + ": " +
+                                             std::strerror(errno));
+  }
+
+  // From here the old file is gone from path_: appends must go to the new one
+  char* old_base = base_;
+  size_t old_size = mapped_size_;
+  int old_fd = fd_;
+  fd_ = fd;
+  if (!map(size)) {
+    if (logger_) {
+      logger_->log_error("OrderJournal", "Failed to map rotated " + path_ + ": " +
+                                             std::strerror(errno));
+    }
+    failed_ = true;
+    base_ = old_base; // Still readable; appends now fail
+    fd_ = old_fd;
+    ::close(fd);
+    durable_cv_.notify_all();
+    return false;
+  }
+  ::munmap(old_base, old_size);
+  ::close(old_fd);
+
+  end_offset_ = kHeaderBytes + tail_bytes;
+  durable_sequence_ = last_sequence_; // Synced as part of the new file
+  ++rotations_;
+  durable_cv_.notify_all();
+
+  if (logger_) {
+    logger_->log_info("OrderJournal", "Rotated " + path_ + " after sequence " +
+                                          std::to_string(first_sequence) + ", kept " +
+                                          std::to_string(tail_bytes) + " bytes");
+  }
+  return true;
+}
+
+uint64_t OrderJournal::checkpoint_sequence() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t sequence = 0;
+  if (base_) {
+    std::memcpy(&sequence, base_ + kCheckpointOffset, sizeof(sequence));
+  }
+  return sequence;
+}
+
+uint64_t OrderJournal::last_sequence() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return last_sequence_;
+}
+
+uint64_t OrderJournal::durable_sequence() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return durable_sequence_;
+}
+
+size_t OrderJournal::size_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return end_offset_;
+}
+
+bool OrderJournal::failed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return failed_;
+}
+
+} // namespace pulseexec
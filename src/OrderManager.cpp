@@ -1,41 +1,89 @@
 #include "pulseexec/OrderManager.hpp"
 #include "pulseexec/DBWriter.hpp"
+#include "pulseexec/LatencyTracker.hpp"
+#include "pulseexec/OrderJournal.hpp"
 #include "pulseexec/Logger.hpp"
+#include "pulseexec/SessionRecorder.hpp"
+#include <algorithm>
+#include <charconv>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <cstring>
 
 namespace pulseexec {
 
-OrderManager::OrderManager(std::shared_ptr<Logger> logger, std::shared_ptr<DBWriter> db_writer)
-    : logger_(logger), db_writer_(db_writer) {}
+// Database sequence tracked for a journal record whose write never reached
+// DBWriter's queue; no flushed sequence ever covers it
+static constexpr uint64_t kNeverFlushed = UINT64_MAX;
+
+// Journal records between checkpoints taken while orders are being updated,
+// so the journal can rotate during a run and not only at shutdown
+static constexpr uint64_t kJournalCheckpointInterval = 4096;
+
+OrderManager::OrderManager(std::shared_ptr<Logger> logger, std::shared_ptr<DBWriter> db_writer,
+                           size_t index_shards)
+    : logger_(logger), db_writer_(db_writer), handles_by_client_id_(index_shards),
+      handles_by_exchange_id_(index_shards) {}
 
 OrderManager::~OrderManager() = default;
 
+void OrderManager::set_latency_tracker(std::shared_ptr<LatencyTracker> tracker) {
+  latency_tracker_ = std::move(tracker);
+}
+
+void OrderManager::set_journal(std::shared_ptr<OrderJournal> journal) {
+  journal_ = std::move(journal);
+}
+
+void OrderManager::set_recorder(std::shared_ptr<SessionRecorder> recorder) {
+  recorder_ = std::move(recorder);
+}
+
+void OrderManager::set_terminal_retention(std::chrono::milliseconds retention,
+                                          size_t max_retained) {
+  terminal_retention_ = retention;
+  max_retained_terminal_ = max_retained;
+  evict_terminal_ = true;
+}
+
 std::string OrderManager::generate_client_order_id() {
   auto counter = order_counter_.fetch_add(1, std::memory_order_relaxed);
   auto now = std::chrono::system_clock::now();
   auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
 
-  std::ostringstream oss;
-  oss << "ORDER_" << now_ms << "_" << counter;
-  return oss.str();
+  // "ORDER_<now_ms>_<counter>", formatted without a stream
+  char buf[64];
+  char* end = buf + sizeof(buf);
+  std::memcpy(buf, "ORDER_", 6);
+  char* p = std::to_chars(buf + 6, end, now_ms).ptr;
+  *p++ = '_';
+  p = std::to_chars(p, end, counter).ptr;
+  return std::string(buf, p);
 }
 
-std::string OrderManager::create_order(const OrderRequest& request) {
+OrderHandle OrderManager::create_order(const OrderRequest& request) {
   // Generate client order ID if not provided
   std::string client_order_id =
       request.client_order_id.empty() ? generate_client_order_id() : request.client_order_id;
 
-  // Check for duplicate
-  {
-    std::lock_guard<std::mutex> lock(map_mutex_);
-    if (orders_by_client_id_.find(client_order_id) != orders_by_client_id_.end()) {
-      if (logger_) {
-        logger_->log_error("OrderManager", "Duplicate client_order_id: " + client_order_id);
-      }
-      return ""; // Return empty string on error
+  // Claim the client ID; the duplicate check and insert are one step
+  OrderHandle handle = orders_.reserve();
+  if (handle == kInvalidOrderHandle) {
+    if (logger_) {
+      logger_->log_event(LogLevel::ERROR, LogFormatId::ORDER_STORE_FULL, client_order_id);
+    }
+    return kInvalidOrderHandle;
+  }
+  if (!handles_by_client_id_.insert(client_order_id, handle)) {
+    if (logger_) {
+      logger_->log_event(LogLevel::ERROR, LogFormatId::DUPLICATE_CLIENT_ORDER_ID,
+                         client_order_id);
     }
+    orders_.release(handle);
+    return kInvalidOrderHandle;
+  }
+
+  if (latency_tracker_) {
+    latency_tracker_->mark_created(client_order_id);
   }
 
   // Create order with timestamp
@@ -44,52 +92,100 @@ std::string OrderManager::create_order(const OrderRequest& request) {
                      .count();
 
   Order order(client_order_id, request, now_us);
+  order.instrument_id = instruments_.intern(request.symbol);
+
+  // Keep every order of an instrument on that instrument's scale, so price and
+  // quantity comparisons between its orders are plain integer compares
+  InstrumentScale scale = instruments_.scale(order.instrument_id);
+  order.request.price = scale.normalize(order.request.price);
+  order.request.amount = scale.normalize(order.request.amount);
+
+  // Log, persist and notify under the order's lock so a concurrent update cannot
+  // be persisted or reported ahead of its creation
+  orders_.publish(handle, std::move(order), [&](const OrderSnapshot& stored) {
+    // Log creation
+    if (logger_) {
+      logger_->log_event(LogLevel::INFO, LogFormatId::ORDER_CREATED, client_order_id,
+                         request.symbol);
+    }
 
-  // Insert into map
-  {
-    std::lock_guard<std::mutex> lock(map_mutex_);
-    orders_by_client_id_[client_order_id] = std::make_unique<OrderEntry>(order);
-  }
-
-  // Log creation
-  if (logger_) {
-    logger_->log_info("OrderManager",
-                      "Created order: " + client_order_id + " for " + request.symbol);
-  }
+    if (recorder_) {
+      recorder_->record_order_create(*stored);
+    }
 
-  // Persist to database
-  if (db_writer_) {
-    db_writer_->write_order(order);
-  }
+    // Journal synchronously, then queue the SQLite write
+    uint64_t journal_sequence = journal_ ? journal_->append(*stored) : 0;
+    if (journal_ && journal_sequence == 0) {
+      journal_failed(stored->client_order_id);
+    }
+    uint64_t db_sequence = 0;
+    bool persisted = !db_writer_ || db_writer_->write_order(*stored, db_sequence);
+    if (journal_sequence != 0) {
+      track_journaled(journal_sequence, persisted, db_sequence);
+    }
 
-  // Notify callbacks
-  notify_update(order);
+    // Notify callbacks
+    notify_update(stored);
+  });
 
-  return client_order_id;
+  if (journal_) {
+    maybe_checkpoint_journal();
+  }
+  return handle;
 }
 
-bool OrderManager::update_order(const std::string& client_order_id, OrderState new_state,
-                                 const std::string& exchange_order_id, double filled_amount,
-                                 const std::string& error_msg) {
-  OrderEntry* entry = nullptr;
+std::vector<OrderHandle> OrderManager::restore_orders(std::vector<Order> orders) {
+  std::vector<OrderHandle> handles;
+  handles.reserve(orders.size());
 
-  // Get entry pointer (under map lock)
-  {
-    std::lock_guard<std::mutex> lock(map_mutex_);
-    auto it = orders_by_client_id_.find(client_order_id);
-    if (it == orders_by_client_id_.end()) {
+  for (Order& order : orders) {
+    OrderHandle handle = orders_.reserve();
+    if (handle == kInvalidOrderHandle) {
       if (logger_) {
-        logger_->log_error("OrderManager", "Order not found: " + client_order_id);
+        logger_->log_event(LogLevel::ERROR, LogFormatId::ORDER_STORE_FULL,
+                           order.client_order_id);
       }
-      return false;
+      continue;
     }
-    entry = it->second.get();
+    if (!handles_by_client_id_.insert(order.client_order_id, handle)) {
+      if (logger_) {
+        logger_->log_event(LogLevel::ERROR, LogFormatId::DUPLICATE_CLIENT_ORDER_ID,
+                           order.client_order_id);
+      }
+      orders_.release(handle);
+      continue;
+    }
+
+    order.instrument_id = instruments_.intern(order.request.symbol);
+    InstrumentScale scale = instruments_.scale(order.instrument_id);
+    order.request.price = scale.normalize(order.request.price);
+    order.request.amount = scale.normalize(order.request.amount);
+    order.filled_amount = scale.normalize(order.filled_amount);
+
+    if (!order.exchange_order_id.empty()) {
+      handles_by_exchange_id_.insert_or_assign(order.exchange_order_id, handle);
+    }
+    if (recorder_) {
+      recorder_->record_order_restore(order);
+    }
+
+    // Already in the database and not news to anyone: no log, write or callback
+    orders_.publish(handle, std::move(order), [](const OrderSnapshot&) {});
+    handles.push_back(handle);
   }
 
-  // Update order (under per-order lock)
-  {
-    std::lock_guard<std::mutex> lock(entry->mutex);
-    Order& order = entry->order;
+  return handles;
+}
+
+bool OrderManager::update_order(OrderHandle handle, OrderState new_state,
+                                const std::string& exchange_order_id, Qty filled_amount,
+                                const std::string& error_msg) {
+  bool became_terminal = false;
+
+  // Update a copy of the order, then log, persist and notify the published
+  // version (under per-order lock)
+  auto mutate = [&](Order& order) {
+    bool was_terminal = order.is_terminal();
 
     // Update state
     order.state = new_state;
@@ -100,14 +196,11 @@ bool OrderManager::update_order(const std::string& client_order_id, OrderState n
     // Update exchange ID if provided
     if (!exchange_order_id.empty() && order.exchange_order_id.empty()) {
       order.exchange_order_id = exchange_order_id;
-
-      // Add to exchange ID map
-      std::lock_guard<std::mutex> map_lock(map_mutex_);
-      exchange_id_to_client_id_[exchange_order_id] = client_order_id;
+      handles_by_exchange_id_.insert_or_assign(exchange_order_id, handle);
     }
 
     // Update filled amount
-    if (filled_amount > 0.0) {
+    if (!filled_amount.is_zero()) {
       order.filled_amount = filled_amount;
     }
 
@@ -116,106 +209,182 @@ bool OrderManager::update_order(const std::string& client_order_id, OrderState n
       order.error_message = error_msg;
     }
 
+    became_terminal = !was_terminal && order.is_terminal();
+  };
+
+  auto on_updated = [&](const OrderSnapshot& order) {
+    // An order that ends before the gateway answers never closes its trace
+    if (latency_tracker_ && !order->is_active()) {
+      latency_tracker_->forget(order->client_order_id);
+    }
+
     // Log update
     if (logger_) {
-      logger_->log_info("OrderManager", "Updated order: " + client_order_id + " -> " +
-                                             to_string(new_state));
+      logger_->log_event(LogLevel::INFO, LogFormatId::ORDER_UPDATED, order->client_order_id,
+                         new_state);
     }
 
-    // Persist update
-    if (db_writer_) {
-      db_writer_->write_order(order);
+    if (recorder_) {
+      recorder_->record_order_update(order->client_order_id, new_state, exchange_order_id,
+                                     filled_amount, error_msg);
+    }
+
+    // Persist update: journal synchronously, then queue the SQLite write
+    uint64_t journal_sequence = journal_ ? journal_->append(*order) : 0;
+    if (journal_ && journal_sequence == 0) {
+      journal_failed(order->client_order_id);
+    }
+    uint64_t db_sequence = 0;
+    bool persisted = !db_writer_ || db_writer_->write_order(*order, db_sequence);
+    if (journal_sequence != 0) {
+      track_journaled(journal_sequence, persisted, db_sequence);
     }
 
     // Notify callbacks
     notify_update(order);
+
+    // An order whose final state never reached the queue is kept in memory:
+    // evicting it would lose it
+    if (became_terminal && evict_terminal_ && persisted) {
+      std::lock_guard<std::mutex> lock(retention_mutex_);
+      terminal_orders_.push_back({handle, std::chrono::steady_clock::now(), db_sequence});
+    }
+  };
+
+  bool found = orders_.update(handle, mutate, on_updated);
+
+  // Evict outside the order's lock; retire() takes other orders' locks
+  if (became_terminal && evict_terminal_) {
+    evict_terminal_orders();
+  }
+  if (journal_) {
+    maybe_checkpoint_journal();
+  }
+
+  if (!found) {
+    if (logger_) {
+      logger_->log_event(LogLevel::ERROR, LogFormatId::ORDER_NOT_FOUND, handle);
+    }
+    return false;
   }
 
   return true;
 }
 
-bool OrderManager::get_order(const std::string& client_order_id, Order& out_order) const {
-  OrderEntry* entry = nullptr;
-
-  {
-    std::lock_guard<std::mutex> lock(map_mutex_);
-    auto it = orders_by_client_id_.find(client_order_id);
-    if (it == orders_by_client_id_.end()) {
-      return false;
+bool OrderManager::update_order(const std::string& client_order_id, OrderState new_state,
+                                const std::string& exchange_order_id, Qty filled_amount,
+                                const std::string& error_msg) {
+  OrderHandle handle = find_handle(client_order_id);
+  if (handle == kInvalidOrderHandle) {
+    if (logger_) {
+      logger_->log_event(LogLevel::ERROR, LogFormatId::ORDER_NOT_FOUND, client_order_id);
     }
-    entry = it->second.get();
+    return false;
   }
+  return update_order(handle, new_state, exchange_order_id, filled_amount, error_msg);
+}
 
-  {
-    std::lock_guard<std::mutex> lock(entry->mutex);
-    out_order = entry->order;
+bool OrderManager::get_order(OrderHandle handle, Order& out_order) const {
+  return orders_.read(handle, [&out_order](const Order& order) { out_order = order; });
+}
+
+OrderSnapshot OrderManager::snapshot(OrderHandle handle) const {
+  return orders_.snapshot(handle);
+}
+
+bool OrderManager::get_order(const std::string& client_order_id, Order& out_order) const {
+  if (get_order(find_handle(client_order_id), out_order)) {
+    return true;
   }
 
+  // Evicted terminal orders live on in the orders table
+  if (!db_writer_ || !db_writer_->load_order(client_order_id, out_order)) {
+    return false;
+  }
+  resolve_archived(out_order);
   return true;
 }
 
 bool OrderManager::get_order_by_exchange_id(const std::string& exchange_order_id,
                                               Order& out_order) const {
-  std::string client_order_id;
+  OrderHandle handle = kInvalidOrderHandle;
+  handles_by_exchange_id_.read(exchange_order_id, [&handle](OrderHandle h) { handle = h; });
+  if (get_order(handle, out_order)) {
+    return true;
+  }
 
-  {
-    std::lock_guard<std::mutex> lock(map_mutex_);
-    auto it = exchange_id_to_client_id_.find(exchange_order_id);
-    if (it == exchange_id_to_client_id_.end()) {
-      return false;
-    }
-    client_order_id = it->second;
+  if (!db_writer_ || !db_writer_->load_order_by_exchange_id(exchange_order_id, out_order)) {
+    return false;
   }
+  resolve_archived(out_order);
+  return true;
+}
+
+void OrderManager::resolve_archived(Order& order) const {
+  // Archived orders have no handle; the instrument id is kept if still interned
+  order.handle = kInvalidOrderHandle;
+  order.instrument_id = instruments_.find(order.request.symbol);
+}
+
+OrderHandle OrderManager::find_handle(const std::string& client_order_id) const {
+  OrderHandle handle = kInvalidOrderHandle;
+  handles_by_client_id_.read(client_order_id, [&handle](OrderHandle h) { handle = h; });
+  return handle;
+}
+
+std::string OrderManager::get_client_order_id(OrderHandle handle) const {
+  std::string client_order_id;
+  orders_.read(handle, [&](const Order& order) { client_order_id = order.client_order_id; });
+  return client_order_id;
+}
 
-  return get_order(client_order_id, out_order);
+bool OrderManager::has_order(OrderHandle handle) const {
+  return orders_.read(handle, [](const Order&) {});
 }
 
 bool OrderManager::has_order(const std::string& client_order_id) const {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  return orders_by_client_id_.find(client_order_id) != orders_by_client_id_.end();
+  if (has_order(find_handle(client_order_id))) {
+    return true;
+  }
+  Order archived;
+  return db_writer_ && db_writer_->load_order(client_order_id, archived);
 }
 
 void OrderManager::register_update_callback(OrderUpdateCallback callback) {
-  std::lock_guard<std::mutex> lock(callback_mutex_);
-  update_callbacks_.push_back(std::move(callback));
+  update_dispatcher_.subscribe(std::move(callback));
 }
 
-std::vector<Order> OrderManager::get_active_orders() const {
-  std::vector<Order> active_orders;
+std::vector<OrderSnapshot> OrderManager::get_active_orders() const {
+  std::vector<OrderSnapshot> active_orders;
+  active_orders.reserve(orders_.active_count());
 
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  for (const auto& [client_id, entry] : orders_by_client_id_) {
-    std::lock_guard<std::mutex> order_lock(entry->mutex);
-    if (entry->order.is_active()) {
-      active_orders.push_back(entry->order);
-    }
-  }
+  // Walks the active index, not every order ever created
+  orders_.for_each_active(
+      [&active_orders](const OrderSnapshot& order) { active_orders.push_back(order); });
 
   return active_orders;
 }
 
-std::vector<Order> OrderManager::get_all_orders() const {
-  std::vector<Order> all_orders;
+std::vector<OrderSnapshot> OrderManager::get_all_orders() const {
+  std::vector<OrderSnapshot> all_orders;
+  all_orders.reserve(orders_.size());
 
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  for (const auto& [client_id, entry] : orders_by_client_id_) {
-    std::lock_guard<std::mutex> order_lock(entry->mutex);
-    all_orders.push_back(entry->order);
-  }
+  orders_.for_each_snapshot(
+      [&all_orders](const OrderSnapshot& order) { all_orders.push_back(order); });
 
   return all_orders;
 }
 
-bool OrderManager::mark_for_cancel(const std::string& client_order_id) {
-  Order order;
-  if (!get_order(client_order_id, order)) {
+bool OrderManager::mark_for_cancel(OrderHandle handle) {
+  OrderSnapshot order = orders_.snapshot(handle);
+  if (!order) {
     return false;
   }
 
-  if (!order.is_active()) {
+  if (!order->is_active()) {
     if (logger_) {
-      logger_->log_warning("OrderManager",
-                           "Cannot cancel inactive order: " + client_order_id);
+      logger_->log_event(LogLevel::WARNING, LogFormatId::CANCEL_INACTIVE_ORDER,
+                         order->client_order_id);
     }
     return false;
   }
@@ -225,11 +394,127 @@ bool OrderManager::mark_for_cancel(const std::string& client_order_id) {
   return true;
 }
 
-void OrderManager::notify_update(const Order& order) {
-  std::lock_guard<std::mutex> lock(callback_mutex_);
-  for (const auto& callback : update_callbacks_) {
-    callback(order);
+void OrderManager::track_journaled(uint64_t journal_sequence, bool persisted,
+                                   uint64_t db_sequence) {
+  std::lock_guard<std::mutex> lock(journal_mutex_);
+  unsettled_journal_.emplace(journal_sequence, persisted ? db_sequence : kNeverFlushed);
+  ++journaled_since_checkpoint_;
+}
+
+void OrderManager::journal_failed(const std::string& client_order_id) {
+  // The SQLite write is still queued, but a crash before it commits loses
+  // the change
+  journal_failures_.fetch_add(1, std::memory_order_relaxed);
+  if (logger_) {
+    logger_->log_error("OrderManager", "Failed to journal order " + client_order_id);
   }
 }
 
+void OrderManager::maybe_checkpoint_journal() {
+  {
+    std::lock_guard<std::mutex> lock(journal_mutex_);
+    if (journaled_since_checkpoint_ < kJournalCheckpointInterval) {
+      return;
+    }
+    journaled_since_checkpoint_ = 0;
+  }
+
+  // Serialized so an older checkpoint never overwrites a newer one; a
+  // rotation blocks appends while it copies the uncheckpointed records
+  std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+  uint64_t through = committed_journal_sequence();
+  if (through > journal_->checkpoint_sequence()) {
+    journal_->checkpoint(through);
+  }
+}
+
+uint64_t OrderManager::committed_journal_sequence() {
+  if (!journal_) {
+    return 0;
+  }
+  uint64_t flushed = db_writer_ ? db_writer_->flushed_sequence() : UINT64_MAX;
+
+  std::lock_guard<std::mutex> lock(journal_mutex_);
+  // Records up to the journal's own checkpoint were brought into SQLite by
+  // recovery, or were never tracked here
+  uint64_t through = std::max(settled_journal_sequence_, journal_->checkpoint_sequence());
+  auto it = unsettled_journal_.begin();
+  while (it != unsettled_journal_.end() && it->first <= through) {
+    it = unsettled_journal_.erase(it);
+  }
+
+  // Journal sequences are handed out before the order's database write is
+  // tracked, so a gap is a write still on its way: stop there, as at the
+  // first write DBWriter has not committed. A write that never reached the
+  // queue stops the checkpoint for good, and the next start replays it.
+  while (it != unsettled_journal_.end() && it->first == through + 1 && it->second <= flushed) {
+    through = it->first;
+    it = unsettled_journal_.erase(it);
+  }
+  settled_journal_sequence_ = through;
+  return through;
+}
+
+size_t OrderManager::evict_terminal_orders() {
+  if (!evict_terminal_) {
+    return 0;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  uint64_t flushed = db_writer_ ? db_writer_->flushed_sequence() : UINT64_MAX;
+  size_t evicted = 0;
+
+  while (true) {
+    OrderHandle handle;
+    {
+      // Oldest first; stop at the first order that must stay, since the ones
+      // behind it became terminal (and were queued for the database) later
+      std::lock_guard<std::mutex> lock(retention_mutex_);
+      if (terminal_orders_.empty()) {
+        break;
+      }
+      const RetainedOrder& oldest = terminal_orders_.front();
+      auto age = std::chrono::duration_cast<std::chrono::milliseconds>(now - oldest.terminal_at);
+      bool expired =
+          age >= terminal_retention_ || terminal_orders_.size() > max_retained_terminal_;
+      if (!expired || oldest.db_sequence > flushed) {
+        break;
+      }
+      handle = oldest.handle;
+      terminal_orders_.pop_front();
+    }
+
+    OrderSnapshot order = orders_.retire(handle);
+    if (!order) {
+      continue;
+    }
+
+    // Lookups by ID miss from here on and fall back to the database
+    handles_by_client_id_.erase(order->client_order_id);
+    if (!order->exchange_order_id.empty()) {
+      handles_by_exchange_id_.erase_if(order->exchange_order_id,
+                                       [handle](OrderHandle h) { return h == handle; });
+    }
+    ++evicted;
+  }
+
+  evicted_count_.fetch_add(evicted, std::memory_order_relaxed);
+  return evicted;
+}
+
+size_t OrderManager::retained_terminal_count() const {
+  std::lock_guard<std::mutex> lock(retention_mutex_);
+  return terminal_orders_.size();
+}
+
+bool OrderManager::mark_for_cancel(const std::string& client_order_id) {
+  return mark_for_cancel(find_handle(client_order_id));
+}
+
+void OrderManager::notify_update(const OrderSnapshot& order) {
+  // Called under the order's lock: the published version is queued as is,
+  // callbacks run on the dispatcher thread
+  update_dispatcher_.publish(order);
+}
+
 } // namespace pulseexec
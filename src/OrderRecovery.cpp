@@ -0,0 +1,209 @@
+#include "pulseexec/OrderRecovery.hpp"
+#include "pulseexec/DBWriter.hpp"
+#include "pulseexec/ExecutionGateway.hpp"
+#include "pulseexec/Logger.hpp"
+#include "pulseexec/OrderJournal.hpp"
+#include "pulseexec/OrderManager.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace pulseexec {
+
+// Journal replay writes this many orders, then waits for them to be flushed,
+// so it never overruns DBWriter's queue
+static constexpr size_t kReplayChunk = 1000;
+static constexpr auto kReplayFlushTimeout = std::chrono::seconds(30);
+
+static int64_t elapsed_us(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                               since)
+      .count();
+}
+
+OrderRecovery::OrderRecovery(std::shared_ptr<Logger> logger, std::shared_ptr<DBWriter> db_writer,
+                             std::shared_ptr<OrderManager> order_manager,
+                             std::shared_ptr<ExecutionGateway> gateway, size_t max_in_flight)
+    : logger_(logger), db_writer_(db_writer), order_manager_(order_manager), gateway_(gateway),
+      max_in_flight_(max_in_flight > 0 ? max_in_flight : 1) {}
+
+void OrderRecovery::set_journal(std::shared_ptr<OrderJournal> journal) {
+  journal_ = std::move(journal);
+}
+
+RecoveryStats OrderRecovery::run(std::chrono::milliseconds reconcile_timeout) {
+  RecoveryStats stats;
+  auto start = std::chrono::steady_clock::now();
+
+  if (journal_ && db_writer_) {
+    stats.journal_replayed = replay_journal();
+  }
+
+  std::vector<Order> orders;
+  if (!db_writer_ || !db_writer_->load_open_orders(orders)) {
+    return stats;
+  }
+  stats.loaded = orders.size();
+
+  std::vector<OrderHandle> handles = order_manager_->restore_orders(std::move(orders));
+  stats.restored = handles.size();
+  stats.load_us = elapsed_us(start);
+
+  if (logger_) {
+    logger_->log_info("OrderRecovery", "Restored " + std::to_string(stats.restored) +
+                                           " open orders in " + std::to_string(stats.load_us) +
+                                           "us");
+  }
+
+  if (gateway_ && !handles.empty()) {
+    auto reconcile_start = std::chrono::steady_clock::now();
+    reconcile(handles, reconcile_timeout, stats);
+    stats.reconcile_us = elapsed_us(reconcile_start);
+  } else {
+    stats.unconfirmed = stats.restored;
+  }
+
+  return stats;
+}
+
+size_t OrderRecovery::replay_journal() {
+  // Only the last version of each order matters to SQLite
+  std::unordered_map<std::string, Order> latest;
+  size_t replayed = journal_->replay(journal_->checkpoint_sequence(), [&](const JournalRecord& r) {
+    latest[r.order.client_order_id] = r.order;
+  });
+  uint64_t replayed_through = journal_->last_sequence();
+
+  auto wait_flushed = [this](uint64_t sequence) {
+    auto deadline = std::chrono::steady_clock::now() + kReplayFlushTimeout;
+    while (db_writer_->flushed_sequence() < sequence) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  };
+
+  bool complete = true;
+  uint64_t sequence = 0;
+  size_t pending = 0;
+  for (const auto& entry : latest) {
+    if (!db_writer_->write_order(entry.second, sequence)) {
+      complete = false;
+      continue;
+    }
+    if (++pending == kReplayChunk) {
+      complete = wait_flushed(sequence) && complete;
+      pending = 0;
+    }
+  }
+  complete = wait_flushed(sequence) && complete;
+
+  // Leave the checkpoint alone after a failure, so the next start retries
+  if (complete) {
+    journal_->checkpoint(replayed_through);
+  } else if (logger_) {
+    logger_->log_error("OrderRecovery", "Journal replay did not reach the database");
+  }
+
+  if (logger_ && replayed > 0) {
+    logger_->log_info("OrderRecovery", "Replayed " + std::to_string(replayed) +
+                                           " journal records for " +
+                                           std::to_string(latest.size()) + " orders");
+  }
+  return replayed;
+}
+
+void OrderRecovery::reconcile(const std::vector<OrderHandle>& handles,
+                              std::chrono::milliseconds timeout, RecoveryStats& stats) {
+  // Shared with the callbacks, which may outlive this call on a timeout
+  struct Progress {
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t in_flight = 0;
+    size_t answered = 0;
+    size_t confirmed = 0;
+    size_t updated = 0;
+    size_t not_found = 0;
+  };
+  auto progress = std::make_shared<Progress>();
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+
+  for (OrderHandle handle : handles) {
+    OrderSnapshot order = order_manager_->snapshot(handle);
+    if (!order) {
+      continue;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(progress->mutex);
+      if (!progress->cv.wait_until(lock, deadline,
+                                   [&] { return progress->in_flight < max_in_flight_; })) {
+        break;
+      }
+      ++progress->in_flight;
+    }
+    ++stats.queried;
+
+    // Runs on the gateway's loop thread. An order without an exchange ID was
+    // sent, but its acknowledgement never reached the database: it is looked
+    // up by its label, the client order ID, and takes the exchange's ID.
+    auto on_status = [progress, logger = logger_, order_manager = order_manager_, handle,
+                      client_order_id = order->client_order_id](const ExecutionResult& result,
+                                                                const Order& exchange) {
+      bool found = result.success && !exchange.exchange_order_id.empty();
+      bool changed = false;
+      if (found) {
+        OrderSnapshot current = order_manager->snapshot(handle);
+        changed = current && (current->state != exchange.state ||
+                              current->filled_amount != exchange.filled_amount ||
+                              current->exchange_order_id.empty());
+        if (changed) {
+          order_manager->update_order(handle, exchange.state, exchange.exchange_order_id,
+                                      exchange.filled_amount);
+        }
+      } else if (result.success && logger) {
+        logger->log_warning("OrderRecovery", "Order " + client_order_id +
+                                                 " is unknown to the exchange; check it by hand");
+      }
+
+      std::lock_guard<std::mutex> lock(progress->mutex);
+      --progress->in_flight;
+      if (result.success) {
+        ++progress->answered;
+        if (!found) {
+          ++progress->not_found;
+        } else if (changed) {
+          ++progress->updated;
+        } else {
+          ++progress->confirmed;
+        }
+      }
+      progress->cv.notify_all();
+    };
+
+    if (order->exchange_order_id.empty()) {
+      gateway_->get_order_status_by_label_async(order->request.symbol, order->client_order_id,
+                                                std::move(on_status));
+    } else {
+      gateway_->get_order_status_async(order->exchange_order_id, std::move(on_status));
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(progress->mutex);
+  progress->cv.wait_until(lock, deadline, [&] { return progress->in_flight == 0; });
+
+  stats.confirmed = progress->confirmed;
+  stats.updated = progress->updated;
+  stats.not_found = progress->not_found;
+  stats.unconfirmed = stats.restored - progress->answered + progress->not_found;
+
+  if (logger_ && stats.unconfirmed > 0) {
+    logger_->log_warning("OrderRecovery", std::to_string(stats.unconfirmed) +
+                                              " recovered orders not confirmed by the exchange");
+  }
+}
+
+} // namespace pulseexec
@@ -0,0 +1,114 @@
+#include "pulseexec/OrderStore.hpp"
+
+namespace pulseexec {
+
+OrderStore::OrderStore() : chunks_(std::make_unique<std::atomic<Slot*>[]>(kMaxChunks)) {
+  for (size_t i = 0; i < kMaxChunks; ++i) {
+    chunks_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+OrderStore::~OrderStore() {
+  for (size_t i = 0; i < kMaxChunks; ++i) {
+    delete[] chunks_[i].load(std::memory_order_relaxed);
+  }
+}
+
+OrderHandle OrderStore::reserve() {
+  {
+    std::lock_guard<std::mutex> lock(free_mutex_);
+    if (!free_slots_.empty()) {
+      uint32_t index = free_slots_.back();
+      free_slots_.pop_back();
+      Slot* slot = slot_for(static_cast<OrderHandle>(index) + 1);
+      return (static_cast<OrderHandle>(slot->generation) << kGenerationShift) | (index + 1);
+    }
+  }
+
+  size_t index = next_index_.fetch_add(1, std::memory_order_relaxed);
+  size_t chunk = index >> kChunkBits;
+  if (chunk >= kMaxChunks) {
+    return kInvalidOrderHandle;
+  }
+
+  // First reservation in a chunk allocates it; losers of the race free theirs
+  if (!chunks_[chunk].load(std::memory_order_acquire)) {
+    Slot* fresh = new Slot[kChunkSize];
+    Slot* expected = nullptr;
+    if (!chunks_[chunk].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+      delete[] fresh;
+    }
+  }
+
+  return static_cast<OrderHandle>(index) + 1;
+}
+
+void OrderStore::release(OrderHandle handle) {
+  Slot* slot = slot_for(handle);
+  if (!slot) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(slot->mutex);
+  if (!std::atomic_load_explicit(&slot->current, std::memory_order_acquire)) {
+    free_slot(*slot, handle);
+  }
+}
+
+OrderSnapshot OrderStore::retire(OrderHandle handle) {
+  Slot* slot = slot_for(handle);
+  if (!slot) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(slot->mutex);
+  OrderSnapshot current = std::atomic_load_explicit(&slot->current, std::memory_order_acquire);
+  if (!current || current->handle != handle) {
+    return nullptr;
+  }
+
+  // Readers still holding the snapshot keep it alive; new lookups miss
+  std::atomic_store_explicit(&slot->current, OrderSnapshot(), std::memory_order_release);
+  live_count_.fetch_sub(1, std::memory_order_relaxed);
+  track_active(*slot, handle, false);
+  free_slot(*slot, handle);
+  return current;
+}
+
+void OrderStore::free_slot(Slot& slot, OrderHandle handle) {
+  std::lock_guard<std::mutex> lock(free_mutex_);
+  if (slot.generation != static_cast<uint32_t>(handle >> kGenerationShift)) {
+    return; // Stale handle: the slot was already freed and handed out again
+  }
+  ++slot.generation;
+  free_slots_.push_back(static_cast<uint32_t>((handle & 0xFFFFFFFFu) - 1));
+}
+
+OrderStore::Slot* OrderStore::slot_for(OrderHandle handle) const {
+  OrderHandle slot_handle = handle & 0xFFFFFFFFu;
+  if (slot_handle == kInvalidOrderHandle) {
+    return nullptr;
+  }
+  size_t index = static_cast<size_t>(slot_handle - 1);
+  size_t chunk = index >> kChunkBits;
+  if (chunk >= kMaxChunks) {
+    return nullptr;
+  }
+
+  Slot* slots = chunks_[chunk].load(std::memory_order_acquire);
+  return slots ? &slots[index & (kChunkSize - 1)] : nullptr;
+}
+
+void OrderStore::track_active(Slot& slot, OrderHandle handle, bool active) {
+  std::lock_guard<std::mutex> lock(active_mutex_);
+  if (active && slot.active_pos == kNotActive) {
+    slot.active_pos = active_.size();
+    active_.push_back(handle);
+  } else if (!active && slot.active_pos != kNotActive) {
+    OrderHandle moved = active_.back();
+    active_[slot.active_pos] = moved;
+    slot_for(moved)->active_pos = slot.active_pos;
+    active_.pop_back();
+    slot.active_pos = kNotActive;
+  }
+}
+
+} // namespace pulseexec
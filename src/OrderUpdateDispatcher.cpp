@@ -0,0 +1,240 @@
+#include "pulseexec/OrderUpdateDispatcher.hpp"
+#include <algorithm>
+
+namespace pulseexec {
+
+// Empty polls the dispatcher spins through before parking
+static constexpr int kSpinIterations = 64;
+
+// Upper bound on a park, so a missed wakeup only delays delivery briefly
+static constexpr auto kParkTimeout = std::chrono::milliseconds(5);
+
+OrderUpdateDispatcher::OrderUpdateDispatcher(size_t queue_capacity)
+    : ring_(queue_capacity), subscribers_(std::make_shared<const SubscriberList>()) {}
+
+OrderUpdateDispatcher::~OrderUpdateDispatcher() { stop(); }
+
+OrderUpdateDispatcher::SubscriberId OrderUpdateDispatcher::subscribe(OrderUpdateCallback callback) {
+  SubscriberId id;
+  {
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    id = next_id_++;
+    auto subscriber = std::make_shared<Subscriber>();
+    subscriber->id = id;
+    subscriber->callback = std::move(callback);
+    subscriber->published_at_subscribe = published_.load(std::memory_order_relaxed);
+
+    auto list = std::make_shared<SubscriberList>(*subscribers_);
+    list->push_back(std::move(subscriber));
+    subscribers_ = std::move(list);
+    subscriber_count_.store(subscribers_->size(), std::memory_order_release);
+    version_.fetch_add(1, std::memory_order_release);
+  }
+
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+  if (!running_.exchange(true)) {
+    worker_ = std::thread(&OrderUpdateDispatcher::dispatcher_thread, this);
+  }
+  return id;
+}
+
+void OrderUpdateDispatcher::unsubscribe(SubscriberId id) {
+  std::lock_guard<std::mutex> lock(subscribers_mutex_);
+  auto list = std::make_shared<SubscriberList>(*subscribers_);
+  list->erase(std::remove_if(list->begin(), list->end(),
+                             [id](const auto& subscriber) { return subscriber->id == id; }),
+              list->end());
+  subscribers_ = std::move(list);
+  subscriber_count_.store(subscribers_->size(), std::memory_order_release);
+  version_.fetch_add(1, std::memory_order_release);
+}
+
+void OrderUpdateDispatcher::publish(const Order& order) {
+  if (!has_subscribers()) {
+    return;
+  }
+  publish(std::make_shared<const Order>(order));
+}
+
+void OrderUpdateDispatcher::publish(OrderSnapshot snapshot) {
+  if (!has_subscribers()) {
+    return;
+  }
+
+  // An order's updates are published one at a time, under its lock, so once
+  // one of them has overflowed the next sees overflowing_ and follows it
+  if (overflowing_.load(std::memory_order_acquire) || !ring_.try_push(std::move(snapshot))) {
+    overflow(std::move(snapshot));
+  } else {
+    published_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Pairs with the fence in dispatcher_thread: either the dispatcher sees this
+  // snapshot before parking, or we see it parked and wake it
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (consumer_parked_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    park_cv_.notify_one();
+  }
+}
+
+void OrderUpdateDispatcher::overflow(OrderSnapshot snapshot) {
+  std::lock_guard<std::mutex> lock(overflow_mutex_);
+  auto inserted = overflow_index_.emplace(snapshot->client_order_id, overflow_.size());
+  if (inserted.second) {
+    overflow_.push_back(std::move(snapshot));
+    published_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    overflow_[inserted.first->second] = std::move(snapshot);
+    coalesced_.fetch_add(1, std::memory_order_relaxed);
+  }
+  overflowing_.store(true, std::memory_order_release);
+}
+
+bool OrderUpdateDispatcher::take_overflow(std::vector<OrderSnapshot>& out) {
+  std::lock_guard<std::mutex> lock(overflow_mutex_);
+  if (overflow_.empty()) {
+    return false;
+  }
+  out.swap(overflow_);
+  overflow_index_.clear();
+  overflowing_.store(false, std::memory_order_release);
+  return true;
+}
+
+void OrderUpdateDispatcher::stop() {
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+  if (!running_.exchange(false)) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> park_lock(park_mutex_);
+    park_cv_.notify_one();
+  }
+
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+bool OrderUpdateDispatcher::wait_idle(std::chrono::milliseconds timeout) const {
+  uint64_t target = published_.load(std::memory_order_relaxed);
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (dispatched_.load(std::memory_order_acquire) < target) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  return true;
+}
+
+std::vector<OrderUpdateDispatcher::SubscriberStats>
+OrderUpdateDispatcher::subscriber_stats() const {
+  std::shared_ptr<const SubscriberList> subscribers;
+  {
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    subscribers = subscribers_;
+  }
+
+  uint64_t published = published_.load(std::memory_order_relaxed);
+  std::vector<SubscriberStats> stats;
+  stats.reserve(subscribers->size());
+  for (const auto& subscriber : *subscribers) {
+    SubscriberStats s;
+    s.id = subscriber->id;
+    s.delivered = subscriber->delivered.load(std::memory_order_relaxed);
+    s.failures = subscriber->failures.load(std::memory_order_relaxed);
+    // Snapshots already queued when the subscriber joined may also reach it
+    uint64_t expected = published - subscriber->published_at_subscribe;
+    s.lag = expected > s.delivered ? expected - s.delivered : 0;
+    stats.push_back(s);
+  }
+  return stats;
+}
+
+void OrderUpdateDispatcher::dispatcher_thread() {
+  std::shared_ptr<const SubscriberList> subscribers;
+  uint64_t seen_version = ~uint64_t(0);
+  OrderSnapshot snapshot;
+  int idle_spins = 0;
+
+  auto refresh = [&] {
+    uint64_t version = version_.load(std::memory_order_acquire);
+    if (version != seen_version) {
+      std::lock_guard<std::mutex> lock(subscribers_mutex_);
+      subscribers = subscribers_;
+      seen_version = version;
+    }
+  };
+
+  // The ring only holds snapshots published before the overflow began, so
+  // the overflow is delivered once the ring is empty
+  std::vector<OrderSnapshot> overflowed;
+  auto deliver_overflow = [&] {
+    if (!overflowing_.load(std::memory_order_acquire) || !take_overflow(overflowed)) {
+      return false;
+    }
+    refresh();
+    for (const OrderSnapshot& overflowed_snapshot : overflowed) {
+      deliver(overflowed_snapshot, *subscribers);
+    }
+    overflowed.clear();
+    return true;
+  };
+
+  while (running_.load(std::memory_order_relaxed)) {
+    if (ring_.try_pop(snapshot)) {
+      refresh();
+      deliver(snapshot, *subscribers);
+      snapshot.reset();
+      idle_spins = 0;
+      continue;
+    }
+    if (deliver_overflow()) {
+      idle_spins = 0;
+      continue;
+    }
+
+    // Spin briefly before parking so bursts don't pay for a wakeup
+    if (++idle_spins < kSpinIterations) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    consumer_parked_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring_.empty() && !overflowing_.load(std::memory_order_relaxed) &&
+        running_.load(std::memory_order_relaxed)) {
+      park_cv_.wait_for(lock, kParkTimeout);
+    }
+    consumer_parked_.store(false, std::memory_order_relaxed);
+    idle_spins = 0;
+  }
+
+  // Deliver what was published before stop()
+  do {
+    while (ring_.try_pop(snapshot)) {
+      refresh();
+      deliver(snapshot, *subscribers);
+    }
+  } while (deliver_overflow());
+}
+
+void OrderUpdateDispatcher::deliver(const OrderSnapshot& snapshot,
+                                    const SubscriberList& subscribers) {
+  for (const auto& subscriber : subscribers) {
+    try {
+      subscriber->callback(*snapshot);
+    } catch (...) {
+      // A throwing subscriber must not take the dispatcher down with it
+      subscriber->failures.fetch_add(1, std::memory_order_relaxed);
+    }
+    subscriber->delivered.fetch_add(1, std::memory_order_relaxed);
+  }
+  dispatched_.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace pulseexec
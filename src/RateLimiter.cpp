@@ -0,0 +1,106 @@
+#include "pulseexec/RateLimiter.hpp"
+#include <algorithm>
+
+namespace pulseexec {
+
+static int64_t steady_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+RateLimiter::RateLimiter() : RateLimiter(Config()) {}
+
+RateLimiter::RateLimiter(const Config& config)
+    : max_wait_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(config.max_wait).count()) {
+  configure(bucket(Pool::MATCHING_ENGINE), config.matching_engine);
+  configure(bucket(Pool::NON_MATCHING), config.non_matching);
+}
+
+void RateLimiter::configure(Bucket& bucket, const PoolConfig& config) {
+  bucket.capacity = config.capacity;
+  if (config.refill_per_sec <= 0) {
+    return;
+  }
+  bucket.ns_per_credit = std::max<int64_t>(1, 1000000000 / config.refill_per_sec);
+  bucket.cost_ns = config.cost * bucket.ns_per_credit;
+  bucket.burst_ns = config.capacity * bucket.ns_per_credit;
+}
+
+RateLimiter::Pool RateLimiter::pool_for(std::string_view endpoint) {
+  endpoint = endpoint.substr(0, endpoint.find('?'));
+  size_t prefix = endpoint.rfind("/private/");
+  if (prefix == std::string_view::npos) {
+    return Pool::NON_MATCHING;
+  }
+
+  // Order entry and its variants (edit_by_label, cancel_all_by_instrument, ...)
+  std::string_view method = endpoint.substr(prefix + 9);
+  if (method == "buy" || method == "sell" || method == "close_position" ||
+      method == "mass_quote" || method.substr(0, 4) == "edit" || method.substr(0, 6) == "cancel") {
+    return Pool::MATCHING_ENGINE;
+  }
+  return Pool::NON_MATCHING;
+}
+
+bool RateLimiter::acquire(Pool pool, std::chrono::microseconds& wait) {
+  Bucket& b = bucket(pool);
+  wait = std::chrono::microseconds(0);
+  if (b.ns_per_credit == 0) {
+    return true;
+  }
+
+  int64_t now = steady_now_ns();
+  int64_t full_at = b.full_at_ns.load(std::memory_order_relaxed);
+  int64_t shortfall_ns = 0;
+  int64_t next = 0;
+  do {
+    // Taking the credits pushes the time the pool is full again further out;
+    // more than a whole pool's refill away means they are not there yet
+    next = std::max(full_at, now) + b.cost_ns;
+    shortfall_ns = next - now - b.burst_ns;
+    if (shortfall_ns > max_wait_ns_) {
+      b.rejected.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  } while (!b.full_at_ns.compare_exchange_weak(full_at, next, std::memory_order_relaxed));
+
+  if (shortfall_ns > 0) {
+    wait = std::chrono::microseconds((shortfall_ns + 999) / 1000);
+    b.delayed.fetch_add(1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+void RateLimiter::on_rate_limited(Pool pool) {
+  Bucket& b = bucket(pool);
+  b.exchange_rejections.fetch_add(1, std::memory_order_relaxed);
+  if (b.ns_per_credit == 0) {
+    return;
+  }
+
+  int64_t empty_until = steady_now_ns() + b.burst_ns;
+  int64_t full_at = b.full_at_ns.load(std::memory_order_relaxed);
+  while (full_at < empty_until &&
+         !b.full_at_ns.compare_exchange_weak(full_at, empty_until, std::memory_order_relaxed)) {
+  }
+}
+
+RateLimiter::Credits RateLimiter::credits(Pool pool) const {
+  const Bucket& b = bucket(pool);
+  Credits out;
+  out.capacity = b.capacity;
+  out.available = b.capacity;
+  out.delayed = b.delayed.load(std::memory_order_relaxed);
+  out.rejected = b.rejected.load(std::memory_order_relaxed);
+  out.exchange_rejections = b.exchange_rejections.load(std::memory_order_relaxed);
+  if (b.ns_per_credit != 0) {
+    int64_t owed_ns = b.full_at_ns.load(std::memory_order_relaxed) - steady_now_ns();
+    if (owed_ns > 0) {
+      out.available -= (owed_ns + b.ns_per_credit - 1) / b.ns_per_credit;
+    }
+  }
+  return out;
+}
+
+} // namespace pulseexec
@@ -0,0 +1,554 @@
+#include "pulseexec/SessionRecorder.hpp"
+#include "pulseexec/DeribitCodec.hpp"
+#include "pulseexec/Logger.hpp"
+#include "pulseexec/MarketDataFeed.hpp"
+#include "pulseexec/OrderManager.hpp"
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+namespace pulseexec {
+
+static constexpr char kMagic[8] = {'P', 'X', 'S', 'E', 'S', 'S', '0', '1'};
+static constexpr size_t kStdioBufferBytes = 1 << 20;
+
+// Bounds on what a crash can lose from the stdio buffer
+static constexpr uint64_t kFlushEveryRecords = 256;
+static constexpr std::chrono::milliseconds kFlushInterval(100);
+
+// Larger records are taken to be corruption rather than data
+static constexpr uint32_t kMaxRecordBytes = 256u << 20;
+
+// Record encoding. Integers are LEB128 varints (signed ones zigzagged first);
+// prices and quantities keep their exact mantissa and decimals.
+
+static void put_varint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+static void put_signed(std::string& out, int64_t value) {
+  put_varint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+static void put_string(std::string& out, std::string_view s) {
+  put_varint(out, s.size());
+  out.append(s.data(), s.size());
+}
+
+template <typename Tag> static void put_fixed(std::string& out, FixedPoint<Tag> value) {
+  put_signed(out, value.mantissa());
+  out.push_back(static_cast<char>(value.decimals()));
+}
+
+static void put_order(std::string& out, const Order& order) {
+  put_signed(out, order.created_ts_us);
+  put_fixed(out, order.request.price);
+  put_fixed(out, order.request.amount);
+  put_fixed(out, order.filled_amount);
+  out.push_back(static_cast<char>(order.request.side));
+  out.push_back(static_cast<char>(order.request.type));
+  out.push_back(static_cast<char>(order.state));
+  put_string(out, order.client_order_id);
+  put_string(out, order.exchange_order_id);
+  put_string(out, order.request.symbol);
+  put_string(out, order.error_message);
+}
+
+namespace {
+
+struct Reader {
+  const char* p;
+  const char* end;
+
+  bool get_varint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+      auto byte = static_cast<uint8_t>(*p++);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool get_signed(int64_t& value) {
+    uint64_t raw = 0;
+    if (!get_varint(raw)) {
+      return false;
+    }
+    value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+    return true;
+  }
+
+  bool get_byte(uint8_t& value) {
+    if (p == end) {
+      return false;
+    }
+    value = static_cast<uint8_t>(*p++);
+    return true;
+  }
+
+  bool get_string(std::string& s) {
+    uint64_t len = 0;
+    if (!get_varint(len) || static_cast<uint64_t>(end - p) < len) {
+      return false;
+    }
+    s.assign(p, len);
+    p += len;
+    return true;
+  }
+
+  template <typename Tag> bool get_fixed(FixedPoint<Tag>& value) {
+    int64_t mantissa = 0;
+    uint8_t decimals = 0;
+    if (!get_signed(mantissa) || !get_byte(decimals)) {
+      return false;
+    }
+    value = FixedPoint<Tag>::from_mantissa(mantissa, decimals);
+    return true;
+  }
+
+  bool get_order(Order& order) {
+    uint8_t side = 0;
+    uint8_t type = 0;
+    uint8_t state = 0;
+    bool ok = get_signed(order.created_ts_us) && get_fixed(order.request.price) &&
+              get_fixed(order.request.amount) && get_fixed(order.filled_amount) &&
+              get_byte(side) && get_byte(type) && get_byte(state) &&
+              get_string(order.client_order_id) && get_string(order.exchange_order_id) &&
+              get_string(order.request.symbol) && get_string(order.error_message);
+    if (!ok) {
+      return false;
+    }
+    order.request.side = static_cast<Side>(side);
+    order.request.type = static_cast<OrderType>(type);
+    order.state = static_cast<OrderState>(state);
+    order.request.client_order_id = order.client_order_id;
+    order.last_update_ts_us = order.created_ts_us;
+    return true;
+  }
+};
+
+} // namespace
+
+static bool decode_event(const std::string& record, SessionEvent& event, int64_t& ts_us) {
+  Reader in{record.data(), record.data() + record.size()};
+  uint8_t type = 0;
+  uint64_t delta_us = 0;
+  if (!in.get_byte(type) || !in.get_varint(delta_us)) {
+    return false;
+  }
+  ts_us += static_cast<int64_t>(delta_us);
+  event.type = static_cast<SessionEventType>(type);
+  event.ts_us = ts_us;
+
+  switch (event.type) {
+  case SessionEventType::FEED_SUBSCRIBE:
+    return in.get_string(event.text) && in.get_byte(event.scale.price_decimals) &&
+           in.get_byte(event.scale.qty_decimals) && in.get_fixed(event.scale.tick_size) &&
+           in.get_fixed(event.scale.lot_size);
+  case SessionEventType::MARKET_DATA:
+    return in.get_string(event.text);
+  case SessionEventType::GATEWAY_RESPONSE: {
+    int64_t http_status = 0;
+    uint8_t success = 0;
+    bool ok = in.get_string(event.endpoint) && in.get_signed(http_status) &&
+              in.get_byte(success) && in.get_string(event.text);
+    event.http_status = static_cast<int>(http_status);
+    event.success = success != 0;
+    return ok;
+  }
+  case SessionEventType::ORDER_CREATE:
+  case SessionEventType::ORDER_UPDATE:
+  case SessionEventType::ORDER_RESTORE:
+    event.order = Order();
+    return in.get_order(event.order);
+  }
+  return false;
+}
+
+SessionRecorder::SessionRecorder(const std::string& path, std::shared_ptr<Logger> logger)
+    : path_(path), logger_(logger) {}
+
+SessionRecorder::~SessionRecorder() { close(); }
+
+bool SessionRecorder::open() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_) {
+    return true;
+  }
+
+  file_ = std::fopen(path_.c_str(), "wb");
+  if (!file_) {
+    if (logger_) {
+      logger_->log_error("SessionRecorder",
+                         "Failed to open " + path_ + ": " + std::strerror(errno));
+    }
+    return false;
+  }
+  std::setvbuf(file_, nullptr, _IOFBF, kStdioBufferBytes);
+  failed_ = false;
+
+  auto start_wall_us = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  if (std::fwrite(kMagic, 1, sizeof(kMagic), file_) != sizeof(kMagic) ||
+      std::fwrite(&start_wall_us, 1, sizeof(start_wall_us), file_) != sizeof(start_wall_us)) {
+    fail_locked("write");
+    return false;
+  }
+
+  start_ = std::chrono::steady_clock::now();
+  last_ts_us_ = 0;
+  event_count_ = 0;
+  bytes_written_ = sizeof(kMagic) + sizeof(start_wall_us);
+  unflushed_records_ = 0;
+
+  flusher_stop_ = false;
+  flusher_ = std::thread([this] { flush_loop(); });
+  return true;
+}
+
+void SessionRecorder::close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flusher_stop_ = true;
+  }
+  flush_cv_.notify_all();
+  if (flusher_.joinable()) {
+    flusher_.join();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_) {
+    return;
+  }
+  if (std::fclose(file_) != 0) {
+    failed_ = true;
+    if (logger_) {
+      logger_->log_error("SessionRecorder",
+                         "Failed to flush " + path_ + ": " + std::strerror(errno));
+    }
+  }
+  file_ = nullptr;
+}
+
+bool SessionRecorder::failed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return failed_;
+}
+
+void SessionRecorder::flush_loop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!flusher_stop_) {
+    flush_cv_.wait_for(lock, kFlushInterval, [this] { return flusher_stop_; });
+    if (file_ && unflushed_records_ > 0) {
+      flush_locked();
+    }
+  }
+}
+
+void SessionRecorder::flush_locked() {
+  if (std::fflush(file_) != 0) {
+    fail_locked("flush");
+    return;
+  }
+  unflushed_records_ = 0;
+}
+
+void SessionRecorder::fail_locked(const char* what) {
+  // Later records could not be read back past the gap, so stop recording
+  failed_ = true;
+  if (logger_) {
+    logger_->log_error("SessionRecorder", std::string("Failed to ") + what + " " + path_ + ": " +
+                                              std::strerror(errno) + "; recording stopped");
+  }
+  std::fclose(file_);
+  file_ = nullptr;
+}
+
+bool SessionRecorder::is_open() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return file_ != nullptr;
+}
+
+void SessionRecorder::begin_record(SessionEventType type) {
+  // The timestamp is taken under the lock so deltas are never negative
+  auto ts_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start_)
+                   .count();
+
+  record_.assign(sizeof(uint32_t), '\0'); // Length, filled in by end_record
+  record_.push_back(static_cast<char>(type));
+  put_varint(record_, static_cast<uint64_t>(ts_us - last_ts_us_));
+  last_ts_us_ = ts_us;
+}
+
+void SessionRecorder::end_record() {
+  auto length = static_cast<uint32_t>(record_.size() - sizeof(uint32_t));
+  std::memcpy(&record_[0], &length, sizeof(length));
+  if (std::fwrite(record_.data(), 1, record_.size(), file_) != record_.size()) {
+    fail_locked("write");
+    return;
+  }
+  ++event_count_;
+  bytes_written_ += record_.size();
+  if (++unflushed_records_ >= kFlushEveryRecords) {
+    flush_locked();
+  }
+}
+
+void SessionRecorder::record_feed_subscribe(const std::string& instrument,
+                                            const InstrumentScale& scale) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_) {
+    return;
+  }
+  begin_record(SessionEventType::FEED_SUBSCRIBE);
+  put_string(record_, instrument);
+  record_.push_back(static_cast<char>(scale.price_decimals));
+  record_.push_back(static_cast<char>(scale.qty_decimals));
+  put_fixed(record_, scale.tick_size);
+  put_fixed(record_, scale.lot_size);
+  end_record();
+}
+
+void SessionRecorder::record_market_data(std::string_view text) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_) {
+    return;
+  }
+  begin_record(SessionEventType::MARKET_DATA);
+  put_string(record_, text);
+  end_record();
+}
+
+void SessionRecorder::record_gateway_response(const std::string& endpoint, int http_status,
+                                              bool success, const std::string& body) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_) {
+    return;
+  }
+  begin_record(SessionEventType::GATEWAY_RESPONSE);
+  put_string(record_, endpoint);
+  put_signed(record_, http_status);
+  record_.push_back(success ? 1 : 0);
+  put_string(record_, body);
+  end_record();
+}
+
+void SessionRecorder::record_order_create(const Order& order) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_) {
+    return;
+  }
+  begin_record(SessionEventType::ORDER_CREATE);
+  put_order(record_, order);
+  end_record();
+}
+
+void SessionRecorder::record_order_update(const std::string& client_order_id, OrderState state,
+                                          const std::string& exchange_order_id,
+                                          Qty filled_amount, const std::string& error_msg) {
+  // The command's arguments, not the resulting order: an exchange ID that did
+  // not overwrite an existing one is still part of what happened
+  Order order;
+  order.client_order_id = client_order_id;
+  order.state = state;
+  order.exchange_order_id = exchange_order_id;
+  order.filled_amount = filled_amount;
+  order.error_message = error_msg;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_) {
+    return;
+  }
+  begin_record(SessionEventType::ORDER_UPDATE);
+  put_order(record_, order);
+  end_record();
+}
+
+void SessionRecorder::record_order_restore(const Order& order) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_) {
+    return;
+  }
+  begin_record(SessionEventType::ORDER_RESTORE);
+  put_order(record_, order);
+  end_record();
+}
+
+uint64_t SessionRecorder::event_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return event_count_;
+}
+
+uint64_t SessionRecorder::bytes_written() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_written_;
+}
+
+SessionReader::SessionReader(const std::string& path) : path_(path) {}
+
+SessionReader::~SessionReader() {
+  if (file_) {
+    std::fclose(file_);
+  }
+}
+
+bool SessionReader::open() {
+  file_ = std::fopen(path_.c_str(), "rb");
+  if (!file_) {
+    return false;
+  }
+  std::setvbuf(file_, nullptr, _IOFBF, kStdioBufferBytes);
+
+  char magic[sizeof(kMagic)];
+  uint64_t start_wall_us = 0;
+  if (std::fread(magic, 1, sizeof(magic), file_) != sizeof(magic) ||
+      std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      std::fread(&start_wall_us, 1, sizeof(start_wall_us), file_) != sizeof(start_wall_us)) {
+    std::fclose(file_);
+    file_ = nullptr;
+    return false;
+  }
+  start_wall_us_ = static_cast<int64_t>(start_wall_us);
+  return true;
+}
+
+bool SessionReader::next(SessionEvent& event) {
+  if (!file_ || truncated_) {
+    return false;
+  }
+
+  uint32_t length = 0;
+  size_t got = std::fread(&length, 1, sizeof(length), file_);
+  if (got == 0) {
+    return false; // Clean end
+  }
+  if (got != sizeof(length) || length > kMaxRecordBytes) {
+    truncated_ = true;
+    return false;
+  }
+
+  record_.resize(length);
+  if (std::fread(&record_[0], 1, length, file_) != length ||
+      !decode_event(record_, event, ts_us_)) {
+    truncated_ = true;
+    return false;
+  }
+  return true;
+}
+
+SessionReplayer::SessionReplayer(std::shared_ptr<Logger> logger,
+                                 std::shared_ptr<OrderManager> order_manager,
+                                 std::shared_ptr<MarketDataFeed> feed)
+    : logger_(logger), order_manager_(order_manager), feed_(feed) {}
+
+bool SessionReplayer::run(const std::string& path, double speed, ReplayStats& stats) {
+  stats = ReplayStats();
+
+  SessionReader reader(path);
+  if (!reader.open()) {
+    if (logger_) {
+      logger_->log_error("SessionReplayer", "Not a session recording: " + path);
+    }
+    return false;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  SessionEvent event;
+  while (reader.next(event)) {
+    if (speed > 0) {
+      auto due = start + std::chrono::microseconds(static_cast<int64_t>(event.ts_us / speed));
+      std::this_thread::sleep_until(due);
+    }
+    apply(event, stats);
+    ++stats.events;
+    stats.recorded_us = event.ts_us;
+  }
+
+  stats.truncated = reader.truncated();
+  stats.elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  if (stats.truncated && logger_) {
+    logger_->log_warning("SessionReplayer", "Recording ends in a torn record after " +
+                                                std::to_string(stats.events) + " events");
+  }
+  return true;
+}
+
+void SessionReplayer::apply(const SessionEvent& event, ReplayStats& stats) {
+  switch (event.type) {
+  case SessionEventType::FEED_SUBSCRIBE:
+    if (feed_) {
+      feed_->subscribe(event.text, event.scale);
+    }
+    break;
+
+  case SessionEventType::MARKET_DATA:
+    ++stats.market_data;
+    if (feed_) {
+      feed_->process_message(event.text);
+    }
+    break;
+
+  case SessionEventType::GATEWAY_RESPONSE: {
+    // Run the body through the parser the gateway would have used
+    ++stats.gateway_responses;
+    ExecutionResult result;
+    if (event.endpoint.find("/private/buy") != std::string::npos ||
+        event.endpoint.find("/private/sell") != std::string::npos) {
+      result = deribit::parse_place_order_response(event.http_status, event.success, event.text);
+    } else if (event.endpoint.find("/get_order_state") != std::string::npos) {
+      Order order;
+      result = deribit::parse_order_state_response(event.http_status, event.success, event.text,
+                                                   order);
+    } else {
+      result.success = event.success;
+    }
+    if (!result.success) {
+      ++stats.gateway_errors;
+    }
+    break;
+  }
+
+  case SessionEventType::ORDER_CREATE: {
+    ++stats.order_commands;
+    if (order_manager_) {
+      OrderRequest request = event.order.request;
+      request.client_order_id = event.order.client_order_id;
+      if (order_manager_->create_order(request) == kInvalidOrderHandle) {
+        ++stats.commands_failed;
+      }
+    }
+    break;
+  }
+
+  case SessionEventType::ORDER_UPDATE:
+    ++stats.order_commands;
+    if (order_manager_ &&
+        !order_manager_->update_order(event.order.client_order_id, event.order.state,
+                                      event.order.exchange_order_id, event.order.filled_amount,
+                                      event.order.error_message)) {
+      ++stats.commands_failed;
+    }
+    break;
+
+  case SessionEventType::ORDER_RESTORE:
+    ++stats.order_commands;
+    if (order_manager_ && order_manager_->restore_orders({event.order}).empty()) {
+      ++stats.commands_failed;
+    }
+    break;
+  }
+}
+
+} // namespace pulseexec
@@ -1,8 +1,393 @@
 #include "pulseexec/WebSocketServer.hpp"
+#include "pulseexec/Logger.hpp"
+#include <algorithm>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <nlohmann/json.hpp>
 
-// Placeholder implementation
 namespace pulseexec {
 
-// TODO: Implement WebSocketServer
+namespace beast = boost::beast;
+namespace net = boost::asio;
+namespace websocket = beast::websocket;
+using tcp = net::ip::tcp;
+using json = nlohmann::json;
+
+SendQueue::PushResult SendQueue::push(SharedMessage message) {
+  if (messages_.size() < capacity_) {
+    messages_.push_back(std::move(message));
+    return PushResult::QUEUED;
+  }
+
+  if (policy_ == SlowConsumerPolicy::CONFLATE && !message->topic.empty()) {
+    // Newest queued message for the topic takes the new value; the in-flight
+    // front is off limits
+    size_t first = writing_ ? 1 : 0;
+    for (size_t i = messages_.size(); i-- > first;) {
+      if (messages_[i]->topic == message->topic) {
+        messages_[i] = std::move(message);
+        return PushResult::CONFLATED;
+      }
+    }
+  }
+  return PushResult::FULL;
+}
+
+const SharedMessage& SendQueue::begin_write() {
+  writing_ = true;
+  return messages_.front();
+}
+
+void SendQueue::end_write() {
+  messages_.pop_front();
+  writing_ = false;
+}
+
+// One client connection. Everything except deliver() and close() runs on the
+// session's strand.
+class WebSocketServer::Session : public std::enable_shared_from_this<Session> {
+public:
+  Session(tcp::socket&& socket, WebSocketServer& server)
+      : ws_(std::move(socket)), server_(server),
+        queue_(server.options_.max_queued_messages, server.options_.slow_consumer_policy) {}
+
+  void start() {
+    net::dispatch(ws_.get_executor(), [self = shared_from_this()] { self->accept(); });
+  }
+
+  // Any thread
+  void deliver(SharedMessage message) {
+    net::post(ws_.get_executor(), [self = shared_from_this(), message = std::move(message)]() {
+      self->enqueue(message);
+    });
+  }
+
+  // Any thread
+  void close() {
+    net::post(ws_.get_executor(), [self = shared_from_this()] { self->shutdown(); });
+  }
+
+  // Strand only
+  const std::vector<std::string>& topics() const { return topics_; }
+
+private:
+  void accept() {
+    ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
+    ws_.async_accept([self = shared_from_this()](beast::error_code ec) {
+      if (ec) {
+        return self->shutdown();
+      }
+      self->read_next();
+    });
+  }
+
+  void read_next() {
+    ws_.async_read(buffer_, [self = shared_from_this()](beast::error_code ec, size_t) {
+      // A read may complete just before the session is shut down; drop it
+      if (ec || self->closed_) {
+        return self->shutdown();
+      }
+      self->handle_request(beast::buffers_to_string(self->buffer_.data()));
+      self->buffer_.consume(self->buffer_.size());
+      self->read_next();
+    });
+  }
+
+  void handle_request(const std::string& text) {
+    json request = json::parse(text, nullptr, false);
+    json response = {{"jsonrpc", "2.0"}};
+    if (request.is_discarded() || !request.is_object()) {
+      response["id"] = nullptr;
+      response["error"] = {{"code", -32700}, {"message", "Parse error"}};
+      return reply(response);
+    }
+    response["id"] = request.value("id", json());
+
+    std::string method = request.value("method", "");
+    if (method != "subscribe" && method != "unsubscribe") {
+      response["error"] = {{"code", -32601}, {"message", "Method not found"}};
+      return reply(response);
+    }
+
+    json topics = json::array();
+    auto params = request.find("params");
+    if (params != request.end() && params->is_object() && params->contains("topics")) {
+      for (const auto& topic : (*params)["topics"]) {
+        if (!topic.is_string()) {
+          continue;
+        }
+        const auto& name = topic.get_ref<const std::string&>();
+        auto known = std::find(topics_.begin(), topics_.end(), name);
+        if (method == "subscribe" && known == topics_.end()) {
+          topics_.push_back(name);
+          server_.subscribe(shared_from_this(), name);
+        } else if (method == "unsubscribe" && known != topics_.end()) {
+          topics_.erase(known);
+          server_.unsubscribe(shared_from_this(), name);
+        }
+        topics.push_back(name);
+      }
+    }
+    response["result"] = topics;
+    reply(response);
+  }
+
+  // Responses have no topic, so they are never conflated
+  void reply(const json& response) {
+    auto message = std::make_shared<OutboundMessage>();
+    message->text = response.dump();
+    enqueue(message);
+  }
+
+  void enqueue(const SharedMessage& message) {
+    if (closed_) {
+      return;
+    }
+
+    switch (queue_.push(message)) {
+    case SendQueue::PushResult::QUEUED:
+      server_.frames_queued_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case SendQueue::PushResult::CONFLATED:
+      server_.frames_conflated_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case SendQueue::PushResult::FULL:
+      server_.slow_consumer_disconnects_.fetch_add(1, std::memory_order_relaxed);
+      if (server_.logger_) {
+        server_.logger_->log_warning("WebSocketServer",
+                                     "Disconnecting slow consumer with " +
+                                         std::to_string(queue_.size()) + " queued messages");
+      }
+      return shutdown();
+    }
+
+    if (!queue_.writing()) {
+      write_next();
+    }
+  }
+
+  void write_next() {
+    const SharedMessage& message = queue_.begin_write();
+    ws_.text(true);
+    ws_.async_write(net::buffer(message->text),
+                    [self = shared_from_this()](beast::error_code ec, size_t) {
+                      if (ec) {
+                        return self->shutdown();
+                      }
+                      self->queue_.end_write();
+                      self->server_.frames_sent_.fetch_add(1, std::memory_order_relaxed);
+                      if (!self->queue_.empty()) {
+                        self->write_next();
+                      }
+                    });
+  }
+
+  void shutdown() {
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+    server_.remove_session(shared_from_this());
+
+    beast::error_code ec;
+    auto& socket = beast::get_lowest_layer(ws_).socket();
+    socket.shutdown(tcp::socket::shutdown_both, ec);
+    socket.close(ec);
+  }
+
+  websocket::stream<beast::tcp_stream> ws_;
+  WebSocketServer& server_;
+  beast::flat_buffer buffer_;
+  SendQueue queue_;
+  std::vector<std::string> topics_;
+  bool closed_ = false;
+};
+
+WebSocketServer::WebSocketServer(const std::string& address, uint16_t port,
+                                 std::shared_ptr<Logger> logger,
+                                 const WebSocketServerOptions& options)
+    : address_(address), port_(port), logger_(std::move(logger)), options_(options) {}
+
+WebSocketServer::~WebSocketServer() { stop(); }
+
+bool WebSocketServer::start() {
+  if (running_.load()) {
+    return true;
+  }
+
+  beast::error_code ec;
+  auto fail = [&](const std::string& what) {
+    if (logger_) {
+      logger_->log_error("WebSocketServer", what + " " + address_ + ":" + std::to_string(port_) +
+                                                ": " + ec.message());
+    }
+    acceptor_.reset();
+    return false;
+  };
+
+  tcp::endpoint endpoint(net::ip::make_address(address_, ec), port_);
+  if (ec) {
+    return fail("Invalid address");
+  }
+
+  acceptor_ = std::make_unique<tcp::acceptor>(net::make_strand(io_));
+  acceptor_->open(endpoint.protocol(), ec);
+  if (!ec) {
+    acceptor_->set_option(net::socket_base::reuse_address(true), ec);
+  }
+  if (!ec) {
+    acceptor_->bind(endpoint, ec);
+  }
+  if (!ec) {
+    acceptor_->listen(net::socket_base::max_listen_connections, ec);
+  }
+  if (ec) {
+    return fail("Cannot listen on");
+  }
+  bound_port_ = acceptor_->local_endpoint().port();
+
+  running_ = true;
+  io_.restart();
+  work_guard_ = std::make_unique<net::executor_work_guard<net::io_context::executor_type>>(
+      io_.get_executor());
+  accept_next();
+  for (size_t i = 0; i < std::max<size_t>(options_.io_threads, 1); ++i) {
+    io_threads_.emplace_back([this] { io_.run(); });
+  }
+
+  if (logger_) {
+    logger_->log_info("WebSocketServer", "Listening on " + address_ + ":" +
+                                             std::to_string(bound_port_));
+  }
+  return true;
+}
+
+void WebSocketServer::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+
+  // Accept completions run on the acceptor's strand, so once the acceptor is
+  // closed there no session can register behind the snapshot taken here
+  net::post(acceptor_->get_executor(), [this] {
+    beast::error_code ec;
+    acceptor_->close(ec);
+
+    std::shared_lock<std::shared_mutex> lock(sessions_mutex_);
+    for (const auto& [ptr, session] : sessions_) {
+      session->close();
+    }
+  });
+
+  // Closed sockets abort every pending operation, so the threads run out of work
+  work_guard_.reset();
+  for (auto& thread : io_threads_) {
+    thread.join();
+  }
+  io_threads_.clear();
+  acceptor_.reset();
+
+  std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+  subscribers_.clear();
+  sessions_.clear();
+}
+
+size_t WebSocketServer::publish(const std::string& topic, std::string_view data_json) {
+  auto message = std::make_shared<OutboundMessage>();
+  message->topic = topic;
+  message->text.reserve(data_json.size() + topic.size() + 72);
+  message->text += R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":)";
+  message->text += json(topic).dump();
+  message->text += R"(,"data":)";
+  message->text += data_json;
+  message->text += "}}";
+  messages_published_.fetch_add(1, std::memory_order_relaxed);
+
+  SharedMessage shared = std::move(message);
+  std::shared_lock<std::shared_mutex> lock(sessions_mutex_);
+  auto it = subscribers_.find(topic);
+  if (it == subscribers_.end()) {
+    return 0;
+  }
+  for (const auto& session : it->second) {
+    session->deliver(shared);
+  }
+  return it->second.size();
+}
+
+size_t WebSocketServer::subscriber_count(const std::string& topic) const {
+  std::shared_lock<std::shared_mutex> lock(sessions_mutex_);
+  auto it = subscribers_.find(topic);
+  return it == subscribers_.end() ? 0 : it->second.size();
+}
+
+WebSocketServer::Stats WebSocketServer::stats() const {
+  Stats s;
+  s.sessions_accepted = sessions_accepted_.load(std::memory_order_relaxed);
+  {
+    std::shared_lock<std::shared_mutex> lock(sessions_mutex_);
+    s.sessions_active = sessions_.size();
+  }
+  s.messages_published = messages_published_.load(std::memory_order_relaxed);
+  s.frames_queued = frames_queued_.load(std::memory_order_relaxed);
+  s.frames_sent = frames_sent_.load(std::memory_order_relaxed);
+  s.frames_conflated = frames_conflated_.load(std::memory_order_relaxed);
+  s.slow_consumer_disconnects = slow_consumer_disconnects_.load(std::memory_order_relaxed);
+  return s;
+}
+
+void WebSocketServer::accept_next() {
+  acceptor_->async_accept(net::make_strand(io_), [this](beast::error_code ec, tcp::socket socket) {
+    if (ec) {
+      if (running_.load() && ec != net::error::operation_aborted) {
+        if (logger_) {
+          logger_->log_warning("WebSocketServer", "Accept failed: " + ec.message());
+        }
+        accept_next();
+      }
+      return;
+    }
+
+    socket.set_option(tcp::no_delay(true), ec);
+    auto session = std::make_shared<Session>(std::move(socket), *this);
+    {
+      std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+      sessions_.emplace(session.get(), session);
+    }
+    sessions_accepted_.fetch_add(1, std::memory_order_relaxed);
+    session->start();
+    accept_next();
+  });
+}
+
+void WebSocketServer::subscribe(const std::shared_ptr<Session>& session, const std::string& topic) {
+  std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+  subscribers_[topic].push_back(session);
+}
+
+void WebSocketServer::unsubscribe(const std::shared_ptr<Session>& session,
+                                  const std::string& topic) {
+  std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+  auto it = subscribers_.find(topic);
+  if (it == subscribers_.end()) {
+    return;
+  }
+  auto& list = it->second;
+  list.erase(std::remove(list.begin(), list.end(), session), list.end());
+  if (list.empty()) {
+    subscribers_.erase(it);
+  }
+}
+
+void WebSocketServer::remove_session(const std::shared_ptr<Session>& session) {
+  for (const auto& topic : session->topics()) {
+    unsubscribe(session, topic);
+  }
+  std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+  sessions_.erase(session.get());
+}
 
 } // namespace pulseexec
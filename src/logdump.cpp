@@ -0,0 +1,35 @@
+// Decodes a binary structured log (LogOutputFormat::BINARY) into JSON lines.
+//
+// Usage: pulseexec_logdump <log_file>   (reads stdin when no file is given)
+
+#include "pulseexec/LogRecord.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace pulseexec;
+
+int main(int argc, char* argv[]) {
+  std::ifstream file;
+  if (argc > 1) {
+    file.open(argv[1], std::ios::binary);
+    if (!file.is_open()) {
+      std::cerr << "Failed to open log file: " << argv[1] << std::endl;
+      return 1;
+    }
+  }
+  std::istream& in = argc > 1 ? file : std::cin;
+
+  LogRecord record;
+  uint64_t count = 0;
+  while (read_binary_log_record(in, record)) {
+    std::cout << render_log_json(record) << '\n';
+    ++count;
+  }
+
+  if (!in.eof()) {
+    std::cerr << "Stopped at corrupt or truncated record after " << count << " records"
+              << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -1,12 +1,23 @@
 #include "pulseexec/DBWriter.hpp"
 #include "pulseexec/ExecutionGateway.hpp"
+#include "pulseexec/LatencyTracker.hpp"
 #include "pulseexec/Logger.hpp"
+#include "pulseexec/MarketDataFeed.hpp"
+#include "pulseexec/OrderJournal.hpp"
 #include "pulseexec/OrderManager.hpp"
+#include "pulseexec/OrderRecovery.hpp"
+#include "pulseexec/RateLimiter.hpp"
+#include "pulseexec/SessionRecorder.hpp"
+#include "pulseexec/WebSocketServer.hpp"
 #include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <nlohmann/json.hpp>
 #include <sstream>
 
 using namespace pulseexec;
@@ -57,6 +68,17 @@ void print_usage(const char* program_name) {
   std::cout << "    --symbol <SYM>    Symbol (e.g., BTC-PERPETUAL)\n";
   std::cout << "    Example: " << program_name << " get-orderbook --symbol BTC-PERPETUAL\n\n";
 
+  std::cout << "  watch-orderbook   Stream live orderbook updates over WebSocket\n";
+  std::cout << "    --symbol <SYM>    Symbol (e.g., BTC-PERPETUAL)\n";
+  std::cout << "    --seconds <N>     How long to watch (default: 10)\n";
+  std::cout << "    Example: " << program_name << " watch-orderbook --symbol BTC-PERPETUAL\n\n";
+
+  std::cout << "  replay            Replay a session recorded with SESSION_RECORD_PATH offline\n";
+  std::cout << "    --file <PATH>     Recording to replay\n";
+  std::cout << "    --speed <X>       Multiple of recorded speed, or max (default: 1)\n";
+  std::cout << "    --db <PATH>       Scratch DB, recreated (default: ./pulseexec_replay.db)\n";
+  std::cout << "    Example: " << program_name << " replay --file session.bin --speed max\n\n";
+
   std::cout << "  interactive       Start interactive mode\n";
   std::cout << "    Example: " << program_name << " interactive\n\n";
 
@@ -66,8 +88,38 @@ void print_usage(const char* program_name) {
   std::cout << "  DERIBIT_KEY       API key (required)\n";
   std::cout << "  DERIBIT_SECRET    API secret (required)\n";
   std::cout << "  DERIBIT_REST_URL  REST API URL (default: https://test.deribit.com)\n";
+  std::cout << "  DERIBIT_WS_URL    WebSocket URL (default: wss://test.deribit.com/ws/api/v2)\n";
   std::cout << "  DB_PATH           Database path (default: ./pulseexec.db)\n";
-  std::cout << "  LOG_FILE          Log file path (default: ./logs/pulseexec.log)\n\n";
+  std::cout << "  LOG_FILE          Log file path (default: ./logs/pulseexec.log)\n";
+  std::cout << "  LOG_FORMAT        json or binary; decode binary logs with pulseexec_logdump\n";
+  std::cout << "  GATEWAY_POOL_SIZE Pooled REST connections, 0 = per-call (default: 4)\n";
+  std::cout << "  DB_BATCH_SIZE     Max order writes per SQLite transaction (default: 256)\n";
+  std::cout << "  DB_BATCH_LATENCY_US  Max wait to fill a DB batch (default: 1000)\n";
+  std::cout << "  DB_OVERFLOW_POLICY  drop, block or spill when the DB queue is full\n";
+  std::cout << "                    (default: drop); spill appends to <DB_PATH>.spill\n";
+  std::cout << "  DB_BLOCK_TIMEOUT_MS Max wait for queue space under block (default: 100)\n";
+  std::cout << "  JOURNAL_PATH      Journal every order change here before SQLite\n";
+  std::cout << "                    (default: no journal)\n";
+  std::cout << "  JOURNAL_FSYNC     0 to skip the group-commit fsync (default: 1)\n";
+  std::cout << "  JOURNAL_ROTATE_MB Rotate the journal once this much is checkpointed,\n";
+  std::cout << "                    0 = never (default: 256)\n";
+  std::cout << "  JOURNAL_ARCHIVE   1 to keep rotated-out journals as <JOURNAL_PATH>.<seq>\n";
+  std::cout << "  LATENCY_FLUSH_MS  Interval for latency_metrics rows (default: 1000)\n";
+  std::cout << "  ORDER_RETENTION_MS  Keep terminal orders in memory this long, then serve\n";
+  std::cout << "                    them from the database (default: keep forever)\n";
+  std::cout << "  ORDER_RETENTION_MAX Max terminal orders kept in memory (default: unbounded)\n";
+  std::cout << "  RECOVERY_TIMEOUT_MS Max wait for the exchange to confirm recovered open\n";
+  std::cout << "                    orders in interactive mode (default: 10000)\n";
+  std::cout << "  SESSION_RECORD_PATH Record market data, gateway responses and order\n";
+  std::cout << "                    commands here for replay (default: off)\n";
+  std::cout << "  RATE_LIMIT        off to send without client-side rate limiting (default: on)\n";
+  std::cout << "  RATE_LIMIT_ME_RATE  Matching engine requests per second (default: 5)\n";
+  std::cout << "  RATE_LIMIT_ME_BURST Matching engine burst (default: 20)\n";
+  std::cout << "  RATE_LIMIT_MAX_WAIT_MS Max wait for credits before a request is rejected\n";
+  std::cout << "                    locally (default: 50)\n";
+  std::cout << "  WS_SERVER_PORT    Serve order updates (topic orders) and watch-orderbook\n";
+  std::cout << "                    books (book.<symbol>) over WebSocket (default: off)\n";
+  std::cout << "  WS_SERVER_ADDRESS Address the WebSocket server binds (default: 127.0.0.1)\n\n";
 
   std::cout << "EXAMPLES:\n";
   std::cout << "  # Place a BUY order\n";
@@ -80,6 +132,12 @@ void print_usage(const char* program_name) {
   std::cout << "  # Get orderbook\n";
   std::cout << "  " << program_name << " get-orderbook --symbol BTC-PERPETUAL\n\n";
 
+  std::cout << "  # Stream orderbook updates for 30 seconds\n";
+  std::cout << "  " << program_name << " watch-orderbook --symbol BTC-PERPETUAL --seconds 30\n\n";
+
+  std::cout << "  # Replay a recorded session as fast as possible\n";
+  std::cout << "  " << program_name << " replay --file session.bin --speed max\n\n";
+
   std::cout << "  # Interactive mode\n";
   std::cout << "  " << program_name << " interactive\n\n";
 }
@@ -95,6 +153,25 @@ std::string get_arg(int argc, char* argv[], const std::string& option,
   return default_val;
 }
 
+// Parse the integer setting `name` into out, leaving out alone when value is
+// null. False, after reporting why, unless value is a whole number in [min, max].
+template <typename T>
+bool parse_integer(const char* name, const char* value, int64_t min, int64_t max, T& out) {
+  if (!value) {
+    return true;
+  }
+  errno = 0;
+  char* end = nullptr;
+  long long parsed = std::strtoll(value, &end, 10);
+  if (end == value || *end != '\0' || errno == ERANGE || parsed < min || parsed > max) {
+    std::cerr << "❌ Invalid " << name << " '" << value << "': expected a whole number from "
+              << min << " to " << max << "\n";
+    return false;
+  }
+  out = static_cast<T>(parsed);
+  return true;
+}
+
 bool has_arg(int argc, char* argv[], const std::string& option) {
   for (int i = 1; i < argc; ++i) {
     if (std::string(argv[i]) == option) {
@@ -163,10 +240,87 @@ void print_orderbook(const OrderBook& book) {
   std::cout << "BIDS (Buy Orders)\n\n";
 }
 
+// Print per-operation latency percentiles since startup
+void print_latency(const LatencyTracker& tracker) {
+  std::cout << "\n┌────────────────────┬──────────┬──────────┬──────────┬──────────┬──────────┐\n";
+  std::cout << "│ Operation          │ Count    │ p50 us   │ p99 us   │ p999 us  │ Max us   │\n";
+  std::cout << "├────────────────────┼──────────┼──────────┼──────────┼──────────┼──────────┤\n";
+  for (const auto& s : tracker.percentiles()) {
+    std::cout << "│ " << std::left << std::setw(18) << to_string(s.op) << " │ " << std::right
+              << std::setw(8) << s.count << " │ " << std::fixed << std::setprecision(1)
+              << std::setw(8) << s.p50_ns / 1000.0 << " │ " << std::setw(8) << s.p99_ns / 1000.0
+              << " │ " << std::setw(8) << s.p999_ns / 1000.0 << " │ " << std::setw(8)
+              << s.max_ns / 1000.0 << " │\n";
+  }
+  std::cout << "└────────────────────┴──────────┴──────────┴──────────┴──────────┴──────────┘\n";
+  std::cout << std::left << "Open traces: " << tracker.open_traces()
+            << ", dropped: " << tracker.dropped_traces() << "\n";
+}
+
+// The scale orders of symbol are kept on; books are read onto the same one
+InstrumentScale instrument_scale(OrderManager& order_manager, const std::string& symbol) {
+  InstrumentRegistry& instruments = order_manager.instruments();
+  return instruments.scale(instruments.intern(symbol));
+}
+
+// Payload of an "orders" notification from the WebSocket server
+std::string order_update_json(const Order& order) {
+  nlohmann::json j = {{"client_order_id", order.client_order_id},
+                      {"exchange_order_id", order.exchange_order_id},
+                      {"symbol", order.request.symbol},
+                      {"side", to_string(order.request.side)},
+                      {"price", order.request.price.to_double()},
+                      {"amount", order.request.amount.to_double()},
+                      {"order_type", to_string(order.request.type)},
+                      {"state", to_string(order.state)},
+                      {"filled_amount", order.filled_amount.to_double()},
+                      {"last_update_ts_us", order.last_update_ts_us},
+                      {"error_message", order.error_message}};
+  return j.dump();
+}
+
+// Payload of a "book.<symbol>" notification: levels as [price, amount], best first
+std::string book_update_json(const OrderBook& book) {
+  auto levels = [](const std::vector<PriceLevel>& side) {
+    nlohmann::json out = nlohmann::json::array();
+    for (const PriceLevel& level : side) {
+      out.push_back({level.price.to_double(), level.amount.to_double()});
+    }
+    return out;
+  };
+  nlohmann::json j = {{"symbol", book.symbol},
+                      {"timestamp_us", book.timestamp_us},
+                      {"bids", levels(book.bids)},
+                      {"asks", levels(book.asks)}};
+  return j.dump();
+}
+
+void print_db_writer_stats(const DBWriter& db_writer) {
+  DBWriter::Stats stats = db_writer.stats();
+  std::cout << "DB queue depth: " << stats.queue_depth
+            << " (high watermark " << stats.queue_high_watermark << "), spilled: " << stats.spilled
+            << " (" << stats.spill_depth << " pending), blocked: " << stats.blocked
+            << ", dropped: " << stats.dropped << ", failed commits: " << stats.failed_commits
+            << ", lost: " << stats.lost << "\n";
+}
+
+void print_rate_limits(const RateLimiter& rate_limiter) {
+  for (auto pool : {RateLimiter::Pool::MATCHING_ENGINE, RateLimiter::Pool::NON_MATCHING}) {
+    RateLimiter::Credits credits = rate_limiter.credits(pool);
+    std::cout << (pool == RateLimiter::Pool::MATCHING_ENGINE ? "Matching engine" : "Non-matching")
+              << " credits: " << credits.available << "/" << credits.capacity
+              << ", delayed: " << credits.delayed << ", rejected locally: " << credits.rejected
+              << ", exchange 429s: " << credits.exchange_rejections << "\n";
+  }
+}
+
 // Interactive mode
 void interactive_mode(std::shared_ptr<OrderManager> order_manager,
                       std::shared_ptr<ExecutionGateway> gateway,
-                      std::shared_ptr<Logger> logger) {
+                      std::shared_ptr<Logger> logger,
+                      std::shared_ptr<LatencyTracker> latency_tracker,
+                      std::shared_ptr<DBWriter> db_writer,
+                      std::shared_ptr<RateLimiter> rate_limiter) {
 
   std::cout << "\n╔══════════════════════════════════════════════════════════════╗\n";
   std::cout << "║           PulseExec Interactive Mode                         ║\n";
@@ -180,6 +334,7 @@ void interactive_mode(std::shared_ptr<OrderManager> order_manager,
     std::cout << "│ 4. List All Orders                  │\n";
     std::cout << "│ 5. Get Order Details                │\n";
     std::cout << "│ 6. Get OrderBook                    │\n";
+    std::cout << "│ 7. Latency Stats                    │\n";
     std::cout << "│ 0. Exit                             │\n";
     std::cout << "└─────────────────────────────────────┘\n";
     std::cout << "Choice: ";
@@ -219,7 +374,9 @@ void interactive_mode(std::shared_ptr<OrderManager> order_manager,
         OrderType type = parse_order_type(type_str);
 
         OrderRequest req(symbol, side, price, amount, type);
-        std::string order_id = order_manager->create_order(req);
+        OrderHandle handle = order_manager->create_order(req);
+        std::string order_id = order_manager->get_client_order_id(handle);
+        req.client_order_id = order_id; // Sent as the exchange label and latency trace key
 
         std::cout << "\n✅ Order created locally: " << order_id << "\n";
         std::cout << "📡 Submitting to exchange...\n";
@@ -228,10 +385,10 @@ void interactive_mode(std::shared_ptr<OrderManager> order_manager,
 
         if (result.success) {
           std::cout << "✅ Order placed on exchange: " << result.exchange_order_id << "\n";
-          order_manager->update_order(order_id, OrderState::OPEN, result.exchange_order_id);
+          order_manager->update_order(handle, OrderState::OPEN, result.exchange_order_id);
         } else {
           std::cout << "❌ Order rejected: " << result.error_message << "\n";
-          order_manager->update_order(order_id, OrderState::REJECTED, "", 0.0,
+          order_manager->update_order(handle, OrderState::REJECTED, "", Qty(),
                                        result.error_message);
         }
         break;
@@ -275,9 +432,9 @@ void interactive_mode(std::shared_ptr<OrderManager> order_manager,
           std::cout << "No active orders.\n";
         } else {
           for (const auto& order : orders) {
-            std::cout << "• " << order.client_order_id << " | " << order.request.symbol << " | "
-                      << to_string(order.request.side) << " | " << order.request.price << " x "
-                      << order.request.amount << " | " << to_string(order.state) << "\n";
+            std::cout << "• " << order->client_order_id << " | " << order->request.symbol << " | "
+                      << to_string(order->request.side) << " | " << order->request.price << " x "
+                      << order->request.amount << " | " << to_string(order->state) << "\n";
           }
         }
         break;
@@ -292,9 +449,9 @@ void interactive_mode(std::shared_ptr<OrderManager> order_manager,
           std::cout << "No orders found.\n";
         } else {
           for (const auto& order : orders) {
-            std::cout << "• " << order.client_order_id << " | " << order.request.symbol << " | "
-                      << to_string(order.request.side) << " | " << order.request.price << " x "
-                      << order.request.amount << " | " << to_string(order.state) << "\n";
+            std::cout << "• " << order->client_order_id << " | " << order->request.symbol << " | "
+                      << to_string(order->request.side) << " | " << order->request.price << " x "
+                      << order->request.amount << " | " << to_string(order->state) << "\n";
           }
         }
         break;
@@ -325,6 +482,7 @@ void interactive_mode(std::shared_ptr<OrderManager> order_manager,
 
         std::cout << "📡 Fetching orderbook...\n";
         OrderBook book;
+        book.scale = instrument_scale(*order_manager, symbol);
         auto result = gateway->get_orderbook(symbol, book);
 
         if (result.success) {
@@ -335,6 +493,17 @@ void interactive_mode(std::shared_ptr<OrderManager> order_manager,
         break;
       }
 
+      case 7:
+        print_latency(*latency_tracker);
+        print_db_writer_stats(*db_writer);
+        if (order_manager->journal_failures() > 0) {
+          std::cout << "⚠️  Journal append failures: " << order_manager->journal_failures() << "\n";
+        }
+        if (rate_limiter) {
+          print_rate_limits(*rate_limiter);
+        }
+        break;
+
       case 0:
         std::cout << "\n👋 Goodbye!\n";
         return;
@@ -348,6 +517,77 @@ void interactive_mode(std::shared_ptr<OrderManager> order_manager,
   }
 }
 
+// Replay a recorded session: needs no credentials or network, and writes to a
+// scratch database instead of DB_PATH
+int replay_session(int argc, char* argv[]) {
+  std::string file = get_arg(argc, argv, "--file");
+  std::string speed_str = get_arg(argc, argv, "--speed", "1");
+  std::string db_path = get_arg(argc, argv, "--db", "./pulseexec_replay.db");
+  const char* log_file_env = std::getenv("LOG_FILE");
+
+  if (file.empty()) {
+    std::cerr << "❌ Missing required argument: --file\n";
+    return 1;
+  }
+  char* speed_end = nullptr;
+  double speed = speed_str == "max" ? 0.0 : std::strtod(speed_str.c_str(), &speed_end);
+  if (speed_str != "max" && (speed_end == speed_str.c_str() || speed <= 0)) {
+    std::cerr << "❌ Invalid --speed '" << speed_str << "' (a positive multiple or max)\n";
+    return 1;
+  }
+
+  // Recorded client order IDs are reused, so start from an empty database
+  for (const std::string& path : {db_path, db_path + "-wal", db_path + "-shm"}) {
+    std::remove(path.c_str());
+  }
+
+  auto logger =
+      std::make_shared<Logger>(log_file_env ? log_file_env : "./logs/pulseexec.log", 10000);
+  logger->set_min_level(LogLevel::INFO);
+  auto db_writer = std::make_shared<DBWriter>(db_path, logger);
+  // Replay runs faster than the writer when unpaced; wait instead of dropping
+  db_writer->set_overflow_policy(DBOverflowPolicy::BLOCK, std::chrono::milliseconds(1000));
+  auto order_manager = std::make_shared<OrderManager>(logger, db_writer);
+  // Never started: the replayer hands it messages directly
+  auto feed = std::make_shared<MarketDataFeed>("ws://127.0.0.1:1", logger);
+
+  logger->start();
+  db_writer->start();
+
+  std::cout << "⏯️  Replaying " << file << " "
+            << (speed > 0 ? "at " + speed_str + "x recorded speed" : "as fast as possible")
+            << "...\n";
+  SessionReplayer replayer(logger, order_manager, feed);
+  ReplayStats stats;
+  bool ok = replayer.run(file, speed, stats);
+
+  logger->stop();
+  db_writer->stop();
+
+  if (!ok) {
+    std::cout << "❌ Not a session recording: " << file << "\n";
+    return 1;
+  }
+
+  auto feed_stats = feed->stats();
+  double seconds = stats.elapsed_us / 1e6;
+  std::cout << "Events: " << stats.events << " (" << stats.market_data << " market data, "
+            << stats.gateway_responses << " gateway responses, " << stats.order_commands
+            << " order commands)\n";
+  std::cout << "Recorded span: " << stats.recorded_us / 1e6 << "s, replayed in " << seconds
+            << "s (" << (seconds > 0 ? static_cast<int64_t>(stats.events / seconds) : 0)
+            << " events/s)\n";
+  std::cout << "Book updates applied: " << feed_stats.deltas_applied
+            << ", gaps: " << feed_stats.gaps << "\n";
+  std::cout << "Orders: " << order_manager->get_all_orders().size() << " ("
+            << order_manager->get_active_orders().size() << " active), failed commands: "
+            << stats.commands_failed << ", gateway errors: " << stats.gateway_errors << "\n";
+  if (stats.truncated) {
+    std::cout << "⚠️  Recording ends in a torn record; replayed up to it\n";
+  }
+  return 0;
+}
+
 int main(int argc, char* argv[]) {
   // Check for help or no arguments
   if (argc < 2 || has_arg(argc, argv, "help") || has_arg(argc, argv, "--help") ||
@@ -356,12 +596,38 @@ int main(int argc, char* argv[]) {
     return 0;
   }
 
+  if (std::string(argv[1]) == "replay") {
+    return replay_session(argc, argv);
+  }
+
   // Get environment variables
   const char* api_key_env = std::getenv("DERIBIT_KEY");
   const char* api_secret_env = std::getenv("DERIBIT_SECRET");
   const char* rest_url_env = std::getenv("DERIBIT_REST_URL");
+  const char* ws_url_env = std::getenv("DERIBIT_WS_URL");
   const char* db_path_env = std::getenv("DB_PATH");
   const char* log_file_env = std::getenv("LOG_FILE");
+  const char* log_format_env = std::getenv("LOG_FORMAT");
+  const char* pool_size_env = std::getenv("GATEWAY_POOL_SIZE");
+  const char* db_batch_size_env = std::getenv("DB_BATCH_SIZE");
+  const char* db_batch_latency_env = std::getenv("DB_BATCH_LATENCY_US");
+  const char* db_overflow_env = std::getenv("DB_OVERFLOW_POLICY");
+  const char* db_block_timeout_env = std::getenv("DB_BLOCK_TIMEOUT_MS");
+  const char* journal_path_env = std::getenv("JOURNAL_PATH");
+  const char* journal_fsync_env = std::getenv("JOURNAL_FSYNC");
+  const char* journal_rotate_env = std::getenv("JOURNAL_ROTATE_MB");
+  const char* journal_archive_env = std::getenv("JOURNAL_ARCHIVE");
+  const char* latency_flush_env = std::getenv("LATENCY_FLUSH_MS");
+  const char* retention_env = std::getenv("ORDER_RETENTION_MS");
+  const char* retention_max_env = std::getenv("ORDER_RETENTION_MAX");
+  const char* recovery_timeout_env = std::getenv("RECOVERY_TIMEOUT_MS");
+  const char* record_path_env = std::getenv("SESSION_RECORD_PATH");
+  const char* rate_limit_env = std::getenv("RATE_LIMIT");
+  const char* rate_limit_me_rate_env = std::getenv("RATE_LIMIT_ME_RATE");
+  const char* rate_limit_me_burst_env = std::getenv("RATE_LIMIT_ME_BURST");
+  const char* rate_limit_max_wait_env = std::getenv("RATE_LIMIT_MAX_WAIT_MS");
+  const char* ws_server_port_env = std::getenv("WS_SERVER_PORT");
+  const char* ws_server_address_env = std::getenv("WS_SERVER_ADDRESS");
 
   if (!api_key_env || !api_secret_env) {
     std::cerr << "❌ Error: DERIBIT_KEY and DERIBIT_SECRET must be set in environment.\n";
@@ -373,21 +639,173 @@ int main(int argc, char* argv[]) {
   std::string api_key = api_key_env;
   std::string api_secret = api_secret_env;
   std::string rest_url = rest_url_env ? rest_url_env : "https://test.deribit.com";
+  std::string ws_url = ws_url_env ? ws_url_env : "wss://test.deribit.com/ws/api/v2";
   std::string db_path = db_path_env ? db_path_env : "./pulseexec.db";
   std::string log_file = log_file_env ? log_file_env : "./logs/pulseexec.log";
 
+  // Numeric settings are all checked before anything starts
+  constexpr int64_t kMaxMs = 3600 * 1000;
+  size_t pool_size = 4;
+  size_t db_batch_size = 256;
+  int64_t db_batch_latency_us = 1000;
+  int64_t latency_flush_ms = 1000;
+  int64_t db_block_timeout_ms = 100;
+  int64_t retention_ms = INT64_MAX;
+  size_t retention_max = SIZE_MAX;
+  int64_t journal_rotate_mb = -1;
+  int64_t recovery_timeout_ms = 10000;
+  int64_t ws_server_port = 0;
+  RateLimiter::Config limits;
+  int64_t rate_limit_max_wait_ms = limits.max_wait.count();
+  if (!parse_integer("GATEWAY_POOL_SIZE", pool_size_env, 0, 1024, pool_size) ||
+      !parse_integer("DB_BATCH_SIZE", db_batch_size_env, 1, 1000000, db_batch_size) ||
+      !parse_integer("DB_BATCH_LATENCY_US", db_batch_latency_env, 0, kMaxMs * 1000,
+                     db_batch_latency_us) ||
+      !parse_integer("LATENCY_FLUSH_MS", latency_flush_env, 1, kMaxMs, latency_flush_ms) ||
+      !parse_integer("DB_BLOCK_TIMEOUT_MS", db_block_timeout_env, 0, kMaxMs,
+                     db_block_timeout_ms) ||
+      !parse_integer("ORDER_RETENTION_MS", retention_env, 0, INT64_MAX, retention_ms) ||
+      !parse_integer("ORDER_RETENTION_MAX", retention_max_env, 0, INT64_MAX, retention_max) ||
+      !parse_integer("JOURNAL_ROTATE_MB", journal_rotate_env, 0, 1 << 20, journal_rotate_mb) ||
+      !parse_integer("RECOVERY_TIMEOUT_MS", recovery_timeout_env, 0, kMaxMs,
+                     recovery_timeout_ms) ||
+      !parse_integer("RATE_LIMIT_ME_RATE", rate_limit_me_rate_env, 0, 1000000,
+                     limits.matching_engine.refill_per_sec) ||
+      !parse_integer("RATE_LIMIT_ME_BURST", rate_limit_me_burst_env, 1, 1000000,
+                     limits.matching_engine.capacity) ||
+      !parse_integer("RATE_LIMIT_MAX_WAIT_MS", rate_limit_max_wait_env, 0, kMaxMs,
+                     rate_limit_max_wait_ms) ||
+      !parse_integer("WS_SERVER_PORT", ws_server_port_env, 0, 65535, ws_server_port)) {
+    return 1;
+  }
+  limits.max_wait = std::chrono::milliseconds(rate_limit_max_wait_ms);
+  auto db_batch_latency = std::chrono::microseconds(db_batch_latency_us);
+  auto latency_flush = std::chrono::milliseconds(latency_flush_ms);
+
   // Initialize components
   auto logger = std::make_shared<Logger>(log_file, 10000);
   logger->set_min_level(LogLevel::INFO);
-  auto db_writer = std::make_shared<DBWriter>(db_path, logger);
+  if (log_format_env && std::string(log_format_env) == "binary") {
+    logger->set_output_format(LogOutputFormat::BINARY);
+  }
+  auto db_writer =
+      std::make_shared<DBWriter>(db_path, logger, 10000, db_batch_size, db_batch_latency);
   auto order_manager = std::make_shared<OrderManager>(logger, db_writer);
-  auto gateway = std::make_shared<ExecutionGateway>(api_key, api_secret, rest_url, logger);
+  auto gateway =
+      std::make_shared<ExecutionGateway>(api_key, api_secret, rest_url, logger, pool_size);
+
+  // Each instrument's tick and lot come from the exchange the first time it is
+  // used, before recovery restores any of its orders
+  order_manager->instruments().set_scale_loader(
+      [gateway](const std::string& symbol, InstrumentScale& scale) {
+        ExecutionResult result = gateway->get_instrument_scale(symbol, scale);
+        if (!result.success) {
+          std::cerr << "⚠️  No instrument details for " << symbol << " ("
+                    << result.error_message << "), using the default scale\n";
+        }
+        return result.success;
+      });
+
+  auto latency_tracker = std::make_shared<LatencyTracker>();
+  order_manager->set_latency_tracker(latency_tracker);
+  gateway->set_latency_tracker(latency_tracker);
+  db_writer->set_latency_tracker(latency_tracker, latency_flush);
+
+  std::shared_ptr<RateLimiter> rate_limiter;
+  if (!rate_limit_env || std::string(rate_limit_env) != "off") {
+    rate_limiter = std::make_shared<RateLimiter>(limits);
+    gateway->set_rate_limiter(rate_limiter);
+  }
+
+  if (db_overflow_env) {
+    std::string policy = db_overflow_env;
+    auto block_timeout = std::chrono::milliseconds(db_block_timeout_ms);
+    if (policy == "block") {
+      db_writer->set_overflow_policy(DBOverflowPolicy::BLOCK, block_timeout);
+    } else if (policy == "spill") {
+      db_writer->set_overflow_policy(DBOverflowPolicy::SPILL);
+    } else if (policy != "drop") {
+      std::cerr << "❌ Unknown DB_OVERFLOW_POLICY '" << policy << "' (drop, block or spill)\n";
+      return 1;
+    }
+  }
+
+  if (retention_env || retention_max_env) {
+    order_manager->set_terminal_retention(std::chrono::milliseconds(retention_ms), retention_max);
+  }
+
+  std::shared_ptr<OrderJournal> journal;
+  if (journal_path_env) {
+    OrderJournalOptions journal_options;
+    journal_options.fsync = !journal_fsync_env || std::string(journal_fsync_env) != "0";
+    if (journal_rotate_mb >= 0) {
+      journal_options.rotate_bytes = static_cast<size_t>(journal_rotate_mb) << 20;
+    }
+    journal_options.keep_rotated = journal_archive_env && std::string(journal_archive_env) == "1";
+    journal = std::make_shared<OrderJournal>(journal_path_env, logger, journal_options);
+    if (!journal->open()) {
+      std::cerr << "❌ Failed to open journal " << journal_path_env << "\n";
+      return 1;
+    }
+    order_manager->set_journal(journal);
+  }
+
+  // Attached before recovery so restored orders are part of the recording
+  std::shared_ptr<SessionRecorder> recorder;
+  if (record_path_env) {
+    recorder = std::make_shared<SessionRecorder>(record_path_env, logger);
+    if (!recorder->open()) {
+      std::cerr << "❌ Failed to open session recording " << record_path_env << "\n";
+      return 1;
+    }
+    order_manager->set_recorder(recorder);
+    gateway->set_recorder(recorder);
+  }
+
+  // Fans order updates, and the books of watch-orderbook, out to local clients
+  std::shared_ptr<WebSocketServer> ws_server;
+  if (ws_server_port_env) {
+    std::string address = ws_server_address_env ? ws_server_address_env : "127.0.0.1";
+    auto port = static_cast<uint16_t>(ws_server_port);
+    ws_server = std::make_shared<WebSocketServer>(address, port, logger);
+    if (!ws_server->start()) {
+      std::cerr << "❌ Failed to start WebSocket server on " << address << ":" << port << "\n";
+      return 1;
+    }
+    std::cout << "🔌 WebSocket server listening on " << address << ":" << ws_server->port() << "\n";
+    order_manager->register_update_callback([ws_server](const Order& order) {
+      if (ws_server->subscriber_count("orders") > 0) {
+        ws_server->publish("orders", order_update_json(order));
+      }
+    });
+  }
 
   logger->start();
   db_writer->start();
 
   std::string command = argv[1];
 
+  // Warm start: bring open orders back from the database. Only the long-running
+  // interactive mode waits on the exchange to confirm them.
+  {
+    auto recovery_timeout = std::chrono::milliseconds(recovery_timeout_ms);
+    OrderRecovery recovery(logger, db_writer, order_manager,
+                           command == "interactive" ? gateway : nullptr);
+    if (journal) {
+      recovery.set_journal(journal);
+    }
+    RecoveryStats stats = recovery.run(recovery_timeout);
+    if (command == "interactive" && stats.restored > 0) {
+      std::cout << "♻️  Recovered " << stats.restored << " open orders (" << stats.confirmed
+                << " confirmed, " << stats.updated << " updated, " << stats.unconfirmed
+                << " unconfirmed)\n";
+      if (stats.not_found > 0) {
+        std::cout << "⚠️  " << stats.not_found
+                  << " recovered orders are unknown to the exchange; see the log\n";
+      }
+    }
+  }
+
   try {
     if (command == "place-order") {
       std::string symbol = get_arg(argc, argv, "--symbol");
@@ -408,12 +826,18 @@ int main(int argc, char* argv[]) {
 
       Side side = parse_side(side_str);
       OrderType type = parse_order_type(type_str);
-      double price = std::stod(price_str);
-      double amount = std::stod(amount_str);
+      Price price;
+      Qty amount;
+      if (!Price::parse(price_str, price) || !Qty::parse(amount_str, amount)) {
+        std::cerr << "❌ Invalid price or amount\n";
+        return 1;
+      }
 
       OrderRequest req(symbol, side, price, amount, type, client_id);
 
-      std::string order_id = order_manager->create_order(req);
+      OrderHandle handle = order_manager->create_order(req);
+      std::string order_id = order_manager->get_client_order_id(handle);
+      req.client_order_id = order_id; // Sent as the exchange label and latency trace key
       std::cout << "✅ Order created locally: " << order_id << "\n";
       std::cout << "📡 Submitting to exchange...\n";
 
@@ -422,17 +846,17 @@ int main(int argc, char* argv[]) {
       if (result.success) {
         std::cout << "✅ Order placed successfully!\n";
         std::cout << "   Exchange Order ID: " << result.exchange_order_id << "\n";
-        order_manager->update_order(order_id, OrderState::OPEN, result.exchange_order_id);
+        order_manager->update_order(handle, OrderState::OPEN, result.exchange_order_id);
 
         Order order;
-        if (order_manager->get_order(order_id, order)) {
+        if (order_manager->get_order(handle, order)) {
           std::cout << "\n";
           print_order(order);
         }
       } else {
         std::cout << "❌ Order rejected by exchange\n";
         std::cout << "   Error: " << result.error_message << "\n";
-        order_manager->update_order(order_id, OrderState::REJECTED, "", 0.0, result.error_message);
+        order_manager->update_order(handle, OrderState::REJECTED, "", Qty(), result.error_message);
       }
 
     } else if (command == "cancel-order") {
@@ -481,8 +905,13 @@ int main(int argc, char* argv[]) {
         return 1;
       }
 
-      double new_price = price_str.empty() ? order.request.price : std::stod(price_str);
-      double new_amount = amount_str.empty() ? order.request.amount : std::stod(amount_str);
+      Price new_price = order.request.price;
+      Qty new_amount = order.request.amount;
+      if ((!price_str.empty() && !Price::parse(price_str, new_price)) ||
+          (!amount_str.empty() && !Qty::parse(amount_str, new_amount))) {
+        std::cerr << "❌ Invalid price or amount\n";
+        return 1;
+      }
 
       if (order.exchange_order_id.empty()) {
         std::cout << "⚠️  Order not yet on exchange, cannot modify\n";
@@ -507,8 +936,8 @@ int main(int argc, char* argv[]) {
       // Filter by symbol if specified
       if (!symbol_filter.empty()) {
         orders.erase(std::remove_if(orders.begin(), orders.end(),
-                                     [&symbol_filter](const Order& o) {
-                                       return o.request.symbol != symbol_filter;
+                                     [&symbol_filter](const OrderSnapshot& o) {
+                                       return o->request.symbol != symbol_filter;
                                      }),
                      orders.end());
       }
@@ -528,12 +957,12 @@ int main(int argc, char* argv[]) {
 
         for (const auto& order : orders) {
           std::cout << "│ " << std::left << std::setw(18)
-                    << order.client_order_id.substr(0, 18) << " │ " << std::setw(13)
-                    << order.request.symbol.substr(0, 13) << " │ " << std::setw(4)
-                    << to_string(order.request.side).substr(0, 4) << " │ " << std::setw(7)
-                    << std::fixed << std::setprecision(2) << order.request.price << " │ "
-                    << std::setw(7) << std::setprecision(4) << order.request.amount << " │ "
-                    << std::setw(9) << to_string(order.state).substr(0, 9) << " │\n";
+                    << order->client_order_id.substr(0, 18) << " │ " << std::setw(13)
+                    << order->request.symbol.substr(0, 13) << " │ " << std::setw(4)
+                    << to_string(order->request.side).substr(0, 4) << " │ " << std::setw(7)
+                    << std::fixed << std::setprecision(2) << order->request.price << " │ "
+                    << std::setw(7) << std::setprecision(4) << order->request.amount << " │ "
+                    << std::setw(9) << to_string(order->state).substr(0, 9) << " │\n";
         }
         std::cout << "└────────────────────┴───────────────┴──────┴─────────┴─────────┴───────────┘\n";
       }
@@ -565,6 +994,7 @@ int main(int argc, char* argv[]) {
 
       std::cout << "📡 Fetching orderbook for " << symbol << "...\n";
       OrderBook book;
+      book.scale = instrument_scale(*order_manager, symbol);
       auto result = gateway->get_orderbook(symbol, book);
 
       if (result.success) {
@@ -574,8 +1004,55 @@ int main(int argc, char* argv[]) {
         return 1;
       }
 
+    } else if (command == "watch-orderbook") {
+      std::string symbol = get_arg(argc, argv, "--symbol");
+      std::string seconds_arg = get_arg(argc, argv, "--seconds", "10");
+      int seconds = 0;
+
+      if (symbol.empty()) {
+        std::cerr << "❌ Missing required argument: --symbol\n";
+        return 1;
+      }
+      if (!parse_integer("--seconds", seconds_arg.c_str(), 1, 86400, seconds)) {
+        return 1;
+      }
+
+      MarketDataFeed feed(ws_url, logger);
+      if (recorder) {
+        feed.set_recorder(recorder);
+      }
+      if (ws_server) {
+        std::string topic = "book." + symbol;
+        feed.set_book_handler([ws_server, topic](const OrderBook& book) {
+          if (ws_server->subscriber_count(topic) > 0) {
+            ws_server->publish(topic, book_update_json(book));
+          }
+        });
+      }
+      feed.subscribe(symbol, instrument_scale(*order_manager, symbol));
+      if (!feed.start()) {
+        std::cout << "❌ Invalid WebSocket URL: " << ws_url << "\n";
+        return 1;
+      }
+
+      std::cout << "📡 Streaming orderbook for " << symbol << " for " << seconds << "s...\n";
+      for (int i = 0; i < seconds; ++i) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        OrderBook book;
+        if (feed.get_book(symbol, book)) {
+          print_orderbook(book);
+        } else {
+          std::cout << "⏳ Waiting for snapshot...\n";
+        }
+      }
+
+      auto stats = feed.stats();
+      feed.stop();
+      std::cout << "Updates applied: " << stats.deltas_applied << ", gaps: " << stats.gaps
+                << ", reconnects: " << stats.reconnects << "\n";
+
     } else if (command == "interactive") {
-      interactive_mode(order_manager, gateway, logger);
+      interactive_mode(order_manager, gateway, logger, latency_tracker, db_writer, rate_limiter);
 
     } else {
       std::cerr << "❌ Unknown command: " << command << "\n";
@@ -590,8 +1067,24 @@ int main(int argc, char* argv[]) {
 
   // Graceful shutdown
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  if (ws_server) {
+    ws_server->stop();
+  }
   logger->stop();
   db_writer->stop();
 
+  // Only what SQLite committed is checkpointed, never past the journal's end.
+  // After a lost batch nothing later is settled, and the next start replays it.
+  if (journal && db_writer->stats().lost == 0) {
+    journal->checkpoint(order_manager->committed_journal_sequence());
+  }
+  if (order_manager->journal_failures() > 0) {
+    std::cerr << "⚠️  " << order_manager->journal_failures()
+              << " order changes could not be journaled\n";
+  }
+  if (recorder) {
+    recorder->close();
+  }
+
   return 0;
 }
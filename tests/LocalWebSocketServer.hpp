@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pulseexec {
+namespace testing {
+
+// Minimal loopback WebSocket server used as a stand-in for the exchange feed.
+// Every text frame a client sends is passed to the handler, and the frames it
+// returns are written back in order - enough to answer subscribe requests with
+// a recorded session, and to react to resubscribes.
+class LocalWebSocketServer {
+public:
+  using Handler = std::function<std::vector<std::string>(const std::string& message)>;
+
+  explicit LocalWebSocketServer(Handler handler)
+      : handler_(std::move(handler)),
+        acceptor_(io_, boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"),
+                                                      0)) {}
+
+  ~LocalWebSocketServer() { stop(); }
+
+  void start() {
+    running_ = true;
+    accept_thread_ = std::thread([this] { accept_loop(); });
+  }
+
+  void stop() {
+    if (!running_.exchange(false)) {
+      return;
+    }
+
+    // A blocking accept() is not interrupted by close(); wake it with a dummy connection
+    boost::system::error_code ec;
+    {
+      boost::asio::ip::tcp::socket waker(io_);
+      waker.connect(acceptor_.local_endpoint(), ec);
+    }
+    if (accept_thread_.joinable()) {
+      accept_thread_.join();
+    }
+    acceptor_.close(ec);
+
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    for (auto& socket : sockets_) {
+      socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    }
+    for (auto& thread : session_threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+  std::string url() const {
+    return "ws://127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port()) + "/ws/api/v2";
+  }
+
+  uint64_t connections_accepted() const { return connections_accepted_.load(); }
+  uint64_t messages_received() const { return messages_received_.load(); }
+
+private:
+  using WebSocket = boost::beast::websocket::stream<boost::asio::ip::tcp::socket&>;
+
+  void accept_loop() {
+    while (running_) {
+      auto socket = std::make_shared<boost::asio::ip::tcp::socket>(io_);
+      boost::system::error_code ec;
+      acceptor_.accept(*socket, ec);
+      if (ec || !running_) {
+        break;
+      }
+
+      socket->set_option(boost::asio::ip::tcp::no_delay(true), ec);
+      connections_accepted_.fetch_add(1);
+
+      std::lock_guard<std::mutex> lock(sessions_mutex_);
+      sockets_.push_back(socket);
+      session_threads_.emplace_back([this, socket] { serve(*socket); });
+    }
+  }
+
+  void serve(boost::asio::ip::tcp::socket& socket) {
+    WebSocket ws(socket);
+    boost::system::error_code ec;
+    ws.accept(ec);
+    if (ec) {
+      return;
+    }
+    ws.text(true);
+
+    boost::beast::flat_buffer buffer;
+    while (running_) {
+      ws.read(buffer, ec);
+      if (ec) {
+        return;
+      }
+      std::string message = boost::beast::buffers_to_string(buffer.data());
+      buffer.consume(buffer.size());
+      messages_received_.fetch_add(1);
+
+      for (const auto& reply : handler_(message)) {
+        ws.write(boost::asio::buffer(reply), ec);
+        if (ec) {
+          return;
+        }
+      }
+    }
+  }
+
+  Handler handler_;
+  boost::asio::io_context io_;
+  boost::asio::ip::tcp::acceptor acceptor_;
+  std::atomic<bool> running_{false};
+  std::thread accept_thread_;
+
+  std::mutex sessions_mutex_;
+  std::vector<std::shared_ptr<boost::asio::ip::tcp::socket>> sockets_;
+  std::vector<std::thread> session_threads_;
+
+  std::atomic<uint64_t> connections_accepted_{0};
+  std::atomic<uint64_t> messages_received_{0};
+};
+
+} // namespace testing
+} // namespace pulseexec
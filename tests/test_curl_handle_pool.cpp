@@ -0,0 +1,59 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/CurlHandlePool.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+
+TEST_CASE("CurlHandlePool handle reuse", "[gateway][curl_pool]") {
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+
+  SECTION("Pooled handles are reused") {
+    CurlHandlePool pool(2);
+    CURL* first = nullptr;
+    {
+      auto lease = pool.acquire();
+      REQUIRE(lease);
+      first = lease.get();
+    }
+    REQUIRE(pool.idle_count() == 1);
+
+    auto lease = pool.acquire();
+    REQUIRE(lease.get() == first);
+    REQUIRE(pool.created_count() == 1);
+  }
+
+  SECTION("Pool never grows beyond its size") {
+    CurlHandlePool pool(2);
+    std::atomic<int> failed_acquires{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+      threads.emplace_back([&pool, &failed_acquires]() {
+        for (int i = 0; i < 50; ++i) {
+          auto lease = pool.acquire();
+          if (!lease) {
+            failed_acquires++;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    REQUIRE(failed_acquires == 0);
+    REQUIRE(pool.created_count() <= 2);
+    REQUIRE(pool.idle_count() == pool.created_count());
+  }
+
+  SECTION("Pool size 0 creates a fresh handle per call") {
+    CurlHandlePool pool(0);
+    { auto lease = pool.acquire(); }
+    { auto lease = pool.acquire(); }
+    REQUIRE(pool.created_count() == 2);
+    REQUIRE(pool.idle_count() == 0);
+  }
+
+  curl_global_cleanup();
+}
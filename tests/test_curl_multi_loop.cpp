@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/CurlMultiLoop.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+using namespace pulseexec;
+
+// file:// transfers exercise the event loop without needing a network endpoint
+TEST_CASE("CurlMultiLoop completes queued transfers", "[gateway][curl_multi]") {
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+
+  std::string path = "/tmp/pulseexec_multi_loop_test.json";
+  {
+    std::ofstream out(path);
+    out << R"({"result":"ok"})";
+  }
+
+  auto transfer = std::make_shared<CurlMultiLoop::Transfer>();
+  transfer->url = "file://" + path;
+
+  SECTION("Many concurrent transfers share one loop thread") {
+    CurlMultiLoop loop(8);
+    loop.start();
+
+    const int num_transfers = 200;
+    std::atomic<int> completed{0};
+    std::atomic<int> bodies_ok{0};
+    std::promise<void> all_done;
+
+    for (int i = 0; i < num_transfers; ++i) {
+      bool queued = loop.submit(transfer, [&](const CurlMultiLoop::Response& resp) {
+        if (resp.body == R"({"result":"ok"})") {
+          bodies_ok++;
+        }
+        if (++completed == num_transfers) {
+          all_done.set_value();
+        }
+      });
+      REQUIRE(queued);
+    }
+
+    REQUIRE(all_done.get_future().wait_for(std::chrono::seconds(5)) ==
+            std::future_status::ready);
+    REQUIRE(bodies_ok == num_transfers);
+    REQUIRE(loop.in_flight_count() == 0);
+  }
+
+  SECTION("Delayed submissions wait for their timer") {
+    CurlMultiLoop loop(1);
+    loop.start();
+
+    std::promise<std::chrono::steady_clock::time_point> fired;
+    auto submitted_at = std::chrono::steady_clock::now();
+    loop.submit(
+        transfer,
+        [&](const CurlMultiLoop::Response&) { fired.set_value(std::chrono::steady_clock::now()); },
+        50);
+
+    auto future = fired.get_future();
+    REQUIRE(future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    REQUIRE(future.get() - submitted_at >= std::chrono::milliseconds(50));
+  }
+
+  SECTION("Stop fails pending transfers") {
+    CurlMultiLoop loop(1);
+    loop.start();
+
+    std::atomic<int> failed{0};
+    loop.submit(
+        transfer,
+        [&](const CurlMultiLoop::Response& resp) {
+          if (!resp.success) {
+            failed++;
+          }
+        },
+        10000);
+    loop.stop();
+
+    REQUIRE(failed == 1);
+    REQUIRE_FALSE(loop.submit(transfer, [](const CurlMultiLoop::Response&) {}));
+  }
+
+  SECTION("A throwing callback does not stop the others from failing") {
+    CurlMultiLoop loop(1);
+    loop.start();
+
+    std::atomic<int> failed{0};
+    loop.submit(
+        transfer, [](const CurlMultiLoop::Response&) { throw std::runtime_error("callback bug"); },
+        10000);
+    loop.submit(
+        transfer,
+        [&](const CurlMultiLoop::Response& resp) {
+          if (!resp.success) {
+            failed++;
+          }
+        },
+        10000);
+    loop.stop();
+
+    REQUIRE(failed == 1);
+  }
+
+  std::remove(path.c_str());
+  curl_global_cleanup();
+}
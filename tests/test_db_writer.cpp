@@ -0,0 +1,374 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/DBWriter.hpp"
+#include "pulseexec/LatencyTracker.hpp"
+#include "pulseexec/Logger.hpp"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <sqlite3.h>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+
+namespace {
+
+int count_rows(const std::string& db_path, const std::string& where = "",
+               const std::string& table = "orders") {
+  sqlite3* db = nullptr;
+  sqlite3_open(db_path.c_str(), &db);
+  std::string sql = "SELECT COUNT(*) FROM " + table + (where.empty() ? "" : " WHERE " + where);
+  sqlite3_stmt* stmt = nullptr;
+  sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+  int count = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : -1;
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+  return count;
+}
+
+} // namespace
+
+TEST_CASE("DBWriter batched persistence", "[db_writer]") {
+  std::string db_path = "/tmp/pulseexec_test_db_writer.db";
+  std::remove(db_path.c_str());
+
+  auto logger = std::make_shared<Logger>();
+
+  SECTION("All queued writes are committed across batches") {
+    DBWriter writer(db_path, logger, 10000, 64);
+    writer.start();
+
+    const int num_orders = 1000;
+    for (int i = 0; i < num_orders; ++i) {
+      OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+      REQUIRE(writer.write_order(Order("batch_" + std::to_string(i), req, i)));
+    }
+    writer.stop();
+
+    REQUIRE(writer.get_written_count() == num_orders);
+    REQUIRE(count_rows(db_path) == num_orders);
+  }
+
+  SECTION("A batch that fails to commit is retried before its writes are settled") {
+    DBWriter writer(db_path, logger, 10000, 64);
+    writer.start();
+
+    // A second connection holding the write lock makes every write SQLITE_BUSY
+    sqlite3* blocker = nullptr;
+    REQUIRE(sqlite3_open(db_path.c_str(), &blocker) == SQLITE_OK);
+    REQUIRE(sqlite3_exec(blocker, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+    Order order("busy_order", req, 1);
+    order.state = OrderState::FILLED;
+    uint64_t sequence = 0;
+    REQUIRE(writer.write_order(order, sequence));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(writer.flushed_sequence() < sequence);
+    CHECK(writer.get_written_count() == 0);
+    CHECK(writer.stats().failed_commits > 0);
+
+    REQUIRE(sqlite3_exec(blocker, "ROLLBACK;", nullptr, nullptr, nullptr) == SQLITE_OK);
+    sqlite3_close(blocker);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (writer.flushed_sequence() < sequence && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    REQUIRE(writer.flushed_sequence() == sequence);
+    writer.stop();
+
+    CHECK(writer.get_written_count() == 1);
+    CHECK(writer.stats().lost == 0);
+    CHECK(count_rows(db_path, "client_order_id = 'busy_order' AND state = 'filled'") == 1);
+  }
+
+  SECTION("Later writes for the same order win within a batch") {
+    DBWriter writer(db_path, logger, 10000, 1024);
+    writer.start();
+
+    OrderRequest req("ETH-PERPETUAL", Side::SELL, 3000.0, 2.0, OrderType::LIMIT);
+    Order order("same_order", req, 1);
+    writer.write_order(order);
+    order.state = OrderState::OPEN;
+    writer.write_order(order);
+    order.state = OrderState::FILLED;
+    order.filled_amount = Qty(2.0);
+    writer.write_order(order);
+    writer.stop();
+
+    REQUIRE(count_rows(db_path) == 1);
+    REQUIRE(count_rows(db_path, "state = 'filled' AND filled_amount = 2.0") == 1);
+  }
+
+  SECTION("Pending writes for the same order are coalesced") {
+    DBWriter writer(db_path, logger, 10000, 1024);
+
+    // Queued before start(), so all five land in the worker's first batch
+    OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+    Order a("order_a", req, 1);
+    Order b("order_b", req, 2);
+    uint64_t sequence = 0;
+    a.state = OrderState::OPEN;
+    writer.write_order(a);
+    b.state = OrderState::OPEN;
+    writer.write_order(b);
+    a.state = OrderState::PARTIAL;
+    a.filled_amount = Qty(0.5);
+    writer.write_order(a);
+    a.state = OrderState::FILLED;
+    a.filled_amount = Qty(1.0);
+    writer.write_order(a);
+    b.state = OrderState::CANCELED;
+    writer.write_order(b, sequence);
+
+    writer.start();
+    writer.stop();
+
+    REQUIRE(writer.get_written_count() == 2);
+    REQUIRE(writer.get_coalesced_count() == 3);
+    REQUIRE(writer.flushed_sequence() == sequence);
+    REQUIRE(count_rows(db_path, "client_order_id = 'order_a' AND state = 'filled' AND "
+                                "filled_amount = 1.0") == 1);
+    REQUIRE(count_rows(db_path, "client_order_id = 'order_b' AND state = 'canceled'") == 1);
+  }
+
+  SECTION("Coalescing can be turned off") {
+    DBWriter writer(db_path, logger, 10000, 1024);
+    writer.set_write_coalescing(false);
+
+    OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+    Order order("uncoalesced", req, 1);
+    for (OrderState state : {OrderState::OPEN, OrderState::PARTIAL, OrderState::FILLED}) {
+      order.state = state;
+      writer.write_order(order);
+    }
+
+    writer.start();
+    writer.stop();
+
+    REQUIRE(writer.get_written_count() == 3);
+    REQUIRE(writer.get_coalesced_count() == 0);
+    REQUIRE(count_rows(db_path, "state = 'filled'") == 1);
+  }
+
+  SECTION("Persist latency is flushed into latency_metrics") {
+    auto tracker = std::make_shared<LatencyTracker>();
+    DBWriter writer(db_path, logger, 10000, 64);
+    writer.set_latency_tracker(tracker, std::chrono::milliseconds(10));
+    writer.start();
+
+    for (int i = 0; i < 100; ++i) {
+      OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+      Order order("latency_" + std::to_string(i), req, i);
+      order.last_update_ts_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch())
+                                    .count();
+      writer.write_order(order);
+    }
+    writer.stop();
+
+    REQUIRE(tracker->percentiles()[static_cast<size_t>(LatencyOp::DB_PERSIST)].count == 100);
+    REQUIRE(count_rows(db_path, "operation = 'db_persist.p99'", "latency_metrics") >= 1);
+    REQUIRE(count_rows(db_path, "operation LIKE 'db_persist.%'", "latency_metrics") % 4 == 0);
+  }
+
+  SECTION("Written orders can be loaded back once flushed") {
+    DBWriter writer(db_path, logger, 10000, 64);
+    writer.start();
+
+    OrderRequest req("ETH-PERPETUAL", Side::SELL, 3000.5, 2.0, OrderType::LIMIT);
+    Order order("archived", req, 10);
+    order.exchange_order_id = "EX-42";
+    order.state = OrderState::CANCELED;
+    order.filled_amount = Qty(0.5);
+    order.last_update_ts_us = 20;
+    order.error_message = "user canceled";
+
+    uint64_t sequence = 0;
+    REQUIRE(writer.write_order(order, sequence));
+    REQUIRE(sequence > 0);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (writer.flushed_sequence() < sequence && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(writer.flushed_sequence() >= sequence);
+
+    Order loaded;
+    REQUIRE(writer.load_order("archived", loaded));
+    REQUIRE(loaded.exchange_order_id == "EX-42");
+    REQUIRE(loaded.request.symbol == "ETH-PERPETUAL");
+    REQUIRE(loaded.request.side == Side::SELL);
+    REQUIRE(loaded.request.price == Price(3000.5));
+    REQUIRE(loaded.request.amount == Qty(2.0));
+    REQUIRE(loaded.state == OrderState::CANCELED);
+    REQUIRE(loaded.filled_amount == Qty(0.5));
+    REQUIRE(loaded.created_ts_us == 10);
+    REQUIRE(loaded.last_update_ts_us == 20);
+    REQUIRE(loaded.error_message == "user canceled");
+
+    Order by_exchange_id;
+    REQUIRE(writer.load_order_by_exchange_id("EX-42", by_exchange_id));
+    REQUIRE(by_exchange_id.client_order_id == "archived");
+    REQUIRE_FALSE(writer.load_order("missing", loaded));
+    writer.stop();
+  }
+
+  SECTION("Only non-terminal orders are loaded as open, oldest first") {
+    DBWriter writer(db_path, logger, 10000, 64);
+    writer.start();
+
+    OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+    const OrderState states[] = {OrderState::OPEN,     OrderState::FILLED,   OrderState::PENDING,
+                                 OrderState::CANCELED, OrderState::REJECTED, OrderState::PARTIAL};
+    uint64_t sequence = 0;
+    for (int i = 0; i < 6; ++i) {
+      Order order("state_" + std::to_string(i), req, 100 - i);
+      order.state = states[i];
+      REQUIRE(writer.write_order(order, sequence));
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (writer.flushed_sequence() < sequence && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::vector<Order> open_orders;
+    REQUIRE(writer.load_open_orders(open_orders));
+    REQUIRE(open_orders.size() == 3);
+    REQUIRE(open_orders[0].client_order_id == "state_5");
+    REQUIRE(open_orders[1].client_order_id == "state_2");
+    REQUIRE(open_orders[2].client_order_id == "state_0");
+    REQUIRE(open_orders[0].state == OrderState::PARTIAL);
+    writer.stop();
+  }
+
+  std::remove(db_path.c_str());
+  std::remove((db_path + "-wal").c_str());
+  std::remove((db_path + "-shm").c_str());
+}
+
+TEST_CASE("DBWriter overflow policies", "[db_writer][overflow]") {
+  std::string db_path = "/tmp/pulseexec_test_db_overflow.db";
+  std::string spill_path = db_path + ".spill";
+  std::remove(db_path.c_str());
+  std::remove(spill_path.c_str());
+
+  auto logger = std::make_shared<Logger>();
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+
+  SECTION("Drop rejects writes past capacity and reports the depth") {
+    DBWriter writer(db_path, logger, 2, 64);
+    REQUIRE(writer.write_order(Order("a", req, 1)));
+    REQUIRE(writer.write_order(Order("b", req, 2)));
+    REQUIRE_FALSE(writer.write_order(Order("c", req, 3)));
+
+    DBWriter::Stats stats = writer.stats();
+    REQUIRE(stats.queue_depth == 2);
+    REQUIRE(stats.queue_high_watermark == 2);
+    REQUIRE(stats.dropped == 1);
+
+    writer.start();
+    writer.stop();
+    REQUIRE(writer.stats().queue_depth == 0);
+    REQUIRE(writer.stats().queue_high_watermark == 2);
+    REQUIRE(count_rows(db_path) == 2);
+  }
+
+  SECTION("Block waits for the worker to make room") {
+    DBWriter writer(db_path, logger, 4, 2, std::chrono::microseconds(0));
+    writer.set_overflow_policy(DBOverflowPolicy::BLOCK, std::chrono::seconds(5));
+    writer.start();
+
+    const int num_orders = 2000;
+    for (int i = 0; i < num_orders; ++i) {
+      REQUIRE(writer.write_order(Order("block_" + std::to_string(i), req, i)));
+    }
+    writer.stop();
+
+    REQUIRE(writer.stats().dropped == 0);
+    REQUIRE(writer.stats().queue_high_watermark <= 4);
+    REQUIRE(count_rows(db_path) == num_orders);
+  }
+
+  SECTION("Block gives up after its timeout") {
+    DBWriter writer(db_path, logger, 1, 64);
+    writer.set_overflow_policy(DBOverflowPolicy::BLOCK, std::chrono::milliseconds(10));
+    REQUIRE(writer.write_order(Order("a", req, 1)));
+    REQUIRE_FALSE(writer.write_order(Order("b", req, 2))); // Not started, never drains
+    REQUIRE(writer.stats().blocked == 1);
+    REQUIRE(writer.stats().dropped == 1);
+  }
+
+  SECTION("Spill loses no state when the writer is saturated") {
+    DBWriter writer(db_path, logger, 64, 32);
+    writer.set_overflow_policy(DBOverflowPolicy::SPILL);
+    writer.start();
+
+    // Every order goes through several states; the last one written must win
+    const int num_threads = 4;
+    const int orders_per_thread = 2000;
+    const OrderState lifecycle[] = {OrderState::PENDING, OrderState::OPEN, OrderState::PARTIAL,
+                                    OrderState::FILLED};
+    std::vector<std::thread> threads;
+    std::atomic<int> rejected{0};
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < orders_per_thread; ++i) {
+          Order order("spill_" + std::to_string(t) + "_" + std::to_string(i), req, i);
+          for (OrderState state : lifecycle) {
+            order.state = state;
+            order.filled_amount = Qty(state == OrderState::FILLED ? 1.0 : 0.0);
+            if (!writer.write_order(order)) {
+              rejected.fetch_add(1);
+            }
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    writer.stop();
+
+    DBWriter::Stats stats = writer.stats();
+    REQUIRE(rejected.load() == 0);
+    REQUIRE(stats.dropped == 0);
+    REQUIRE(stats.spilled > 0);
+    REQUIRE(stats.spill_depth == 0);
+    REQUIRE(stats.queue_high_watermark == 64);
+    REQUIRE(writer.flushed_sequence() == num_threads * orders_per_thread * 4);
+    REQUIRE(count_rows(db_path) == num_threads * orders_per_thread);
+    REQUIRE(count_rows(db_path, "state = 'filled' AND filled_amount = 1.0") ==
+            num_threads * orders_per_thread);
+
+    std::FILE* leftover = std::fopen(spill_path.c_str(), "rb");
+    REQUIRE(leftover == nullptr);
+  }
+
+  SECTION("A spill file left by a crash is replayed on start") {
+    {
+      std::FILE* spill = std::fopen(spill_path.c_str(), "wb");
+      std::fputs(R"({"client_order_id":"crashed","symbol":"BTC-PERPETUAL","side":"buy",)"
+                 R"("price":50000.0,"amount":1.0,"order_type":"limit","state":"open",)"
+                 R"("filled_amount":0.25,"created_ts_us":1,"last_update_ts_us":2})"
+                 "\n{\"client_order_id\":\"torn",
+                 spill);
+      std::fclose(spill);
+    }
+
+    DBWriter writer(db_path, logger);
+    writer.start();
+    REQUIRE(writer.flushed_sequence() == 0);
+    writer.stop();
+
+    REQUIRE(count_rows(db_path, "client_order_id = 'crashed' AND filled_amount = 0.25") == 1);
+    REQUIRE(count_rows(db_path) == 1);
+    REQUIRE(std::fopen(spill_path.c_str(), "rb") == nullptr);
+  }
+
+  std::remove(db_path.c_str());
+  std::remove((db_path + "-wal").c_str());
+  std::remove((db_path + "-shm").c_str());
+  std::remove(spill_path.c_str());
+}
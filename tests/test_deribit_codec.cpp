@@ -0,0 +1,240 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/DeribitCodec.hpp"
+#include <nlohmann/json.hpp>
+
+using namespace pulseexec;
+using json = nlohmann::json;
+
+namespace {
+
+OrderRequest make_request(const std::string& symbol, Side side, Price price, Qty amount,
+                          OrderType type, const std::string& label) {
+  OrderRequest req;
+  req.symbol = symbol;
+  req.side = side;
+  req.price = price;
+  req.amount = amount;
+  req.type = type;
+  req.client_order_id = label;
+  return req;
+}
+
+} // namespace
+
+TEST_CASE("RequestWriter encodes order bodies the gateway sends", "[deribit_codec]") {
+  deribit::RequestWriter writer;
+
+  SECTION("Limit orders carry exact decimals and a label") {
+    OrderRequest req = make_request("BTC-PERPETUAL", Side::BUY, Price(50000.5, 1),
+                                    Qty(12.25, 2), OrderType::LIMIT, "CLIENT_1");
+    const std::string& body = writer.place_order(req);
+    CHECK(body == R"({"jsonrpc":"2.0","id":1,"method":"private/buy","params":)"
+                  R"({"instrument_name":"BTC-PERPETUAL","amount":12.25,"type":"limit",)"
+                  R"("price":50000.5,"label":"CLIENT_1"}})");
+    CHECK(body == deribit::build_place_order_body(req));
+  }
+
+  SECTION("Market sells have no price, and no label when none is set") {
+    OrderRequest req = make_request("ETH-PERPETUAL", Side::SELL, Price(), Qty(3.0, 0),
+                                    OrderType::MARKET, "");
+    json j = json::parse(writer.place_order(req));
+    CHECK(j["method"] == "private/sell");
+    CHECK(j["params"]["type"] == "market");
+    CHECK(j["params"]["amount"].get<double>() == 3.0);
+    CHECK_FALSE(j["params"].contains("price"));
+    CHECK_FALSE(j["params"].contains("label"));
+  }
+
+  SECTION("Decimals below one, negatives and trailing zeros") {
+    OrderRequest req = make_request("X", Side::BUY, Price(-0.05, 4), Qty(0.0012, 6),
+                                    OrderType::LIMIT, "");
+    json j = json::parse(writer.place_order(req));
+    CHECK(j["params"]["price"].dump() == "-0.05");
+    CHECK(j["params"]["amount"].dump() == "0.0012");
+
+    json edit = json::parse(writer.modify_order("ETH-1", Price(100.0, 2), Qty(0.0, 3)));
+    CHECK(edit["price"].dump() == "100");
+    CHECK(edit["amount"].dump() == "0");
+  }
+
+  SECTION("Strings are escaped") {
+    OrderRequest req = make_request("BTC", Side::BUY, Price(1.0, 0), Qty(1.0, 0),
+                                    OrderType::LIMIT, "a\"b\\c\n\x01");
+    json j = json::parse(writer.place_order(req));
+    CHECK(j["params"]["label"] == "a\"b\\c\n\x01");
+  }
+
+  SECTION("Cancel, edit and get_order_state address the exchange ID") {
+    CHECK(writer.cancel_order("ETH-584849853") == R"({"order_id":"ETH-584849853"})");
+    CHECK(writer.get_order_state("ETH-584849853") == R"({"order_id":"ETH-584849853"})");
+    CHECK(writer.modify_order("ETH-584849853", Price(50010.5, 1), Qty(20.0, 0)) ==
+          R"({"order_id":"ETH-584849853","amount":20,"price":50010.5})");
+  }
+
+  SECTION("Orders without an exchange ID are looked up by label and currency") {
+    CHECK(writer.get_order_state_by_label(deribit::instrument_currency("BTC-PERPETUAL"),
+                                          "CLIENT_1") ==
+          R"({"currency":"BTC","label":"CLIENT_1"})");
+    CHECK(deribit::instrument_currency("ETH-28JUN24-3000-C") == "ETH");
+    CHECK(deribit::instrument_currency("SOL_USDC-PERPETUAL") == "USDC");
+  }
+
+  SECTION("The buffer is reused once it is large enough") {
+    OrderRequest req = make_request("BTC-PERPETUAL", Side::BUY, Price(50000.5, 1),
+                                    Qty(10.0, 0), OrderType::LIMIT, "CLIENT_1");
+    const char* data = writer.place_order(req).data();
+    writer.cancel_order("ETH-1");
+    CHECK(writer.place_order(req).data() == data);
+  }
+}
+
+TEST_CASE("Gateway responses decode into orders and books", "[deribit_codec]") {
+  SECTION("place_order takes result.order.order_id") {
+    ExecutionResult result = deribit::parse_place_order_response(
+        200, true,
+        R"({"jsonrpc":"2.0","id":1,"result":{"trades":[],"order":{"order_state":"open",)"
+        R"("order_id":"ETH-584849853","label":"C1"}}})");
+    CHECK(result.success);
+    CHECK(result.exchange_order_id == "ETH-584849853");
+
+    result = deribit::parse_place_order_response(200, true, R"({"jsonrpc":"2.0","result":{}})");
+    CHECK_FALSE(result.success);
+    CHECK(result.error_message == "Invalid response format");
+
+    result = deribit::parse_place_order_response(200, true, R"({"result":{"order":{"order_id":)");
+    CHECK_FALSE(result.success);
+    CHECK(result.error_message.rfind("JSON parse error", 0) == 0);
+
+    result = deribit::parse_place_order_response(503, false, "unavailable");
+    CHECK(result.error_message == "unavailable");
+  }
+
+  SECTION("get_order_state fills the fields that were sent") {
+    Order order;
+    order.client_order_id = "KEEP";
+    ExecutionResult result = deribit::parse_order_state_response(
+        200, true,
+        R"({"jsonrpc":"2.0","result":{"order_id":"ETH-1","label":"",)"
+        R"("instrument_name":"ETH-PERPETUAL",)"
+        R"("direction":"sell","price":3000.05,"amount":12.5,"order_type":"limit",)"
+        R"("order_state":"cancelled","filled_amount":2.25,"time_in_force":"good_til_cancelled"}})",
+        order);
+    REQUIRE(result.success);
+    CHECK(order.exchange_order_id == "ETH-1");
+    CHECK(order.client_order_id == "KEEP");
+    CHECK(order.request.symbol == "ETH-PERPETUAL");
+    CHECK(order.request.side == Side::SELL);
+    CHECK(order.request.price.to_string() == "3000.05");
+    CHECK(order.request.amount.to_string() == "12.5");
+    CHECK(order.state == OrderState::CANCELED);
+    CHECK(order.filled_amount.to_string() == "2.25");
+
+    // Market orders report their price as text
+    Price before = order.request.price;
+    result = deribit::parse_order_state_response(
+        200, true, R"({"result":{"price":"market_price","order_type":"market"}})", order);
+    REQUIRE(result.success);
+    CHECK(order.request.price == before);
+    CHECK(order.request.type == OrderType::MARKET);
+
+    result = deribit::parse_order_state_response(
+        200, true, R"({"jsonrpc":"2.0","error":{"message":"order_not_found","code":10004}})",
+        order);
+    CHECK_FALSE(result.success);
+    CHECK(result.error_message == R"({"message":"order_not_found","code":10004})");
+  }
+
+  SECTION("get_order_state_by_label takes the first order, if any") {
+    Order order;
+    ExecutionResult result = deribit::parse_order_state_by_label_response(
+        200, true,
+        R"({"jsonrpc":"2.0","result":[{"order_id":"BTC-7","label":"C1","order_state":"filled",)"
+        R"("filled_amount":10},{"order_id":"BTC-8","label":"C1"}]})",
+        order);
+    REQUIRE(result.success);
+    CHECK(result.exchange_order_id == "BTC-7");
+    CHECK(order.exchange_order_id == "BTC-7");
+    CHECK(order.state == OrderState::FILLED);
+
+    Order unknown;
+    result = deribit::parse_order_state_by_label_response(200, true,
+                                                          R"({"jsonrpc":"2.0","result":[]})",
+                                                          unknown);
+    CHECK(result.success);
+    CHECK(result.exchange_order_id.empty());
+
+    result = deribit::parse_order_state_by_label_response(
+        200, true, R"({"error":{"message":"unauthorized","code":13009}})", unknown);
+    CHECK_FALSE(result.success);
+    CHECK(result.error_message == R"({"message":"unauthorized","code":13009})");
+  }
+
+  SECTION("get_order_book rounds levels onto the book's scale") {
+    OrderBook book;
+    book.scale = InstrumentScale{1, 0, Price(0.5, 1), Qty(10.0, 0)};
+    book.bids.emplace_back(Price(1.0, 1), Qty(1.0, 0)); // Replaced
+    ExecutionResult result = deribit::parse_order_book_response(
+        200, true,
+        R"({"jsonrpc":"2.0","result":{"timestamp":1700000000000,"stats":{"volume":1.5},)"
+        R"("bids":[[50000.5,120.0],[50000.0,40]],"asks":[[50001.0,10, "x"]],"state":"open"}})",
+        book);
+    REQUIRE(result.success);
+    REQUIRE(book.bids.size() == 2);
+    CHECK(book.bids[0].price == Price::from_mantissa(500005, 1));
+    CHECK(book.bids[0].amount == Qty::from_mantissa(120, 0));
+    CHECK(book.bids[1].amount == Qty::from_mantissa(40, 0));
+    REQUIRE(book.asks.size() == 1);
+    CHECK(book.asks[0].price == Price::from_mantissa(500010, 1));
+    CHECK(book.timestamp_us == 1700000000000);
+
+    result = deribit::parse_order_book_response(200, true, R"({"result":{"bids":[[1,)", book);
+    CHECK_FALSE(result.success);
+  }
+
+  SECTION("get_instrument gives the tick, the lot and their decimals") {
+    InstrumentScale scale;
+    ExecutionResult result = deribit::parse_instrument_response(
+        200, true,
+        R"({"jsonrpc":"2.0","result":{"tick_size":0.5,"min_trade_amount":10,)"
+        R"("contract_size":10,"instrument_name":"BTC-PERPETUAL"}})",
+        scale);
+    REQUIRE(result.success);
+    CHECK(scale.price_decimals == 1);
+    CHECK(scale.qty_decimals == 0);
+    CHECK(scale.tick_size == Price::from_mantissa(5, 1));
+    CHECK(scale.lot_size == Qty::from_mantissa(10, 0));
+
+    result = deribit::parse_instrument_response(
+        200, true, R"({"result":{"tick_size":5e-05,"min_trade_amount":0.0010}})", scale);
+    REQUIRE(result.success);
+    CHECK(scale.price_decimals == 5);
+    CHECK(scale.tick_size == Price::from_mantissa(5, 5));
+    CHECK(scale.qty_decimals == 3);
+
+    // Left alone without both sizes
+    result = deribit::parse_instrument_response(200, true, R"({"result":{"tick_size":0.01}})",
+                                                scale);
+    CHECK_FALSE(result.success);
+    CHECK(scale.price_decimals == 5);
+    result = deribit::parse_instrument_response(
+        200, true, R"({"result":{"tick_size":0,"min_trade_amount":1}})", scale);
+    CHECK_FALSE(result.success);
+  }
+}
+
+TEST_CASE("Auth replies need a token and a positive lifetime", "[deribit_codec]") {
+  std::string token;
+  int64_t expires_in = 0;
+  REQUIRE(deribit::parse_auth_response(
+      R"({"jsonrpc":"2.0","result":{"access_token":"abc","expires_in":900,"scope":"x"}})", token,
+      expires_in));
+  CHECK(token == "abc");
+  CHECK(expires_in == 900);
+
+  CHECK_FALSE(deribit::parse_auth_response(
+      R"({"result":{"access_token":"abc","expires_in":0}})", token, expires_in));
+  CHECK_FALSE(deribit::parse_auth_response(
+      R"({"result":{"access_token":"abc","expires_in":-5}})", token, expires_in));
+  CHECK_FALSE(deribit::parse_auth_response(R"({"result":{"access_token":"abc"}})", token,
+                                           expires_in));
+}
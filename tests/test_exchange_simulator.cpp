@@ -0,0 +1,160 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/DeribitCodec.hpp"
+#include "pulseexec/ExchangeSimulator.hpp"
+#include "pulseexec/MarketDataFeed.hpp"
+#include <nlohmann/json.hpp>
+
+using namespace pulseexec;
+using json = nlohmann::json;
+
+namespace {
+
+const InstrumentScale kBtcScale{1, 0, Price(0.5, 1), Qty(10.0, 0)};
+
+ExecutionResult place(ExchangeSimulator& sim, Side side, double price, double amount,
+                      const std::string& label) {
+  OrderRequest req("BTC-PERPETUAL", side, price, amount, OrderType::LIMIT, label);
+  auto reply =
+      sim.handle("POST", side == Side::BUY ? "/api/v2/private/buy" : "/api/v2/private/sell",
+                 deribit::build_place_order_body(req));
+  return deribit::parse_place_order_response(reply.status, reply.status == 200, reply.body);
+}
+
+} // namespace
+
+TEST_CASE("ExchangeSimulator speaks the gateway's JSON-RPC", "[exchange_simulator]") {
+  ExchangeSimulator sim;
+  REQUIRE(sim.add_instrument("BTC-PERPETUAL", kBtcScale));
+  REQUIRE_FALSE(sim.add_instrument("BTC-PERPETUAL", kBtcScale));
+
+  ExecutionResult ask = place(sim, Side::SELL, 50000.5, 30, "ASK_1");
+  REQUIRE(ask.success);
+  REQUIRE_FALSE(ask.exchange_order_id.empty());
+
+  SECTION("Placed orders match and report their trades") {
+    OrderRequest req("BTC-PERPETUAL", Side::BUY, 50001.0, 20, OrderType::LIMIT, "BID_1");
+    auto reply = sim.handle("POST", "/api/v2/private/buy", deribit::build_place_order_body(req));
+    REQUIRE(reply.status == 200);
+    json response = json::parse(reply.body);
+    CHECK(response["result"]["order"]["order_state"] == "filled");
+    CHECK(response["result"]["order"]["label"] == "BID_1");
+    REQUIRE(response["result"]["trades"].size() == 1);
+    CHECK(response["result"]["trades"][0]["price"].get<double>() == 50000.5);
+    CHECK(response["result"]["trades"][0]["amount"].get<double>() == 20.0);
+
+    Order order;
+    reply = sim.handle("POST", "/api/v2/private/get_order_state",
+                       deribit::build_get_order_state_body(ask.exchange_order_id));
+    REQUIRE(deribit::parse_order_state_response(reply.status, true, reply.body, order).success);
+    CHECK(order.client_order_id == "ASK_1");
+    CHECK(order.request.side == Side::SELL);
+    CHECK(order.state == OrderState::OPEN); // Deribit reports partial fills as open
+    CHECK(order.filled_amount == Qty(20.0));
+  }
+
+  SECTION("Cancel and edit address orders by exchange ID") {
+    auto reply = sim.handle("POST", "/api/v2/private/edit",
+                            deribit::build_modify_order_body(ask.exchange_order_id,
+                                                             Price(50002.0), Qty(40.0)));
+    REQUIRE(reply.status == 200);
+    CHECK(json::parse(reply.body)["result"]["order"]["price"].get<double>() == 50002.0);
+
+    OrderBook book;
+    REQUIRE(sim.get_book("BTC-PERPETUAL", 10, book));
+    REQUIRE(book.asks.size() == 1);
+    CHECK(book.asks[0].price == kBtcScale.price(50002.0));
+    CHECK(book.asks[0].amount == kBtcScale.qty(40));
+
+    reply = sim.handle("POST", "/api/v2/private/cancel",
+                       deribit::build_cancel_order_body(ask.exchange_order_id));
+    REQUIRE(reply.status == 200);
+    CHECK(json::parse(reply.body)["result"]["order_state"] == "cancelled");
+
+    reply = sim.handle("POST", "/api/v2/private/cancel",
+                       deribit::build_cancel_order_body(ask.exchange_order_id));
+    CHECK(reply.status == 400);
+    CHECK(json::parse(reply.body)["error"]["message"] == "not_open_order");
+    CHECK(sim.handle("POST", "/api/v2/private/cancel", deribit::build_cancel_order_body("123456"))
+              .status == 400);
+  }
+
+  SECTION("Order books and auth are served on the gateway's paths") {
+    auto reply = sim.handle(
+        "GET", "/api/v2/public/get_order_book?instrument_name=BTC-PERPETUAL&depth=10", "");
+    REQUIRE(reply.status == 200);
+    json book = json::parse(reply.body)["result"];
+    REQUIRE(book["asks"].size() == 1);
+    CHECK(book["asks"][0][0].get<double>() == 50000.5);
+    CHECK(book["bids"].empty());
+
+    reply = sim.handle(
+        "POST", "/api/v2/public/auth",
+        deribit::build_jsonrpc_request("public/auth", {{"grant_type", "client_credentials"}}));
+    REQUIRE(reply.status == 200);
+    CHECK(json::parse(reply.body)["result"].contains("access_token"));
+  }
+
+  SECTION("Malformed requests are refused") {
+    CHECK(sim.handle("POST", "/api/v2/private/buy", "{not json").status == 400);
+    CHECK(sim.handle("POST", "/api/v2/private/buy", R"({"params":{"amount":10}})").status == 400);
+    CHECK(sim.handle("POST", "/api/v2/private/close_position", "{}").status == 400);
+    CHECK(sim.requests_failed() == 3);
+  }
+}
+
+TEST_CASE("ExchangeSimulator book notifications keep a MarketDataFeed in sync",
+          "[exchange_simulator]") {
+  ExchangeSimulator sim;
+  sim.add_instrument("BTC-PERPETUAL", kBtcScale);
+  place(sim, Side::SELL, 50001.0, 30, "A1");
+  place(sim, Side::BUY, 49999.0, 50, "B1");
+
+  auto feed = std::make_shared<MarketDataFeed>("ws://127.0.0.1:1/ws/api/v2", nullptr);
+  feed->subscribe("BTC-PERPETUAL", kBtcScale);
+  feed->process_message(sim.snapshot_notification("BTC-PERPETUAL"));
+
+  int notifications = 0;
+  sim.set_book_listener([&](const std::string& notification) {
+    ++notifications;
+    feed->process_message(notification);
+  });
+
+  place(sim, Side::SELL, 50000.5, 30, "A2");
+  place(sim, Side::BUY, 50001.0, 80, "B2");  // Clears both asks, rests 20 at 50001
+  place(sim, Side::SELL, 49999.0, 10, "A3"); // Takes from the new best bid
+  CHECK(notifications == 3);
+
+  OrderBook expected;
+  OrderBook actual;
+  REQUIRE(sim.get_book("BTC-PERPETUAL", 10, expected));
+  REQUIRE(feed->get_book("BTC-PERPETUAL", actual));
+  CHECK(actual.sequence == expected.sequence);
+  REQUIRE(actual.bids.size() == expected.bids.size());
+  for (size_t i = 0; i < expected.bids.size(); ++i) {
+    CHECK(actual.bids[i].price == expected.bids[i].price);
+    CHECK(actual.bids[i].amount == expected.bids[i].amount);
+  }
+  CHECK(actual.asks.empty());
+  REQUIRE(expected.bids.size() == 2);
+  CHECK(expected.bids[0].amount == kBtcScale.qty(10));
+}
+
+TEST_CASE("ExchangeSimulator enforces credit limits per pool", "[exchange_simulator]") {
+  ExchangeSimulator sim;
+  RateLimiter::Config limits;
+  limits.matching_engine = {2, 1, 1};
+  sim.set_rate_limits(limits);
+
+  REQUIRE(place(sim, Side::SELL, 50000.5, 10, "ASK_1").success);
+  REQUIRE(place(sim, Side::SELL, 50001.0, 10, "ASK_2").success);
+
+  OrderRequest req("BTC-PERPETUAL", Side::SELL, 50001.5, 10, OrderType::LIMIT, "ASK_3");
+  auto reply = sim.handle("POST", "/api/v2/private/sell", deribit::build_place_order_body(req));
+  CHECK(reply.status == 429);
+  CHECK(json::parse(reply.body)["error"]["code"] == 10028);
+  CHECK(sim.requests_rate_limited() == 1);
+
+  // Non-matching requests draw on their own pool
+  auto book = sim.handle("GET", "/api/v2/public/get_order_book?instrument_name=BTC-PERPETUAL", "");
+  CHECK(book.status == 200);
+}
@@ -0,0 +1,215 @@
+#include <catch2/catch_test_macros.hpp>
+#include "LocalHttpServer.hpp"
+#include "pulseexec/ExchangeSimulator.hpp"
+#include "pulseexec/ExecutionGateway.hpp"
+#include "pulseexec/RateLimiter.hpp"
+#include "pulseexec/SessionRecorder.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+using namespace pulseexec;
+using bench::LocalHttpServer;
+
+namespace {
+
+const std::string kOrderReply =
+    R"({"jsonrpc":"2.0","id":1,"result":{"order":{"order_id":"ETH-1","order_state":"open"}}})";
+
+int64_t elapsed_ms(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                               since)
+      .count();
+}
+
+} // namespace
+
+TEST_CASE("ExecutionGateway renews its access token off the order path", "[gateway]") {
+  // Tokens live 2 s, so renewal is due after 1 s and the token stops being
+  // used after 1.8 s. Every successful auth after the first takes 300 ms.
+  std::atomic<int> auths{0};
+  std::atomic<bool> auth_fails{false};
+  LocalHttpServer server([&](const std::string&, const std::string& target, const std::string&) {
+    if (target == "/api/v2/public/auth") {
+      int n = ++auths;
+      if (auth_fails) {
+        return LocalHttpServer::Reply{500, "{}"};
+      }
+      if (n > 1) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+      }
+      return LocalHttpServer::Reply{
+          200, R"({"jsonrpc":"2.0","id":1,"result":{"access_token":"token-)" + std::to_string(n) +
+                   R"(","expires_in":2,"token_type":"bearer"}})"};
+    }
+    return LocalHttpServer::Reply{200, kOrderReply};
+  });
+  server.start();
+
+  auto gateway = std::make_unique<ExecutionGateway>("key", "secret", server.base_url(), nullptr, 2);
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT, "T1");
+  REQUIRE(gateway->place_order(req).success);
+  REQUIRE(auths == 1);
+
+  SECTION("Orders never wait for a renewal") {
+    int64_t slowest_ms = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (elapsed_ms(start) < 2500) {
+      auto sent = std::chrono::steady_clock::now();
+      REQUIRE(gateway->place_order(req).success);
+      slowest_ms = std::max(slowest_ms, elapsed_ms(sent));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(auths >= 2);
+    CHECK(slowest_ms < 200);
+  }
+
+  SECTION("Once renewals have failed past expiry, orders authenticate inline") {
+    auth_fails = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+    int failed_renewals = auths - 1;
+    CHECK(failed_renewals >= 1);
+
+    auth_fails = false;
+    auto sent = std::chrono::steady_clock::now();
+    CHECK(gateway->place_order(req).success);
+    CHECK(elapsed_ms(sent) >= 300); // Paid for the auth round trip itself
+    CHECK(auths >= failed_renewals + 2);
+  }
+
+  // The refresher is waiting for its next renewal; stopping must not
+  auto stopping = std::chrono::steady_clock::now();
+  gateway.reset();
+  CHECK(elapsed_ms(stopping) < 500);
+}
+
+TEST_CASE("ExecutionGateway records the final response of sync requests", "[gateway]") {
+  LocalHttpServer server([](const std::string&, const std::string& target, const std::string&) {
+    if (target == "/api/v2/public/auth") {
+      return LocalHttpServer::Reply{
+          200, R"({"jsonrpc":"2.0","id":1,"result":{"access_token":"t","expires_in":900}})"};
+    }
+    return LocalHttpServer::Reply{200, kOrderReply};
+  });
+  server.start();
+
+  std::string path = "/tmp/pulseexec_test_gateway_session.bin";
+  auto recorder = std::make_shared<SessionRecorder>(path, nullptr);
+  REQUIRE(recorder->open());
+  {
+    ExecutionGateway gateway("key", "secret", server.base_url(), nullptr, 2);
+    gateway.set_recorder(recorder);
+    OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT, "REC_1");
+    REQUIRE(gateway.place_order(req).success);
+  }
+  recorder->close();
+
+  SessionReader reader(path);
+  REQUIRE(reader.open());
+  SessionEvent event;
+  REQUIRE(reader.next(event));
+  CHECK(event.type == SessionEventType::GATEWAY_RESPONSE);
+  CHECK(event.endpoint == "/api/v2/private/buy");
+  CHECK(event.http_status == 200);
+  CHECK(event.success);
+  CHECK(event.text == kOrderReply);
+  CHECK_FALSE(reader.next(event)); // The auth reply is not recorded
+  CHECK_FALSE(reader.truncated());
+  std::remove(path.c_str());
+}
+
+TEST_CASE("ExecutionGateway stays inside the exchange's rate limits", "[gateway]") {
+  // Bursts of 5 matching engine requests, then one every 20 ms
+  RateLimiter::Config limits;
+  limits.matching_engine = {5, 50, 1};
+  limits.max_wait = std::chrono::milliseconds(1000);
+
+  // The exchange enforces the same pools, with one request's slack for
+  // scheduling jitter between the gateway sending and the server reading
+  RateLimiter::Config enforced = limits;
+  enforced.matching_engine.capacity += 1;
+  ExchangeSimulator sim;
+  sim.set_rate_limits(enforced);
+  LocalHttpServer server([&sim](const std::string& method, const std::string& target,
+                                const std::string& body) {
+    ExchangeSimulator::Reply reply = sim.handle(method, target, body);
+    return LocalHttpServer::Reply{reply.status, std::move(reply.body)};
+  });
+  server.start();
+
+  ExecutionGateway gateway("key", "secret", server.base_url(), nullptr, 2);
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 10.0, OrderType::LIMIT, "");
+  const int orders = 25;
+
+  SECTION("Without a limiter a burst draws 429s") {
+    for (int i = 0; i < 10; ++i) {
+      gateway.place_order(req);
+    }
+    CHECK(sim.requests_rate_limited() > 0);
+  }
+
+  SECTION("Sync requests wait for credits instead") {
+    auto limiter = std::make_shared<RateLimiter>(limits);
+    gateway.set_rate_limiter(limiter);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < orders; ++i) {
+      REQUIRE(gateway.place_order(req).success);
+    }
+    CHECK(elapsed_ms(start) >= (orders - 5) * 20 - 20);
+    CHECK(sim.requests_rate_limited() == 0);
+
+    RateLimiter::Credits credits = limiter->credits(RateLimiter::Pool::MATCHING_ENGINE);
+    CHECK(credits.capacity == 5);
+    CHECK(credits.available <= 1);
+    CHECK(credits.delayed >= orders - 6);
+    CHECK(credits.rejected == 0);
+    CHECK(credits.exchange_rejections == 0);
+    CHECK(limiter->credits(RateLimiter::Pool::NON_MATCHING).available == 50000);
+  }
+
+  SECTION("Async requests are held on the loop's timer") {
+    auto limiter = std::make_shared<RateLimiter>(limits);
+    gateway.set_rate_limiter(limiter);
+
+    std::atomic<int> succeeded{0};
+    std::atomic<int> completed{0};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < orders; ++i) {
+      gateway.place_order_async(req, [&](const ExecutionResult& result) {
+        succeeded += result.success ? 1 : 0;
+        ++completed;
+      });
+    }
+    while (completed < orders && elapsed_ms(start) < 5000) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    CHECK(succeeded == orders);
+    CHECK(elapsed_ms(start) >= (orders - 5) * 20 - 20);
+    CHECK(sim.requests_rate_limited() == 0);
+  }
+
+  SECTION("Requests that would wait too long fail locally") {
+    limits.max_wait = std::chrono::milliseconds(0);
+    auto limiter = std::make_shared<RateLimiter>(limits);
+    gateway.set_rate_limiter(limiter);
+
+    int succeeded = 0;
+    for (int i = 0; i < 10; ++i) {
+      ExecutionResult result = gateway.place_order(req);
+      if (result.success) {
+        ++succeeded;
+      } else {
+        CHECK(result.http_status == 0);
+        CHECK(result.error_message.find("Rate limited locally") != std::string::npos);
+      }
+    }
+    CHECK(succeeded >= 5);
+    CHECK(succeeded < 10);
+    CHECK(limiter->credits(RateLimiter::Pool::MATCHING_ENGINE).rejected ==
+          static_cast<uint64_t>(10 - succeeded));
+    CHECK(sim.requests_rate_limited() == 0);
+  }
+}
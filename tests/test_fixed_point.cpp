@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/FixedPoint.hpp"
+#include "pulseexec/InstrumentRegistry.hpp"
+
+using namespace pulseexec;
+
+TEST_CASE("FixedPoint conversion and formatting", "[fixed_point]") {
+  SECTION("Doubles round to the nearest mantissa") {
+    Price p(50000.5);
+    REQUIRE(p.decimals() == PriceTag::kDefaultDecimals);
+    REQUIRE(p.mantissa() == 500005000);
+    REQUIRE(p.to_double() == 50000.5);
+
+    // 0.1 + 0.2 is not 0.3 in binary floating point, but is in fixed point
+    REQUIRE(Qty(0.1) + Qty(0.2) == Qty(0.3));
+  }
+
+  SECTION("Exact decimal parsing") {
+    Price p;
+    REQUIRE(Price::parse("50000.25", p));
+    REQUIRE(p.mantissa() == 500002500);
+    REQUIRE(Price::parse("-0.00005", p));
+    REQUIRE(p.mantissa() == -1); // Fifth decimal rounds half away from zero
+    REQUIRE(Price::parse("7", p, 0));
+    REQUIRE(p.mantissa() == 7);
+
+    REQUIRE_FALSE(Price::parse("", p));
+    REQUIRE_FALSE(Price::parse("12a", p));
+    REQUIRE_FALSE(Price::parse("1.2.3", p));
+    REQUIRE_FALSE(Price::parse("--5", p));
+  }
+
+  SECTION("Parsing fails instead of overflowing the mantissa") {
+    Price p;
+    REQUIRE(Price::parse("9223372036854775807", p, 0));
+    REQUIRE(p.mantissa() == INT64_MAX);
+    REQUIRE(Price::parse("-92233720368547758.07", p, 2));
+    REQUIRE(p.mantissa() == -INT64_MAX);
+
+    REQUIRE_FALSE(Price::parse("92233720368547758.08", p, 2)); // Fraction digits
+    REQUIRE_FALSE(Price::parse("922337203685477581", p, 1));   // Padding to decimals
+    REQUIRE_FALSE(Price::parse("9223372036854775807.5", p, 0)); // Rounding up
+    REQUIRE_FALSE(Price::parse("99999999999999999999", p, 0));  // Whole part
+  }
+
+  SECTION("to_string is exact and trims trailing zeros") {
+    REQUIRE(Price(50000.0).to_string() == "50000");
+    REQUIRE(Qty(0.001).to_string() == "0.001");
+    REQUIRE(Price::from_mantissa(-15, 1).to_string() == "-1.5");
+    REQUIRE(Price::from_mantissa(-5, 2).to_string() == "-0.05");
+  }
+}
+
+TEST_CASE("FixedPoint arithmetic and comparison", "[fixed_point]") {
+  SECTION("Mixed decimals compare by value") {
+    REQUIRE(Price(1.5, 1) == Price(1.5, 6));
+    REQUIRE(Price(1.5, 1) < Price(1.55, 2));
+    REQUIRE(Price(2.0, 0) > Price(1.9999, 4));
+    REQUIRE((Price(1.5, 1) + Price(0.25, 2)).to_string() == "1.75");
+  }
+
+  SECTION("Rescaling and increments") {
+    REQUIRE(Price(1.2345, 4).rescaled(2) == Price(1.23, 2));
+    REQUIRE(Price(1.235, 3).rescaled(2) == Price(1.24, 2));
+    REQUIRE(Price(-1.235, 3).rescaled(2) == Price(-1.24, 2));
+
+    Price tick(0.5, 1);
+    REQUIRE(Price(50000.3).round_to(tick) == Price(50000.5));
+    REQUIRE(Price(50000.2).round_to(tick) == Price(50000.0));
+    REQUIRE(Price(50000.2).round_to(Price()) == Price(50000.2));
+  }
+
+  SECTION("Instrument scale normalizes onto tick and decimals") {
+    InstrumentScale scale;
+    scale.price_decimals = 2;
+    scale.qty_decimals = 0;
+    scale.tick_size = Price(0.05, 2);
+    scale.lot_size = Qty(10.0, 0);
+
+    Price p = scale.normalize(Price(3000.123));
+    REQUIRE(p.decimals() == 2);
+    REQUIRE(p == Price(3000.10));
+    REQUIRE(scale.normalize(Qty(24.0)) == Qty(20.0));
+  }
+
+  SECTION("Registry holds per-instrument scales") {
+    InstrumentRegistry registry;
+    InstrumentId eth = registry.intern("ETH-PERPETUAL");
+    REQUIRE(registry.scale(eth).price_decimals == PriceTag::kDefaultDecimals);
+
+    InstrumentScale scale;
+    scale.price_decimals = 2;
+    registry.set_scale(eth, scale);
+    REQUIRE(registry.scale(eth).price_decimals == 2);
+  }
+
+  SECTION("A scale loader sets each new instrument's scale once") {
+    InstrumentRegistry registry;
+    int loads = 0;
+    registry.set_scale_loader([&](const std::string& symbol, InstrumentScale& scale) {
+      ++loads;
+      scale.price_decimals = 1;
+      scale.tick_size = Price(0.5, 1);
+      return symbol == "BTC-PERPETUAL";
+    });
+
+    InstrumentId btc = registry.intern("BTC-PERPETUAL");
+    REQUIRE(registry.intern("BTC-PERPETUAL") == btc);
+    REQUIRE(loads == 1);
+    REQUIRE(registry.scale(btc).price_decimals == 1);
+    REQUIRE(registry.scale(btc).normalize(Price(50000.3)) == Price::from_mantissa(500005, 1));
+
+    // A failed load leaves the default scale, not a partly filled one
+    InstrumentId eth = registry.intern("ETH-PERPETUAL");
+    REQUIRE(registry.scale(eth).price_decimals == PriceTag::kDefaultDecimals);
+  }
+}
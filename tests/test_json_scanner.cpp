@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/JsonScanner.hpp"
+#include <string>
+
+using namespace pulseexec;
+
+TEST_CASE("JsonScanner reads only the values asked for", "[json_scanner]") {
+  // Long enough for the 16-byte scans to run over the skipped parts
+  const std::string text = R"({ "skip": {"nested": [1, "a \"quoted\" ]} string", {"x": [[], {}]}]},
+      "id" : 42, "neg": -7, "big": 18446744073709551615,
+      "price": 50000.25, "exp": 1.5e3, "flag": true, "none": null,
+      "name": "BTC-PERP\né😀", "tail": [1, 2, 3] })";
+  JsonScanner scanner(text);
+  REQUIRE(scanner.enter_object());
+
+  std::string_view key;
+  std::string_view raw;
+  int64_t id = 0;
+  int64_t neg = 0;
+  uint64_t big = 0;
+  Price price;
+  Price exp;
+  std::string name;
+  std::vector<std::string> keys;
+  while (scanner.next_key(key)) {
+    keys.emplace_back(key);
+    if (key == "id") {
+      REQUIRE(scanner.read_int(id));
+    } else if (key == "neg") {
+      REQUIRE(scanner.read_int(neg));
+    } else if (key == "big") {
+      REQUIRE(scanner.read_uint(big));
+    } else if (key == "price") {
+      REQUIRE(scanner.read_decimal(price, 2));
+    } else if (key == "exp") {
+      REQUIRE(scanner.read_decimal(exp, 1));
+    } else if (key == "name") {
+      REQUIRE(scanner.read_string(name));
+    } else if (key == "skip") {
+      REQUIRE(scanner.skip_value(&raw));
+    } else {
+      REQUIRE(scanner.skip_value());
+    }
+  }
+  REQUIRE(scanner.ok());
+
+  CHECK(keys.size() == 10);
+  CHECK(raw.front() == '{');
+  CHECK(raw.back() == '}');
+  CHECK(id == 42);
+  CHECK(neg == -7);
+  CHECK(big == UINT64_MAX);
+  CHECK(price == Price::from_mantissa(5000025, 2));
+  CHECK(exp == Price::from_mantissa(15000, 1));
+  CHECK(name == "BTC-PERP\n\xc3\xa9\xf0\x9f\x98\x80");
+}
+
+TEST_CASE("JsonScanner walks nested arrays and can leave them early", "[json_scanner]") {
+  JsonScanner scanner(R"([[1, 2, "x"], [3, 4], []])");
+  REQUIRE(scanner.enter_array());
+
+  std::vector<int64_t> firsts;
+  while (scanner.next_element()) {
+    REQUIRE(scanner.enter_array());
+    int64_t value = 0;
+    if (scanner.next_element() && scanner.read_int(value)) {
+      firsts.push_back(value);
+      REQUIRE(scanner.leave());
+    }
+  }
+  REQUIRE(scanner.ok());
+  CHECK(firsts == std::vector<int64_t>{1, 3});
+  CHECK(scanner.peek() == '\0');
+}
+
+TEST_CASE("JsonScanner finds keys and fails on malformed input", "[json_scanner]") {
+  SECTION("find_key stops on the value and reports absent keys") {
+    JsonScanner scanner(R"({"a": {"b": 1}, "c": "d"})");
+    REQUIRE(scanner.enter_object());
+    REQUIRE(scanner.find_key("c"));
+    CHECK(scanner.peek() == '"');
+
+    JsonScanner missing(R"({"a": 1})");
+    REQUIRE(missing.enter_object());
+    CHECK_FALSE(missing.find_key("b"));
+    CHECK(missing.ok());
+  }
+
+  SECTION("Errors stick and stop loops") {
+    for (const char* text : {R"({"a": 1 "b": 2})", R"({"a": [1, 2})", R"({"a": "unterminated)",
+                             R"({"a": tru})", R"({"a": })", R"({"a": 1,})", R"({"a": "\x"})"}) {
+      INFO(text);
+      JsonScanner scanner(text);
+      REQUIRE(scanner.enter_object());
+      std::string_view key;
+      std::string value;
+      while (scanner.next_key(key)) {
+        scanner.peek() == '"' ? scanner.read_string(value) : scanner.skip_value();
+      }
+      CHECK_FALSE(scanner.ok());
+      CHECK_FALSE(scanner.next_key(key));
+      CHECK(scanner.peek() == '\0');
+    }
+
+    JsonScanner scanner("[1,]");
+    REQUIRE(scanner.enter_array());
+    int64_t element = 0;
+    while (scanner.next_element()) {
+      scanner.read_int(element);
+    }
+    CHECK_FALSE(scanner.ok());
+  }
+
+  SECTION("Type mismatches fail") {
+    int64_t value = 0;
+    JsonScanner text_as_number(R"("12")");
+    CHECK_FALSE(text_as_number.read_int(value));
+    JsonScanner fraction_as_int("1.5");
+    CHECK_FALSE(fraction_as_int.read_int(value));
+    JsonScanner array_as_object("[]");
+    CHECK_FALSE(array_as_object.enter_object());
+  }
+}
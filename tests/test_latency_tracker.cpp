@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/LatencyTracker.hpp"
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+
+TEST_CASE("LatencyHistogram buckets and percentiles", "[latency_tracker]") {
+  SECTION("Buckets are contiguous and bounded") {
+    for (uint64_t v = 0; v < (uint64_t(1) << 16); ++v) {
+      size_t index = LatencyHistogram::bucket_index(v);
+      REQUIRE(v <= LatencyHistogram::bucket_upper_bound(index));
+      if (index > 0) {
+        REQUIRE(v > LatencyHistogram::bucket_upper_bound(index - 1));
+      }
+    }
+    REQUIRE(LatencyHistogram::bucket_index(LatencyHistogram::kMaxValue) ==
+            LatencyHistogram::kBucketCount - 1);
+  }
+
+  SECTION("Percentiles are within the bucket resolution") {
+    LatencyHistogram histogram;
+    REQUIRE(histogram.percentile(50) == 0);
+
+    for (int i = 1; i <= 1000; ++i) {
+      histogram.record(i * 1000);
+    }
+    REQUIRE(histogram.count() == 1000);
+    REQUIRE(histogram.max() == 1000000);
+
+    int64_t p50 = histogram.percentile(50);
+    REQUIRE(p50 >= 500000);
+    REQUIRE(p50 <= 500000 * 33 / 32);
+    REQUIRE(histogram.percentile(99) >= 990000);
+    REQUIRE(histogram.percentile(100) == 1000000);
+  }
+
+  SECTION("Small values are exact and out-of-range values are clamped") {
+    LatencyHistogram histogram;
+    histogram.record(-5);
+    histogram.record(7);
+    histogram.record(int64_t(1) << 60);
+    REQUIRE(histogram.percentile(0) == 0);
+    REQUIRE(histogram.percentile(50) == 7);
+    REQUIRE(histogram.max() == static_cast<int64_t>(LatencyHistogram::kMaxValue));
+  }
+
+  SECTION("drain_into moves every sample") {
+    LatencyHistogram source;
+    LatencyHistogram target;
+    source.record(10);
+    source.record(2000);
+    target.record(30);
+    source.drain_into(target);
+
+    REQUIRE(source.count() == 0);
+    REQUIRE(source.max() == 0);
+    REQUIRE(target.count() == 3);
+    REQUIRE(target.max() >= 2000);
+  }
+}
+
+TEST_CASE("LatencyTracker traces orders through the pipeline", "[latency_tracker]") {
+  LatencyTracker tracker(2);
+
+  auto summary_of = [](const std::vector<LatencyTracker::Summary>& summaries, LatencyOp op) {
+    for (const auto& s : summaries) {
+      if (s.op == op) {
+        return s;
+      }
+    }
+    return LatencyTracker::Summary{};
+  };
+
+  SECTION("A full trace records send, round trip and end to end") {
+    tracker.mark_created("A");
+    tracker.mark_sent("A");
+    tracker.mark_sent("A"); // A resubmission does not count twice
+    tracker.mark_acked("A");
+    REQUIRE(tracker.open_traces() == 0);
+
+    auto total = tracker.percentiles();
+    REQUIRE(total.size() == static_cast<size_t>(LatencyOp::COUNT));
+    REQUIRE(summary_of(total, LatencyOp::CREATE_TO_SEND).count == 1);
+    REQUIRE(summary_of(total, LatencyOp::GATEWAY_ROUND_TRIP).count == 1);
+    auto end_to_end = summary_of(total, LatencyOp::CREATE_TO_ACK);
+    REQUIRE(end_to_end.count == 1);
+    REQUIRE(end_to_end.p50_ns >= summary_of(total, LatencyOp::GATEWAY_ROUND_TRIP).p50_ns);
+  }
+
+  SECTION("Untraced and forgotten orders record nothing") {
+    tracker.mark_sent("unknown");
+    tracker.mark_acked("unknown");
+    tracker.mark_created("B");
+    tracker.forget("B");
+    tracker.mark_acked("B");
+
+    REQUIRE(tracker.open_traces() == 0);
+    REQUIRE(tracker.take_interval().empty());
+  }
+
+  SECTION("Open traces are bounded") {
+    tracker.mark_created("A");
+    tracker.mark_created("B");
+    tracker.mark_created("C");
+    REQUIRE(tracker.open_traces() == 2);
+    REQUIRE(tracker.dropped_traces() == 1);
+  }
+
+  SECTION("take_interval returns only samples since the previous call") {
+    tracker.record(LatencyOp::DB_PERSIST, 1500);
+    tracker.record(LatencyOp::DB_PERSIST, 2500);
+
+    auto interval = tracker.take_interval();
+    REQUIRE(interval.size() == 1);
+    REQUIRE(interval[0].op == LatencyOp::DB_PERSIST);
+    REQUIRE(interval[0].count == 2);
+    REQUIRE(tracker.take_interval().empty());
+
+    // The cumulative view keeps them
+    REQUIRE(summary_of(tracker.percentiles(), LatencyOp::DB_PERSIST).count == 2);
+  }
+}
+
+TEST_CASE("LatencyTracker records concurrently", "[latency_tracker]") {
+  LatencyTracker tracker;
+  const int threads = 8;
+  const int per_thread = 5000;
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      for (int i = 0; i < per_thread; ++i) {
+        tracker.record(LatencyOp::DB_PERSIST, (t + 1) * 1000 + i);
+      }
+    });
+  }
+  uint64_t drained = 0;
+  for (int i = 0; i < 20; ++i) {
+    for (const auto& s : tracker.take_interval()) {
+      drained += s.count;
+    }
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (const auto& s : tracker.take_interval()) {
+    drained += s.count;
+  }
+
+  REQUIRE(drained == static_cast<uint64_t>(threads) * per_thread);
+  REQUIRE(tracker.percentiles()[static_cast<size_t>(LatencyOp::DB_PERSIST)].count == drained);
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/LogRecord.hpp"
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+using namespace pulseexec;
+
+static LogRecord make_record(LogFormatId id) { return LogRecord(1, id, 1700000000000000); }
+
+TEST_CASE("LogRecord renders deferred formats", "[logger][log_record]") {
+  SECTION("String and order state arguments") {
+    LogRecord record = make_record(LogFormatId::ORDER_UPDATED);
+    encode_log_args(record, std::string("ORDER_1"), OrderState::FILLED);
+
+    REQUIRE(render_log_message(record) == "Updated order: ORDER_1 -> filled");
+    REQUIRE(log_record_component(record) == "OrderManager");
+  }
+
+  SECTION("Integer arguments") {
+    LogRecord record = make_record(LogFormatId::REQUEST_RETRY);
+    encode_log_args(record, 400, 2, 3);
+
+    REQUIRE(render_log_message(record) == "Retrying after 400ms (attempt 2/3)");
+    REQUIRE(log_record_component(record) == "ExecutionGateway");
+  }
+
+  SECTION("A full order store is told apart from a duplicate id") {
+    LogRecord full = make_record(LogFormatId::ORDER_STORE_FULL);
+    encode_log_args(full, "ORDER_1");
+    LogRecord duplicate = make_record(LogFormatId::DUPLICATE_CLIENT_ORDER_ID);
+    encode_log_args(duplicate, "ORDER_1");
+
+    REQUIRE(render_log_message(full) == "Order store full, dropped order: ORDER_1");
+    REQUIRE(render_log_message(duplicate) == "Duplicate client_order_id: ORDER_1");
+    REQUIRE(log_record_component(full) == "OrderManager");
+  }
+
+  SECTION("Missing arguments render as placeholders") {
+    LogRecord record = make_record(LogFormatId::ORDER_CREATED);
+    encode_log_args(record, "ORDER_1");
+
+    REQUIRE(render_log_message(record) == "Created order: ORDER_1 for ?");
+  }
+
+  SECTION("Oversized strings are truncated to the payload") {
+    LogRecord record = make_record(LogFormatId::ORDER_CREATED);
+    encode_log_args(record, std::string(500, 'x'), "BTC-PERPETUAL");
+
+    // The first string fills the payload, so the symbol no longer fits
+    std::string expected = "Created order: " + std::string(LogRecord::kPayloadBytes - 1, 'x') +
+                           " for ?";
+    REQUIRE(render_log_message(record) == expected);
+  }
+
+  SECTION("Text records keep their component and message") {
+    LogRecord record = make_record(LogFormatId::TEXT);
+    record.component = "Main";
+    record.message = "Starting";
+
+    auto j = nlohmann::json::parse(render_log_json(record));
+    REQUIRE(j["component"] == "Main");
+    REQUIRE(j["level"] == "INFO");
+    REQUIRE(j["message"] == "Starting");
+    REQUIRE(j["timestamp"] == 1700000000000000);
+  }
+}
+
+TEST_CASE("LogRecord binary round trip", "[logger][log_record]") {
+  std::stringstream stream;
+
+  LogRecord created = make_record(LogFormatId::ORDER_CREATED);
+  encode_log_args(created, "ORDER_1", "BTC-PERPETUAL");
+  LogRecord text = make_record(LogFormatId::TEXT);
+  text.component = "Main";
+  text.message = "Shutting down";
+
+  write_binary_log_record(stream, created);
+  write_binary_log_record(stream, text);
+
+  LogRecord decoded;
+  REQUIRE(read_binary_log_record(stream, decoded));
+  REQUIRE(render_log_json(decoded) == render_log_json(created));
+
+  REQUIRE(read_binary_log_record(stream, decoded));
+  REQUIRE(render_log_json(decoded) == render_log_json(text));
+
+  REQUIRE_FALSE(read_binary_log_record(stream, decoded));
+}
+
+TEST_CASE("LogRecord rejects arguments that overrun the payload", "[logger][log_record]") {
+  LogRecord record = make_record(LogFormatId::ORDER_CREATED);
+  encode_log_args(record, "ORDER_1", "BTC-PERPETUAL");
+  record.payload[0] = static_cast<char>(200); // First string now claims 200 bytes
+
+  SECTION("Rendering stops at the bad argument") {
+    REQUIRE(render_log_message(record) == "Created order: ? for ?");
+  }
+
+  SECTION("Reading it back fails") {
+    std::stringstream stream;
+    write_binary_log_record(stream, record);
+    LogRecord decoded;
+    REQUIRE_FALSE(read_binary_log_record(stream, decoded));
+  }
+
+  SECTION("More arguments than payload") {
+    LogRecord short_payload = make_record(LogFormatId::REQUEST_RETRY);
+    encode_log_args(short_payload, 400, 2, 3);
+    short_payload.payload_used = 12; // Cuts the second integer in half
+
+    REQUIRE(render_log_message(short_payload) == "Retrying after 400ms (attempt ?/?)");
+    std::stringstream stream;
+    write_binary_log_record(stream, short_payload);
+    LogRecord decoded;
+    REQUIRE_FALSE(read_binary_log_record(stream, decoded));
+  }
+}
@@ -0,0 +1,215 @@
+#include <catch2/catch_test_macros.hpp>
+#include "LocalWebSocketServer.hpp"
+#include "pulseexec/IncrementalBook.hpp"
+#include "pulseexec/MarketDataFeed.hpp"
+#include <chrono>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <thread>
+
+using namespace pulseexec;
+
+namespace {
+
+const InstrumentScale kBtcScale{1, 0, Price(0.5, 1), Qty(10.0, 0)};
+
+// Book notification in the exchange's wire format
+std::string book_message(const std::string& type, uint64_t change_id, uint64_t prev_change_id,
+                         const std::string& bids, const std::string& asks) {
+  std::string prev =
+      type == "snapshot" ? "" : R"("prev_change_id":)" + std::to_string(prev_change_id) + ",";
+  return R"({"jsonrpc":"2.0","method":"subscription",)"
+         R"("params":{"channel":"book.BTC-PERPETUAL.100ms","data":{"type":")" +
+         type + R"(","timestamp":1700000000000,"instrument_name":"BTC-PERPETUAL",)" +
+         R"("change_id":)" + std::to_string(change_id) + "," + prev + R"("bids":)" + bids +
+         R"(,"asks":)" + asks + "}}}";
+}
+
+// Recorded session: snapshot followed by two chained changes
+std::vector<std::string> recorded_session() {
+  return {
+      book_message("snapshot", 100, 0,
+                   R"([["new",50000.0,1000],["new",49999.5,2000],["new",49999.0,500]])",
+                   R"([["new",50000.5,800],["new",50001.0,1500]])"),
+      book_message("change", 101, 100, R"([["change",50000.0,1200]])",
+                   R"([["delete",50000.5,0]])"),
+      book_message("change", 102, 101, R"([["new",50000.5,300]])", R"([["new",50001.5,100]])"),
+  };
+}
+
+BookDelta snapshot_delta(uint64_t change_id) {
+  BookDelta delta;
+  delta.snapshot = true;
+  delta.change_id = change_id;
+  delta.bids = {{LevelUpdate::Action::NEW, Price(100.0, 1), Qty(5.0, 0)},
+                {LevelUpdate::Action::NEW, Price(99.5, 1), Qty(7.0, 0)}};
+  delta.asks = {{LevelUpdate::Action::NEW, Price(100.5, 1), Qty(3.0, 0)}};
+  return delta;
+}
+
+template <typename Pred> bool wait_for(Pred pred) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!pred()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return true;
+}
+
+void check_recorded_book(const OrderBook& book) {
+  REQUIRE(book.bids.size() == 4);
+  CHECK(book.bids[0].price == Price(50000.5, 1));
+  CHECK(book.bids[0].amount == Qty(300.0, 0));
+  CHECK(book.bids[1].price == Price(50000.0, 1));
+  CHECK(book.bids[1].amount == Qty(1200.0, 0));
+  CHECK(book.bids[3].price == Price(49999.0, 1));
+
+  REQUIRE(book.asks.size() == 2);
+  CHECK(book.asks[0].price == Price(50001.0, 1));
+  CHECK(book.asks[1].price == Price(50001.5, 1));
+  CHECK(book.sequence == 102);
+}
+
+} // namespace
+
+TEST_CASE("IncrementalBook applies snapshots and chained changes", "[market_data]") {
+  IncrementalBook book("TEST", kBtcScale);
+  REQUIRE(book.apply(snapshot_delta(10)) == IncrementalBook::ApplyResult::APPLIED);
+  REQUIRE(book.synced());
+
+  SECTION("Changes insert, resize and delete levels in price order") {
+    BookDelta change;
+    change.change_id = 11;
+    change.prev_change_id = 10;
+    change.bids = {{LevelUpdate::Action::NEW, Price(100.5, 1), Qty(1.0, 0)},
+                   {LevelUpdate::Action::CHANGE, Price(99.5, 1), Qty(9.0, 0)},
+                   {LevelUpdate::Action::DELETE, Price(100.0, 1), Qty()}};
+    change.asks = {{LevelUpdate::Action::NEW, Price(101.0, 1), Qty(2.0, 0)},
+                   {LevelUpdate::Action::DELETE, Price(105.0, 1), Qty()}}; // Absent: ignored
+    REQUIRE(book.apply(change) == IncrementalBook::ApplyResult::APPLIED);
+
+    OrderBook top;
+    book.top(10, top);
+    REQUIRE(top.bids.size() == 2);
+    CHECK(top.bids[0].price == Price(100.5, 1));
+    CHECK(top.bids[1].price == Price(99.5, 1));
+    CHECK(top.bids[1].amount == Qty(9.0, 0));
+    REQUIRE(top.asks.size() == 2);
+    CHECK(top.asks[0].price == Price(100.5, 1));
+    CHECK(top.asks[1].price == Price(101.0, 1));
+    CHECK(top.sequence == 11);
+
+    book.top(1, top);
+    CHECK(top.bids.size() == 1);
+    CHECK(top.asks.size() == 1);
+  }
+
+  SECTION("A gap drops the book until the next snapshot") {
+    BookDelta change;
+    change.change_id = 13;
+    change.prev_change_id = 12;
+    CHECK(book.apply(change) == IncrementalBook::ApplyResult::GAP);
+    CHECK_FALSE(book.synced());
+    CHECK(book.bid_depth() == 0);
+
+    change.change_id = 14;
+    change.prev_change_id = 13;
+    CHECK(book.apply(change) == IncrementalBook::ApplyResult::AWAITING_SNAPSHOT);
+
+    CHECK(book.apply(snapshot_delta(20)) == IncrementalBook::ApplyResult::APPLIED);
+    CHECK(book.synced());
+    CHECK(book.change_id() == 20);
+    CHECK(book.bid_depth() == 2);
+  }
+}
+
+TEST_CASE("MarketDataFeed replays recorded messages without a socket", "[market_data]") {
+  MarketDataFeed feed("ws://127.0.0.1:1/ws/api/v2", nullptr);
+  feed.subscribe("BTC-PERPETUAL", kBtcScale);
+
+  OrderBook book;
+  CHECK_FALSE(feed.get_book("BTC-PERPETUAL", book)); // No snapshot yet
+  CHECK_FALSE(feed.get_book("ETH-PERPETUAL", book)); // Not subscribed
+
+  feed.process_message("not json");
+  feed.process_message(R"({"jsonrpc":"2.0","id":1,"result":["book.BTC-PERPETUAL.100ms"]})");
+  for (const auto& message : recorded_session()) {
+    feed.process_message(message);
+  }
+
+  REQUIRE(feed.get_book("BTC-PERPETUAL", book));
+  check_recorded_book(book);
+
+  auto stats = feed.stats();
+  CHECK(stats.messages == 5);
+  CHECK(stats.deltas_applied == 3);
+  CHECK(stats.gaps == 0);
+}
+
+TEST_CASE("MarketDataFeed streams from a WebSocket endpoint and resnapshots on gaps",
+          "[market_data]") {
+  std::mutex mutex;
+  int subscribes = 0;
+
+  testing::LocalWebSocketServer server([&](const std::string& text) {
+    auto request = nlohmann::json::parse(text);
+    std::string ack = nlohmann::json{{"jsonrpc", "2.0"},
+                                     {"id", request["id"]},
+                                     {"result", request["params"]["channels"]}}
+                          .dump();
+    if (request["method"] != "public/subscribe") {
+      return std::vector<std::string>{ack};
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> replies{ack};
+    if (++subscribes == 1) {
+      // Recorded session, then a change whose predecessor (103) was lost
+      for (auto& message : recorded_session()) {
+        replies.push_back(message);
+      }
+      replies.push_back(book_message("change", 104, 103, "[]", R"([["new",50002.0,10]])"));
+      replies.push_back(book_message("change", 105, 104, "[]", "[]"));
+    } else {
+      replies.push_back(book_message("snapshot", 200, 0, R"([["new",50010.0,50]])",
+                                     R"([["new",50010.5,60]])"));
+      replies.push_back(book_message("change", 201, 200, R"([["new",50009.5,70]])", "[]"));
+    }
+    return replies;
+  });
+  server.start();
+
+  MarketDataFeed feed(server.url(), nullptr, 5);
+  feed.subscribe("BTC-PERPETUAL", kBtcScale);
+
+  std::mutex books_mutex;
+  std::vector<uint64_t> published;
+  feed.set_book_handler([&](const OrderBook& book) {
+    std::lock_guard<std::mutex> lock(books_mutex);
+    published.push_back(book.sequence);
+  });
+  REQUIRE(feed.start());
+
+  OrderBook book;
+  REQUIRE(wait_for([&] { return feed.get_book("BTC-PERPETUAL", book) && book.sequence == 201; }));
+  feed.stop();
+  server.stop();
+
+  REQUIRE(book.bids.size() == 2);
+  CHECK(book.bids[0].price == Price(50010.0, 1));
+  CHECK(book.bids[1].price == Price(50009.5, 1));
+  REQUIRE(book.asks.size() == 1);
+  CHECK(book.asks[0].amount == Qty(60.0, 0));
+
+  auto stats = feed.stats();
+  CHECK(stats.gaps == 1);
+  CHECK(stats.resnapshots == 1);
+  CHECK(stats.reconnects == 0);
+  CHECK(subscribes == 2);
+
+  // Change 105 arrived before the new snapshot and was dropped, never published
+  CHECK(published == std::vector<uint64_t>{100, 101, 102, 200, 201});
+  CHECK(stats.dropped_changes == 1);
+}
@@ -0,0 +1,198 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/MatchingEngine.hpp"
+
+using namespace pulseexec;
+
+namespace {
+
+const InstrumentScale kBtcScale{1, 0, Price(0.5, 1), Qty(10.0, 0)};
+
+Price px(double value) { return kBtcScale.price(value); }
+Qty qty(double value) { return kBtcScale.qty(value); }
+
+} // namespace
+
+TEST_CASE("MatchingEngine rests and matches in price-time priority", "[matching_engine]") {
+  MatchingEngine engine("BTC-PERPETUAL", kBtcScale);
+
+  engine.submit(1, Side::SELL, OrderType::LIMIT, px(50001.0), qty(10), "a1", 1);
+  engine.submit(2, Side::SELL, OrderType::LIMIT, px(50000.5), qty(20), "a2", 2);
+  engine.submit(3, Side::SELL, OrderType::LIMIT, px(50000.5), qty(30), "a3", 3);
+  engine.submit(4, Side::BUY, OrderType::LIMIT, px(49999.0), qty(40), "b1", 4);
+  REQUIRE(engine.ask_depth() == 2);
+  REQUIRE(engine.bid_depth() == 1);
+
+  OrderBook book;
+  engine.top(10, book);
+  REQUIRE(book.asks.size() == 2);
+  CHECK(book.asks[0].price == px(50000.5));
+  CHECK(book.asks[0].amount == qty(50));
+  CHECK(book.asks[1].price == px(50001.0));
+  CHECK(book.bids[0].price == px(49999.0));
+
+  SECTION("A crossing order fills the oldest order at the best price first") {
+    const MatchingOrder& taker =
+        *engine.submit(5, Side::BUY, OrderType::LIMIT, px(50001.0), qty(60), "t", 5);
+    CHECK(taker.state == OrderState::FILLED);
+    REQUIRE(engine.fills().size() == 3);
+    CHECK(engine.fills()[0].maker_id == 2);
+    CHECK(engine.fills()[0].amount == qty(20));
+    CHECK(engine.fills()[1].maker_id == 3);
+    CHECK(engine.fills()[1].amount == qty(30));
+    CHECK(engine.fills()[1].price == px(50000.5));
+    CHECK(engine.fills()[2].maker_id == 1);
+    CHECK(engine.fills()[2].amount == qty(10));
+    CHECK(engine.fills()[2].price == px(50001.0));
+    CHECK(engine.ask_depth() == 0);
+    CHECK(engine.trade_count() == 3);
+  }
+
+  SECTION("A limit order takes only up to its price and rests the remainder") {
+    const MatchingOrder& taker =
+        *engine.submit(5, Side::BUY, OrderType::LIMIT, px(50000.5), qty(60), "t", 5);
+    CHECK(taker.state == OrderState::PARTIAL);
+    CHECK(taker.filled == qty(50));
+    CHECK(engine.find(2)->state == OrderState::FILLED);
+    CHECK(engine.find(3)->state == OrderState::FILLED);
+
+    engine.top(10, book);
+    REQUIRE(book.bids.size() == 2);
+    CHECK(book.bids[0].price == px(50000.5));
+    CHECK(book.bids[0].amount == qty(10));
+    REQUIRE(book.asks.size() == 1);
+    CHECK(book.asks[0].price == px(50001.0));
+
+    // The emptied ask level and the new bid level, each reported once
+    REQUIRE(engine.level_changes().size() == 2);
+    CHECK(engine.level_changes()[0].side == Side::SELL);
+    CHECK(engine.level_changes()[0].amount.is_zero());
+    CHECK(engine.level_changes()[1].side == Side::BUY);
+    CHECK(engine.level_changes()[1].amount == qty(10));
+  }
+
+  SECTION("A market order takes what there is and cancels the rest") {
+    const MatchingOrder& taker =
+        *engine.submit(5, Side::SELL, OrderType::MARKET, Price(), qty(100), "m", 5);
+    CHECK(taker.state == OrderState::CANCELED);
+    CHECK(taker.filled == qty(40));
+    CHECK(engine.bid_depth() == 0);
+  }
+
+  SECTION("Canceled orders lose their place and are skipped when matching") {
+    REQUIRE(engine.cancel(2, 5));
+    CHECK(engine.find(2)->state == OrderState::CANCELED);
+    CHECK_FALSE(engine.cancel(2, 6));
+    CHECK_FALSE(engine.cancel(99, 6));
+
+    engine.top(10, book);
+    CHECK(book.asks[0].amount == qty(30));
+
+    engine.submit(5, Side::BUY, OrderType::LIMIT, px(50000.5), qty(10), "t", 7);
+    REQUIRE(engine.fills().size() == 1);
+    CHECK(engine.fills()[0].maker_id == 3);
+  }
+
+  SECTION("Edits keep priority only when shrinking at the same price") {
+    REQUIRE(engine.edit(2, px(50000.5), qty(10), 5));
+    engine.submit(5, Side::BUY, OrderType::LIMIT, px(50000.5), qty(10), "t", 6);
+    REQUIRE(engine.fills().size() == 1);
+    CHECK(engine.fills()[0].maker_id == 2);
+
+    engine.submit(6, Side::SELL, OrderType::LIMIT, px(50000.5), qty(10), "a4", 7);
+    REQUIRE(engine.edit(3, px(50000.5), qty(40), 8)); // Grows: now behind order 6
+    engine.submit(7, Side::BUY, OrderType::LIMIT, px(50000.5), qty(40), "t", 9);
+    REQUIRE(engine.fills().size() == 2);
+    CHECK(engine.fills()[0].maker_id == 6);
+    CHECK(engine.fills()[1].maker_id == 3);
+    CHECK(engine.find(3)->state == OrderState::PARTIAL);
+  }
+
+  SECTION("An edit that crosses the book matches") {
+    REQUIRE(engine.edit(4, px(50000.5), qty(30), 5));
+    CHECK(engine.find(4)->state == OrderState::FILLED);
+    REQUIRE(engine.fills().size() == 2);
+    CHECK(engine.fills()[0].taker_id == 4);
+    CHECK(engine.bid_depth() == 0);
+  }
+
+  SECTION("Edits below the filled amount or of closed orders are refused") {
+    engine.submit(5, Side::BUY, OrderType::LIMIT, px(50000.5), qty(10), "t", 5);
+    REQUIRE(engine.find(2)->filled == qty(10));
+    CHECK_FALSE(engine.edit(2, px(50000.5), qty(10), 6));
+    CHECK(engine.edit(2, px(50000.5), qty(20), 6));
+    CHECK_FALSE(engine.edit(5, px(50000.5), qty(20), 6));
+  }
+}
+
+TEST_CASE("MatchingEngine normalizes and rejects inputs", "[matching_engine]") {
+  MatchingEngine engine("BTC-PERPETUAL", kBtcScale);
+
+  const MatchingOrder& order =
+      *engine.submit(1, Side::BUY, OrderType::LIMIT, Price(50000.3, 2), Qty(12.0, 2), "n", 1);
+  CHECK(order.state == OrderState::OPEN);
+  CHECK(order.price == px(50000.5));
+  CHECK(order.amount == qty(10));
+
+  CHECK(engine.submit(2, Side::BUY, OrderType::LIMIT, px(50000.0), qty(0), "z", 2)->state ==
+        OrderState::REJECTED);
+  CHECK(engine.submit(3, Side::SELL, OrderType::LIMIT, Price(), qty(10), "p", 3)->state ==
+        OrderState::REJECTED);
+  CHECK(engine.bid_depth() == 1);
+  CHECK(engine.ask_depth() == 0);
+  CHECK(engine.order_count() == 3);
+}
+
+TEST_CASE("MatchingEngine keeps only recent terminal orders", "[matching_engine]") {
+  MatchingEngine engine("BTC-PERPETUAL", kBtcScale, 2);
+
+  // Two asks share a level; the first is canceled, leaving a stale queue entry
+  engine.submit(1, Side::SELL, OrderType::LIMIT, px(50000.0), qty(10), "a1", 1);
+  engine.submit(2, Side::SELL, OrderType::LIMIT, px(50000.0), qty(10), "a2", 2);
+  REQUIRE(engine.cancel(1, 3));
+
+  // Enough other orders finish to push order 1 out of the retention
+  engine.submit(3, Side::BUY, OrderType::LIMIT, px(40000.0), qty(10), "b1", 4);
+  REQUIRE(engine.cancel(3, 5));
+  CHECK(engine.submit(4, Side::BUY, OrderType::LIMIT, px(40000.0), qty(0), "b2", 6)->state ==
+        OrderState::REJECTED);
+  CHECK(engine.find(1) == nullptr);
+  CHECK(engine.find(3) != nullptr);
+  CHECK(engine.find(4) != nullptr);
+  CHECK(engine.order_count() == 3); // Order 2 is open and never dropped
+
+  // Matching skips the entry whose order is gone and fills order 2
+  const MatchingOrder& taker =
+      *engine.submit(5, Side::BUY, OrderType::LIMIT, px(50000.0), qty(10), "b3", 7);
+  CHECK(taker.state == OrderState::FILLED);
+  REQUIRE(engine.fills().size() == 1);
+  CHECK(engine.fills()[0].maker_id == 2);
+  CHECK(engine.ask_depth() == 0);
+
+  // Orders 2 and 5 are now the two retained terminal orders
+  CHECK(engine.find(2)->state == OrderState::FILLED);
+  CHECK(engine.find(5)->state == OrderState::FILLED);
+  CHECK(engine.find(3) == nullptr);
+  CHECK(engine.order_count() == 2);
+}
+
+TEST_CASE("MatchingEngine refuses IDs it still knows", "[matching_engine]") {
+  MatchingEngine engine("BTC-PERPETUAL", kBtcScale, 1);
+  OrderBook book;
+
+  engine.submit(1, Side::SELL, OrderType::LIMIT, px(50000.0), qty(10), "a1", 1);
+  CHECK(engine.submit(1, Side::SELL, OrderType::LIMIT, px(50001.0), qty(20), "dup", 2) ==
+        nullptr);
+  CHECK(engine.find(1)->label == "a1");
+  engine.top(10, book);
+  REQUIRE(book.asks.size() == 1);
+  CHECK(book.asks[0].amount == qty(10));
+
+  // The only retained terminal order stays queryable after a reused ID
+  const MatchingOrder& rejected =
+      *engine.submit(2, Side::BUY, OrderType::LIMIT, px(40000.0), qty(0), "b1", 3);
+  CHECK(rejected.state == OrderState::REJECTED);
+  CHECK(engine.submit(2, Side::BUY, OrderType::LIMIT, px(40000.0), qty(0), "b1", 4) == nullptr);
+  REQUIRE(engine.find(2) != nullptr);
+  CHECK(engine.find(2)->state == OrderState::REJECTED);
+  CHECK(engine.order_count() == 2);
+}
@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/MpscRingBuffer.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+
+TEST_CASE("MpscRingBuffer single-threaded behavior", "[ring_buffer]") {
+  SECTION("Capacity rounds up to a power of two") {
+    MpscRingBuffer<int> ring(100);
+    REQUIRE(ring.capacity() == 128);
+  }
+
+  SECTION("FIFO order and empty detection") {
+    MpscRingBuffer<int> ring(8);
+    REQUIRE(ring.empty());
+
+    for (int i = 0; i < 5; ++i) {
+      REQUIRE(ring.try_push(int(i)));
+    }
+    REQUIRE_FALSE(ring.empty());
+
+    int value = -1;
+    for (int i = 0; i < 5; ++i) {
+      REQUIRE(ring.try_pop(value));
+      REQUIRE(value == i);
+    }
+    REQUIRE_FALSE(ring.try_pop(value));
+    REQUIRE(ring.empty());
+  }
+
+  SECTION("Push fails when full and succeeds again after a pop") {
+    MpscRingBuffer<int> ring(4);
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(ring.try_push(int(i)));
+    }
+    REQUIRE_FALSE(ring.try_push(99));
+
+    int value = -1;
+    REQUIRE(ring.try_pop(value));
+    REQUIRE(ring.try_push(99));
+  }
+}
+
+TEST_CASE("MpscRingBuffer concurrent producers", "[ring_buffer][concurrency]") {
+  const int num_producers = 4;
+  const int items_per_producer = 20000;
+  MpscRingBuffer<int> ring(1024);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_producers; ++p) {
+    producers.emplace_back([&ring, p]() {
+      for (int i = 0; i < items_per_producer; ++i) {
+        int value = p * items_per_producer + i;
+        while (!ring.try_push(int(value))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // Every item must arrive exactly once, and each producer's items in order
+  std::vector<int> seen(num_producers * items_per_producer, 0);
+  std::vector<int> last_per_producer(num_producers, -1);
+  bool in_order = true;
+  int received = 0;
+  int value = 0;
+  while (received < num_producers * items_per_producer) {
+    if (ring.try_pop(value)) {
+      int producer = value / items_per_producer;
+      in_order = in_order && value > last_per_producer[producer];
+      last_per_producer[producer] = value;
+      seen[value]++;
+      received++;
+    }
+  }
+
+  for (auto& thread : producers) {
+    thread.join();
+  }
+
+  REQUIRE(in_order);
+  bool all_once = true;
+  for (int count : seen) {
+    all_once = all_once && count == 1;
+  }
+  REQUIRE(all_once);
+}
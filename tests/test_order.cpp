@@ -9,8 +9,8 @@ TEST_CASE("OrderRequest construction", "[order][request]") {
     OrderRequest req;
     REQUIRE(req.symbol.empty());
     REQUIRE(req.side == Side::BUY);
-    REQUIRE(req.price == 0.0);
-    REQUIRE(req.amount == 0.0);
+    REQUIRE(req.price.is_zero());
+    REQUIRE(req.amount.is_zero());
     REQUIRE(req.type == OrderType::LIMIT);
   }
 
@@ -18,8 +18,8 @@ TEST_CASE("OrderRequest construction", "[order][request]") {
     OrderRequest req("BTC-PERPETUAL", Side::SELL, 50000.0, 1.5, OrderType::LIMIT, "test_123");
     REQUIRE(req.symbol == "BTC-PERPETUAL");
     REQUIRE(req.side == Side::SELL);
-    REQUIRE(req.price == 50000.0);
-    REQUIRE(req.amount == 1.5);
+    REQUIRE(req.price == Price(50000.0));
+    REQUIRE(req.amount == Qty(1.5));
     REQUIRE(req.type == OrderType::LIMIT);
     REQUIRE(req.client_order_id == "test_123");
   }
@@ -59,7 +59,7 @@ TEST_CASE("Order construction and state", "[order]") {
     REQUIRE(order.client_order_id.empty());
     REQUIRE(order.exchange_order_id.empty());
     REQUIRE(order.state == OrderState::PENDING);
-    REQUIRE(order.filled_amount == 0.0);
+    REQUIRE(order.filled_amount.is_zero());
     REQUIRE(order.created_ts_us == 0);
     REQUIRE(order.last_update_ts_us == 0);
   }
@@ -70,7 +70,7 @@ TEST_CASE("Order construction and state", "[order]") {
 
     REQUIRE(order.client_order_id == "client_123");
     REQUIRE(order.state == OrderState::PENDING);
-    REQUIRE(order.filled_amount == 0.0);
+    REQUIRE(order.filled_amount.is_zero());
     REQUIRE(order.created_ts_us == 1000000);
     REQUIRE(order.last_update_ts_us == 1000000);
   }
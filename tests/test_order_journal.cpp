@@ -0,0 +1,303 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/DBWriter.hpp"
+#include "pulseexec/Logger.hpp"
+#include "pulseexec/OrderJournal.hpp"
+#include "pulseexec/OrderManager.hpp"
+#include "pulseexec/OrderRecovery.hpp"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+
+namespace {
+
+Order make_order(const std::string& id, OrderState state, double filled = 0.0) {
+  OrderRequest req("ETH-PERPETUAL", Side::SELL, 3000.25, 2.0, OrderType::LIMIT);
+  Order order(id, req, 10);
+  order.state = state;
+  order.filled_amount = Qty(filled);
+  order.last_update_ts_us = 20;
+  return order;
+}
+
+std::vector<JournalRecord> read_all(const OrderJournal& journal, uint64_t after = 0) {
+  std::vector<JournalRecord> records;
+  journal.replay(after, [&](const JournalRecord& r) { records.push_back(r); });
+  return records;
+}
+
+} // namespace
+
+TEST_CASE("OrderJournal append and replay", "[order_journal]") {
+  std::string path = "/tmp/pulseexec_test_order_journal.bin";
+  std::remove(path.c_str());
+
+  auto logger = std::make_shared<Logger>();
+  OrderJournalOptions options;
+  options.grow_bytes = 4096; // Small, so appends have to grow the mapping
+
+  SECTION("Records come back in order with every field intact") {
+    OrderJournal journal(path, logger, options);
+    REQUIRE(journal.open());
+
+    Order order = make_order("journaled", OrderState::PARTIAL, 0.5);
+    order.exchange_order_id = "EX-7";
+    order.error_message = "partially filled";
+    REQUIRE(journal.append(order) == 1);
+    order.state = OrderState::FILLED;
+    order.filled_amount = Qty(2.0);
+    REQUIRE(journal.append(order) == 2);
+    REQUIRE(journal.durable_sequence() == 2);
+
+    auto records = read_all(journal);
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[0].sequence == 1);
+    REQUIRE(records[0].order.state == OrderState::PARTIAL);
+    REQUIRE(records[0].order.filled_amount == Qty(0.5));
+    REQUIRE(records[1].order.state == OrderState::FILLED);
+
+    const Order& loaded = records[1].order;
+    REQUIRE(loaded.client_order_id == "journaled");
+    REQUIRE(loaded.exchange_order_id == "EX-7");
+    REQUIRE(loaded.request.symbol == "ETH-PERPETUAL");
+    REQUIRE(loaded.request.side == Side::SELL);
+    REQUIRE(loaded.request.type == OrderType::LIMIT);
+    REQUIRE(loaded.request.price == Price(3000.25));
+    REQUIRE(loaded.request.amount == Qty(2.0));
+    REQUIRE(loaded.created_ts_us == 10);
+    REQUIRE(loaded.last_update_ts_us == 20);
+    REQUIRE(loaded.error_message == "partially filled");
+
+    REQUIRE(read_all(journal, 1).size() == 1);
+  }
+
+  SECTION("Reopening continues the sequence across growth") {
+    {
+      OrderJournal journal(path, logger, options);
+      REQUIRE(journal.open());
+      for (int i = 0; i < 500; ++i) {
+        REQUIRE(journal.append(make_order("order_" + std::to_string(i), OrderState::OPEN)) ==
+                static_cast<uint64_t>(i + 1));
+      }
+      REQUIRE(journal.size_bytes() > 4096 * 2);
+      journal.checkpoint(300);
+    }
+
+    OrderJournal journal(path, logger, options);
+    REQUIRE(journal.open());
+    REQUIRE(journal.last_sequence() == 500);
+    REQUIRE(journal.checkpoint_sequence() == 300);
+    REQUIRE(journal.append(make_order("after_reopen", OrderState::OPEN)) == 501);
+    REQUIRE(read_all(journal, journal.checkpoint_sequence()).size() == 201);
+  }
+
+  SECTION("A torn tail is discarded and overwritten") {
+    size_t intact_bytes = 0;
+    {
+      OrderJournal journal(path, logger, options);
+      REQUIRE(journal.open());
+      journal.append(make_order("first", OrderState::OPEN));
+      intact_bytes = journal.size_bytes();
+      journal.append(make_order("second", OrderState::OPEN));
+    }
+
+    // Flip a byte inside the second record's payload
+    {
+      std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(static_cast<std::streamoff>(intact_bytes + 20));
+      file.put('\x7F');
+    }
+
+    OrderJournal journal(path, logger, options);
+    REQUIRE(journal.open());
+    REQUIRE(journal.last_sequence() == 1);
+    REQUIRE(journal.size_bytes() == intact_bytes);
+    REQUIRE(journal.append(make_order("replacement", OrderState::OPEN)) == 2);
+
+    auto records = read_all(journal);
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[1].order.client_order_id == "replacement");
+  }
+
+  SECTION("Concurrent appends share group commits") {
+    OrderJournal journal(path, logger, options);
+    REQUIRE(journal.open());
+
+    const int num_threads = 8;
+    const int per_thread = 200;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < per_thread; ++i) {
+          journal.append(make_order(std::to_string(t) + "_" + std::to_string(i), OrderState::OPEN));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    REQUIRE(journal.durable_sequence() == num_threads * per_thread);
+    REQUIRE(journal.sync_count() <= num_threads * per_thread);
+    REQUIRE(read_all(journal).size() == num_threads * per_thread);
+  }
+
+  SECTION("Replay runs safely while appends grow the file") {
+    OrderJournalOptions unsynced = options;
+    unsynced.fsync = false; // Appends fast enough to remap during the replay
+    OrderJournal journal(path, logger, unsynced);
+    REQUIRE(journal.open());
+    for (int i = 0; i < 2000; ++i) {
+      journal.append(make_order("before_" + std::to_string(i), OrderState::OPEN));
+    }
+
+    std::atomic<bool> done{false};
+    std::thread appender([&] {
+      for (int i = 0; !done; ++i) {
+        journal.append(make_order("during_" + std::to_string(i), OrderState::OPEN));
+      }
+    });
+
+    for (int pass = 0; pass < 20; ++pass) {
+      uint64_t expected = 1;
+      bool in_order = true;
+      size_t replayed = journal.replay(0, [&](const JournalRecord& r) {
+        in_order = in_order && r.sequence == expected++;
+      });
+      REQUIRE(in_order);
+      REQUIRE(replayed >= 2000);
+    }
+    done = true;
+    appender.join();
+  }
+
+  SECTION("A checkpoint rotates out the records it covers") {
+    std::string archive = path + ".500";
+    std::remove(archive.c_str());
+    OrderJournalOptions rotating = options;
+    rotating.rotate_bytes = 8192;
+    rotating.keep_rotated = true;
+    {
+      OrderJournal journal(path, logger, rotating);
+      REQUIRE(journal.open());
+      for (int i = 0; i < 500; ++i) {
+        journal.append(make_order("order_" + std::to_string(i), OrderState::OPEN));
+      }
+      size_t full_bytes = journal.size_bytes();
+
+      journal.checkpoint(10); // Too little covered to rotate
+      REQUIRE(journal.size_bytes() == full_bytes);
+
+      journal.checkpoint(300);
+      REQUIRE(journal.size_bytes() < full_bytes / 2);
+      REQUIRE(journal.checkpoint_sequence() == 300);
+      REQUIRE(journal.last_sequence() == 500);
+      REQUIRE(journal.durable_sequence() == 500);
+
+      auto records = read_all(journal);
+      REQUIRE(records.size() == 200);
+      REQUIRE(records.front().sequence == 301);
+      REQUIRE(records.front().order.client_order_id == "order_300");
+      REQUIRE(journal.append(make_order("after_rotation", OrderState::OPEN)) == 501);
+    }
+
+    // The sequence carries on across a reopen
+    {
+      OrderJournal journal(path, logger, rotating);
+      REQUIRE(journal.open());
+      REQUIRE(journal.last_sequence() == 501);
+      REQUIRE(journal.checkpoint_sequence() == 300);
+      REQUIRE(read_all(journal, 300).size() == 201);
+      REQUIRE(journal.append(make_order("after_reopen", OrderState::OPEN)) == 502);
+    }
+
+    // The rotated-out file still holds everything up to the rotation
+    OrderJournal archived(archive, logger, rotating);
+    REQUIRE(archived.open());
+    REQUIRE(archived.last_sequence() == 500);
+    REQUIRE(read_all(archived).size() == 500);
+    archived.close();
+    std::remove(archive.c_str());
+  }
+
+  SECTION("Files that are not journals are refused") {
+    {
+      std::ofstream file(path, std::ios::binary);
+      file << std::string(8192, 'x');
+    }
+    OrderJournal journal(path, logger, options);
+    REQUIRE_FALSE(journal.open());
+    REQUIRE(journal.append(make_order("nowhere", OrderState::OPEN)) == 0);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("OrderJournal rebuilds SQLite after a crash", "[order_journal][order_recovery]") {
+  std::string path = "/tmp/pulseexec_test_order_journal_crash.bin";
+  std::string db_path = "/tmp/pulseexec_test_order_journal_crash.db";
+  for (const std::string& file : {path, db_path, db_path + "-wal", db_path + "-shm"}) {
+    std::remove(file.c_str());
+  }
+
+  auto logger = std::make_shared<Logger>();
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+
+  // A run whose SQLite writes never happen, as if the process died with them queued
+  std::string open_id;
+  std::string filled_id;
+  {
+    auto journal = std::make_shared<OrderJournal>(path, logger);
+    REQUIRE(journal->open());
+    OrderManager manager(logger, nullptr);
+    manager.set_journal(journal);
+
+    OrderHandle open = manager.create_order(req);
+    manager.update_order(open, OrderState::OPEN, "EX-1");
+    open_id = manager.get_client_order_id(open);
+
+    OrderHandle filled = manager.create_order(req);
+    manager.update_order(filled, OrderState::OPEN, "EX-2");
+    manager.update_order(filled, OrderState::FILLED, "", Qty(1.0));
+    filled_id = manager.get_client_order_id(filled);
+
+    REQUIRE(journal->last_sequence() == 5);
+  }
+
+  auto journal = std::make_shared<OrderJournal>(path, logger);
+  REQUIRE(journal->open());
+  auto db_writer = std::make_shared<DBWriter>(db_path, logger);
+  db_writer->start();
+  auto manager = std::make_shared<OrderManager>(logger, db_writer);
+
+  OrderRecovery recovery(logger, db_writer, manager, nullptr);
+  recovery.set_journal(journal);
+  RecoveryStats stats = recovery.run(std::chrono::milliseconds(0));
+
+  REQUIRE(stats.journal_replayed == 5);
+  REQUIRE(stats.restored == 1);
+  REQUIRE(journal->checkpoint_sequence() == 5);
+
+  Order order;
+  REQUIRE(manager->get_order(open_id, order));
+  REQUIRE(order.state == OrderState::OPEN);
+  REQUIRE(order.exchange_order_id == "EX-1");
+  REQUIRE(db_writer->load_order(filled_id, order));
+  REQUIRE(order.state == OrderState::FILLED);
+
+  // Checkpointed: a second start has nothing to replay
+  OrderRecovery again(logger, db_writer, std::make_shared<OrderManager>(logger, db_writer),
+                      nullptr);
+  again.set_journal(journal);
+  REQUIRE(again.run(std::chrono::milliseconds(0)).journal_replayed == 0);
+
+  db_writer->stop();
+  journal->close();
+  for (const std::string& file : {path, db_path, db_path + "-wal", db_path + "-shm"}) {
+    std::remove(file.c_str());
+  }
+}
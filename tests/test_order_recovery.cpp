@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/DBWriter.hpp"
+#include "pulseexec/Logger.hpp"
+#include "pulseexec/OrderManager.hpp"
+#include "pulseexec/OrderRecovery.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+using namespace pulseexec;
+
+namespace {
+
+void remove_db(const std::string& db_path) {
+  std::remove(db_path.c_str());
+  std::remove((db_path + "-wal").c_str());
+  std::remove((db_path + "-shm").c_str());
+}
+
+} // namespace
+
+TEST_CASE("OrderRecovery restores open orders from the database", "[order_recovery]") {
+  std::string db_path = "/tmp/pulseexec_test_order_recovery.db";
+  remove_db(db_path);
+
+  auto logger = std::make_shared<Logger>();
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+
+  // First run: leave a mix of open and finished orders behind
+  std::string open_id;
+  std::string pending_id;
+  {
+    auto db_writer = std::make_shared<DBWriter>(db_path, logger, 10000, 64);
+    db_writer->start();
+    OrderManager manager(logger, db_writer);
+
+    OrderHandle open = manager.create_order(req);
+    manager.update_order(open, OrderState::OPEN, "EX-OPEN");
+    manager.update_order(open, OrderState::PARTIAL, "", Qty(0.25));
+    open_id = manager.get_client_order_id(open);
+
+    OrderHandle pending = manager.create_order(req);
+    pending_id = manager.get_client_order_id(pending);
+
+    OrderHandle filled = manager.create_order(req);
+    manager.update_order(filled, OrderState::OPEN, "EX-FILLED");
+    manager.update_order(filled, OrderState::FILLED, "", Qty(1.0));
+
+    OrderHandle canceled = manager.create_order(req);
+    manager.update_order(canceled, OrderState::CANCELED);
+
+    db_writer->stop();
+  }
+
+  auto db_writer = std::make_shared<DBWriter>(db_path, logger, 10000, 64);
+  db_writer->start();
+  auto manager = std::make_shared<OrderManager>(logger, db_writer);
+
+  SECTION("Only non-terminal orders come back, reachable by every ID") {
+    OrderRecovery recovery(logger, db_writer, manager, nullptr);
+    RecoveryStats stats = recovery.run(std::chrono::milliseconds(0));
+
+    REQUIRE(stats.loaded == 2);
+    REQUIRE(stats.restored == 2);
+    REQUIRE(stats.queried == 0);
+    REQUIRE(stats.unconfirmed == 2);
+    REQUIRE(manager->get_all_orders().size() == 2);
+    REQUIRE(manager->get_active_orders().size() == 1);
+
+    Order order;
+    REQUIRE(manager->get_order(open_id, order));
+    REQUIRE(order.state == OrderState::PARTIAL);
+    REQUIRE(order.filled_amount == Qty(0.25));
+    REQUIRE(order.request.price == Price(50000.0));
+    REQUIRE(order.handle != kInvalidOrderHandle);
+
+    Order by_exchange_id;
+    REQUIRE(manager->get_order_by_exchange_id("EX-OPEN", by_exchange_id));
+    REQUIRE(by_exchange_id.handle == order.handle);
+    REQUIRE(manager->has_order(pending_id));
+
+    // Restored handles take updates like any other
+    REQUIRE(manager->update_order(order.handle, OrderState::FILLED, "", Qty(1.0)));
+    REQUIRE(manager->get_active_orders().empty());
+  }
+
+  SECTION("Restoring does not log, re-persist or notify") {
+    std::atomic<int> callbacks{0};
+    manager->register_update_callback([&](const Order&) { callbacks.fetch_add(1); });
+    uint64_t written_before = db_writer->get_written_count();
+
+    OrderRecovery recovery(logger, db_writer, manager, nullptr);
+    recovery.run(std::chrono::milliseconds(0));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(callbacks.load() == 0);
+    REQUIRE(db_writer->get_written_count() == written_before);
+  }
+
+  SECTION("Orders already in memory are skipped") {
+    OrderRequest existing = req;
+    existing.client_order_id = open_id;
+    REQUIRE(manager->create_order(existing) != kInvalidOrderHandle);
+
+    OrderRecovery recovery(logger, db_writer, manager, nullptr);
+    RecoveryStats stats = recovery.run(std::chrono::milliseconds(0));
+    REQUIRE(stats.loaded == 2);
+    REQUIRE(stats.restored == 1);
+    REQUIRE(manager->get_all_orders().size() == 2);
+  }
+
+  db_writer->stop();
+  remove_db(db_path);
+}
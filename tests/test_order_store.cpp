@@ -0,0 +1,195 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/InstrumentRegistry.hpp"
+#include "pulseexec/OrderStore.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+
+TEST_CASE("OrderStore handles", "[order_store]") {
+  OrderStore store;
+
+  SECTION("Reserved handles stay invisible until published") {
+    OrderHandle handle = store.reserve();
+    REQUIRE(handle != kInvalidOrderHandle);
+    REQUIRE_FALSE(store.read(handle, [](const Order&) {}));
+
+    OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+    store.publish(handle, Order("order_1", req, 1), [](const OrderSnapshot&) {});
+
+    std::string id;
+    REQUIRE(store.read(handle, [&](const Order& order) { id = order.client_order_id; }));
+    REQUIRE(id == "order_1");
+  }
+
+  SECTION("Unknown handles are rejected") {
+    REQUIRE_FALSE(store.read(kInvalidOrderHandle, [](const Order&) {}));
+    REQUIRE_FALSE(store.update(OrderHandle(42), [](Order&) {}));
+  }
+
+  SECTION("Handles span chunks") {
+    OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+    const size_t count = OrderStore::kChunkSize + 10;
+    for (size_t i = 0; i < count; ++i) {
+      OrderHandle handle = store.reserve();
+      store.publish(handle, Order(std::to_string(i), req, 1), [](const OrderSnapshot&) {});
+    }
+
+    size_t visited = 0;
+    store.for_each([&](const Order& order) {
+      REQUIRE(order.client_order_id == std::to_string(visited));
+      ++visited;
+    });
+    REQUIRE(visited == count);
+  }
+}
+
+TEST_CASE("OrderStore snapshots", "[order_store]") {
+  OrderStore store;
+  OrderRequest req("BTC-PERPETUAL", Side::BUY, 50000.0, 1.0, OrderType::LIMIT);
+
+  auto add = [&](const std::string& id) {
+    Order order(id, req, 1);
+    order.state = OrderState::OPEN;
+    OrderHandle handle = store.reserve();
+    store.publish(handle, std::move(order), [](const OrderSnapshot&) {});
+    return handle;
+  };
+
+  SECTION("Updates publish a new version and leave old snapshots untouched") {
+    OrderHandle handle = add("A");
+    OrderSnapshot before = store.snapshot(handle);
+    REQUIRE(before->handle == handle);
+
+    OrderSnapshot published;
+    REQUIRE(store.update(
+        handle, [](Order& order) { order.state = OrderState::PARTIAL; },
+        [&](const OrderSnapshot& order) { published = order; }));
+
+    REQUIRE(before->state == OrderState::OPEN);
+    REQUIRE(published->state == OrderState::PARTIAL);
+    REQUIRE(store.snapshot(handle) == published);
+  }
+
+  SECTION("The active index follows state changes") {
+    OrderHandle a = add("A");
+    OrderHandle b = add("B");
+    OrderHandle c = add("C");
+    REQUIRE(store.active_count() == 3);
+
+    store.update(a, [](Order& order) { order.state = OrderState::FILLED; });
+    store.update(c, [](Order& order) { order.state = OrderState::CANCELED; });
+    REQUIRE(store.active_count() == 1);
+
+    std::vector<OrderHandle> active;
+    store.for_each_active([&](const OrderSnapshot& order) { active.push_back(order->handle); });
+    REQUIRE(active == std::vector<OrderHandle>{b});
+
+    // Terminal orders are still listed by for_each_snapshot
+    size_t all = 0;
+    store.for_each_snapshot([&](const OrderSnapshot&) { ++all; });
+    REQUIRE(all == 3);
+  }
+
+  SECTION("Retired slots are reused under a new generation") {
+    OrderHandle a = add("A");
+    REQUIRE(store.size() == 1);
+
+    OrderSnapshot retired = store.retire(a);
+    REQUIRE(retired->client_order_id == "A");
+    REQUIRE(store.size() == 0);
+    REQUIRE(store.active_count() == 0);
+    REQUIRE_FALSE(store.retire(a));
+
+    OrderHandle b = add("B");
+    REQUIRE(b != a);
+    REQUIRE(store.slot_count() == 1);
+
+    // The old handle no longer resolves, even though its slot is in use again
+    REQUIRE_FALSE(store.snapshot(a));
+    REQUIRE_FALSE(store.update(a, [](Order&) {}));
+    REQUIRE(store.snapshot(b)->client_order_id == "B");
+
+    // Stale releases and retires leave the new order alone
+    store.release(a);
+    REQUIRE_FALSE(store.retire(a));
+    REQUIRE(store.reserve() != b);
+    REQUIRE(store.snapshot(b));
+  }
+
+  SECTION("Released reservations are handed out again") {
+    OrderHandle reserved = store.reserve();
+    store.release(reserved);
+    OrderHandle a = add("A");
+    REQUIRE(a != reserved);
+    REQUIRE(store.slot_count() == 1);
+  }
+
+  SECTION("Readers never see a torn order while writers update it") {
+    OrderHandle handle = add("A");
+    auto fill = [&](int i) {
+      store.update(handle, [i](Order& order) {
+        order.state = OrderState::PARTIAL;
+        order.request.amount = Qty(static_cast<double>(i));
+        order.filled_amount = Qty(static_cast<double>(i));
+      });
+    };
+    fill(1);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::thread reader([&] {
+      while (!done.load()) {
+        store.for_each_active([&](const OrderSnapshot& order) {
+          // The writer always sets both fields to the same value
+          if (order->filled_amount != order->request.amount) {
+            torn.fetch_add(1);
+          }
+        });
+      }
+    });
+
+    for (int i = 2; i <= 10000; ++i) {
+      fill(i);
+    }
+    done = true;
+    reader.join();
+
+    REQUIRE(torn.load() == 0);
+  }
+}
+
+TEST_CASE("InstrumentRegistry interning", "[instrument_registry]") {
+  InstrumentRegistry registry;
+
+  InstrumentId btc = registry.intern("BTC-PERPETUAL");
+  REQUIRE(btc != kInvalidInstrumentId);
+  REQUIRE(registry.intern("BTC-PERPETUAL") == btc);
+  REQUIRE(registry.find("BTC-PERPETUAL") == btc);
+  REQUIRE(registry.find("ETH-PERPETUAL") == kInvalidInstrumentId);
+  REQUIRE(registry.name(btc) == "BTC-PERPETUAL");
+  REQUIRE(registry.name(kInvalidInstrumentId).empty());
+
+  // Concurrent interning of the same names yields one id per name
+  const int num_threads = 4;
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 100; ++i) {
+        std::string symbol = "SYM-" + std::to_string(i);
+        if (registry.name(registry.intern(symbol)) != symbol) {
+          mismatches.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(mismatches.load() == 0);
+  REQUIRE(registry.size() == 101);
+}
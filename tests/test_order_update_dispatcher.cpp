@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/OrderUpdateDispatcher.hpp"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+
+namespace {
+
+Order make_order(const std::string& id, OrderState state) {
+  Order order;
+  order.client_order_id = id;
+  order.state = state;
+  return order;
+}
+
+} // namespace
+
+TEST_CASE("OrderUpdateDispatcher delivers snapshots in order", "[order_update_dispatcher]") {
+  OrderUpdateDispatcher dispatcher(1024);
+
+  SECTION("Publishing without subscribers is a no-op") {
+    REQUIRE_FALSE(dispatcher.has_subscribers());
+    dispatcher.publish(make_order("A", OrderState::PENDING));
+    REQUIRE(dispatcher.published_count() == 0);
+  }
+
+  SECTION("Every subscriber sees every update in publish order") {
+    std::vector<std::string> first;
+    std::vector<std::string> second;
+    dispatcher.subscribe([&](const Order& order) { first.push_back(order.client_order_id); });
+    dispatcher.subscribe([&](const Order& order) { second.push_back(order.client_order_id); });
+
+    for (int i = 0; i < 100; ++i) {
+      dispatcher.publish(make_order(std::to_string(i), OrderState::OPEN));
+    }
+    REQUIRE(dispatcher.wait_idle(std::chrono::seconds(5)));
+
+    REQUIRE(first.size() == 100);
+    REQUIRE(first == second);
+    for (int i = 0; i < 100; ++i) {
+      REQUIRE(first[i] == std::to_string(i));
+    }
+    for (const auto& stats : dispatcher.subscriber_stats()) {
+      REQUIRE(stats.delivered == 100);
+      REQUIRE(stats.lag == 0);
+    }
+  }
+
+  SECTION("Snapshots are unaffected by later changes to the source order") {
+    std::string seen_state;
+    dispatcher.subscribe([&](const Order& order) { seen_state = to_string(order.state); });
+
+    Order order = make_order("A", OrderState::OPEN);
+    dispatcher.publish(order);
+    order.state = OrderState::FILLED;
+    REQUIRE(dispatcher.wait_idle(std::chrono::seconds(5)));
+    REQUIRE(seen_state == to_string(OrderState::OPEN));
+  }
+
+  SECTION("Unsubscribed callbacks stop receiving updates") {
+    std::atomic<int> calls{0};
+    auto id = dispatcher.subscribe([&](const Order&) { calls.fetch_add(1); });
+    dispatcher.publish(make_order("A", OrderState::OPEN));
+    REQUIRE(dispatcher.wait_idle(std::chrono::seconds(5)));
+
+    dispatcher.unsubscribe(id);
+    REQUIRE_FALSE(dispatcher.has_subscribers());
+    dispatcher.publish(make_order("B", OrderState::OPEN));
+    REQUIRE(calls.load() == 1);
+  }
+
+  SECTION("A throwing callback is counted and does not stop delivery") {
+    std::atomic<int> calls{0};
+    dispatcher.subscribe([](const Order&) { throw std::runtime_error("subscriber bug"); });
+    dispatcher.subscribe([&](const Order&) { calls.fetch_add(1); });
+    dispatcher.subscribe([](const Order&) { throw 42; }); // Not a std::exception
+
+    dispatcher.publish(make_order("A", OrderState::OPEN));
+    dispatcher.publish(make_order("B", OrderState::OPEN));
+    REQUIRE(dispatcher.wait_idle(std::chrono::seconds(5)));
+
+    REQUIRE(calls.load() == 2);
+    REQUIRE(dispatcher.subscriber_stats()[0].failures == 2);
+    REQUIRE(dispatcher.subscriber_stats()[2].failures == 2);
+  }
+}
+
+TEST_CASE("OrderUpdateDispatcher isolates publishers from slow subscribers",
+          "[order_update_dispatcher]") {
+  OrderUpdateDispatcher dispatcher(8);
+  std::atomic<bool> release{false};
+  std::vector<Order> delivered;
+  dispatcher.subscribe([&](const Order& order) {
+    while (!release.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    delivered.push_back(order);
+  });
+
+  SECTION("Orders past the ring's capacity still arrive") {
+    // The first snapshot blocks the subscriber; the rest fill the ring, then overflow
+    for (int i = 0; i < 20; ++i) {
+      dispatcher.publish(make_order(std::to_string(i), OrderState::OPEN));
+    }
+    REQUIRE(dispatcher.published_count() == 20);
+    REQUIRE(dispatcher.subscriber_stats()[0].lag > 0);
+
+    release = true;
+    REQUIRE(dispatcher.wait_idle(std::chrono::seconds(5)));
+    REQUIRE(dispatcher.subscriber_stats()[0].delivered == 20);
+    REQUIRE(dispatcher.subscriber_stats()[0].lag == 0);
+    for (int i = 0; i < 20; ++i) {
+      REQUIRE(delivered[i].client_order_id == std::to_string(i));
+    }
+  }
+
+  SECTION("An overflowing order keeps its latest state and its sequence") {
+    for (int i = 0; i < 20; ++i) {
+      dispatcher.publish(make_order(std::to_string(i), OrderState::OPEN));
+    }
+    dispatcher.publish(make_order("A", OrderState::OPEN));
+    dispatcher.publish(make_order("A", OrderState::PARTIAL));
+    dispatcher.publish(make_order("A", OrderState::FILLED));
+    REQUIRE(dispatcher.coalesced_count() == 2);
+
+    release = true;
+    REQUIRE(dispatcher.wait_idle(std::chrono::seconds(5)));
+    REQUIRE(delivered.size() == 21);
+    REQUIRE(delivered.back().client_order_id == "A");
+    REQUIRE(delivered.back().state == OrderState::FILLED);
+
+    // Once the overflow is delivered, publishes take the ring again
+    dispatcher.publish(make_order("A", OrderState::CANCELED));
+    REQUIRE(dispatcher.wait_idle(std::chrono::seconds(5)));
+    REQUIRE(delivered.back().state == OrderState::CANCELED);
+    REQUIRE(dispatcher.coalesced_count() == 2);
+  }
+
+  release = true;
+  dispatcher.stop();
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/RateLimiter.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+using Pool = RateLimiter::Pool;
+
+TEST_CASE("RateLimiter sorts endpoints into the exchange's credit pools", "[rate_limiter]") {
+  CHECK(RateLimiter::pool_for("/api/v2/private/buy") == Pool::MATCHING_ENGINE);
+  CHECK(RateLimiter::pool_for("/api/v2/private/sell") == Pool::MATCHING_ENGINE);
+  CHECK(RateLimiter::pool_for("/api/v2/private/edit") == Pool::MATCHING_ENGINE);
+  CHECK(RateLimiter::pool_for("/api/v2/private/cancel") == Pool::MATCHING_ENGINE);
+  CHECK(RateLimiter::pool_for("/api/v2/private/cancel_all_by_instrument?instrument_name=x") ==
+        Pool::MATCHING_ENGINE);
+  CHECK(RateLimiter::pool_for("/api/v2/private/get_order_state?order_id=buy") ==
+        Pool::NON_MATCHING);
+  CHECK(RateLimiter::pool_for("/api/v2/public/get_order_book?instrument_name=BTC-PERPETUAL") ==
+        Pool::NON_MATCHING);
+  CHECK(RateLimiter::pool_for("/api/v2/public/auth") == Pool::NON_MATCHING);
+}
+
+TEST_CASE("RateLimiter serves a burst, then queues, then rejects", "[rate_limiter]") {
+  // Four requests at once, then one every 100 ms; nobody waits over 250 ms
+  RateLimiter::Config config;
+  config.matching_engine = {4, 10, 1};
+  config.max_wait = std::chrono::milliseconds(250);
+  RateLimiter limiter(config);
+
+  std::chrono::microseconds wait(0);
+  for (int i = 0; i < 4; ++i) {
+    REQUIRE(limiter.acquire(Pool::MATCHING_ENGINE, wait));
+    CHECK(wait.count() == 0);
+  }
+
+  REQUIRE(limiter.acquire(Pool::MATCHING_ENGINE, wait));
+  CHECK(wait > std::chrono::milliseconds(50));
+  CHECK(wait <= std::chrono::milliseconds(100));
+  auto first_wait = wait;
+  REQUIRE(limiter.acquire(Pool::MATCHING_ENGINE, wait));
+  CHECK(wait > first_wait + std::chrono::milliseconds(50));
+  CHECK_FALSE(limiter.acquire(Pool::MATCHING_ENGINE, wait));
+
+  RateLimiter::Credits credits = limiter.credits(Pool::MATCHING_ENGINE);
+  CHECK(credits.capacity == 4);
+  CHECK(credits.available < 0); // Two requests hold credits not yet refilled
+  CHECK(credits.available >= -2);
+  CHECK(credits.delayed == 2);
+  CHECK(credits.rejected == 1);
+
+  // The other pool is untouched
+  RateLimiter::Credits other = limiter.credits(Pool::NON_MATCHING);
+  CHECK(other.available == 50000);
+  CHECK(other.capacity == 50000);
+}
+
+TEST_CASE("RateLimiter refills at its configured rate", "[rate_limiter]") {
+  RateLimiter::Config config;
+  config.non_matching = {1000, 100000, 500}; // Two requests, refilled in 10 ms
+  config.max_wait = std::chrono::milliseconds(0);
+  RateLimiter limiter(config);
+
+  std::chrono::microseconds wait(0);
+  REQUIRE(limiter.acquire(Pool::NON_MATCHING, wait));
+  REQUIRE(limiter.acquire(Pool::NON_MATCHING, wait));
+  CHECK(limiter.credits(Pool::NON_MATCHING).available <= 100);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(15));
+  CHECK(limiter.credits(Pool::NON_MATCHING).available == 1000);
+  CHECK(limiter.acquire(Pool::NON_MATCHING, wait));
+  CHECK(wait.count() == 0);
+}
+
+TEST_CASE("RateLimiter empties a pool the exchange says is exhausted", "[rate_limiter]") {
+  RateLimiter limiter;
+  limiter.on_rate_limited(Pool::NON_MATCHING);
+
+  RateLimiter::Credits credits = limiter.credits(Pool::NON_MATCHING);
+  CHECK(credits.available < 500); // Not one request's worth
+  CHECK(credits.exchange_rejections == 1);
+
+  // One request's 500 credits take 50 ms to come back, just inside max_wait
+  std::chrono::microseconds wait(0);
+  REQUIRE(limiter.acquire(Pool::NON_MATCHING, wait));
+  CHECK(wait > std::chrono::milliseconds(40));
+  CHECK_FALSE(limiter.acquire(Pool::NON_MATCHING, wait));
+}
+
+TEST_CASE("RateLimiter hands out each credit once across threads", "[rate_limiter]") {
+  RateLimiter::Config config;
+  config.matching_engine = {100, 1, 1};
+  config.non_matching = {0, 0, 1}; // Unlimited
+  config.max_wait = std::chrono::milliseconds(0);
+  RateLimiter limiter(config);
+
+  std::atomic<int> granted{0};
+  std::atomic<int> unlimited{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      std::chrono::microseconds wait(0);
+      for (int i = 0; i < 1000; ++i) {
+        granted += limiter.acquire(Pool::MATCHING_ENGINE, wait) ? 1 : 0;
+        unlimited += limiter.acquire(Pool::NON_MATCHING, wait) ? 1 : 0;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  CHECK(granted >= 100);
+  CHECK(granted <= 101); // At most one credit refills while the threads run
+  CHECK(unlimited == 4000);
+  CHECK(limiter.credits(Pool::MATCHING_ENGINE).rejected == 4000 - static_cast<uint64_t>(granted));
+}
@@ -0,0 +1,268 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/Logger.hpp"
+#include "pulseexec/MarketDataFeed.hpp"
+#include "pulseexec/OrderManager.hpp"
+#include "pulseexec/SessionRecorder.hpp"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace pulseexec;
+
+namespace {
+
+const InstrumentScale kBtcScale{1, 0, Price(0.5, 1), Qty(10.0, 0)};
+
+std::string book_message(const std::string& type, uint64_t change_id, uint64_t prev_change_id,
+                         const std::string& bids, const std::string& asks) {
+  std::string prev =
+      type == "snapshot" ? "" : R"("prev_change_id":)" + std::to_string(prev_change_id) + ",";
+  return R"({"jsonrpc":"2.0","method":"subscription",)"
+         R"("params":{"channel":"book.BTC-PERPETUAL.100ms","data":{"type":")" +
+         type + R"(","timestamp":1700000000000,"instrument_name":"BTC-PERPETUAL",)" +
+         R"("change_id":)" + std::to_string(change_id) + "," + prev + R"("bids":)" + bids +
+         R"(,"asks":)" + asks + "}}}";
+}
+
+std::vector<SessionEvent> read_all(const std::string& path, bool* truncated = nullptr) {
+  SessionReader reader(path);
+  REQUIRE(reader.open());
+  std::vector<SessionEvent> events;
+  SessionEvent event;
+  while (reader.next(event)) {
+    events.push_back(event);
+  }
+  if (truncated) {
+    *truncated = reader.truncated();
+  }
+  return events;
+}
+
+// A short live session: a book, an order placed, partially filled and filled,
+// another rejected, and the exchange's replies to both placements
+void run_session(const std::shared_ptr<SessionRecorder>& recorder) {
+  auto feed = std::make_shared<MarketDataFeed>("ws://127.0.0.1:1/ws/api/v2", nullptr);
+  feed->set_recorder(recorder);
+  feed->subscribe("BTC-PERPETUAL", kBtcScale);
+
+  auto manager = std::make_shared<OrderManager>(nullptr, nullptr);
+  manager->set_recorder(recorder);
+
+  feed->process_message(book_message("snapshot", 100, 0, R"([["new",50000.0,1000]])",
+                                     R"([["new",50000.5,800]])"));
+
+  OrderRequest buy("BTC-PERPETUAL", Side::BUY, 50000.0, 20.0, OrderType::LIMIT, "BUY_1");
+  OrderHandle handle = manager->create_order(buy);
+  recorder->record_gateway_response("/api/v2/private/buy", 200, true,
+                                    R"({"result":{"order":{"order_id":"EX-1"}}})");
+  manager->update_order(handle, OrderState::OPEN, "EX-1");
+
+  feed->process_message(
+      book_message("change", 101, 100, R"([["change",50000.0,1200]])", "[]"));
+  manager->update_order(handle, OrderState::PARTIAL, "", Qty(10.0));
+  manager->update_order(handle, OrderState::FILLED, "", Qty(20.0));
+
+  OrderRequest sell("BTC-PERPETUAL", Side::SELL, 60000.0, 10.0, OrderType::LIMIT, "SELL_1");
+  manager->create_order(sell);
+  recorder->record_gateway_response("/api/v2/private/sell", 400, false, "invalid_price");
+  manager->update_order("SELL_1", OrderState::REJECTED, "", Qty(), "invalid_price");
+
+  OrderRequest open("BTC-PERPETUAL", Side::BUY, 49000.0, 10.0, OrderType::LIMIT, "BUY_2");
+  manager->update_order(manager->create_order(open), OrderState::OPEN, "EX-2");
+}
+
+} // namespace
+
+TEST_CASE("SessionRecorder writes events that SessionReader reads back", "[session_replay]") {
+  std::string path = "/tmp/pulseexec_test_session.bin";
+  std::remove(path.c_str());
+  auto logger = std::make_shared<Logger>();
+
+  SECTION("Every event type round-trips with its fields") {
+    SessionRecorder recorder(path, logger);
+    REQUIRE(recorder.open());
+
+    recorder.record_feed_subscribe("BTC-PERPETUAL", kBtcScale);
+    recorder.record_market_data("{\"method\":\"heartbeat\"}");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    recorder.record_gateway_response("/api/v2/private/cancel", 503, false, "unavailable");
+
+    OrderRequest req("ETH-PERPETUAL", Side::SELL, 3000.25, 2.0, OrderType::LIMIT);
+    Order order("REC_1", req, 1234);
+    order.exchange_order_id = "EX-9";
+    order.state = OrderState::PARTIAL;
+    order.filled_amount = Qty(0.5);
+    recorder.record_order_create(order);
+    recorder.record_order_update("REC_1", OrderState::FILLED, "EX-9", Qty(2.0), "done");
+    recorder.record_order_restore(order);
+    REQUIRE(recorder.event_count() == 6);
+    recorder.close();
+
+    bool truncated = true;
+    auto events = read_all(path, &truncated);
+    REQUIRE_FALSE(truncated);
+    REQUIRE(events.size() == 6);
+
+    REQUIRE(events[0].type == SessionEventType::FEED_SUBSCRIBE);
+    CHECK(events[0].text == "BTC-PERPETUAL");
+    CHECK(events[0].scale.price_decimals == 1);
+    CHECK(events[0].scale.tick_size == Price(0.5, 1));
+    CHECK(events[0].scale.lot_size == Qty(10.0, 0));
+
+    REQUIRE(events[1].type == SessionEventType::MARKET_DATA);
+    CHECK(events[1].text == "{\"method\":\"heartbeat\"}");
+
+    REQUIRE(events[2].type == SessionEventType::GATEWAY_RESPONSE);
+    CHECK(events[2].endpoint == "/api/v2/private/cancel");
+    CHECK(events[2].http_status == 503);
+    CHECK_FALSE(events[2].success);
+    CHECK(events[2].text == "unavailable");
+    CHECK(events[2].ts_us - events[1].ts_us >= 2000);
+
+    REQUIRE(events[3].type == SessionEventType::ORDER_CREATE);
+    CHECK(events[3].order.client_order_id == "REC_1");
+    CHECK(events[3].order.request.symbol == "ETH-PERPETUAL");
+    CHECK(events[3].order.request.side == Side::SELL);
+    CHECK(events[3].order.request.price == Price(3000.25));
+    CHECK(events[3].order.request.amount == Qty(2.0));
+
+    REQUIRE(events[4].type == SessionEventType::ORDER_UPDATE);
+    CHECK(events[4].order.state == OrderState::FILLED);
+    CHECK(events[4].order.filled_amount == Qty(2.0));
+    CHECK(events[4].order.error_message == "done");
+
+    REQUIRE(events[5].type == SessionEventType::ORDER_RESTORE);
+    CHECK(events[5].order.state == OrderState::PARTIAL);
+    CHECK(events[5].order.exchange_order_id == "EX-9");
+    CHECK(events[5].order.created_ts_us == 1234);
+
+    for (size_t i = 1; i < events.size(); ++i) {
+      CHECK(events[i].ts_us >= events[i - 1].ts_us);
+    }
+  }
+
+  SECTION("A torn last record ends the session cleanly") {
+    {
+      SessionRecorder recorder(path, logger);
+      REQUIRE(recorder.open());
+      recorder.record_market_data("first");
+      recorder.record_market_data("second");
+    }
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    auto size = static_cast<off_t>(in.tellg());
+    REQUIRE(truncate(path.c_str(), size - 3) == 0);
+
+    bool truncated = false;
+    auto events = read_all(path, &truncated);
+    REQUIRE(truncated);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].text == "first");
+  }
+
+  SECTION("Records reach the file while recording is still open") {
+    SessionRecorder recorder(path, logger);
+    REQUIRE(recorder.open());
+    recorder.record_market_data("before a crash");
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    auto events = read_all(path);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].text == "before a crash");
+  }
+
+  SECTION("A failed write stops the recording and is reported") {
+    SessionRecorder recorder("/dev/full", logger);
+    REQUIRE(recorder.open());
+    for (int i = 0; i < 300; ++i) {
+      recorder.record_market_data("lost");
+    }
+    CHECK(recorder.failed());
+    CHECK_FALSE(recorder.is_open());
+    CHECK(recorder.event_count() < 300);
+  }
+
+  SECTION("Files that are not recordings are refused") {
+    {
+      std::ofstream file(path, std::ios::binary);
+      file << "not a session recording";
+    }
+    SessionReader reader(path);
+    REQUIRE_FALSE(reader.open());
+
+    SessionReplayer replayer(logger, nullptr, nullptr);
+    ReplayStats stats;
+    REQUIRE_FALSE(replayer.run(path, 0, stats));
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("SessionReplayer reproduces a recorded session", "[session_replay]") {
+  std::string path = "/tmp/pulseexec_test_session_replay.bin";
+  std::remove(path.c_str());
+  auto logger = std::make_shared<Logger>();
+
+  auto recorder = std::make_shared<SessionRecorder>(path, logger);
+  REQUIRE(recorder->open());
+  run_session(recorder);
+  recorder->close();
+
+  auto feed = std::make_shared<MarketDataFeed>("ws://127.0.0.1:1/ws/api/v2", nullptr);
+  auto manager = std::make_shared<OrderManager>(nullptr, nullptr);
+  SessionReplayer replayer(logger, manager, feed);
+
+  ReplayStats stats;
+  REQUIRE(replayer.run(path, 0, stats));
+  CHECK(stats.events == 13);
+  CHECK(stats.market_data == 2);
+  CHECK(stats.gateway_responses == 2);
+  CHECK(stats.gateway_errors == 1);
+  CHECK(stats.order_commands == 8);
+  CHECK(stats.commands_failed == 0);
+  CHECK_FALSE(stats.truncated);
+
+  Order order;
+  REQUIRE(manager->get_order("BUY_1", order));
+  CHECK(order.state == OrderState::FILLED);
+  CHECK(order.exchange_order_id == "EX-1");
+  CHECK(order.filled_amount == Qty(20.0));
+  REQUIRE(manager->get_order("SELL_1", order));
+  CHECK(order.state == OrderState::REJECTED);
+  CHECK(order.error_message == "invalid_price");
+  REQUIRE(manager->get_order_by_exchange_id("EX-2", order));
+  CHECK(order.client_order_id == "BUY_2");
+  CHECK(manager->get_active_orders().size() == 1);
+
+  OrderBook book;
+  REQUIRE(feed->get_book("BTC-PERPETUAL", book));
+  CHECK(book.sequence == 101);
+  REQUIRE(book.bids.size() == 1);
+  CHECK(book.bids[0].amount == Qty(1200.0, 0));
+
+  SECTION("Replaying into the same order manager again is rejected, not duplicated") {
+    ReplayStats again;
+    REQUIRE(replayer.run(path, 0, again));
+    CHECK(again.commands_failed == 3); // The three creates; updates apply to existing orders
+    CHECK(manager->get_all_orders().size() == 3);
+  }
+
+  SECTION("Recorded gaps are kept, scaled by speed") {
+    auto paced = std::make_shared<SessionRecorder>(path, logger);
+    REQUIRE(paced->open());
+    paced->record_market_data("{}");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    paced->record_market_data("{}");
+    paced->close();
+
+    SessionReplayer idle(logger, nullptr, nullptr);
+    ReplayStats paced_stats;
+    REQUIRE(idle.run(path, 2.0, paced_stats));
+    CHECK(paced_stats.recorded_us >= 100000);
+    CHECK(paced_stats.elapsed_us >= paced_stats.recorded_us / 2);
+  }
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/ShardedFlatMap.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pulseexec;
+
+TEST_CASE("ShardedFlatMap basic operations", "[sharded_flat_map]") {
+  ShardedFlatMap<int> map(4, 2);
+  REQUIRE(map.shard_count() == 4);
+
+  SECTION("Insert rejects duplicates") {
+    REQUIRE(map.insert("a", 1));
+    REQUIRE_FALSE(map.insert("a", 2));
+
+    int value = 0;
+    REQUIRE(map.read("a", [&](const int& v) { value = v; }));
+    REQUIRE(value == 1);
+    REQUIRE(map.size() == 1);
+  }
+
+  SECTION("Update and insert_or_assign modify in place") {
+    REQUIRE_FALSE(map.update("missing", [](int&) {}));
+
+    map.insert_or_assign("a", 1);
+    map.insert_or_assign("a", 5);
+    REQUIRE(map.update("a", [](int& v) { v += 1; }));
+
+    int value = 0;
+    map.read("a", [&](const int& v) { value = v; });
+    REQUIRE(value == 6);
+  }
+
+  SECTION("Grows past the initial capacity") {
+    for (int i = 0; i < 1000; ++i) {
+      REQUIRE(map.insert("key_" + std::to_string(i), i));
+    }
+    REQUIRE(map.size() == 1000);
+
+    for (int i = 0; i < 1000; ++i) {
+      int value = -1;
+      REQUIRE(map.read("key_" + std::to_string(i), [&](const int& v) { value = v; }));
+      REQUIRE(value == i);
+    }
+  }
+
+  SECTION("Erase keeps the remaining probe chains reachable") {
+    ShardedFlatMap<int> single(1, 2);
+    for (int i = 0; i < 500; ++i) {
+      single.insert("key_" + std::to_string(i), i);
+    }
+    for (int i = 0; i < 500; i += 2) {
+      REQUIRE(single.erase("key_" + std::to_string(i)));
+    }
+    REQUIRE_FALSE(single.erase("key_0"));
+    REQUIRE(single.size() == 250);
+
+    for (int i = 0; i < 500; ++i) {
+      REQUIRE(single.contains("key_" + std::to_string(i)) == (i % 2 == 1));
+    }
+
+    int visited = 0;
+    single.for_each([&](const std::string&, const int& v) {
+      REQUIRE(v % 2 == 1);
+      ++visited;
+    });
+    REQUIRE(visited == 250);
+  }
+
+  SECTION("erase_if only erases matching values") {
+    map.insert("a", 1);
+    REQUIRE_FALSE(map.erase_if("a", [](const int& v) { return v == 2; }));
+    REQUIRE(map.contains("a"));
+    REQUIRE(map.erase_if("a", [](const int& v) { return v == 1; }));
+    REQUIRE_FALSE(map.contains("a"));
+    REQUIRE_FALSE(map.erase_if("a", [](const int&) { return true; }));
+  }
+}
+
+TEST_CASE("ShardedFlatMap concurrent access", "[sharded_flat_map][concurrency]") {
+  ShardedFlatMap<int> map(16);
+  const int num_threads = 8;
+  const int keys_per_thread = 2000;
+  std::atomic<int> failed_inserts{0};
+  std::atomic<int> failed_reads{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < keys_per_thread; ++i) {
+        std::string key = std::to_string(t) + "_" + std::to_string(i);
+        if (!map.insert(key, i)) {
+          failed_inserts.fetch_add(1);
+        }
+        int value = -1;
+        if (!map.read(key, [&](const int& v) { value = v; }) || value != i) {
+          failed_reads.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(failed_inserts.load() == 0);
+  REQUIRE(failed_reads.load() == 0);
+  REQUIRE(map.size() == num_threads * keys_per_thread);
+}
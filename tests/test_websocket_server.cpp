@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pulseexec/WebSocketServer.hpp"
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include <thread>
+
+using namespace pulseexec;
+
+namespace {
+
+SharedMessage make_message(const std::string& topic, const std::string& text) {
+  return std::make_shared<OutboundMessage>(OutboundMessage{topic, text});
+}
+
+// Blocking client for driving the server from a test
+class TestClient {
+public:
+  explicit TestClient(uint16_t port) : ws_(io_) {
+    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address("127.0.0.1"), port);
+    ws_.next_layer().connect(endpoint);
+    ws_.handshake("127.0.0.1", "/");
+  }
+
+  void send(const std::string& method, const std::vector<std::string>& topics) {
+    nlohmann::json request = {{"jsonrpc", "2.0"},
+                              {"id", ++next_id_},
+                              {"method", method},
+                              {"params", {{"topics", topics}}}};
+    ws_.write(boost::asio::buffer(request.dump()));
+  }
+
+  nlohmann::json read() {
+    boost::beast::flat_buffer buffer;
+    ws_.read(buffer);
+    return nlohmann::json::parse(boost::beast::buffers_to_string(buffer.data()));
+  }
+
+  // Subscribe and wait for the acknowledgement
+  void subscribe(const std::vector<std::string>& topics) {
+    send("subscribe", topics);
+    read();
+  }
+
+private:
+  boost::asio::io_context io_;
+  boost::beast::websocket::stream<boost::asio::ip::tcp::socket> ws_;
+  int next_id_ = 0;
+};
+
+template <typename Pred> bool wait_for(Pred pred) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!pred()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("SendQueue bounds each session's backlog", "[websocket_server]") {
+  SECTION("Disconnect policy rejects once full") {
+    SendQueue queue(2, SlowConsumerPolicy::DISCONNECT);
+    CHECK(queue.push(make_message("a", "1")) == SendQueue::PushResult::QUEUED);
+    CHECK(queue.push(make_message("a", "2")) == SendQueue::PushResult::QUEUED);
+    CHECK(queue.push(make_message("a", "3")) == SendQueue::PushResult::FULL);
+  }
+
+  SECTION("Conflate policy replaces the newest queued message of the topic") {
+    SendQueue queue(3, SlowConsumerPolicy::CONFLATE);
+    queue.push(make_message("book", "b1"));
+    queue.push(make_message("orders", "o1"));
+    queue.push(make_message("book", "b2"));
+    REQUIRE(queue.begin_write()->text == "b1");
+
+    CHECK(queue.push(make_message("book", "b3")) == SendQueue::PushResult::CONFLATED);
+    CHECK(queue.push(make_message("trades", "t1")) == SendQueue::PushResult::FULL);
+    CHECK(queue.size() == 3);
+
+    queue.end_write();
+    CHECK(queue.begin_write()->text == "o1");
+    queue.end_write();
+    CHECK(queue.begin_write()->text == "b3");
+  }
+
+  SECTION("The in-flight message is never conflated") {
+    SendQueue queue(1, SlowConsumerPolicy::CONFLATE);
+    queue.push(make_message("book", "b1"));
+    queue.begin_write();
+    CHECK(queue.push(make_message("book", "b2")) == SendQueue::PushResult::FULL);
+  }
+
+  SECTION("Responses without a topic are never conflated") {
+    SendQueue queue(1, SlowConsumerPolicy::CONFLATE);
+    queue.push(make_message("", "r1"));
+    CHECK(queue.push(make_message("", "r2")) == SendQueue::PushResult::FULL);
+  }
+}
+
+TEST_CASE("WebSocketServer routes published updates to topic subscribers",
+          "[websocket_server]") {
+  WebSocketServer server("127.0.0.1", 0, nullptr);
+  REQUIRE(server.start());
+  REQUIRE(server.port() != 0);
+
+  TestClient both(server.port());
+  TestClient book_only(server.port());
+  both.subscribe({"book.BTC-PERPETUAL", "orders"});
+  book_only.subscribe({"book.BTC-PERPETUAL"});
+  CHECK(server.subscriber_count("book.BTC-PERPETUAL") == 2);
+  CHECK(server.subscriber_count("orders") == 1);
+
+  CHECK(server.publish("book.BTC-PERPETUAL", R"({"best_bid":50000})") == 2);
+  for (auto* client : {&both, &book_only}) {
+    auto message = client->read();
+    CHECK(message["method"] == "subscription");
+    CHECK(message["params"]["channel"] == "book.BTC-PERPETUAL");
+    CHECK(message["params"]["data"]["best_bid"] == 50000);
+  }
+
+  // After unsubscribing, the next update on "book" is skipped and "orders" arrives first
+  both.send("unsubscribe", {"book.BTC-PERPETUAL"});
+  auto ack = both.read();
+  CHECK(ack["result"] == nlohmann::json::array({"book.BTC-PERPETUAL"}));
+  CHECK(server.publish("book.BTC-PERPETUAL", "1") == 1);
+  CHECK(server.publish("orders", "2") == 1);
+  CHECK(both.read()["params"]["channel"] == "orders");
+  CHECK(book_only.read()["params"]["data"] == 1);
+
+  both.send("bogus", {});
+  CHECK(both.read()["error"]["code"] == -32601);
+
+  server.stop();
+  auto stats = server.stats();
+  CHECK(stats.sessions_accepted == 2);
+  CHECK(stats.messages_published == 3);
+  CHECK(stats.slow_consumer_disconnects == 0);
+}
+
+TEST_CASE("WebSocketServer disconnects a client that stops reading", "[websocket_server]") {
+  WebSocketServerOptions options;
+  options.max_queued_messages = 4;
+  options.slow_consumer_policy = SlowConsumerPolicy::DISCONNECT;
+  WebSocketServer server("127.0.0.1", 0, nullptr, options);
+  REQUIRE(server.start());
+
+  TestClient healthy(server.port());
+  TestClient stalled(server.port());
+  healthy.subscribe({"book"});
+  stalled.subscribe({"book"});
+
+  // Large frames fill the socket buffers quickly; the healthy client keeps up
+  std::string payload = "\"" + std::string(64 * 1024, 'x') + "\"";
+  std::thread reader([&] {
+    try {
+      for (;;) {
+        healthy.read();
+      }
+    } catch (const std::exception&) {
+      // Closed by server.stop()
+    }
+  });
+
+  bool disconnected = wait_for([&] {
+    server.publish("book", payload);
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    return server.stats().slow_consumer_disconnects == 1;
+  });
+  CHECK(disconnected);
+  CHECK(wait_for([&] { return server.subscriber_count("book") == 1; }));
+
+  server.stop();
+  reader.join();
+}